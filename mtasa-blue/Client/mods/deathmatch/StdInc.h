@@ -49,6 +49,7 @@
 #include "net/SyncStructures.h"
 #include "CIdArray.h"
 #include "pcrecpp.h"
+#include "CRegexCache.h"
 
 // Shared logic includes
 #include <Utils.h>
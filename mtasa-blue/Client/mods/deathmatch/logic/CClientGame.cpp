@@ -302,7 +302,7 @@ CClientGame::CClientGame ( bool bLocalPlay )
     CLuaDefs::Initialize ( this, m_pLuaManager, m_pScriptDebugging );
 
     // Start async task scheduler
-    m_pAsyncTaskScheduler = new SharedUtil::CAsyncTaskScheduler(2);
+    m_pAsyncTaskScheduler = new SharedUtil::CAsyncTaskScheduler(2, 1024);     // Tasks are refused while 1024 are waiting to start
 
     // Disable the enter/exit vehicle key button (we want to handle this button ourselves)
     g_pMultiplayer->DisableEnterExitVehicleKey ( true );
@@ -138,6 +138,10 @@ bool CPacketHandler::ProcessPacket ( unsigned char ucPacketID, NetBitStreamInter
             Packet_Lua ( ucPacketID, bitStream );
             return true;
 
+        case PACKET_ID_LUA_ELEMENT_RPC_BATCH:
+            Packet_ElementRPCBatch ( bitStream );
+            return true;
+
         case PACKET_ID_TEXT_ITEM:
             Packet_TextItem ( bitStream );
             break;
@@ -198,6 +202,10 @@ bool CPacketHandler::ProcessPacket ( unsigned char ucPacketID, NetBitStreamInter
             Packet_LatentTransfer ( bitStream );
             return true;
 
+        case PACKET_ID_COMPRESSED:
+            Packet_Compressed ( bitStream );
+            return true;
+
         case PACKET_ID_SYNC_SETTINGS:
             Packet_SyncSettings ( bitStream );
             return true;
@@ -4163,6 +4171,42 @@ void CPacketHandler::Packet_Lua ( unsigned char ucPacketID, NetBitStreamInterfac
     }
 }
 
+//
+// Element RPCs which the server collected during one pulse. Each one gets its own bitstream as if it was sent alone.
+//
+void CPacketHandler::Packet_ElementRPCBatch ( NetBitStreamInterface& bitStream )
+{
+    ushort usNumRPCs;
+    if ( !bitStream.ReadCompressed ( usNumRPCs ) )
+        return;
+
+    NetBitStreamInterface* pBitStream = g_pNet->AllocateNetBitStream ();
+    if ( !pBitStream )
+        return;
+
+    std::vector < char > buffer;
+    for ( uint i = 0 ; i < usNumRPCs ; i++ )
+    {
+        uint uiNumBits;
+        if ( !bitStream.ReadCompressed ( uiNumBits ) || uiNumBits > (uint)bitStream.GetNumberOfUnreadBits () )
+        {
+            RaiseProtocolError ( 53 );
+            break;
+        }
+
+        buffer.resize ( ( uiNumBits + 7 ) / 8 + 1 );
+        bitStream.ReadBits ( &buffer[0], uiNumBits );
+
+        pBitStream->Reset ();
+        pBitStream->WriteBits ( &buffer[0], uiNumBits );
+        pBitStream->ResetReadPointer ();
+        Packet_Lua ( PACKET_ID_LUA_ELEMENT_RPC, *pBitStream );
+    }
+
+    g_pNet->DeallocateNetBitStream ( pBitStream );
+}
+
+
 void CPacketHandler::Packet_TextItem( NetBitStreamInterface& bitStream )
 {
     // unsigned long    (4)     - text item id
@@ -5087,6 +5131,57 @@ void CPacketHandler::Packet_LatentTransfer ( NetBitStreamInterface& bitStream )
 }
 
 
+//
+// Big packet compressed by the server. Rebuild the original and handle it as normal.
+//
+void CPacketHandler::Packet_Compressed ( NetBitStreamInterface& bitStream )
+{
+    uchar ucPacketID;
+    uint uiNumBits;
+    uint uiCompressedSize;
+    if ( !bitStream.Read ( ucPacketID ) || !bitStream.Read ( uiNumBits ) || !bitStream.Read ( uiCompressedSize ) )
+        return;
+
+    // zlib can not do better than about 1000:1
+    if ( ucPacketID == PACKET_ID_COMPRESSED || uiCompressedSize == 0 || uiCompressedSize > (uint)bitStream.GetNumberOfBytesUsed () || uiNumBits / 8 / 1100 > uiCompressedSize )
+    {
+        RaiseProtocolError ( 51 );
+        return;
+    }
+
+    std::vector < Bytef > compressed ( uiCompressedSize );
+    if ( !bitStream.Read ( reinterpret_cast < char* > ( &compressed[0] ), uiCompressedSize ) )
+        return;
+
+    uLongf ulSize = ( uiNumBits + 7 ) / 8;
+    std::vector < Bytef > buffer ( ulSize + 1 );
+    if ( uncompress ( &buffer[0], &ulSize, &compressed[0], uiCompressedSize ) != Z_OK || ulSize != ( uiNumBits + 7 ) / 8 )
+    {
+        RaiseProtocolError ( 52 );
+        return;
+    }
+
+    NetBitStreamInterface* pBitStream = g_pNet->AllocateNetBitStream ();
+    if ( !pBitStream )
+        return;
+
+    // Whole bytes, then the last bits which WriteBits takes from the low end of the byte
+    uint uiNumWholeBits = uiNumBits & ~7;
+    if ( uiNumWholeBits )
+        pBitStream->WriteBits ( &buffer[0], uiNumWholeBits );
+    uint uiNumRemainingBits = uiNumBits & 7;
+    if ( uiNumRemainingBits )
+    {
+        uchar ucLast = buffer[ uiNumWholeBits / 8 ] >> ( 8 - uiNumRemainingBits );
+        pBitStream->WriteBits ( &ucLast, uiNumRemainingBits );
+    }
+    pBitStream->ResetReadPointer ();
+
+    ProcessPacket ( ucPacketID, *pBitStream );
+    g_pNet->DeallocateNetBitStream ( pBitStream );
+}
+
+
 void CPacketHandler::Packet_SyncSettings ( NetBitStreamInterface& bitStream )
 {
     uchar ucNumWeapons = 0;
@@ -103,6 +103,8 @@ public:
     void                Packet_LatentTransfer           ( NetBitStreamInterface& bitStream );
     void                Packet_SyncSettings             ( NetBitStreamInterface& bitStream );
     void                Packet_PedTask                  ( NetBitStreamInterface& bitStream );
+    void                Packet_Compressed               ( NetBitStreamInterface& bitStream );
+    void                Packet_ElementRPCBatch          ( NetBitStreamInterface& bitStream );
 
     // For debugging protocol errors during ENTITY_ADD packet
     void                EntityAddDebugBegin             ( uint uiNumEntities, NetBitStreamInterface* pBitStream );
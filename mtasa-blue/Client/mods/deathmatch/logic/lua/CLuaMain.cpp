@@ -36,6 +36,7 @@ CLuaMain::CLuaMain ( CLuaManager* pLuaManager, CResource* pResourceOwner, bool b
     // Initialise everything to be setup in the Start function
     m_pLuaManager = pLuaManager;
     m_luaVM = NULL;
+    m_AsyncTaskToken = CAsyncTaskToken::Create ();
     m_bBeingDeleted = false;
     m_pLuaTimerManager = new CLuaTimerManager;
     m_FunctionEnterTimer.SetMaxIncrement ( 500 );
@@ -51,6 +52,9 @@ CLuaMain::CLuaMain ( CLuaManager* pLuaManager, CResource* pResourceOwner, bool b
 
 CLuaMain::~CLuaMain ( void )
 {
+    // Stop async task results from being delivered to this VM
+    m_AsyncTaskToken.Cancel ();
+
     g_pClientGame->GetRemoteCalls()->Remove ( this );
     g_pClientGame->GetLatentTransferManager ()->OnLuaMainDestroy ( this );
     g_pClientGame->GetDebugHookManager()->OnLuaMainDestroy ( this );
@@ -64,6 +64,7 @@ public:
     void                            ResetInstructionCount   ( void );
 
     inline class CResource*         GetResource             ( void )                        { return m_pResource; }
+    const CAsyncTaskToken&          GetAsyncTaskToken       ( void ) const                  { return m_AsyncTaskToken; }
 
     CXMLFile *                      CreateXML               ( const char* szFilename, bool bUseIDs = true, bool bReadOnly = false );
     void                            DestroyXML              ( CXMLFile* pFile );
@@ -90,6 +91,7 @@ private:
 
     lua_State*                      m_luaVM;
     CLuaTimerManager*               m_pLuaTimerManager;
+    CAsyncTaskToken                 m_AsyncTaskToken;       // Cancels async tasks when we are destroyed
 
     bool                            m_bBeingDeleted; // prevent it being deleted twice
 
@@ -178,6 +178,18 @@ bool CModManagerImpl::PendingWorkToDo ( void )
 }
 
 
+void CModManagerImpl::WaitForPendingWork ( uint uiTimeoutMs )
+{
+    if ( m_pBase )
+    {
+        m_pBase->WaitForPendingWork ( uiTimeoutMs );
+        return;
+    }
+
+    Sleep ( uiTimeoutMs );
+}
+
+
 bool CModManagerImpl::GetSleepIntervals( int& iSleepBusyMs, int& iSleepIdleMs, int& iLogicFpsLimit )
 {
     iSleepBusyMs = 20;
@@ -53,6 +53,7 @@ public:
     bool                IsFinished              ( void );
 
     bool                PendingWorkToDo         ( void );
+    void                WaitForPendingWork      ( uint uiTimeoutMs );
     bool                GetSleepIntervals       ( int& iSleepBusyMs, int& iSleepIdleMs, int& iLogicFpsLimit );
     CDynamicLibrary&    GetDynamicLibrary       ( void )                { return m_Library; };
 
@@ -522,22 +522,8 @@ void CServerImpl::HandlePulseSleep( void )
         return;
     }
 
-    CTickCount sleepLimit = CTickCount::Now() + CTickCount( (long long)iSleepIdleMs );
-
-    // Initial sleep period
-    int iInitialMs = std::min( iSleepIdleMs, iSleepBusyMs );
-    Sleep( Clamp ( 1, iInitialMs, 50 ) );
-
-    // Remaining idle sleep period
-    int iFinalMs = Clamp ( 1, iSleepIdleMs - iInitialMs, 50 );
-    for( int i = 0 ; i < iFinalMs ; i++ )
-    {
-        if ( m_pModManager->PendingWorkToDo() )
-            break;
-        Sleep( 1 );
-        if ( CTickCount::Now() >= sleepLimit )
-            break;
-    }
+    // Idle sleep period - Mod will return early when work arrives
+    m_pModManager->WaitForPendingWork( Clamp ( 1, iSleepIdleMs, 100 ) );
 }
 
 
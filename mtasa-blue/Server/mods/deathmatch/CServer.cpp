@@ -23,6 +23,7 @@
 CServerInterface* g_pServerInterface = NULL;
 CNetServer* g_pNetServer = NULL;
 CNetServer* g_pRealNetServer = NULL;
+CWorkSignal g_MainThreadWorkSignal;
 
 CServer::CServer ( void )
 {
@@ -123,6 +124,28 @@ bool CServer::PendingWorkToDo ( void )
     return false;
 }
 
+//
+// Block until another thread queues work for the main thread, or the timeout expires
+//
+void CServer::WaitForPendingWork ( unsigned int uiTimeoutMs )
+{
+    if ( m_pGame && m_pGame->GetConfig () && !m_pGame->GetConfig ()->GetThreadNetEnabled () )
+    {
+        // Net module is pulsed on this thread, so nothing will signal us when packets arrive
+        CTickCount sleepLimit = CTickCount::Now () + CTickCount ( (long long)uiTimeoutMs );
+        while ( !PendingWorkToDo () && CTickCount::Now () < sleepLimit )
+            Sleep ( 1 );
+        return;
+    }
+
+    // HTTP downloads are polled on this thread, so don't wait long while any are running
+    if ( m_pGame && m_pGame->HasPendingDownloads () )
+        uiTimeoutMs = std::min < uint > ( uiTimeoutMs, std::max ( 1, m_pGame->GetConfig ()->GetPendingWorkToDoSleepTime () ) );
+
+    // Sync thread, database threads and async tasks notify when they have results for us
+    g_MainThreadWorkSignal.Wait ( uiTimeoutMs );
+}
+
 bool CServer::GetSleepIntervals ( int& iSleepBusyMs, int& iSleepIdleMs, int& iLogicFpsLimit )
 {
     if ( m_pGame && g_pNetServer )
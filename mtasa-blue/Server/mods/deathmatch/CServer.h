@@ -32,6 +32,7 @@ public:
 
     bool                IsFinished          ( void );
     bool                PendingWorkToDo     ( void );
+    void                WaitForPendingWork  ( unsigned int uiTimeoutMs );
     bool                GetSleepIntervals   ( int& iSleepBusyMs, int& iSleepIdleMs, int& iLogicFpsLimit );
 
 private:
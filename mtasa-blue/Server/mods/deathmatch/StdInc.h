@@ -45,6 +45,7 @@ struct SAclRequest;
 #include "CChecksum.h"
 #include "CIdArray.h"
 #include "pcrecpp.h"
+#include "CRegexCache.h"
 
 // Packet includes
 #include "packets/CCameraSyncPacket.h"
@@ -179,6 +180,7 @@ struct SAclRequest;
 #include "CAclRightName.h"
 #include "CBan.h"
 #include "CBandwidthSettings.h"
+#include "CBitStreamFragment.h"
 #include "CBlendedWeather.h"
 #include "CBlip.h"
 #include "CBlipManager.h"
@@ -203,13 +205,16 @@ struct SAclRequest;
 #include "CConsoleCommand.h"
 #include "CConsoleCommands.h"
 #include "CCustomData.h"
+#include "CDeadlineQueue.h"
 #include "CDummy.h"
 #include "CElement.h"
 #include "CElementDeleter.h"
 #include "CElementGroup.h"
 #include "CElementIDs.h"
 #include "CElementRefManager.h"
+#include "CElementRPCBatch.h"
 #include "CEvents.h"
+#include "CFileChecksumCache.h"
 #include "CGame.h"
 #include "CGroups.h"
 #include "CHTTPD.h"
@@ -217,7 +222,9 @@ struct SAclRequest;
 #include "CHandlingManager.h"
 #include "CKeyBinds.h"
 #include "CLanBroadcast.h"
+#include "CLatencyHistogram.h"
 #include "CLightsyncManager.h"
+#include "CLogWriter.h"
 #include "CLogger.h"
 #include "CMainConfig.h"
 #include "CMapEvent.h"
@@ -228,6 +235,8 @@ struct SAclRequest;
 #include "CObject.h"
 #include "CObjectManager.h"
 #include "CObjectSync.h"
+#include "CPacketCompressor.h"
+#include "CPacketRecorder.h"
 #include "CPacketTranslator.h"
 #include "CPad.h"
 #include "CPed.h"
@@ -238,6 +247,7 @@ struct SAclRequest;
 #include "CPickup.h"
 #include "CPickupManager.h"
 #include "CPlayer.h"
+#include "CPlayerBitSet.h"
 #include "CPlayerCamera.h"
 #include "CPlayerClothes.h"
 #include "CPlayerManager.h"
@@ -265,6 +275,7 @@ struct SAclRequest;
 #include "CScriptDebugging.h"
 #include "CScriptFile.h"
 #include "CSettings.h"
+#include "CSlowFrameRecorder.h"
 #include "CSpatialDatabase.h"
 #include "CTeam.h"
 #include "CTeamManager.h"
@@ -306,3 +317,4 @@ struct SAclRequest;
 
 extern CNetServer* g_pRealNetServer;
 extern CGame* g_pGame;
+extern CWorkSignal g_MainThreadWorkSignal;
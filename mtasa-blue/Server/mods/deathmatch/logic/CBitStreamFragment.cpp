@@ -0,0 +1,70 @@
+/*****************************************************************************
+*
+*  PROJECT:     Multi Theft Auto v1.0
+*  LICENSE:     See LICENSE in the top level directory
+*  FILE:        mods/deathmatch/logic/CBitStreamFragment.cpp
+*  PURPOSE:     Copy of some encoded bits which can be written into other packets
+*
+*  Multi Theft Auto is available from http://www.multitheftauto.com/
+*
+*****************************************************************************/
+
+#include "StdInc.h"
+
+
+///////////////////////////////////////////////////////////////
+//
+// CBitStreamFragment::Capture
+//
+// Copy the bits from uiStartBit to the end of BitStream.
+// The start does not have to be on a byte boundary.
+//
+///////////////////////////////////////////////////////////////
+void CBitStreamFragment::Capture ( uint uiContext, const NetBitStreamInterface& BitStream, uint uiStartBit )
+{
+    const uchar* pSrc = BitStream.GetData ();
+    uint uiEndBit = BitStream.GetNumberOfBitsUsed ();
+    uint uiNumBits = uiEndBit > uiStartBit ? uiEndBit - uiStartBit : 0;
+    uint uiNumBytes = ( uiNumBits + 7 ) / 8;
+    uint uiSrcByte = uiStartBit / 8;
+    uint uiShift = uiStartBit & 7;
+    uint uiSrcBytesUsed = ( uiEndBit + 7 ) / 8;
+
+    // Bitstream data has the first bit at the high end of each byte, so shift everything up to align the start
+    m_Data.resize ( uiNumBytes );
+    for ( uint i = 0 ; i < uiNumBytes ; i++ )
+    {
+        uchar ucByte = pSrc[ uiSrcByte + i ] << uiShift;
+        if ( uiShift && uiSrcByte + i + 1 < uiSrcBytesUsed )
+            ucByte |= pSrc[ uiSrcByte + i + 1 ] >> ( 8 - uiShift );
+        m_Data[ i ] = ucByte;
+    }
+
+    m_uiContext = uiContext;
+    m_usBitStreamVersion = BitStream.Version ();
+    m_uiNumBits = uiNumBits;
+}
+
+
+///////////////////////////////////////////////////////////////
+//
+// CBitStreamFragment::Write
+//
+// Append the stored bits to BitStream
+//
+///////////////////////////////////////////////////////////////
+void CBitStreamFragment::Write ( NetBitStreamInterface& BitStream ) const
+{
+    // Whole bytes
+    uint uiNumWholeBits = m_uiNumBits & ~7;
+    if ( uiNumWholeBits )
+        BitStream.WriteBits ( &m_Data[0], uiNumWholeBits );
+
+    // WriteBits takes the last bits from the low end of the byte, but the bitstream data has them at the high end
+    uint uiNumRemainingBits = m_uiNumBits & 7;
+    if ( uiNumRemainingBits )
+    {
+        uchar ucLast = m_Data[ uiNumWholeBits / 8 ] >> ( 8 - uiNumRemainingBits );
+        BitStream.WriteBits ( &ucLast, uiNumRemainingBits );
+    }
+}
@@ -0,0 +1,33 @@
+/*****************************************************************************
+*
+*  PROJECT:     Multi Theft Auto v1.0
+*  LICENSE:     See LICENSE in the top level directory
+*  FILE:        mods/deathmatch/logic/CBitStreamFragment.h
+*  PURPOSE:     Copy of some encoded bits which can be written into other packets
+*
+*  Multi Theft Auto is available from http://www.multitheftauto.com/
+*
+*****************************************************************************/
+#pragma once
+
+//
+// Encoded data depends on the bitstream version, so a fragment is only valid for the version it was made with.
+// uiContext is set by the owner to say which state was encoded. Zero means nothing is stored.
+//
+class CBitStreamFragment
+{
+public:
+                            CBitStreamFragment      ( void ) : m_uiContext ( 0 ), m_usBitStreamVersion ( 0 ), m_uiNumBits ( 0 ) {}
+
+    bool                    IsValid                 ( uint uiContext, ushort usBitStreamVersion ) const     { return m_uiContext && m_uiContext == uiContext && m_usBitStreamVersion == usBitStreamVersion; }
+    void                    Invalidate              ( void )                                                { m_uiContext = 0; }
+
+    void                    Capture                 ( uint uiContext, const NetBitStreamInterface& BitStream, uint uiStartBit );
+    void                    Write                   ( NetBitStreamInterface& BitStream ) const;
+
+protected:
+    uint                    m_uiContext;
+    ushort                  m_usBitStreamVersion;
+    uint                    m_uiNumBits;
+    std::vector < uchar >   m_Data;
+};
@@ -15,6 +15,7 @@
 *****************************************************************************/
 
 #include "StdInc.h"
+#include "net/SimHeaders.h"
 
 extern CGame* g_pGame;
 
@@ -1920,3 +1921,181 @@ bool CConsoleCommands::DebugUpTime ( CConsole* pConsole, const char* szArguments
     pEchoClient->SendConsole ( SString( "TickCount advanced by %d days", iDaysAdd ) );
     return true;
 }
+
+
+bool CConsoleCommands::DebugEventBench ( CConsole* pConsole, const char* szArguments, CClient* pClient, CClient* pEchoClient )
+{
+    if ( pClient->GetClientType () != CClient::CLIENT_CONSOLE )
+    {
+        if ( !g_pGame->GetACLManager()->CanObjectUseRight ( pClient->GetAccount ()->GetName ().c_str (), CAccessControlListGroupObject::OBJECT_TYPE_USER, "debugeventbench", CAccessControlListRight::RIGHT_TYPE_COMMAND, false ) )
+        {
+            pEchoClient->SendConsole ( "debugeventbench: You do not have sufficient rights to use this command." );
+            return false;
+        }
+    }
+
+    int iCount = 100000;
+    if ( szArguments && szArguments[0] )
+        iCount = Clamp ( 1, atoi ( szArguments ), 10000000 );
+
+    // Use a player as the source if there is one, as that is typical for frequent events
+    CPlayerManager* pPlayerManager = g_pGame->GetPlayerManager ();
+    CElement* pSource = pPlayerManager->Count () ? (CElement*)*pPlayerManager->IterBegin () : (CElement*)g_pGame->GetMapManager ()->GetRootElement ();
+
+    // Scripts can add handlers for 'onDebugEventBench' to measure handler overhead
+    CLuaArguments Arguments;
+    Arguments.PushNumber ( 1 );
+    long long llHandlerCallsBefore = g_pStats->events.llHandlerCalls;
+    TIMEUS startTime = GetTimeUs ();
+
+    for ( int i = 0 ; i < iCount ; i++ )
+        pSource->CallEvent ( "onDebugEventBench", Arguments );
+
+    TIMEUS timeUs = std::max < TIMEUS > ( 1, GetTimeUs () - startTime );
+    long long llHandlerCalls = g_pStats->events.llHandlerCalls - llHandlerCallsBefore;
+    pEchoClient->SendConsole ( SString ( "debugeventbench: %d events on %s in %.1f ms, %.0f events/sec, %.0f handler calls/sec"
+                                            , iCount
+                                            , pSource->GetTypeName ().c_str ()
+                                            , timeUs / 1000.0
+                                            , iCount * 1000000.0 / timeUs
+                                            , llHandlerCalls * 1000000.0 / timeUs ) );
+    return true;
+}
+
+
+bool CConsoleCommands::DebugQueueBench ( CConsole* pConsole, const char* szArguments, CClient* pClient, CClient* pEchoClient )
+{
+    if ( pClient->GetClientType () != CClient::CLIENT_CONSOLE )
+    {
+        if ( !g_pGame->GetACLManager()->CanObjectUseRight ( pClient->GetAccount ()->GetName ().c_str (), CAccessControlListGroupObject::OBJECT_TYPE_USER, "debugqueuebench", CAccessControlListRight::RIGHT_TYPE_COMMAND, false ) )
+        {
+            pEchoClient->SendConsole ( "debugqueuebench: You do not have sufficient rights to use this command." );
+            return false;
+        }
+    }
+
+    int iCount = 1000000;
+    if ( szArguments && szArguments[0] )
+        iCount = Clamp ( 1, atoi ( szArguments ), 100000000 );
+
+    // Stress and time the queue used between the main and sync threads
+    pEchoClient->SendConsole ( SString ( "debugqueuebench: %s", *CSimControl::BenchQueue ( iCount ) ) );
+    return true;
+}
+
+
+bool CConsoleCommands::CapturePackets ( CConsole* pConsole, const char* szArguments, CClient* pClient, CClient* pEchoClient )
+{
+    // Captures include passwords and other private data, so only allow from the server console
+    if ( pClient->GetClientType () != CClient::CLIENT_CONSOLE )
+    {
+        pEchoClient->SendConsole ( "capturepackets: This command can only be used from the server console" );
+        return false;
+    }
+
+    CPacketRecorder* pPacketRecorder = g_pGame->GetPacketRecorder ();
+    SString strArguments = szArguments ? szArguments : "";
+
+    if ( strArguments.empty () )
+    {
+        pEchoClient->SendConsole ( "capturepackets <filename>|stop - Captured files are saved in logs/packets" );
+        pEchoClient->SendConsole ( pPacketRecorder->GetStatus () );
+        return false;
+    }
+
+    if ( strArguments == "stop" )
+    {
+        pPacketRecorder->StopCapture ();
+        pEchoClient->SendConsole ( pPacketRecorder->GetStatus () );
+        return true;
+    }
+
+    SString strPathFilename = g_pServerInterface->GetModManager ()->GetAbsolutePath ( PathJoin ( "logs", "packets", ExtractFilename ( strArguments ) ) );
+    if ( !pPacketRecorder->StartCapture ( strPathFilename ) )
+    {
+        pEchoClient->SendConsole ( SString ( "capturepackets: Could not create %s", *strPathFilename ) );
+        return false;
+    }
+
+    pEchoClient->SendConsole ( pPacketRecorder->GetStatus () );
+    return true;
+}
+
+
+bool CConsoleCommands::ReplayPackets ( CConsole* pConsole, const char* szArguments, CClient* pClient, CClient* pEchoClient )
+{
+    // Replayed packets will act as the captured players, so only allow from the server console
+    if ( pClient->GetClientType () != CClient::CLIENT_CONSOLE )
+    {
+        pEchoClient->SendConsole ( "replaypackets: This command can only be used from the server console" );
+        return false;
+    }
+
+    CPacketRecorder* pPacketRecorder = g_pGame->GetPacketRecorder ();
+    std::vector < SString > parts;
+    SStringX ( szArguments ? szArguments : "" ).Split ( " ", parts );
+
+    if ( parts.empty () || parts[0].empty () )
+    {
+        pEchoClient->SendConsole ( "replaypackets <filename> [speed]|stop - Speed 0 replays as fast as possible, default is 1" );
+        pEchoClient->SendConsole ( pPacketRecorder->GetStatus () );
+        return false;
+    }
+
+    if ( parts[0] == "stop" )
+    {
+        pPacketRecorder->StopReplay ();
+        pEchoClient->SendConsole ( pPacketRecorder->GetStatus () );
+        return true;
+    }
+
+    float fSpeed = parts.size () > 1 ? static_cast < float > ( atof ( parts[1] ) ) : 1.f;
+    SString strPathFilename = g_pServerInterface->GetModManager ()->GetAbsolutePath ( PathJoin ( "logs", "packets", ExtractFilename ( parts[0] ) ) );
+    if ( !pPacketRecorder->StartReplay ( strPathFilename, fSpeed ) )
+    {
+        pEchoClient->SendConsole ( SString ( "replaypackets: Could not read %s", *strPathFilename ) );
+        return false;
+    }
+
+    pEchoClient->SendConsole ( pPacketRecorder->GetStatus () );
+    return true;
+}
+
+
+bool CConsoleCommands::SimClients ( CConsole* pConsole, const char* szArguments, CClient* pClient, CClient* pEchoClient )
+{
+    // Simulated clients are for load testing, so only allow from the server console
+    if ( pClient->GetClientType () != CClient::CLIENT_CONSOLE )
+    {
+        pEchoClient->SendConsole ( "simclients: This command can only be used from the server console" );
+        return false;
+    }
+
+    CSimClientNetServer* pSimClientNetServer = g_pGame->GetSimClientNetServer ();
+    if ( !pSimClientNetServer )
+    {
+        pEchoClient->SendConsole ( "simclients is not enabled. Set <sim_clients> in mtaserver.conf and restart the server" );
+        return false;
+    }
+
+    std::vector < SString > parts;
+    SStringX ( szArguments ? szArguments : "" ).Split ( " ", parts );
+
+    if ( !parts.empty () && !parts[0].empty () )
+    {
+        uint uiCount = atoi ( parts[0] );
+        pSimClientNetServer->SetClientCount ( uiCount );
+        pEchoClient->SendConsole ( SString ( "simclients: Changing to %u simulated clients", uiCount ) );
+    }
+
+    if ( parts.size () > 1 )
+    {
+        // Percentage of clients which report packet loss and a full send queue
+        uint uiPercent = Clamp ( 0, atoi ( parts[1] ), 100 );
+        pSimClientNetServer->SetCongestedPercent ( uiPercent );
+        pEchoClient->SendConsole ( SString ( "simclients: %u%% of simulated clients are congested", uiPercent ) );
+    }
+
+    pEchoClient->SendConsole ( pSimClientNetServer->GetStatus () );
+    return true;
+}
@@ -16,10 +16,101 @@
 
 typedef CFastList < CDbJobData* > CJobQueueType;
 
+#define DB_QUEUE_MAX_POOL_SIZE      16
+#define DB_QUEUE_OPEN_RETRY_MS      10000   // Wait after failing to open an extra pool connection
+
+namespace
+{
+    //
+    // Connections used by one connection handle
+    //
+    struct SConnectionPool
+    {
+        CDatabaseType*                          pTypeManager;
+        SString                                 strHost;
+        SString                                 strUsername;
+        SString                                 strPassword;
+        SString                                 strOptions;
+        uint                                    uiPoolSize;         // Max number of connections
+        CTickCount                              nextOpenTime;       // No extra connections are opened before this
+        bool                                    bOrdered;           // false if read queries can run alongside each other
+        std::vector < CDatabaseConnection* >    connectionList;     // First one is made by CONNECT, the rest when needed. NULL while connecting
+    };
+
+    //
+    // A job which has not started yet
+    //
+    struct SWaitingJob
+    {
+        CDbJobData*             pJobData;
+        bool                    bReadOnly;      // From IsReadOnlyQuery, worked out when the job is added
+    };
+
+    //
+    // Jobs for one connection handle
+    //
+    struct SHandleQueue
+    {
+        std::deque < SWaitingJob >  waitingList;        // In the order they were added
+        uint                        uiNumRunning;
+        bool                        bBarrierRunning;    // Running job has to finish before anything else can start
+    };
+
+    //
+    // What a worker thread is using for the current job
+    //
+    struct SJobSlot
+    {
+        SHandleQueue*           pQueue;
+        SConnectionPool*        pPool;
+        CDatabaseConnection*    pConnection;
+        bool                    bReadOnly;
+        bool                    bBarrier;
+        bool                    bOpenNew;       // Connection has to be added to the pool before use
+        bool                    bRequeue;       // Job did not run and should wait for another connection
+    };
+
+    //
+    // Returns true if the query only reads data and does not depend on session state,
+    // so it can run on any connection in the pool
+    //
+    bool IsReadOnlyQuery ( const SString& strQuery )
+    {
+        size_t uiStart = strQuery.find_first_not_of ( " \t\r\n(" );
+        if ( uiStart == std::string::npos )
+            return false;
+
+        size_t uiEnd = uiStart;
+        while ( uiEnd < strQuery.length () && isalpha ( (uchar)strQuery[ uiEnd ] ) )
+            uiEnd++;
+        SString strKeyword = strQuery.SubStr ( uiStart, uiEnd - uiStart ).ToUpper ();
+        if ( strKeyword != "SELECT" && strKeyword != "SHOW" && strKeyword != "DESCRIBE" && strKeyword != "DESC" && strKeyword != "EXPLAIN" )
+            return false;
+
+        // Multiple statements
+        size_t uiSemicolon = strQuery.find ( ';' );
+        if ( uiSemicolon != std::string::npos && strQuery.find_first_not_of ( " \t\r\n;", uiSemicolon ) != std::string::npos )
+            return false;
+
+        // Writes, locks and anything which relies on earlier queries on the same connection
+        static const char* const excludeList[] = { "INTO", "LOCK", "FOR UPDATE", "LAST_INSERT_ID", "FOUND_ROWS", "ROW_COUNT", "@" };
+        for ( uint i = 0 ; i < NUMELMS ( excludeList ) ; i++ )
+            if ( strQuery.ContainsI ( excludeList[i] ) )
+                return false;
+
+        return true;
+    }
+}
+
+
 ///////////////////////////////////////////////////////////////
 //
 // CDatabaseJobQueueImpl
 //
+// Jobs are run by one or more worker threads.
+// Each connection handle runs one job at a time in order, unless the connection was
+// made with 'ordered=0', in which case read queries can run at the same time
+// as each other using extra connections from the pool.
 //
 ///////////////////////////////////////////////////////////////
 class CDatabaseJobQueueImpl : public CDatabaseJobQueue
@@ -37,9 +128,11 @@ public:
     virtual CDbJobData*         FindCommandFromId           ( SDbJobId id );
     virtual void                IgnoreConnectionResults     ( SConnectionHandle connectionHandle );
     virtual bool                UsesConnection              ( SConnectionHandle connectionHandle );
+    virtual void                GetQueueStats               ( SDbQueueStats& outStats );
 
 protected:
-    void                        StopThread                  ( void );
+    void                        StartThreads                ( uint uiNumThreads );
+    void                        StopThreads                 ( void );
     CDbJobData*                 GetNewJobData               ( void );
     void                        UpdateDebugData             ( void );
     void                        IgnoreJobResults            ( CDbJobData* pJobData );
@@ -47,41 +140,52 @@ protected:
     // Other thread functions
     static void*                StaticThreadProc            ( void* pContext );
     void*                       ThreadProc                  ( void );
-    void                        ProcessCommand              ( CDbJobData* pJobData );
+    CDbJobData*                 TakeRunnableCommand         ( SJobSlot& outSlot );
+    bool                        CanStartJob                 ( SConnectionHandle connectionHandle, SHandleQueue& handleQueue, SJobSlot& outSlot );
+    void                        ReleaseJobSlot              ( SJobSlot& slot );
+    void                        ProcessCommand              ( CDbJobData* pJobData, SJobSlot& slot );
     void                        ProcessConnect              ( CDbJobData* pJobData );
-    void                        ProcessDisconnect           ( CDbJobData* pJobData );
-    void                        ProcessQuery                ( CDbJobData* pJobData );
-    void                        ProcessFlush                ( CDbJobData* pJobData );
+    void                        ProcessDisconnect           ( CDbJobData* pJobData, SJobSlot& slot );
+    void                        ProcessQuery                ( CDbJobData* pJobData, SJobSlot& slot );
+    void                        ProcessFlush                ( CDbJobData* pJobData, SJobSlot& slot );
     void                        ProcessSetLogLevel          ( CDbJobData* pJobData );
-    CDatabaseConnection*        GetConnectionFromHandle     ( SConnectionHandle connectionHandle );
-    void                        RemoveHandleForConnection   ( SConnectionHandle connectionHandle, CDatabaseConnection* pConnection );
-    void                        LogResult                   ( CDbJobData* pJobData );
+    CDatabaseConnection*        OpenConnection              ( CDatabaseType* pTypeManager, const SString& strHost, const SString& strUsername, const SString& strPassword, const SString& strOptions, SString& strOutError );
+    void                        ReleaseConnection           ( CDatabaseConnection* pConnection );
+    SConnectionPool*            GetConnectionPoolFromHandle ( SConnectionHandle connectionHandle );
+    void                        LogResult                   ( CDbJobData* pJobData, CDatabaseConnection* pConnection );
     void                        LogString                   ( const SString& strText );
 
     // Main thread variables
-    CThreadHandle*                      m_pServiceThreadHandle;
+    std::vector < CThreadHandle* >      m_ServiceThreadHandleList;
     std::map < SDbJobId, CDbJobData* >  m_ActiveJobHandles;
     std::set < CDbJobData* >            m_FinishedList;         // Result has been used, will be deleted next pulse
     uint                                m_uiJobCountWarnThresh;
     uint                                m_uiJobCount10sMin;
     CElapsedTime                        m_JobCountElpasedTime;
     std::set < SConnectionHandle >      m_PendingFlushMap;
+    uint                                m_uiConnectionCountWarnThresh;
 
     // Other thread variables
     std::map < SString, CDatabaseType* >                    m_DatabaseTypeMap;
-    uint                                                    m_uiConnectionCountWarnThresh;
+    CCriticalSection                                        m_DatabaseTypeCS;       // Type managers are not thread safe
     EJobLogLevelType                                        m_LogLevel;
     SString                                                 m_strLogFilename;
+    CCriticalSection                                        m_LogCS;
 
     // Shared variables
     struct
     {
-        bool                                        m_bTerminateThread;
-        bool                                        m_bThreadTerminated;
+        bool                                        m_bTerminateThreads;
+        uint                                        m_uiNumThreadsRunning;
         CJobQueueType                               m_CommandQueue;
+        uint                                        m_uiNumProcessing;      // Jobs in m_CommandQueue which have been started
         CJobQueueType                               m_ResultQueue;
         CComboMutex                                 m_Mutex;
-        std::map < SConnectionHandle, CDatabaseConnection* >    m_HandleConnectionMap;
+        std::map < SConnectionHandle, SConnectionPool* >    m_HandleConnectionMap;
+        std::map < SConnectionHandle, SHandleQueue >        m_HandleQueueMap;       // Handles with jobs waiting or running
+        std::set < CDatabaseConnection* >           m_BusyConnectionSet;
+        CLatencyHistogram                           m_WaitTimeHistogram[2];  // Current and previous 10 second period
+        CLatencyHistogram                           m_ExecTimeHistogram[2];
     } shared;
 };
 
@@ -99,7 +203,7 @@ CDatabaseJobQueue* NewDatabaseJobQueue ( void )
 //
 // CDatabaseJobQueueImpl::CDatabaseJobQueueImpl
 //
-// Init known database types and start the job service thread
+// Init known database types and start the first job service thread
 //
 ///////////////////////////////////////////////////////////////
 CDatabaseJobQueueImpl::CDatabaseJobQueueImpl ( void )
@@ -114,8 +218,8 @@ CDatabaseJobQueueImpl::CDatabaseJobQueueImpl ( void )
     CDatabaseType* pDatabaseTypeMySql = NewDatabaseTypeMySql ();
     MapSet ( m_DatabaseTypeMap, pDatabaseTypeMySql->GetDataSourceTag (), pDatabaseTypeMySql );
 
-    // Start the job queue processing thread
-    m_pServiceThreadHandle = new CThreadHandle ( CDatabaseJobQueueImpl::StaticThreadProc, this );
+    // Start the job queue processing thread. More are added if a connection asks for a pool
+    StartThreads ( 1 );
 }
 
 
@@ -128,11 +232,12 @@ CDatabaseJobQueueImpl::CDatabaseJobQueueImpl ( void )
 ///////////////////////////////////////////////////////////////
 CDatabaseJobQueueImpl::~CDatabaseJobQueueImpl ( void )
 {
-    // Stop the job queue processing thread
-    StopThread ();
+    // Stop the job queue processing threads
+    StopThreads ();
 
-    // Delete thread
-    SAFE_DELETE ( m_pServiceThreadHandle );
+    // Delete threads
+    for ( uint i = 0 ; i < m_ServiceThreadHandleList.size () ; i++ )
+        SAFE_DELETE ( m_ServiceThreadHandleList[i] );
 
     // Delete database types
     for ( std::map < SString, CDatabaseType* >::iterator iter = m_DatabaseTypeMap.begin () ; iter != m_DatabaseTypeMap.end () ; ++iter )
@@ -142,29 +247,49 @@ CDatabaseJobQueueImpl::~CDatabaseJobQueueImpl ( void )
 
 ///////////////////////////////////////////////////////////////
 //
-// CDatabaseJobQueueImpl::StopThread
+// CDatabaseJobQueueImpl::StartThreads
+//
+// Make sure there are at least uiNumThreads job queue processing threads
+//
+///////////////////////////////////////////////////////////////
+void CDatabaseJobQueueImpl::StartThreads ( uint uiNumThreads )
+{
+    while ( m_ServiceThreadHandleList.size () < uiNumThreads )
+    {
+        shared.m_Mutex.Lock ();
+        shared.m_uiNumThreadsRunning++;
+        shared.m_Mutex.Unlock ();
+        m_ServiceThreadHandleList.push_back ( new CThreadHandle ( CDatabaseJobQueueImpl::StaticThreadProc, this ) );
+    }
+}
+
+
+///////////////////////////////////////////////////////////////
+//
+// CDatabaseJobQueueImpl::StopThreads
 //
-// Stop the job queue processing thread
+// Stop the job queue processing threads
 //
 ///////////////////////////////////////////////////////////////
-void CDatabaseJobQueueImpl::StopThread ( void )
+void CDatabaseJobQueueImpl::StopThreads ( void )
 {
-    // Stop the job queue processing thread
+    // Stop the job queue processing threads
     shared.m_Mutex.Lock ();
-    shared.m_bTerminateThread = true;
-    shared.m_Mutex.Signal ();
+    shared.m_bTerminateThreads = true;
+    shared.m_Mutex.Broadcast ();
     shared.m_Mutex.Unlock ();
 
     for ( uint i = 0 ; i < 5000 ; i += 15 )
     {
-        if ( shared.m_bThreadTerminated )
+        if ( shared.m_uiNumThreadsRunning == 0 )
             return;
 
         Sleep ( 15 );
     }
 
-    // If thread not stopped, (async) cancel it
-    m_pServiceThreadHandle->Cancel ();
+    // If threads not stopped, (async) cancel them
+    for ( uint i = 0 ; i < m_ServiceThreadHandleList.size () ; i++ )
+        m_ServiceThreadHandleList[i]->Cancel ();
 }
 
 
@@ -199,18 +324,34 @@ CDbJobData* CDatabaseJobQueueImpl::AddCommand ( EJobCommandType jobType, SConnec
     if ( jobType == EJobCommand::QUERY )
         MapInsert ( m_PendingFlushMap, connectionHandle );
 
+    // Add worker threads if the new connection wants a pool
+    if ( jobType == EJobCommand::CONNECT )
+    {
+        std::vector < SString > parts;
+        strData.Split ( "\1", parts );
+        uint uiPoolSize = 1;
+        if ( parts.size () >= 5 && parts[0] != "sqlite" )
+            GetOption < CDbOptionsMap > ( parts[4], "pool", uiPoolSize, 1 );
+        StartThreads ( Clamp < uint > ( 1, uiPoolSize, DB_QUEUE_MAX_POOL_SIZE ) );
+    }
+
     // Create command
     CDbJobData* pJobData = GetNewJobData ();
     pJobData->command.type = jobType;
     pJobData->command.connectionHandle = connectionHandle;
     pJobData->command.strData = strData;
     pJobData->command.pJobQueue = this;
+    pJobData->command.timeQueued = GetTimeUs ();
+
+    // Check the query text here, so the worker threads do not have to while holding the lock
+    SWaitingJob waitingJob = { pJobData, jobType == EJobCommand::QUERY && IsReadOnlyQuery ( strData ) };
 
     // Add to queue
     shared.m_Mutex.Lock ();
     pJobData->stage = EJobStage::COMMAND_QUEUE;
     shared.m_CommandQueue.push_back ( pJobData );
-    shared.m_Mutex.Signal ();
+    MapGet ( shared.m_HandleQueueMap, connectionHandle ).waitingList.push_back ( waitingJob );
+    shared.m_Mutex.Broadcast ();
     shared.m_Mutex.Unlock ();
 
     return pJobData;
@@ -320,6 +461,12 @@ void CDatabaseJobQueueImpl::UpdateDebugData ( void )
     m_JobCountElpasedTime.Reset ();
     m_uiJobCount10sMin = m_ActiveJobHandles.size ();
 
+    // Start new timing period
+    shared.m_WaitTimeHistogram[1] = shared.m_WaitTimeHistogram[0];
+    shared.m_WaitTimeHistogram[0].Clear ();
+    shared.m_ExecTimeHistogram[1] = shared.m_ExecTimeHistogram[0];
+    shared.m_ExecTimeHistogram[0].Clear ();
+
     CTickCount timeNow = CTickCount::Now ( true );
 
     // Log old uncollected queries
@@ -525,7 +672,41 @@ void CDatabaseJobQueueImpl::IgnoreJobResults ( CDbJobData* pJobData )
 ///////////////////////////////////////////////////////////////
 bool CDatabaseJobQueueImpl::UsesConnection( SConnectionHandle connectionHandle )
 {
-    return GetConnectionFromHandle( connectionHandle ) != nullptr;
+    return GetConnectionPoolFromHandle( connectionHandle ) != nullptr;
+}
+
+
+///////////////////////////////////////////////////////////////
+//
+// CDatabaseJobQueueImpl::GetQueueStats
+//
+// Get current state of the queue
+//
+///////////////////////////////////////////////////////////////
+void CDatabaseJobQueueImpl::GetQueueStats ( SDbQueueStats& outStats )
+{
+    shared.m_Mutex.Lock ();
+
+    CLatencyHistogram waitTime = shared.m_WaitTimeHistogram[0];
+    waitTime.Merge ( shared.m_WaitTimeHistogram[1] );
+    CLatencyHistogram execTime = shared.m_ExecTimeHistogram[0];
+    execTime.Merge ( shared.m_ExecTimeHistogram[1] );
+
+    uint uiNumConnections = 0;
+    for ( std::map < SConnectionHandle, SConnectionPool* >::const_iterator iter = shared.m_HandleConnectionMap.begin () ; iter != shared.m_HandleConnectionMap.end () ; ++iter )
+        uiNumConnections += iter->second->connectionList.size ();
+
+    outStats.uiNumWorkers = m_ServiceThreadHandleList.size ();
+    outStats.uiNumHandles = shared.m_HandleConnectionMap.size ();
+    outStats.uiNumConnections = uiNumConnections;
+    outStats.uiNumWaiting = shared.m_CommandQueue.size () - shared.m_uiNumProcessing;
+    outStats.uiNumProcessing = shared.m_uiNumProcessing;
+    outStats.uiNumResults = shared.m_ResultQueue.size ();
+    outStats.uiNumQueries = execTime.GetCount ();
+    outStats.strWaitTime = waitTime.GetSummaryString ();
+    outStats.strExecTime = execTime.GetSummaryString ();
+
+    shared.m_Mutex.Unlock ();
 }
 
 
@@ -563,46 +744,215 @@ void* CDatabaseJobQueueImpl::StaticThreadProc ( void* pContext )
 void* CDatabaseJobQueueImpl::ThreadProc ( void )
 {
     shared.m_Mutex.Lock ();
-    while ( !shared.m_bTerminateThread )
+    while ( !shared.m_bTerminateThreads )
     {
-        // Is there a waiting command?
-        if ( shared.m_CommandQueue.empty () )
+        // Is there a command we can run?
+        SJobSlot slot = {};
+        CDbJobData* pJobData = TakeRunnableCommand ( slot );
+        if ( !pJobData )
         {
             shared.m_Mutex.Wait ( 100 );
         }
         else
         {
-            // Get next command
-            CDbJobData* pJobData = shared.m_CommandQueue.front ();
-            pJobData->stage = EJobStage::PROCCESSING;
+            TIMEUS timeStarted = GetTimeUs ();
             shared.m_Mutex.Unlock ();
 
             // Process command
-            ProcessCommand ( pJobData );
+            ProcessCommand ( pJobData, slot );
+
+            TIMEUS timeFinished = GetTimeUs ();
 
             // Store result
             shared.m_Mutex.Lock ();
+            ReleaseJobSlot ( slot );
+            shared.m_uiNumProcessing--;
+
+            if ( slot.bRequeue )
+            {
+                // Job was first in the waiting list when it was taken, so put it back there
+                SWaitingJob waitingJob = { pJobData, slot.bReadOnly };
+                slot.pQueue->waitingList.push_front ( waitingJob );
+                pJobData->stage = EJobStage::COMMAND_QUEUE;
+                shared.m_Mutex.Broadcast ();
+                continue;
+            }
+
+            if ( slot.pQueue->waitingList.empty () && slot.pQueue->uiNumRunning == 0 )
+                MapRemove ( shared.m_HandleQueueMap, pJobData->command.connectionHandle );
+
+            if ( pJobData->command.type == EJobCommand::QUERY )
+            {
+                shared.m_WaitTimeHistogram[0].AddSample ( timeStarted - pJobData->command.timeQueued );
+                shared.m_ExecTimeHistogram[0].AddSample ( timeFinished - timeStarted );
+            }
+
             // Check command has not been cancelled (this should not be possible)
-            if ( !shared.m_CommandQueue.empty () && pJobData == shared.m_CommandQueue.front () )
+            if ( ListContains ( shared.m_CommandQueue, pJobData ) )
             {
                 // Remove command
-                shared.m_CommandQueue.pop_front ();
+                ListRemove ( shared.m_CommandQueue, pJobData );
                 // Add result
                 pJobData->stage = EJobStage::RESULT;
                 pJobData->result.timeReady = CTickCount::Now ( true );
                 shared.m_ResultQueue.push_back ( pJobData );
+                g_MainThreadWorkSignal.Notify ();
             }
-            shared.m_Mutex.Signal ();
+
+            // Wake main thread and any workers waiting for this job to finish
+            shared.m_Mutex.Broadcast ();
         }
     }
 
-    shared.m_bThreadTerminated = true;
+    shared.m_uiNumThreadsRunning--;
     shared.m_Mutex.Unlock ();
 
     return NULL;
 }
 
 
+///////////////////////////////////////////////////////////////
+//
+// CDatabaseJobQueueImpl::TakeRunnableCommand
+//
+// Find the oldest job which can run now and reserve a connection for it.
+// * Assumes shared.m_Mutex is locked *
+//
+// Only the first waiting job of each handle is checked, as any job
+// behind it would have to wait for the same thing.
+//
+///////////////////////////////////////////////////////////////
+CDbJobData* CDatabaseJobQueueImpl::TakeRunnableCommand ( SJobSlot& outSlot )
+{
+    // Quick check if everything is already being processed
+    if ( shared.m_CommandQueue.size () == shared.m_uiNumProcessing )
+        return NULL;
+
+    CDbJobData* pBestJobData = NULL;
+    for ( std::map < SConnectionHandle, SHandleQueue >::iterator iter = shared.m_HandleQueueMap.begin () ; iter != shared.m_HandleQueueMap.end () ; ++iter )
+    {
+        SHandleQueue& handleQueue = iter->second;
+        if ( handleQueue.waitingList.empty () )
+            continue;
+
+        CDbJobData* pJobData = handleQueue.waitingList.front ().pJobData;
+        if ( pBestJobData && pBestJobData->command.timeQueued <= pJobData->command.timeQueued )
+            continue;
+
+        SJobSlot slot = {};
+        if ( CanStartJob ( iter->first, handleQueue, slot ) )
+        {
+            pBestJobData = pJobData;
+            outSlot = slot;
+        }
+    }
+
+    if ( !pBestJobData )
+        return NULL;
+
+    // Reserve the connection
+    if ( outSlot.bOpenNew )
+        outSlot.pPool->connectionList.push_back ( NULL );
+    else
+    if ( outSlot.pConnection )
+        MapInsert ( shared.m_BusyConnectionSet, outSlot.pConnection );
+
+    outSlot.pQueue->waitingList.pop_front ();
+    outSlot.pQueue->uiNumRunning++;
+    outSlot.pQueue->bBarrierRunning = outSlot.bBarrier;
+    pBestJobData->stage = EJobStage::PROCCESSING;
+    shared.m_uiNumProcessing++;
+    return pBestJobData;
+}
+
+
+///////////////////////////////////////////////////////////////
+//
+// CDatabaseJobQueueImpl::CanStartJob
+//
+// Check if the first waiting job for a handle can run, and which connection it would use.
+// * Assumes shared.m_Mutex is locked *
+//
+// A job has to wait for any earlier job with the same connection handle,
+// except for read queries on unordered connections, which only wait for earlier writes.
+//
+///////////////////////////////////////////////////////////////
+bool CDatabaseJobQueueImpl::CanStartJob ( SConnectionHandle connectionHandle, SHandleQueue& handleQueue, SJobSlot& outSlot )
+{
+    const SWaitingJob& waitingJob = handleQueue.waitingList.front ();
+    SConnectionPool* pPool = MapFindRef ( shared.m_HandleConnectionMap, connectionHandle );
+
+    outSlot.pQueue = &handleQueue;
+    outSlot.pPool = pPool;
+    outSlot.bReadOnly = waitingJob.bReadOnly;
+    outSlot.bBarrier = !pPool || pPool->bOrdered || !waitingJob.bReadOnly;
+
+    if ( outSlot.bBarrier )
+    {
+        if ( handleQueue.uiNumRunning )
+            return false;
+
+        // Always use the first connection for ordered jobs
+        if ( pPool )
+            outSlot.pConnection = pPool->connectionList[0];
+        return !outSlot.pConnection || !MapContains ( shared.m_BusyConnectionSet, outSlot.pConnection );
+    }
+
+    if ( handleQueue.bBarrierRunning )
+        return false;
+
+    // Use any free connection, or make a new one if the pool is not full
+    for ( uint i = 0 ; i < pPool->connectionList.size () ; i++ )
+    {
+        CDatabaseConnection* pConnection = pPool->connectionList[i];
+        if ( pConnection && !MapContains ( shared.m_BusyConnectionSet, pConnection ) )
+        {
+            outSlot.pConnection = pConnection;
+            return true;
+        }
+    }
+    if ( pPool->connectionList.size () < pPool->uiPoolSize && CTickCount::Now ( true ) >= pPool->nextOpenTime )
+    {
+        outSlot.bOpenNew = true;
+        return true;
+    }
+    return false;
+}
+
+
+///////////////////////////////////////////////////////////////
+//
+// CDatabaseJobQueueImpl::ReleaseJobSlot
+//
+// Make the connection used by a finished job available again
+// * Assumes shared.m_Mutex is locked *
+//
+///////////////////////////////////////////////////////////////
+void CDatabaseJobQueueImpl::ReleaseJobSlot ( SJobSlot& slot )
+{
+    slot.pQueue->uiNumRunning--;
+    slot.pQueue->bBarrierRunning = false;
+
+    if ( slot.bOpenNew )
+    {
+        // Replace placeholder with the new connection, or remove it if connecting failed
+        std::vector < CDatabaseConnection* >& connectionList = slot.pPool->connectionList;
+        std::vector < CDatabaseConnection* >::iterator iter = std::find ( connectionList.begin (), connectionList.end (), (CDatabaseConnection*)NULL );
+        if ( slot.pConnection )
+            *iter = slot.pConnection;
+        else
+        {
+            // Try again later, as the server may only be down for a while
+            connectionList.erase ( iter );
+            slot.pPool->nextOpenTime = CTickCount::Now ( true ) + CTickCount ( (long long)DB_QUEUE_OPEN_RETRY_MS );
+        }
+    }
+    else
+    if ( slot.pConnection )
+        MapRemove ( shared.m_BusyConnectionSet, slot.pConnection );
+}
+
+
 ///////////////////////////////////////////////////////////////
 //
 // CDatabaseJobQueueImpl::ProcessCommand
@@ -610,19 +960,19 @@ void* CDatabaseJobQueueImpl::ThreadProc ( void )
 //
 //
 ///////////////////////////////////////////////////////////////
-void CDatabaseJobQueueImpl::ProcessCommand ( CDbJobData* pJobData )
+void CDatabaseJobQueueImpl::ProcessCommand ( CDbJobData* pJobData, SJobSlot& slot )
 {
     if ( pJobData->command.type == EJobCommand::CONNECT )
         ProcessConnect ( pJobData );
     else
     if ( pJobData->command.type == EJobCommand::DISCONNECT )
-        ProcessDisconnect ( pJobData );
+        ProcessDisconnect ( pJobData, slot );
     else
     if ( pJobData->command.type == EJobCommand::QUERY )
-        ProcessQuery ( pJobData );
+        ProcessQuery ( pJobData, slot );
     else
     if ( pJobData->command.type == EJobCommand::FLUSH )
-        ProcessFlush ( pJobData );
+        ProcessFlush ( pJobData, slot );
     else
     if ( pJobData->command.type == EJobCommand::SETLOGLEVEL )
         ProcessSetLogLevel ( pJobData );
@@ -657,34 +1007,30 @@ void CDatabaseJobQueueImpl::ProcessConnect ( CDbJobData* pJobData )
     }
 
     // Get type manager to return a CDatabaseConnection*
-    CDatabaseConnection* pConnection = pTypeManager->Connect ( parts[1], parts[2], parts[3], parts[4] );
+    CDatabaseConnection* pConnection = OpenConnection ( pTypeManager, parts[1], parts[2], parts[3], parts[4], pJobData->result.strReason );
     if ( !pConnection )
     {
         pJobData->result.status = EJobResult::FAIL;
-        pJobData->result.strReason = "Could not connect";
         return;
     }
 
-    if ( !pConnection->IsValid () )
-    {
-        pJobData->result.status = EJobResult::FAIL;
-        pJobData->result.strReason = pConnection->GetLastErrorMessage ();
-        pConnection->Release ();
-        return;
-    }
-
-    // Extract some options
-    GetOption < CDbOptionsMap > ( parts[4], "log", pConnection->m_bLoggingEnabled, 0 );
-    GetOption < CDbOptionsMap > ( parts[4], "tag", pConnection->m_strLogTag );
-    GetOption < CDbOptionsMap > ( parts[4], "suppress", ",", pConnection->m_SuppressedErrorCodes );
-
-    // Only allow error codes to be suppress with mysql, as sqlite only has one error code
+    // Extract pool options. Only mysql can have more than one connection
+    SConnectionPool* pPool = new SConnectionPool ();
+    pPool->pTypeManager = pTypeManager;
+    pPool->strHost = parts[1];
+    pPool->strUsername = parts[2];
+    pPool->strPassword = parts[3];
+    pPool->strOptions = parts[4];
+    pPool->connectionList.push_back ( pConnection );
+    GetOption < CDbOptionsMap > ( parts[4], "pool", pPool->uiPoolSize, 1 );
+    GetOption < CDbOptionsMap > ( parts[4], "ordered", pPool->bOrdered, 1 );
     if ( pTypeManager->GetDataSourceTag () != "mysql" )
-        pConnection->m_SuppressedErrorCodes.clear ();
+        pPool->uiPoolSize = 1;
+    pPool->uiPoolSize = Clamp < uint > ( 1, pPool->uiPoolSize, DB_QUEUE_MAX_POOL_SIZE );
 
-    // Associate handle with CDatabaseConnection*
+    // Associate handle with connection pool
     shared.m_Mutex.Lock();
-    MapSet( shared.m_HandleConnectionMap, pJobData->command.connectionHandle, pConnection );
+    MapSet( shared.m_HandleConnectionMap, pJobData->command.connectionHandle, pPool );
     shared.m_Mutex.Unlock();
 
     // Set result
@@ -696,24 +1042,31 @@ void CDatabaseJobQueueImpl::ProcessConnect ( CDbJobData* pJobData )
 //
 // CDatabaseJobQueueImpl::ProcessDisconnect
 //
-//
+// Only runs when no other jobs are using the connection pool
 //
 ///////////////////////////////////////////////////////////////
-void CDatabaseJobQueueImpl::ProcessDisconnect ( CDbJobData* pJobData )
+void CDatabaseJobQueueImpl::ProcessDisconnect ( CDbJobData* pJobData, SJobSlot& slot )
 {
-    // CDatabaseConnection* from handle
-    CDatabaseConnection* pConnection = GetConnectionFromHandle ( pJobData->command.connectionHandle );
-    if ( !pConnection )
+    if ( !slot.pPool )
     {
         pJobData->result.status = EJobResult::FAIL;
         pJobData->result.strReason = "Invalid connection";
         return;
     }
 
+    // Remove handle
+    shared.m_Mutex.Lock();
+    if ( MapFindRef ( shared.m_HandleConnectionMap, pJobData->command.connectionHandle ) != slot.pPool )
+        CLogger::ErrorPrintf ( "ProcessDisconnect: Serious problem here\n" );
+    MapRemove ( shared.m_HandleConnectionMap, pJobData->command.connectionHandle );
+    MapRemove ( shared.m_BusyConnectionSet, slot.pConnection );
+    shared.m_Mutex.Unlock();
+
     // And disconnect
-    RemoveHandleForConnection ( pJobData->command.connectionHandle, pConnection );
-    pConnection->Release ();
-    pConnection = NULL;
+    for ( uint i = 0 ; i < slot.pPool->connectionList.size () ; i++ )
+        ReleaseConnection ( slot.pPool->connectionList[i] );
+    SAFE_DELETE ( slot.pPool );
+    slot.pConnection = NULL;
 
     // Set result
     pJobData->result.status = EJobResult::SUCCESS;
@@ -727,18 +1080,31 @@ void CDatabaseJobQueueImpl::ProcessDisconnect ( CDbJobData* pJobData )
 //
 //
 ///////////////////////////////////////////////////////////////
-void CDatabaseJobQueueImpl::ProcessQuery ( CDbJobData* pJobData )
+void CDatabaseJobQueueImpl::ProcessQuery ( CDbJobData* pJobData, SJobSlot& slot )
 {
-    // CDatabaseConnection* from handle
-    CDatabaseConnection* pConnection = GetConnectionFromHandle ( pJobData->command.connectionHandle );
-    if ( !pConnection )
+    if ( !slot.pPool )
     {
         pJobData->result.status = EJobResult::FAIL;
         pJobData->result.strReason = "Invalid connection";
         return;
     }
 
+    // Add another connection to the pool if needed
+    if ( slot.bOpenNew )
+    {
+        SConnectionPool* pPool = slot.pPool;
+        SString strError;
+        slot.pConnection = OpenConnection ( pPool->pTypeManager, pPool->strHost, pPool->strUsername, pPool->strPassword, pPool->strOptions + ";share=0", strError );
+        if ( !slot.pConnection )
+        {
+            // The pool still has its first connection, so wait for that instead of failing the query
+            slot.bRequeue = true;
+            return;
+        }
+    }
+
     // And query
+    CDatabaseConnection* pConnection = slot.pConnection;
     if ( !pConnection->Query ( pJobData->command.strData, pJobData->result.registryResult ) )
     {
         pJobData->result.status = EJobResult::FAIL;
@@ -752,7 +1118,7 @@ void CDatabaseJobQueueImpl::ProcessQuery ( CDbJobData* pJobData )
     }
 
     // And log if required
-    LogResult ( pJobData );
+    LogResult ( pJobData, pConnection );
 }
 
 
@@ -760,13 +1126,13 @@ void CDatabaseJobQueueImpl::ProcessQuery ( CDbJobData* pJobData )
 //
 // CDatabaseJobQueueImpl::ProcessFlush ()
 //
-// Tell the connection to flush cached data
+// Tell the connections to flush cached data
+// Only runs when no other jobs are using the connection pool
 //
 ///////////////////////////////////////////////////////////////
-void CDatabaseJobQueueImpl::ProcessFlush ( CDbJobData* pJobData )
+void CDatabaseJobQueueImpl::ProcessFlush ( CDbJobData* pJobData, SJobSlot& slot )
 {
-    CDatabaseConnection* pConnection = GetConnectionFromHandle ( pJobData->command.connectionHandle );
-    if ( !pConnection )
+    if ( !slot.pPool )
     {
         pJobData->result.status = EJobResult::FAIL;
         pJobData->result.strReason = "Invalid connection";
@@ -774,7 +1140,8 @@ void CDatabaseJobQueueImpl::ProcessFlush ( CDbJobData* pJobData )
     }
 
     // Do flush
-    pConnection->Flush ();
+    for ( uint i = 0 ; i < slot.pPool->connectionList.size () ; i++ )
+        slot.pPool->connectionList[i]->Flush ();
     pJobData->result.status = EJobResult::SUCCESS;
 }
 
@@ -788,6 +1155,7 @@ void CDatabaseJobQueueImpl::ProcessFlush ( CDbJobData* pJobData )
 ///////////////////////////////////////////////////////////////
 void CDatabaseJobQueueImpl::ProcessSetLogLevel ( CDbJobData* pJobData )
 {
+    LOCK_SCOPE ( m_LogCS );
     GetOption < CDbOptionsMap > ( pJobData->command.strData, "name", m_strLogFilename );
     GetOption < CDbOptionsMap > ( pJobData->command.strData, "level", m_LogLevel );
     pJobData->result.status = EJobResult::SUCCESS;
@@ -796,35 +1164,72 @@ void CDatabaseJobQueueImpl::ProcessSetLogLevel ( CDbJobData* pJobData )
 
 ///////////////////////////////////////////////////////////////
 //
-// CDatabaseJobQueueImpl::GetConnectionFromHandle
-//
+// CDatabaseJobQueueImpl::OpenConnection
 //
+// Returns NULL and sets strOutError on failure
 //
 ///////////////////////////////////////////////////////////////
-CDatabaseConnection* CDatabaseJobQueueImpl::GetConnectionFromHandle ( SConnectionHandle connectionHandle )
+CDatabaseConnection* CDatabaseJobQueueImpl::OpenConnection ( CDatabaseType* pTypeManager, const SString& strHost, const SString& strUsername, const SString& strPassword, const SString& strOptions, SString& strOutError )
 {
-    shared.m_Mutex.Lock();
-    CDatabaseConnection* pConnection = MapFindRef ( shared.m_HandleConnectionMap, connectionHandle );
-    shared.m_Mutex.Unlock();
+    CDatabaseConnection* pConnection;
+    {
+        LOCK_SCOPE ( m_DatabaseTypeCS );
+        pConnection = pTypeManager->Connect ( strHost, strUsername, strPassword, strOptions );
+    }
+
+    if ( !pConnection )
+    {
+        strOutError = "Could not connect";
+        return NULL;
+    }
+
+    if ( !pConnection->IsValid () )
+    {
+        strOutError = pConnection->GetLastErrorMessage ();
+        ReleaseConnection ( pConnection );
+        return NULL;
+    }
+
+    // Extract some options
+    GetOption < CDbOptionsMap > ( strOptions, "log", pConnection->m_bLoggingEnabled, 0 );
+    GetOption < CDbOptionsMap > ( strOptions, "tag", pConnection->m_strLogTag );
+    GetOption < CDbOptionsMap > ( strOptions, "suppress", ",", pConnection->m_SuppressedErrorCodes );
+
+    // Only allow error codes to be suppress with mysql, as sqlite only has one error code
+    if ( pTypeManager->GetDataSourceTag () != "mysql" )
+        pConnection->m_SuppressedErrorCodes.clear ();
+
     return pConnection;
 }
 
 
 ///////////////////////////////////////////////////////////////
 //
-// CDatabaseJobQueueImpl::RemoveHandleForConnection
+// CDatabaseJobQueueImpl::ReleaseConnection
 //
 //
 //
 ///////////////////////////////////////////////////////////////
-void CDatabaseJobQueueImpl::RemoveHandleForConnection ( SConnectionHandle connectionHandle, CDatabaseConnection* pConnection )
+void CDatabaseJobQueueImpl::ReleaseConnection ( CDatabaseConnection* pConnection )
 {
-    shared.m_Mutex.Lock();
-    if ( !MapContains ( shared.m_HandleConnectionMap, connectionHandle ) )
-        CLogger::ErrorPrintf ( "RemoveHandleForConnection: Serious problem here\n" );
+    LOCK_SCOPE ( m_DatabaseTypeCS );
+    pConnection->Release ();
+}
 
-    MapRemove ( shared.m_HandleConnectionMap, connectionHandle );
+
+///////////////////////////////////////////////////////////////
+//
+// CDatabaseJobQueueImpl::GetConnectionPoolFromHandle
+//
+//
+//
+///////////////////////////////////////////////////////////////
+SConnectionPool* CDatabaseJobQueueImpl::GetConnectionPoolFromHandle ( SConnectionHandle connectionHandle )
+{
+    shared.m_Mutex.Lock();
+    SConnectionPool* pPool = MapFindRef ( shared.m_HandleConnectionMap, connectionHandle );
     shared.m_Mutex.Unlock();
+    return pPool;
 }
 
 
@@ -835,15 +1240,16 @@ void CDatabaseJobQueueImpl::RemoveHandleForConnection ( SConnectionHandle connec
 // Log last job if connection has logging enabled
 //
 ///////////////////////////////////////////////////////////////
-void CDatabaseJobQueueImpl::LogResult ( CDbJobData* pJobData )
+void CDatabaseJobQueueImpl::LogResult ( CDbJobData* pJobData, CDatabaseConnection* pConnection )
 {
+    LOCK_SCOPE ( m_LogCS );
+
     // Early out if logging switched off globally
     if ( m_LogLevel == EJobLogLevel::NONE )
         return;
 
     // Check logging status of connection
-    CDatabaseConnection* pConnection = GetConnectionFromHandle ( pJobData->command.connectionHandle );
-    if ( !pConnection || !pConnection->m_bLoggingEnabled )
+    if ( !pConnection->m_bLoggingEnabled )
         return;
 
     if ( pJobData->result.status == EJobResult::SUCCESS )
@@ -885,6 +1291,7 @@ void CDatabaseJobQueueImpl::LogResult ( CDbJobData* pJobData )
 // CDatabaseJobQueueImpl::LogString
 //
 // Add string to log output
+// * Assumes m_LogCS is locked *
 //
 ///////////////////////////////////////////////////////////////
 void CDatabaseJobQueueImpl::LogString ( const SString& strText )
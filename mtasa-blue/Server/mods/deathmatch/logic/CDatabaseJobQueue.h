@@ -29,6 +29,7 @@ public:
     virtual CDbJobData*         FindCommandFromId           ( SDbJobId id ) = 0;
     virtual void                IgnoreConnectionResults     ( SConnectionHandle connectionHandle ) = 0;
     virtual bool                UsesConnection              ( SConnectionHandle connectionHandle ) = 0;
+    virtual void                GetQueueStats               ( SDbQueueStats& outStats ) = 0;
 };
 
 CDatabaseJobQueue* NewDatabaseJobQueue ( void );
@@ -162,6 +162,25 @@ void CDatabaseJobQueueManager::SetLogLevel( EJobLogLevelType logLevel, const SSt
 }
 
 
+///////////////////////////////////////////////////////////////
+//
+// CDatabaseJobQueueManager::GetQueueStats
+//
+// Get current state of each queue
+//
+///////////////////////////////////////////////////////////////
+void CDatabaseJobQueueManager::GetQueueStats( std::vector< SDbQueueStats >& outStatsList )
+{
+    for ( const auto& iter : m_QueueNameMap )
+    {
+        SDbQueueStats stats;
+        iter.second->GetQueueStats( stats );
+        stats.strName = iter.first;
+        outStatsList.push_back( stats );
+    }
+}
+
+
 ///////////////////////////////////////////////////////////////
 //
 // CDatabaseJobQueueManager::FindQueueFromConnection
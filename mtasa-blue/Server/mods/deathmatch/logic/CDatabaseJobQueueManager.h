@@ -28,6 +28,7 @@ public:
     CDbJobData*                 FindCommandFromId           ( SDbJobId id );
     void                        IgnoreConnectionResults     ( SConnectionHandle connectionHandle );
     void                        SetLogLevel                 ( EJobLogLevelType logLevel, const SString& strLogFilename );
+    void                        GetQueueStats               ( std::vector < SDbQueueStats >& outStatsList );
 
 protected:
     CDatabaseJobQueue*          GetQueueFromConnectCommand  ( const SString& strData );
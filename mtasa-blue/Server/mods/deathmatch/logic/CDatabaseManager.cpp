@@ -49,6 +49,7 @@ public:
     virtual bool                    QueryWithCallback           ( SConnectionHandle hConnection, PFN_DBRESULT pfnDbResult, void* pCallbackContext, const SString& strQuery, CLuaArguments* pArgs = nullptr );
     virtual bool                    QueryWithCallbackf          ( SConnectionHandle hConnection, PFN_DBRESULT pfnDbResult, void* pCallbackContext, const char* szQuery, ... );
     virtual void                    SetLogLevel                 ( EJobLogLevelType logLevel, const SString& strLogFilename );
+    virtual void                    GetQueueStats               ( std::vector < SDbQueueStats >& outStatsList );
 
     // CDatabaseManagerImpl
     SString                         InsertQueryArguments        ( SConnectionHandle hConnection, const SString& strQuery, CLuaArguments* pArgs );
@@ -570,6 +571,19 @@ void CDatabaseManagerImpl::SetLogLevel ( EJobLogLevelType logLevel, const SStrin
     return m_JobQueue->SetLogLevel( logLevel, strLogFilename );
 }
 
+
+///////////////////////////////////////////////////////////////
+//
+// CDatabaseManagerImpl::GetQueueStats
+//
+// Get current state of each job queue
+//
+///////////////////////////////////////////////////////////////
+void CDatabaseManagerImpl::GetQueueStats ( std::vector < SDbQueueStats >& outStatsList )
+{
+    m_JobQueue->GetQueueStats( outStatsList );
+}
+
 ///////////////////////////////////////////////////////////////
 //
 // CDatabaseManagerImpl::InsertQueryArguments
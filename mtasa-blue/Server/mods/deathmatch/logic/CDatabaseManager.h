@@ -70,6 +70,24 @@ using EJobLogLevel::EJobLogLevelType;
 typedef void (*PFN_DBRESULT) ( CDbJobData* pJobData, void* pContext );
 
 
+//
+// Snapshot of a job queue for perfstat
+//
+struct SDbQueueStats
+{
+    SString     strName;
+    uint        uiNumWorkers;
+    uint        uiNumHandles;
+    uint        uiNumConnections;
+    uint        uiNumWaiting;           // Jobs not started yet
+    uint        uiNumProcessing;
+    uint        uiNumResults;           // Results not collected yet
+    uint        uiNumQueries;           // Queries completed in the last 10 to 20 seconds
+    SString     strWaitTime;            // Time queries spent waiting to start as p50/p99/max
+    SString     strExecTime;            // Time queries spent executing as p50/p99/max
+};
+
+
 //
 // Specialized map for the options string
 //
@@ -107,6 +125,7 @@ public:
         SConnectionHandle   connectionHandle;
         SString             strData;
         CDatabaseJobQueue*  pJobQueue;
+        TIMEUS              timeQueued;
     } command;
 
     struct
@@ -165,6 +184,7 @@ public:
     virtual bool                    QueryWithCallback       ( SConnectionHandle hConnection, PFN_DBRESULT pfnDbResult, void* pCallbackContext, const SString& strQuery, CLuaArguments* pArgs = nullptr ) = 0;
     virtual bool                    QueryWithCallbackf      ( SConnectionHandle hConnection, PFN_DBRESULT pfnDbResult, void* pCallbackContext, const char* szQuery, ... ) = 0;
     virtual void                    SetLogLevel             ( EJobLogLevelType logLevel, const SString& strLogFilename ) = 0;
+    virtual void                    GetQueueStats           ( std::vector < SDbQueueStats >& outStatsList ) = 0;
 };
 
 CDatabaseManager* NewDatabaseManager ( void );
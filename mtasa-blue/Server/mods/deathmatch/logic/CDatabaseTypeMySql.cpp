@@ -136,6 +136,8 @@ void CDatabaseTypeMySql::NotifyConnectionChanged ( CDatabaseConnection* pConnect
 //
 //      Options are:
 //          share=1     // Share this connection with anything else (defaults to share=1)
+//          pool=4      // Number of worker threads for the queue, and connections for this handle (defaults to pool=1)
+//          ordered=0   // Allow read queries to run at the same time using pooled connections (defaults to ordered=1)
 //
 ///////////////////////////////////////////////////////////////
 CDatabaseConnection* CDatabaseTypeMySql::Connect ( const SString& strHost, const SString& strUsername, const SString& strPassword, const SString& strOptions )
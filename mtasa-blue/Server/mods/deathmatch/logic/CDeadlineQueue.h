@@ -0,0 +1,76 @@
+/*****************************************************************************
+*
+*  PROJECT:     Multi Theft Auto v1.0
+*  LICENSE:     See LICENSE in the top level directory
+*  FILE:        mods/deathmatch/logic/CDeadlineQueue.h
+*  PURPOSE:     Queue of items ordered by when they next need attention
+*
+*  Multi Theft Auto is available from http://www.multitheftauto.com/
+*
+*****************************************************************************/
+#pragma once
+
+#include <map>
+#include <set>
+#include <vector>
+
+//
+// Keeps items sorted by time, so only the ones which are due need to be looked at
+// Each item is in the queue at most once
+//
+template < class T >
+class CDeadlineQueue
+{
+public:
+    // Set the time the item is due, replacing any previous time
+    void Set ( T* pItem, long long llTime )
+    {
+        Remove ( pItem );
+        m_ItemTimeMap[ pItem ] = llTime;
+        m_Queue.insert ( std::make_pair ( llTime, pItem ) );
+    }
+
+    // Set the time the item is due, unless it is already due sooner
+    void SetIfEarlier ( T* pItem, long long llTime )
+    {
+        long long* pTime = MapFind ( m_ItemTimeMap, pItem );
+        if ( !pTime || llTime < *pTime )
+            Set ( pItem, llTime );
+    }
+
+    void Remove ( T* pItem )
+    {
+        typename std::map < T*, long long >::iterator iter = m_ItemTimeMap.find ( pItem );
+        if ( iter != m_ItemTimeMap.end () )
+        {
+            m_Queue.erase ( std::make_pair ( iter->second, pItem ) );
+            m_ItemTimeMap.erase ( iter );
+        }
+    }
+
+    bool Contains ( T* pItem ) const
+    {
+        return MapContains ( m_ItemTimeMap, pItem );
+    }
+
+    // Remove and return items whose time is before llNow
+    void PopDue ( long long llNow, std::vector < T* >& outList )
+    {
+        while ( !m_Queue.empty () && m_Queue.begin ()->first < llNow )
+        {
+            T* pItem = m_Queue.begin ()->second;
+            m_Queue.erase ( m_Queue.begin () );
+            m_ItemTimeMap.erase ( pItem );
+            outList.push_back ( pItem );
+        }
+    }
+
+    uint Count ( void ) const
+    {
+        return m_Queue.size ();
+    }
+
+protected:
+    std::set < std::pair < long long, T* > >    m_Queue;
+    std::map < T*, long long >                  m_ItemTimeMap;
+};
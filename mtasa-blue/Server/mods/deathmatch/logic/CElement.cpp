@@ -40,6 +40,7 @@ CElement::CElement ( CElement* pParent, CXMLNode* pNode )
     m_bIsBeingDeleted = false;
     m_usDimension = 0;
     m_ucSyncTimeContext = 1;
+    m_uiSyncRevision = 1;
     m_ucInterior = 0;
     m_bDoubleSided = false;
     m_bUpdatingSpatialData = false;
@@ -403,6 +404,7 @@ CElement* CElement::SetParentObject ( CElement* pParent, bool bUpdatePerPlayerEn
 
         // Set the new parent
         m_pParent = pParent;
+        IncrementSyncRevision ();
 
         // New parent?
         if ( pParent )
@@ -460,11 +462,16 @@ bool CElement::CallEvent ( const char* szName, const CLuaArguments& Arguments, C
     // Make sure our event-manager knows we're about to call an event
     pEvents->PreEventPulse ();
 
-    // Call the event on our parents/us first
-    CallParentEvent ( szName, Arguments, this, pCaller );
+    // Only need to look for handlers if one has been added for this name at some point
+    uint uiNameId = CMapEventManager::FindEventNameId ( szName );
+    if ( uiNameId )
+    {
+        // Call the event on our parents/us first
+        CallParentEvent ( uiNameId, Arguments, this, pCaller );
 
-    // Call it on all our children
-    CallEventNoParent ( szName, Arguments, this, pCaller );
+        // Call it on all our children
+        CallEventNoParent ( uiNameId, Arguments, this, pCaller );
+    }
 
     // Tell the event manager that we're done calling the event
     pEvents->PostEventPulse ();
@@ -754,6 +761,7 @@ void CElement::SetCustomData ( const char* szName, const CLuaArgument& Variable,
 
     // Set the new data
     m_pCustomData->Set ( szName, Variable, bSynchronized );
+    IncrementSyncRevision ();
 
     if ( bTriggerEvent )
     {
@@ -778,6 +786,7 @@ void CElement::DeleteCustomData ( const char* szName )
 
         // Delete the custom data
         m_pCustomData->Delete ( szName );
+        IncrementSyncRevision ();
 
         // Trigger the onElementDataChange event on us
         CLuaArguments Arguments;
@@ -1044,12 +1053,12 @@ void CElement::FindAllChildrenByTypeIndex ( unsigned int uiTypeHash, lua_State*
 }
 
 
-void CElement::CallEventNoParent ( const char* szName, const CLuaArguments& Arguments, CElement* pSource, CPlayer* pCaller )
+void CElement::CallEventNoParent ( uint uiNameId, const CLuaArguments& Arguments, CElement* pSource, CPlayer* pCaller )
 {
     // Call it on us if this isn't the same class it was raised on
     if ( pSource != this && m_pEventManager->HasEvents () )
     {
-        m_pEventManager->Call ( szName, Arguments, pSource, this, pCaller );
+        m_pEventManager->Call ( uiNameId, Arguments, pSource, this, pCaller );
     }
 
     // Call it on all our children
@@ -1062,7 +1071,7 @@ void CElement::CallEventNoParent ( const char* szName, const CLuaArguments& Argu
         {
             if ( !pElement->m_pEventManager || pElement->m_pEventManager->HasEvents () || !pElement->m_Children.empty () )
             {
-                pElement->CallEventNoParent ( szName, Arguments, pSource, pCaller );
+                pElement->CallEventNoParent ( uiNameId, Arguments, pSource, pCaller );
                 if ( m_bIsBeingDeleted )
                     break;
             }
@@ -1072,18 +1081,18 @@ void CElement::CallEventNoParent ( const char* szName, const CLuaArguments& Argu
 }
 
 
-void CElement::CallParentEvent ( const char* szName, const CLuaArguments& Arguments, CElement* pSource, CPlayer* pCaller )
+void CElement::CallParentEvent ( uint uiNameId, const CLuaArguments& Arguments, CElement* pSource, CPlayer* pCaller )
 {
     // Call the event on us
     if ( m_pEventManager->HasEvents () )
     {
-        m_pEventManager->Call ( szName, Arguments, pSource, this, pCaller );
+        m_pEventManager->Call ( uiNameId, Arguments, pSource, this, pCaller );
     }
 
     // Call parent's handler
     if ( m_pParent )
     {
-        m_pParent->CallParentEvent ( szName, Arguments, pSource, pCaller );
+        m_pParent->CallParentEvent ( uiNameId, Arguments, pSource, pCaller );
     }
 }
 
@@ -1143,6 +1152,7 @@ void CElement::AttachTo ( CElement* pElement )
         m_pAttachedTo->RemoveAttachedElement ( this );
 
     m_pAttachedTo = pElement;
+    IncrementSyncRevision ();
 
     if ( m_pAttachedTo )
         m_pAttachedTo->AddAttachedElement ( this );
@@ -1172,6 +1182,7 @@ void CElement::SetAttachedOffsets ( CVector & vecPosition, CVector & vecRotation
 {
     m_vecAttachedPosition = vecPosition;
     m_vecAttachedRotation = vecRotation;
+    IncrementSyncRevision ();
 }
 
 
@@ -1262,6 +1273,7 @@ unsigned char CElement::GenerateSyncTimeContext ( void )
 {
     // Increment the sync time index
     ++m_ucSyncTimeContext;
+    IncrementSyncRevision ();
 
     #ifdef MTA_DEBUG
     if ( GetType ( ) == EElementType::PLAYER )
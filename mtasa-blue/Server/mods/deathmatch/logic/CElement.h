@@ -164,7 +164,7 @@ public:
     void                                        SetTypeName                 ( const std::string& strTypeName );
 
     inline const std::string&                   GetName                     ( void )                        { return m_strName; };
-    inline void                                 SetName                     ( const std::string& strName )  { m_strName = strName; };
+    inline void                                 SetName                     ( const std::string& strName )  { m_strName = strName; IncrementSyncRevision (); };
 
     bool                                        LoadFromCustomData          ( CEvents* pEvents );
 
@@ -182,7 +182,7 @@ public:
     std::list < class CColShape* > ::iterator   CollisionsEnd               ( void )                        { return m_Collisions.end (); }
 
     inline unsigned short                       GetDimension                ( void )                        { return m_usDimension; }
-    inline void                                 SetDimension                ( unsigned short usDimension )  { m_usDimension = usDimension; }
+    inline void                                 SetDimension                ( unsigned short usDimension )  { m_usDimension = usDimension; IncrementSyncRevision (); }
 
     class CClient*                              GetClient                   ( void );
 
@@ -214,21 +214,25 @@ public:
     unsigned char                               GenerateSyncTimeContext     ( void );
     bool                                        CanUpdateSync               ( unsigned char ucRemote );
 
+    // Changes whenever something sent in the entity add packet changes, so the encoded data can be reused until then
+    uint                                        GetSyncRevision             ( void )                    { return m_uiSyncRevision; }
+    void                                        IncrementSyncRevision       ( void )                    { if ( ++m_uiSyncRevision == 0 ) m_uiSyncRevision = 1; }
+
     inline void                                 AddOriginSourceUser         ( class CPed * pPed )           { m_OriginSourceUsers.push_back ( pPed ); }
     inline void                                 RemoveOriginSourceUser      ( class CPed * pPed )           { m_OriginSourceUsers.remove ( pPed ); }
 
     inline unsigned char                        GetInterior                 ( void )                        { return m_ucInterior; }
-    inline void                                 SetInterior                 ( unsigned char ucInterior )    { m_ucInterior = ucInterior; }
+    inline void                                 SetInterior                 ( unsigned char ucInterior )    { m_ucInterior = ucInterior; IncrementSyncRevision (); }
 
     bool                                        IsDoubleSided               ( void )                        { return m_bDoubleSided; }
-    void                                        SetDoubleSided              ( bool bDoubleSided )           { m_bDoubleSided = bDoubleSided; }
+    void                                        SetDoubleSided              ( bool bDoubleSided )           { m_bDoubleSided = bDoubleSided; IncrementSyncRevision (); }
 
     // Spatial database
     virtual CSphere                             GetWorldBoundingSphere      ( void );
     virtual void                                UpdateSpatialData           ( void );
 
     bool                                        IsCallPropagationEnabled    ( void )                        { return m_bCallPropagationEnabled; }
-    void                                        SetCallPropagationEnabled   ( bool bEnabled )               { m_bCallPropagationEnabled = bEnabled; }
+    void                                        SetCallPropagationEnabled   ( bool bEnabled )               { m_bCallPropagationEnabled = bEnabled; IncrementSyncRevision (); }
 
 protected:
     CElement*                                   GetRootElement              ( void );
@@ -238,8 +242,8 @@ protected:
     CElement*                                   FindChildByTypeIndex        ( unsigned int uiTypeHash, unsigned int uiIndex, unsigned int& uiCurrentIndex, bool bRecursive );
     void                                        FindAllChildrenByTypeIndex  ( unsigned int uiTypeHash, lua_State* pLua, unsigned int& uiIndex );
 
-    void                                        CallEventNoParent           ( const char* szName, const CLuaArguments& Arguments, CElement* pSource, CPlayer* pCaller = NULL );
-    void                                        CallParentEvent             ( const char* szName, const CLuaArguments& Arguments, CElement* pSource, CPlayer* pCaller = NULL );
+    void                                        CallEventNoParent           ( uint uiNameId, const CLuaArguments& Arguments, CElement* pSource, CPlayer* pCaller = NULL );
+    void                                        CallParentEvent             ( uint uiNameId, const CLuaArguments& Arguments, CElement* pSource, CPlayer* pCaller = NULL );
 
 
     CMapEventManager*                           m_pEventManager;
@@ -275,6 +279,7 @@ protected:
 
     unsigned short                              m_usDimension;
     unsigned char                               m_ucSyncTimeContext;
+    uint                                        m_uiSyncRevision;
 
     std::list < class CPed * >                  m_OriginSourceUsers;
     unsigned char                               m_ucInterior;
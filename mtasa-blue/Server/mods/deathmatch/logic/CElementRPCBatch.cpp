@@ -0,0 +1,149 @@
+/*****************************************************************************
+*
+*  PROJECT:     Multi Theft Auto v1.0
+*  LICENSE:     See LICENSE in the top level directory
+*  FILE:        mods/deathmatch/logic/CElementRPCBatch.cpp
+*  PURPOSE:     Element RPCs waiting to be sent to one player
+*
+*  Multi Theft Auto is available from http://www.multitheftauto.com/
+*
+*****************************************************************************/
+
+#include "StdInc.h"
+
+
+///////////////////////////////////////////////////////////////
+//
+// CElementRPCBatch::IsBatchable
+//
+// Latent sends are left alone so they still go through the latent transfer manager
+//
+///////////////////////////////////////////////////////////////
+bool CElementRPCBatch::IsBatchable ( const CPacket& Packet, ushort usBitStreamVersion )
+{
+    return Packet.GetPacketID () == PACKET_ID_LUA_ELEMENT_RPC && usBitStreamVersion >= 0x06C && !g_pGame->IsLatentSendsEnabled ();
+}
+
+
+///////////////////////////////////////////////////////////////
+//
+// CElementRPCBatch::IsLastWriteWins
+//
+// Setters where only the final value matters
+//
+///////////////////////////////////////////////////////////////
+bool CElementRPCBatch::IsLastWriteWins ( uchar ucActionID )
+{
+    switch ( ucActionID )
+    {
+        case SET_ELEMENT_POSITION:
+        case SET_ELEMENT_VELOCITY:
+        case SET_ELEMENT_ALPHA:
+        case SET_ELEMENT_NAME:
+        case SET_ELEMENT_HEALTH:
+        case SET_ELEMENT_MODEL:
+        case SET_ELEMENT_DOUBLESIDED:
+        case SET_ELEMENT_FROZEN:
+        case SET_PED_ROTATION:
+        case SET_PED_ARMOR:
+        case SET_VEHICLE_ROTATION:
+        case SET_VEHICLE_COLOR:
+        case SET_OBJECT_ROTATION:
+            return true;
+    }
+    return false;
+}
+
+
+///////////////////////////////////////////////////////////////
+//
+// CElementRPCBatch::Add
+//
+// pBitStream holds the encoded RPC
+//
+///////////////////////////////////////////////////////////////
+void CElementRPCBatch::Add ( const CPacket& Packet, NetBitStreamInterface* pBitStream )
+{
+    const CElementRPCPacket& RPCPacket = static_cast < const CElementRPCPacket& > ( Packet );
+
+    SItem item;
+    item.ucActionID = RPCPacket.GetActionID ();
+    item.ID = RPCPacket.GetSourceElement ()->GetID ();
+    item.pBitStream = pBitStream;
+
+    // Remove the previous call to this setter, the new one is added at the end so the order of the final values is kept
+    if ( IsLastWriteWins ( item.ucActionID ) )
+    {
+        for ( std::vector < SItem > ::iterator iter = m_Items.begin () ; iter != m_Items.end () ; ++iter )
+        {
+            if ( iter->ucActionID == item.ucActionID && iter->ID == item.ID )
+            {
+                SAFE_RELEASE ( iter->pBitStream );
+                m_Items.erase ( iter );
+                break;
+            }
+        }
+    }
+
+    pBitStream->AddRef ();
+    m_Items.push_back ( item );
+}
+
+
+///////////////////////////////////////////////////////////////
+//
+// CElementRPCBatch::Flush
+//
+// Send everything waiting. A single RPC is sent as a normal element RPC packet.
+//
+///////////////////////////////////////////////////////////////
+void CElementRPCBatch::Flush ( const NetServerPlayerID& Socket, ushort usBitStreamVersion )
+{
+    if ( m_Items.empty () )
+        return;
+
+    if ( m_Items.size () == 1 )
+    {
+        g_pGame->SendPacket ( PACKET_ID_LUA_ELEMENT_RPC, Socket, m_Items[0].pBitStream, false, PACKET_PRIORITY_HIGH, PACKET_RELIABILITY_RELIABLE_ORDERED );
+        Clear ();
+        return;
+    }
+
+    NetBitStreamInterface* pBitStream = g_pNetServer->AllocateNetServerBitStream ( usBitStreamVersion );
+    if ( pBitStream )
+    {
+        pBitStream->WriteCompressed ( static_cast < ushort > ( m_Items.size () ) );
+        for ( uint i = 0 ; i < m_Items.size () ; i++ )
+        {
+            // Copy the RPC with its size so the client can give each one its own bitstream.
+            // The data is copied without reading, as other players' sends may share the bitstream.
+            NetBitStreamInterface* pItemBitStream = m_Items[i].pBitStream;
+            uint uiNumBits = pItemBitStream->GetNumberOfBitsUsed ();
+            pBitStream->WriteCompressed ( uiNumBits );
+
+            m_Fragment.Capture ( 1, *pItemBitStream, 0 );
+            m_Fragment.Write ( *pBitStream );
+
+            CPerfStatRPCPacketUsage::GetSingleton ()->UpdatePacketUsageOut ( m_Items[i].ucActionID, pItemBitStream->GetNumberOfBytesUsed () );
+        }
+
+        g_pGame->SendPacket ( PACKET_ID_LUA_ELEMENT_RPC_BATCH, Socket, pBitStream, false, PACKET_PRIORITY_HIGH, PACKET_RELIABILITY_RELIABLE_ORDERED );
+        g_pNetServer->DeallocateNetServerBitStream ( pBitStream );
+    }
+    Clear ();
+}
+
+
+///////////////////////////////////////////////////////////////
+//
+// CElementRPCBatch::Clear
+//
+//
+//
+///////////////////////////////////////////////////////////////
+void CElementRPCBatch::Clear ( void )
+{
+    for ( uint i = 0 ; i < m_Items.size () ; i++ )
+        SAFE_RELEASE ( m_Items[i].pBitStream );
+    m_Items.clear ();
+}
@@ -0,0 +1,44 @@
+/*****************************************************************************
+*
+*  PROJECT:     Multi Theft Auto v1.0
+*  LICENSE:     See LICENSE in the top level directory
+*  FILE:        mods/deathmatch/logic/CElementRPCBatch.h
+*  PURPOSE:     Element RPCs waiting to be sent to one player
+*
+*  Multi Theft Auto is available from http://www.multitheftauto.com/
+*
+*****************************************************************************/
+#pragma once
+
+#define ELEMENT_RPC_BATCH_MAX_ITEMS     256
+
+//
+// Element RPCs for a player are held here until the end of the pulse, or until something else is sent to the player.
+// They are then sent as one packet. A setter which is called again for the same element replaces the earlier call.
+// The encoded RPC bitstreams are ref counted, so players on the same bitstream version share them.
+//
+class CElementRPCBatch
+{
+public:
+                        ~CElementRPCBatch       ( void )        { Clear (); }
+
+    static bool         IsBatchable             ( const CPacket& Packet, ushort usBitStreamVersion );
+    bool                IsEmpty                 ( void ) const  { return m_Items.empty (); }
+    bool                IsFull                  ( void ) const  { return m_Items.size () >= ELEMENT_RPC_BATCH_MAX_ITEMS; }
+
+    void                Add                     ( const CPacket& Packet, NetBitStreamInterface* pBitStream );
+    void                Flush                   ( const NetServerPlayerID& Socket, ushort usBitStreamVersion );
+
+protected:
+    static bool         IsLastWriteWins         ( uchar ucActionID );
+    void                Clear                   ( void );
+
+    struct SItem
+    {
+        uchar                   ucActionID;
+        ElementID               ID;
+        NetBitStreamInterface*  pBitStream;
+    };
+    std::vector < SItem >       m_Items;
+    CBitStreamFragment          m_Fragment;         // Reused copy buffer
+};
@@ -0,0 +1,326 @@
+/*****************************************************************************
+*
+*  PROJECT:     Multi Theft Auto v1.0
+*  LICENSE:     See LICENSE in the top level directory
+*  FILE:        mods/deathmatch/logic/CFileChecksumCache.cpp
+*  PURPOSE:     Persistent cache of file checksums keyed by path, size and modified time
+*
+*  Multi Theft Auto is available from http://www.multitheftauto.com/
+*
+*****************************************************************************/
+
+#include "StdInc.h"
+
+#define CHECKSUM_CACHE_FILENAME     "checksums.dat"
+#define CHECKSUM_CACHE_ID           "MTACSUM"
+#define CHECKSUM_CACHE_VERSION      1
+#define CHECKSUM_CACHE_MAX_WORKERS  8
+#define CHECKSUM_CACHE_MAX_QUEUED   256
+
+
+///////////////////////////////////////////////////////////////
+//
+// CFileChecksumCache::CFileChecksumCache
+//
+//
+//
+///////////////////////////////////////////////////////////////
+CFileChecksumCache::CFileChecksumCache ( void )
+{
+    m_strCacheFilename = PathJoin ( g_pServerInterface->GetServerModPath (), "resource-cache", CHECKSUM_CACHE_FILENAME );
+    Load ();
+}
+
+
+///////////////////////////////////////////////////////////////
+//
+// CFileChecksumCache::~CFileChecksumCache
+//
+//
+//
+///////////////////////////////////////////////////////////////
+CFileChecksumCache::~CFileChecksumCache ( void )
+{
+    Save ();
+    ReleaseWorkers ();
+}
+
+
+///////////////////////////////////////////////////////////////
+//
+// CFileChecksumCache::IsEntryValid
+//
+// Check if the cached entry for the file matches what is on disk
+// Returns false and sets uiOutSize to zero if the file does not exist
+//
+///////////////////////////////////////////////////////////////
+bool CFileChecksumCache::IsEntryValid ( const SString& strPathFilename, SFileInfo*& pOutInfo, uint64& uiOutSize, uint64& uiOutModifiedTime )
+{
+    pOutInfo = MapFind ( m_InfoMap, strPathFilename );
+    if ( !FileGetSizeAndModifiedTime ( strPathFilename, uiOutSize, uiOutModifiedTime ) )
+    {
+        uiOutSize = 0;
+        uiOutModifiedTime = 0;
+        return false;
+    }
+
+    return pOutInfo && pOutInfo->uiSize == uiOutSize && pOutInfo->uiModifiedTime == uiOutModifiedTime;
+}
+
+
+///////////////////////////////////////////////////////////////
+//
+// CFileChecksumCache::GetChecksum
+//
+// Get checksum for a file, only reading the file if it has changed since last time
+// Returns a zero checksum if the file does not exist
+//
+///////////////////////////////////////////////////////////////
+CChecksum CFileChecksumCache::GetChecksum ( const SString& strPathFilename, uint64* pOutFileSize )
+{
+    SFileInfo* pInfo;
+    uint64 uiSize, uiModifiedTime;
+    if ( !IsEntryValid ( strPathFilename, pInfo, uiSize, uiModifiedTime ) )
+    {
+        if ( uiModifiedTime == 0 )
+        {
+            // File does not exist
+            if ( pOutFileSize )
+                *pOutFileSize = 0;
+            return CChecksum ();
+        }
+
+        SFileInfo& info = MapGet ( m_InfoMap, strPathFilename );
+        info.uiSize = uiSize;
+        info.uiModifiedTime = uiModifiedTime;
+        info.checksum = CChecksum::GenerateChecksumFromFile ( strPathFilename );
+        pInfo = &info;
+        m_bDirty = true;
+    }
+
+    pInfo->bUsed = true;
+    if ( pOutFileSize )
+        *pOutFileSize = pInfo->uiSize;
+    return pInfo->checksum;
+}
+
+
+///////////////////////////////////////////////////////////////
+//
+// CFileChecksumCache::UpdateChecksum
+//
+// Set the checksum for a file which has just been written with known contents
+//
+///////////////////////////////////////////////////////////////
+void CFileChecksumCache::UpdateChecksum ( const SString& strPathFilename, const CChecksum& checksum )
+{
+    uint64 uiSize, uiModifiedTime;
+    if ( !FileGetSizeAndModifiedTime ( strPathFilename, uiSize, uiModifiedTime ) )
+    {
+        MapRemove ( m_InfoMap, strPathFilename );
+        return;
+    }
+
+    SFileInfo& info = MapGet ( m_InfoMap, strPathFilename );
+    info.uiSize = uiSize;
+    info.uiModifiedTime = uiModifiedTime;
+    info.checksum = checksum;
+    info.bUsed = true;
+    m_bDirty = true;
+}
+
+
+///////////////////////////////////////////////////////////////
+//
+// CFileChecksumCache::InvalidateChecksum
+//
+// Forget a file whose contents are not known, so it is hashed again next time
+//
+///////////////////////////////////////////////////////////////
+void CFileChecksumCache::InvalidateChecksum ( const SString& strPathFilename )
+{
+    if ( MapContains ( m_InfoMap, strPathFilename ) )
+    {
+        MapRemove ( m_InfoMap, strPathFilename );
+        m_bDirty = true;
+    }
+}
+
+
+///////////////////////////////////////////////////////////////
+//
+// CFileChecksumCache::PrecacheChecksums
+//
+// Hash all changed files in the list using worker threads
+// Blocks until done, so following calls to GetChecksum will not touch the file contents
+//
+///////////////////////////////////////////////////////////////
+void CFileChecksumCache::PrecacheChecksums ( const std::vector < SString >& pathFilenameList )
+{
+    // Find which files need hashing
+    std::vector < SString > changedList;
+    for ( uint i = 0 ; i < pathFilenameList.size () ; i++ )
+    {
+        const SString& strPathFilename = pathFilenameList[i];
+        SFileInfo* pInfo;
+        uint64 uiSize, uiModifiedTime;
+        if ( !IsEntryValid ( strPathFilename, pInfo, uiSize, uiModifiedTime ) && uiModifiedTime != 0 )
+        {
+            SFileInfo& info = MapGet ( m_InfoMap, strPathFilename );
+            info.uiSize = uiSize;
+            info.uiModifiedTime = uiModifiedTime;
+            info.checksum = CChecksum ();
+            changedList.push_back ( strPathFilename );
+        }
+    }
+
+    // Not worth waking workers for one file
+    if ( changedList.size () < 2 )
+    {
+        for ( uint i = 0 ; i < changedList.size () ; i++ )
+            MapGet ( m_InfoMap, changedList[i] ).checksum = CChecksum::GenerateChecksumFromFile ( changedList[i] );
+        m_bDirty |= !changedList.empty ();
+        return;
+    }
+
+    if ( !m_pWorkers )
+    {
+        uint uiNumWorkers = Clamp < uint > ( 2, std::thread::hardware_concurrency (), CHECKSUM_CACHE_MAX_WORKERS );
+        m_pWorkers = new CAsyncTaskScheduler ( uiNumWorkers, CHECKSUM_CACHE_MAX_QUEUED );
+        m_pWorkers->SetResultSignal ( &m_WorkDoneSignal );
+    }
+
+    uint uiNumPending = changedList.size ();
+    for ( uint i = 0 ; i < changedList.size () ; i++ )
+    {
+        SString strPathFilename = changedList[i];
+        while ( !m_pWorkers->PushTask < CChecksum > (
+            [strPathFilename]
+            {
+                return CChecksum::GenerateChecksumFromFile ( strPathFilename );
+            },
+            [this, strPathFilename, &uiNumPending] ( const CChecksum& checksum )
+            {
+                if ( SFileInfo* pInfo = MapFind ( m_InfoMap, strPathFilename ) )
+                    pInfo->checksum = checksum;
+                uiNumPending--;
+            },
+            CAsyncTaskScheduler::EPriority::Bulk
+        ) )
+        {
+            // Queue is full, so let the workers catch up
+            m_WorkDoneSignal.Wait ( 100 );
+            m_pWorkers->CollectResults ();
+        }
+    }
+
+    while ( uiNumPending )
+    {
+        m_WorkDoneSignal.Wait ( 100 );
+        m_pWorkers->CollectResults ();
+    }
+    m_bDirty = true;
+}
+
+
+///////////////////////////////////////////////////////////////
+//
+// CFileChecksumCache::ReleaseWorkers
+//
+// Stop worker threads until they are needed again
+//
+///////////////////////////////////////////////////////////////
+void CFileChecksumCache::ReleaseWorkers ( void )
+{
+    SAFE_DELETE ( m_pWorkers );
+}
+
+
+///////////////////////////////////////////////////////////////
+//
+// CFileChecksumCache::Load
+//
+//
+//
+///////////////////////////////////////////////////////////////
+void CFileChecksumCache::Load ( void )
+{
+    m_InfoMap.clear ();
+
+    CBuffer fileContents;
+    if ( !fileContents.LoadFromFile ( m_strCacheFilename ) )
+        return;
+
+    CBufferReadStream stream ( fileContents );
+
+    SString strId;
+    uint uiVersion = 0;
+    uint uiCount = 0;
+    if ( !stream.ReadString ( strId ) || strId != CHECKSUM_CACHE_ID
+        || !stream.Read ( uiVersion ) || uiVersion != CHECKSUM_CACHE_VERSION
+        || !stream.Read ( uiCount ) )
+        return;
+
+    for ( uint i = 0 ; i < uiCount ; i++ )
+    {
+        SString strPathFilename;
+        SFileInfo info;
+        info.bUsed = false;
+        if ( !stream.ReadString ( strPathFilename )
+            || !stream.Read ( info.uiSize )
+            || !stream.Read ( info.uiModifiedTime )
+            || !stream.Read ( info.checksum.ulCRC )
+            || !stream.ReadBytes ( info.checksum.md5.data, sizeof ( info.checksum.md5.data ) ) )
+        {
+            // Corrupt file - start again
+            m_InfoMap.clear ();
+            return;
+        }
+        MapSet ( m_InfoMap, strPathFilename, info );
+    }
+}
+
+
+///////////////////////////////////////////////////////////////
+//
+// CFileChecksumCache::Save
+//
+// Save entries used this session and release worker threads
+//
+///////////////////////////////////////////////////////////////
+void CFileChecksumCache::Save ( void )
+{
+    ReleaseWorkers ();
+
+    if ( !m_bDirty )
+        return;
+    m_bDirty = false;
+
+    // Drop entries for files which are no longer part of any resource
+    for ( std::map < SString, SFileInfo >::iterator iter = m_InfoMap.begin () ; iter != m_InfoMap.end () ; )
+    {
+        if ( !iter->second.bUsed )
+            m_InfoMap.erase ( iter++ );
+        else
+            ++iter;
+    }
+
+    CBuffer fileContents;
+    CBufferWriteStream stream ( fileContents );
+    stream.WriteString ( CHECKSUM_CACHE_ID );
+    stream.Write ( (uint)CHECKSUM_CACHE_VERSION );
+    stream.Write ( (uint)m_InfoMap.size () );
+
+    for ( std::map < SString, SFileInfo >::const_iterator iter = m_InfoMap.begin () ; iter != m_InfoMap.end () ; ++iter )
+    {
+        const SFileInfo& info = iter->second;
+        stream.WriteString ( iter->first );
+        stream.Write ( info.uiSize );
+        stream.Write ( info.uiModifiedTime );
+        stream.Write ( info.checksum.ulCRC );
+        stream.WriteBytes ( info.checksum.md5.data, sizeof ( info.checksum.md5.data ) );
+    }
+
+    MakeSureDirExists ( m_strCacheFilename );
+    fileContents.SaveToFile ( m_strCacheFilename );
+}
@@ -0,0 +1,50 @@
+/*****************************************************************************
+*
+*  PROJECT:     Multi Theft Auto v1.0
+*  LICENSE:     See LICENSE in the top level directory
+*  FILE:        mods/deathmatch/logic/CFileChecksumCache.h
+*  PURPOSE:     Persistent cache of file checksums keyed by path, size and modified time
+*
+*  Multi Theft Auto is available from http://www.multitheftauto.com/
+*
+*****************************************************************************/
+#pragma once
+
+//
+// Remembers the checksum of each file along with the size and modified time it had when it
+// was hashed. A file is only read again if its size or modified time has changed.
+// The cache is saved to resource-cache so it survives server restarts.
+// Main thread only.
+//
+class CFileChecksumCache
+{
+    struct SFileInfo
+    {
+        uint64      uiSize;
+        uint64      uiModifiedTime;
+        CChecksum   checksum;
+        bool        bUsed;      // Seen this session - unused entries are not saved
+    };
+
+public:
+    ZERO_ON_NEW
+                    CFileChecksumCache          ( void );
+                    ~CFileChecksumCache         ( void );
+
+    CChecksum       GetChecksum                 ( const SString& strPathFilename, uint64* pOutFileSize = NULL );
+    void            UpdateChecksum              ( const SString& strPathFilename, const CChecksum& checksum );
+    void            InvalidateChecksum          ( const SString& strPathFilename );
+    void            PrecacheChecksums           ( const std::vector < SString >& pathFilenameList );
+    void            Save                        ( void );
+
+protected:
+    void            Load                        ( void );
+    bool            IsEntryValid                ( const SString& strPathFilename, SFileInfo*& pOutInfo, uint64& uiOutSize, uint64& uiOutModifiedTime );
+    void            ReleaseWorkers              ( void );
+
+    std::map < SString, SFileInfo >     m_InfoMap;
+    SString                             m_strCacheFilename;
+    bool                                m_bDirty;
+    CAsyncTaskScheduler*                m_pWorkers;
+    CWorkSignal                         m_WorkDoneSignal;
+};
@@ -113,6 +113,7 @@ CGame::CGame ( void )
     m_pHandlingManager = NULL;
     m_pLuaManager = NULL;
     m_pPacketTranslator = NULL;
+    m_pPacketCompressor = NULL;
     m_pMarkerManager = NULL;
     m_pRadarAreaManager = NULL;
     m_pPlayerManager = NULL;
@@ -149,6 +150,9 @@ CGame::CGame ( void )
     m_pBuildingRemovalManager = NULL;
     m_pCustomWeaponManager = NULL;
     m_pFunctionUseLogger = NULL;
+    m_pSlowFrameRecorder = new CSlowFrameRecorder ();
+    m_pPacketRecorder = new CPacketRecorder ();
+    m_pSimClientNetServer = NULL;
 #ifdef WITH_OBJECT_SYNC
     m_pObjectSync = NULL;
 #endif
@@ -292,6 +296,7 @@ CGame::~CGame ( void )
     SAFE_DELETE ( m_pMapManager );
     SAFE_DELETE ( m_pRemoteCalls );
     SAFE_DELETE ( m_pPacketTranslator );
+    SAFE_DELETE ( m_pPacketCompressor );
     SAFE_DELETE ( m_pMarkerManager );
     SAFE_DELETE ( m_pRadarAreaManager );
     SAFE_DELETE ( m_pPlayerManager );
@@ -330,12 +335,24 @@ CGame::~CGame ( void )
     SAFE_DELETE ( m_pBuildingRemovalManager );
     SAFE_DELETE ( m_pCustomWeaponManager );
     SAFE_DELETE ( m_pFunctionUseLogger );
+    SAFE_DELETE ( m_pSlowFrameRecorder );
+    SAFE_DELETE ( m_pPacketRecorder );
     SAFE_DELETE ( m_pOpenPortsTester );
     SAFE_DELETE ( m_pMasterServerAnnouncer );
     SAFE_DELETE ( m_pASE );
     SAFE_RELEASE ( m_pHqComms );
     CSimControl::Shutdown ();
 
+    // Put the real net server back
+    if ( m_pSimClientNetServer )
+    {
+        g_pNetServer = g_pRealNetServer = g_pServerInterface->GetNetwork ();
+        SAFE_DELETE ( m_pSimClientNetServer );
+    }
+
+    // Write out anything still queued for the log files
+    CLogger::StopLogWriter ();
+
     // Clear our global pointer
     g_pGame = NULL;
 
@@ -392,6 +409,9 @@ void CGame::DoPulse ( void )
 
     UpdateModuleTickCount64 ();
 
+    m_pSlowFrameRecorder->FrameStart ();
+    TIMEUS pulseStartTime = GetTimeUs ();
+
     // Calculate FPS
     long long llCurrentTime = SharedUtil::GetModuleTickCount64 ();
     long long ulDiff = llCurrentTime - m_llLastFPSTime;
@@ -421,14 +441,16 @@ void CGame::DoPulse ( void )
 
     CLOCK_SET_SECTION( "CGame::DoPulse" );
     CLOCK1( "HTTPDownloadManager" );
-    GetRemoteCalls()->ProcessQueuedFiles();
-    g_pNetServer->GetHTTPDownloadManager ( EDownloadMode::ASE )->ProcessQueuedFiles ();
+    m_bHasPendingDownloads = !GetRemoteCalls()->ProcessQueuedFiles();
+    if ( !g_pNetServer->GetHTTPDownloadManager ( EDownloadMode::ASE )->ProcessQueuedFiles () )
+        m_bHasPendingDownloads = true;
     UNCLOCK1( "HTTPDownloadManager" );
 
     CLOCK_CALL1( m_pPlayerManager->DoPulse (); );
 
     // Pulse the net interface
     CLOCK_CALL1( g_pNetServer->DoPulse (); );
+    CLOCK_CALL1( m_pPacketRecorder->DoPulse (); );
 
     if ( m_pLanBroadcast )
     {
@@ -488,9 +510,17 @@ void CGame::DoPulse ( void )
 
     CLOCK_CALL1(m_pAsyncTaskScheduler->CollectResults());
 
+    // Send the element RPCs made during this pulse
+    CLOCK_CALL1( m_pPlayerManager->FlushElementRPCs (); );
+
     PrintLogOutputFromNetModule();
     m_pScriptDebugging->UpdateLogOutput();
 
+    m_pSlowFrameRecorder->FrameEnd ();
+
+    if ( m_pSimClientNetServer )
+        m_pSimClientNetServer->AddMainPulseTime ( GetTimeUs () - pulseStartTime );
+
     // Unlock the critical section again
     Unlock();
 }
@@ -518,6 +548,7 @@ bool CGame::Start ( int iArgumentCount, char* szArguments [] )
     m_pHandlingManager = new CHandlingManager;
     m_pVehicleManager = new CVehicleManager;
     m_pPacketTranslator = new CPacketTranslator ( m_pPlayerManager );
+    m_pPacketCompressor = new CPacketCompressor;
     m_pBanManager = new CBanManager;
     m_pTeamManager = new CTeamManager;
     m_pPedManager = new CPedManager;
@@ -613,7 +644,8 @@ bool CGame::Start ( int iArgumentCount, char* szArguments [] )
     unsigned int uiMaxPlayers = m_pMainConfig->GetMaxPlayers ();
 
     // Start async task scheduler
-    m_pAsyncTaskScheduler = new SharedUtil::CAsyncTaskScheduler(2);
+    m_pAsyncTaskScheduler = new SharedUtil::CAsyncTaskScheduler(2, 1024);     // Tasks are refused while 1024 are waiting to start
+    m_pAsyncTaskScheduler->SetResultSignal(&g_MainThreadWorkSignal);
 
     // Create the account manager
     strBuffer = g_pServerInterface->GetModManager ()->GetAbsolutePath ( "internal.db" );
@@ -854,6 +886,15 @@ bool CGame::Start ( int iArgumentCount, char* szArguments [] )
     // Load the accounts
     m_pAccountManager->Load ();
 
+    // Add simulated clients for load testing
+    if ( m_pMainConfig->GetSimClientCount () > 0 )
+    {
+        m_pSimClientNetServer = new CSimClientNetServer ( g_pRealNetServer );
+        m_pSimClientNetServer->SetClientCount ( m_pMainConfig->GetSimClientCount () );
+        g_pNetServer = g_pRealNetServer = m_pSimClientNetServer;
+        CLogger::LogPrintf ( "Simulated clients enabled: %d\n", m_pMainConfig->GetSimClientCount () );
+    }
+
     // Register our packethandler
     g_pNetServer->RegisterPacketHandler ( CGame::StaticProcessPacket );
 
@@ -990,6 +1031,19 @@ void CGame::StartOpenPortsTest ( void )
 
 
 bool CGame::StaticProcessPacket ( unsigned char ucPacketID, const NetServerPlayerID& Socket, NetBitStreamInterface* pBitStream, SNetExtraInfo* pNetExtraInfo )
+{
+    g_pGame->GetPacketRecorder ()->OnPacket ( ucPacketID, Socket, pBitStream );
+
+    TIMEUS startTime = GetTimeUs ();
+    bool bHandled = DispatchPacket ( ucPacketID, Socket, pBitStream, pNetExtraInfo );
+    TIMEUS deltaTimeUs = GetTimeUs () - startTime;
+    CPerfStatHandlerTiming::GetSingleton ()->UpdatePacketTiming ( ucPacketID, deltaTimeUs );
+    g_pGame->GetSlowFrameRecorder ()->OnPacket ( ucPacketID, deltaTimeUs );
+    return bHandled;
+}
+
+
+bool CGame::DispatchPacket ( unsigned char ucPacketID, const NetServerPlayerID& Socket, NetBitStreamInterface* pBitStream, SNetExtraInfo* pNetExtraInfo )
 {
     // Is it a join packet? Pass it to the handler immediately
     if ( ucPacketID == PACKET_ID_PLAYER_JOIN )
@@ -1019,8 +1073,8 @@ bool CGame::StaticProcessPacket ( unsigned char ucPacketID, const NetServerPlaye
         // Handle it
         bool bHandled = g_pGame->ProcessPacket ( *pPacket );
 
-        // Destroy the packet and return whether it could handle it or not
-        delete pPacket;
+        // Destroy (or recycle) the packet and return whether it could handle it or not
+        g_pGame->m_pPacketTranslator->ReleasePacket ( pPacket );
         return bHandled;
     }
 
@@ -2034,6 +2088,16 @@ void CGame::RelayPlayerPuresync ( CPacket& Packet )
             CPlayer* pSendPlayer = it->first;
             SViewerInfo& nearInfo = it->second;
 
+            // Less often if the other player's connection is struggling
+            if ( !pSendPlayer->IsTimeToReceiveScaledSync ( nearInfo.llLastUpdateTime, g_pBandwidthSettings->ZoneUpdateIntervals [ ZONE3 ] ) )
+            {
+                g_pStats->puresync.llSentPacketsByZone [ ZONE3 ]--;
+                g_pStats->puresync.llSentBytesByZone [ ZONE3 ] -= pPlayer->GetApproxPuresyncPacketSize ();
+                g_pStats->puresync.llSkippedPacketsByZone [ ZONE3 ]++;
+                g_pStats->puresync.llSkippedBytesByZone [ ZONE3 ] += pPlayer->GetApproxPuresyncPacketSize ();
+                continue;
+            }
+
             nearInfo.llLastUpdateTime = llTickCountNow;
             sendList.push_back ( pSendPlayer );
         }
@@ -4133,6 +4197,10 @@ void CGame::HandleBackup ( void )
 //
 void CGame::EnableLatentSends ( bool bEnabled, int iBandwidth, CLuaMain* pLuaMain, ushort usResourceNetId )
 {
+    // Waiting element RPCs were sent before this, so they should not become latent
+    if ( bEnabled && iBandwidth )
+        m_pPlayerManager->FlushElementRPCs ();
+
     m_bLatentSendsEnabled = bEnabled && iBandwidth;
     m_iLatentSendsBandwidth = iBandwidth;
     m_pLatentSendsLuaMain = pLuaMain;
@@ -4145,13 +4213,14 @@ void CGame::EnableLatentSends ( bool bEnabled, int iBandwidth, CLuaMain* pLuaMai
 //
 void CGame::SendPacketBatchBegin ( unsigned char ucPacketId, NetBitStreamInterface* pBitStream )
 {
+    m_bInSendPacketBatch = true;
     if ( m_bLatentSendsEnabled )
         GetLatentTransferManager ()->AddSendBatchBegin ( ucPacketId, pBitStream );
 }
 
 
 //
-// Maybe route though LatentTransferManager
+// Maybe compress or route though LatentTransferManager
 //
 bool CGame::SendPacket ( unsigned char ucPacketID, const NetServerPlayerID& playerID, NetBitStreamInterface* pBitStream, bool bBroadcast, NetServerPacketPriority packetPriority, NetServerPacketReliability packetReliability, ePacketOrdering packetOrdering )
 {
@@ -4166,7 +4235,21 @@ bool CGame::SendPacket ( unsigned char ucPacketID, const NetServerPlayerID& play
             pBitStream->ResetReadPointer();
             CPerfStatRPCPacketUsage::GetSingleton ()->UpdatePacketUsageOut( ucRpcId, pBitStream->GetNumberOfBytesUsed() );
         }
-        return g_pNetServer->SendPacket ( ucPacketID, playerID, pBitStream, bBroadcast, packetPriority, packetReliability, packetOrdering );
+
+        // Send big packets compressed if the client can handle it
+        bool bResult;
+        NetBitStreamInterface* pCompressedBitStream = NULL;
+        if ( m_pPacketCompressor )
+            pCompressedBitStream = m_pPacketCompressor->Compress ( ucPacketID, packetReliability, pBitStream );
+        if ( pCompressedBitStream )
+            bResult = g_pNetServer->SendPacket ( PACKET_ID_COMPRESSED, playerID, pCompressedBitStream, bBroadcast, packetPriority, packetReliability, packetOrdering );
+        else
+            bResult = g_pNetServer->SendPacket ( ucPacketID, playerID, pBitStream, bBroadcast, packetPriority, packetReliability, packetOrdering );
+
+        // Only keep the compressed copy while the same bitstream is being sent to a batch of players
+        if ( m_pPacketCompressor && !m_bInSendPacketBatch )
+            m_pPacketCompressor->ClearCache ();
+        return bResult;
     }
     else
         GetLatentTransferManager ()->AddSend ( playerID, pBitStream->Version (), m_iLatentSendsBandwidth, m_pLatentSendsLuaMain, m_usLatentSendsResourceNetId );
@@ -4179,6 +4262,9 @@ bool CGame::SendPacket ( unsigned char ucPacketID, const NetServerPlayerID& play
 //
 void CGame::SendPacketBatchEnd ( void )
 {
+    m_bInSendPacketBatch = false;
+    if ( m_pPacketCompressor )
+        m_pPacketCompressor->ClearCache ();
     if ( m_bLatentSendsEnabled )
         GetLatentTransferManager ()->AddSendBatchEnd ();
 }
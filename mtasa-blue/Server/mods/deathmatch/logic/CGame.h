@@ -91,6 +91,7 @@ class CMarkerManager;
 class CObjectManager;
 class CPacket;
 class CPacketTranslator;
+class CPacketCompressor;
 class CLatentTransferManager;
 class CDebugHookManager;
 class CPedManager;
@@ -124,6 +125,9 @@ class COpenPortsTester;
 class CMasterServerAnnouncer;
 class CHqComms;
 class CFunctionUseLogger;
+class CSlowFrameRecorder;
+class CPacketRecorder;
+class CSimClientNetServer;
 
 // Packet forward declarations
 class CCommandPacket;
@@ -214,6 +218,7 @@ public:
     void                        Stop                        ( void );
 
     static bool                 StaticProcessPacket         ( unsigned char ucPacketID, const NetServerPlayerID& Socket, NetBitStreamInterface* BitStream, SNetExtraInfo* pNetExtraInfo );
+    static bool                 DispatchPacket              ( unsigned char ucPacketID, const NetServerPlayerID& Socket, NetBitStreamInterface* BitStream, SNetExtraInfo* pNetExtraInfo );
     bool                        ProcessPacket               ( CPacket& Packet );
 
     inline void                 SetIsFinished               ( bool bFinished )  { m_bIsFinished = bFinished; };
@@ -242,6 +247,8 @@ public:
     inline CEvents*                 GetEvents                   ( void )        { return &m_Events; }
     inline CColManager*             GetColManager               ( void )        { return m_pColManager; }
     inline CLatentTransferManager*  GetLatentTransferManager    ( void )        { return m_pLatentTransferManager; }
+    inline CPacketTranslator*       GetPacketTranslator         ( void )        { return m_pPacketTranslator; }
+    inline CPacketCompressor*       GetPacketCompressor         ( void )        { return m_pPacketCompressor; }
     inline CDebugHookManager*       GetDebugHookManager         ( void )        { return m_pDebugHookManager; }
     inline CPedManager*             GetPedManager               ( void )        { return m_pPedManager; }
     inline CResourceManager*        GetResourceManager          ( void )        { return m_pResourceManager; }
@@ -265,6 +272,9 @@ public:
     inline CBuildingRemovalManager* GetBuildingRemovalManager   ( void )        { return m_pBuildingRemovalManager; }
     inline CCustomWeaponManager*    GetCustomWeaponManager      ( void )        { return m_pCustomWeaponManager; }
     inline CFunctionUseLogger*      GetFunctionUseLogger        ( void )        { return m_pFunctionUseLogger; }
+    inline CSlowFrameRecorder*      GetSlowFrameRecorder        ( void )        { return m_pSlowFrameRecorder; }
+    inline CPacketRecorder*         GetPacketRecorder           ( void )        { return m_pPacketRecorder; }
+    inline CSimClientNetServer*     GetSimClientNetServer       ( void )        { return m_pSimClientNetServer; }
     inline CMasterServerAnnouncer*  GetMasterServerAnnouncer    ( void )        { return m_pMasterServerAnnouncer; }
     inline SharedUtil::CAsyncTaskScheduler* GetAsyncTaskScheduler(void )        { return m_pAsyncTaskScheduler; }
 
@@ -385,6 +395,7 @@ public:
     void                        StartOpenPortsTest          ( void );
 
     bool                        IsServerFullyUp             ( void )        { return m_bServerFullyUp; }
+    bool                        HasPendingDownloads         ( void )        { return m_bHasPendingDownloads; }
 
     ushort                      GetServerFPS                ( void )        { return m_usFPS; }
     int                         GetSyncFPS                  ( void )        { return m_iSyncFPS; }
@@ -393,6 +404,7 @@ public:
     void                        HandleBackup                ( void );
     void                        HandleCrashDumpEncryption   ( void );
     void                        EnableLatentSends           ( bool bEnabled, int iBandwidth = 0, CLuaMain* pLuaMain = NULL, ushort usResourceNetId = 0xFFFF );
+    bool                        IsLatentSendsEnabled        ( void ) const      { return m_bLatentSendsEnabled; }
     void                        SendPacketBatchBegin        ( unsigned char ucPacketId, NetBitStreamInterface* pBitStream );
     bool                        SendPacket                  ( unsigned char ucPacketID, const NetServerPlayerID& playerID, NetBitStreamInterface* pBitStream, bool bBroadcast, NetServerPacketPriority packetPriority, NetServerPacketReliability packetReliability, ePacketOrdering packetOrdering = PACKET_ORDERING_DEFAULT );
     void                        SendPacketBatchEnd          ( void );
@@ -467,6 +479,7 @@ private:
     CRadarAreaManager*              m_pRadarAreaManager;
     CVehicleManager*                m_pVehicleManager;
     CPacketTranslator*              m_pPacketTranslator;
+    CPacketCompressor*              m_pPacketCompressor;
     CMapManager*                    m_pMapManager;
     CElementDeleter                 m_ElementDeleter;
     CConnectHistory                 m_FloodProtect;
@@ -508,6 +521,9 @@ private:
 
     CCustomWeaponManager*           m_pCustomWeaponManager;
     CFunctionUseLogger*             m_pFunctionUseLogger;
+    CSlowFrameRecorder*             m_pSlowFrameRecorder;
+    CPacketRecorder*                m_pPacketRecorder;
+    CSimClientNetServer*            m_pSimClientNetServer;
 
     char*                       m_szCurrentFileName;
 
@@ -585,7 +601,9 @@ private:
     CLightsyncManager           m_lightsyncManager;
 
     bool                        m_bServerFullyUp;       // No http operations should be allowed unless this is true
+    bool                        m_bHasPendingDownloads; // HTTP downloads are waiting or in progress
 
+    bool                        m_bInSendPacketBatch;
     bool                        m_bLatentSendsEnabled;
     int                         m_iLatentSendsBandwidth;
     CLuaMain*                   m_pLatentSendsLuaMain;
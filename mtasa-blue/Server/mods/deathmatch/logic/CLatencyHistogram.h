@@ -0,0 +1,116 @@
+/*****************************************************************************
+*
+*  PROJECT:     Multi Theft Auto v1.0
+*  LICENSE:     See LICENSE in the top level directory
+*  FILE:        mods/deathmatch/logic/CLatencyHistogram.h
+*  PURPOSE:     Fixed size log-scale histogram for timing samples
+*
+*  Multi Theft Auto is available from http://www.multitheftauto.com/
+*
+*****************************************************************************/
+#pragma once
+
+//
+// Records microsecond samples into log2 buckets split into 4 sub-buckets each,
+// so percentiles are accurate to about 25% without storing individual samples.
+// Not thread safe.
+//
+class CLatencyHistogram
+{
+public:
+    enum { NUM_BUCKETS = 4 + 4 * 30 };   // Covers up to about 30 minutes
+
+    CLatencyHistogram ( void )
+    {
+        Clear ();
+    }
+
+    void Clear ( void )
+    {
+        memset ( m_BucketCounts, 0, sizeof ( m_BucketCounts ) );
+        m_uiCount = 0;
+        m_MaxUs = 0;
+        m_TotalUs = 0;
+    }
+
+    void AddSample ( TIMEUS timeUs )
+    {
+        m_BucketCounts [ GetBucketIndex ( timeUs ) ]++;
+        m_uiCount++;
+        m_TotalUs += timeUs;
+        m_MaxUs = std::max ( m_MaxUs, timeUs );
+    }
+
+    void Merge ( const CLatencyHistogram& other )
+    {
+        for ( uint i = 0 ; i < NUM_BUCKETS ; i++ )
+            m_BucketCounts [ i ] += other.m_BucketCounts [ i ];
+        m_uiCount += other.m_uiCount;
+        m_TotalUs += other.m_TotalUs;
+        m_MaxUs = std::max ( m_MaxUs, other.m_MaxUs );
+    }
+
+    // fPercentile is in the range 0 to 100
+    TIMEUS GetPercentile ( float fPercentile ) const
+    {
+        if ( m_uiCount == 0 )
+            return 0;
+
+        uint uiTarget = static_cast < uint > ( m_uiCount * Clamp ( 0.f, fPercentile, 100.f ) / 100.f );
+        uint uiAccumulated = 0;
+        for ( uint i = 0 ; i < NUM_BUCKETS ; i++ )
+        {
+            uiAccumulated += m_BucketCounts [ i ];
+            if ( uiAccumulated > uiTarget )
+                return std::min ( GetBucketUpperBound ( i ), m_MaxUs );
+        }
+        return m_MaxUs;
+    }
+
+    uint    GetCount        ( void ) const      { return m_uiCount; }
+    TIMEUS  GetMax          ( void ) const      { return m_MaxUs; }
+    TIMEUS  GetTotal        ( void ) const      { return static_cast < TIMEUS > ( m_TotalUs ); }
+    TIMEUS  GetAverage      ( void ) const      { return m_uiCount ? static_cast < TIMEUS > ( m_TotalUs / m_uiCount ) : 0; }
+
+    // Format as "p50/p99/max" in milliseconds
+    SString GetSummaryString ( void ) const
+    {
+        if ( m_uiCount == 0 )
+            return "-";
+        return SString ( "%s / %s / %s ms", *FormatMs ( GetPercentile ( 50 ) ), *FormatMs ( GetPercentile ( 99 ) ), *FormatMs ( m_MaxUs ) );
+    }
+
+    static SString FormatMs ( TIMEUS timeUs )
+    {
+        return SString ( timeUs < 10000 ? "%.2f" : "%.0f", timeUs / 1000.0 );
+    }
+
+protected:
+    static uint GetBucketIndex ( TIMEUS timeUs )
+    {
+        if ( timeUs < 4 )
+            return static_cast < uint > ( timeUs );
+
+        uint uiMsb = 0;
+        for ( uint64 value = timeUs ; value > 1 ; value >>= 1 )
+            uiMsb++;
+
+        uint uiSub = static_cast < uint > ( timeUs >> ( uiMsb - 2 ) ) & 3;
+        return std::min < uint > ( 4 + ( uiMsb - 2 ) * 4 + uiSub, NUM_BUCKETS - 1 );
+    }
+
+    static TIMEUS GetBucketUpperBound ( uint uiIndex )
+    {
+        if ( uiIndex < 4 )
+            return uiIndex;
+
+        uint uiMsb = ( uiIndex - 4 ) / 4 + 2;
+        uint uiSub = ( uiIndex - 4 ) % 4;
+        return static_cast < TIMEUS > ( ( ( 4ULL + uiSub + 1 ) << ( uiMsb - 2 ) ) - 1 );
+    }
+
+    uint        m_BucketCounts [ NUM_BUCKETS ];
+    uint        m_uiCount;
+    TIMEUS      m_MaxUs;
+    uint64      m_TotalUs;
+};
@@ -14,6 +14,7 @@
 
 CLightsyncManager::CLightsyncManager ()
 {
+    m_uiFragmentContext = 0;
 }
 
 CLightsyncManager::~CLightsyncManager ()
@@ -35,31 +36,20 @@ void CLightsyncManager::RegisterPlayer ( CPlayer* pPlayer )
 
 CPlayer* CLightsyncManager::FindPlayer ( const char* szArguments )
 {    
-    for ( std::list<SEntry>::iterator iter = m_Queue.begin();
-          iter != m_Queue.end (); )
+    for ( uint i = 0 ; i < m_Queue.size () ; i++ )
     {
-        SEntry& entry = *iter;
+        SEntry& entry = m_Queue[i];
         if ( strcmp ( entry.pPlayer->GetNick ( ), szArguments ) == 0 )
         {
             return entry.pPlayer;
         }
-
-         ++iter;
     }
     return NULL;
 }
 
 void CLightsyncManager::UnregisterPlayer ( CPlayer* pPlayer )
 {
-    for ( std::list<SEntry>::iterator iter = m_Queue.begin();
-          iter != m_Queue.end (); )
-    {
-        SEntry& entry = *iter;
-        if ( entry.pPlayer == pPlayer )
-            m_Queue.erase ( iter++ );
-        else
-            ++iter;
-    }
+    m_Queue.remove_if ( [pPlayer] ( const SEntry& entry ) { return entry.pPlayer == pPlayer; } );
 }
 
 void CLightsyncManager::DoPulse ()
@@ -78,6 +68,13 @@ void CLightsyncManager::DoPulse ()
     // reaches that special entry again. As there might be multiple changes in a complete queue cycle, we
     // are also storing the delta context in what it happened, so we only consider the health unchanged
     // when we find the marker with the same context value.
+    //
+    // Each player's record is the same for everyone who receives it, so it is encoded once per pulse
+    // into a fragment which the packets then copy. Anything which changes the record during the pulse
+    // (the delta flags) invalidates the fragment.
+    //
+    // Players on struggling connections are skipped for some turns (see CPlayerManager::PulseSyncRates),
+    // so markers are sent round again until the slowest of them has had a turn.
 
     if ( g_pBandwidthSettings->bLightSyncEnabled == false )
         return;
@@ -90,6 +87,13 @@ void CLightsyncManager::DoPulse ()
     long iLimitCounter = std::max < uint > ( 10, g_pGame->GetPlayerManager ()->Count () / 25 );
     int iLightsyncRate = g_TickRateSettings.iLightSync;
     long long llTickCountNow = GetTickCount64_ ();
+    uint uiHighestScale = g_pGame->GetPlayerManager ()->GetHighestSyncRateScale ();
+    long long llMarkerLifeTime = uiHighestScale > 100 ? iLightsyncRate * (long long)uiHighestScale / 100 : 0;
+
+    // New fragments for this pulse
+    if ( ++m_uiFragmentContext == 0 )
+        m_uiFragmentContext = 1;
+
     while ( m_Queue.size() > 0 && m_Queue.front().ullTime + iLightsyncRate <= llTickCountNow && iLimitCounter > 0 )
     {
         SEntry entry = m_Queue.front ();
@@ -102,7 +106,16 @@ void CLightsyncManager::DoPulse ()
         {
             case SYNC_PLAYER:
             {
-                CLightsyncPacket packet;
+                // Less often if this player's connection is struggling
+                CPlayer::SSyncRateData& rateData = pPlayer->GetSyncRateData ();
+                if ( !pPlayer->IsTimeToReceiveScaledSync ( rateData.llLastLightSyncTime, iLightsyncRate ) )
+                {
+                    RegisterPlayer ( pPlayer );
+                    break;
+                }
+                rateData.llLastLightSyncTime = GetModuleTickCount64 ();
+
+                CLightsyncPacket packet ( m_uiFragmentContext );
 
                 // Use this players far list
                 const SViewerMapType& farList = pPlayer->GetFarPlayerList ();
@@ -127,10 +140,12 @@ void CLightsyncManager::DoPulse ()
                             currentData.health.fLastArmor = pCurrent->GetArmor ();
                             currentData.health.bSync = true;
                             currentData.health.uiContext++;
+                            currentData.fragment.Invalidate ();
 
                             // Generate the health marker
                             SEntry marker;
                             marker.ullTime = 0;
+                            marker.ullCreated = llTickCountNow;
                             marker.pPlayer = pCurrent;
                             marker.eType = DELTA_MARKER_HEALTH;
                             marker.uiContext = currentData.health.uiContext;
@@ -147,10 +162,12 @@ void CLightsyncManager::DoPulse ()
                                 currentData.vehicleHealth.lastVehicle = pVehicle;
                                 currentData.vehicleHealth.bSync = true;
                                 currentData.vehicleHealth.uiContext++;
+                                currentData.fragment.Invalidate ();
 
                                 // Generate the vehicle health marker
                                 SEntry marker;
                                 marker.ullTime = 0;
+                                marker.ullCreated = llTickCountNow;
                                 marker.pPlayer = pCurrent;
                                 marker.eType = DELTA_MARKER_VEHICLE_HEALTH;
                                 marker.uiContext = currentData.vehicleHealth.uiContext;
@@ -180,16 +197,22 @@ void CLightsyncManager::DoPulse ()
 
             case DELTA_MARKER_HEALTH:
             {
-                if ( data.health.uiContext == entry.uiContext )
+                if ( data.health.uiContext == entry.uiContext && !KeepMarker ( entry, llTickCountNow, llMarkerLifeTime ) )
+                {
                     data.health.bSync = false;
+                    data.fragment.Invalidate ();
+                }
 
                 break;
             }
 
             case DELTA_MARKER_VEHICLE_HEALTH:
             {
-                if ( data.vehicleHealth.uiContext == entry.uiContext )
+                if ( data.vehicleHealth.uiContext == entry.uiContext && !KeepMarker ( entry, llTickCountNow, llMarkerLifeTime ) )
+                {
                     data.vehicleHealth.bSync = false;
+                    data.fragment.Invalidate ();
+                }
 
                 break;
             }
@@ -204,3 +227,16 @@ void CLightsyncManager::DoPulse ()
     g_pStats->lightsync.llSyncPacketsSkipped -= iPacketsSent;
     g_pStats->lightsync.llSyncBytesSkipped -= iBitsSent / 8;
 }
+
+
+// Send a marker round the queue again if it is younger than llLifeTime
+bool CLightsyncManager::KeepMarker ( SEntry& entry, long long llTickCountNow, long long llLifeTime )
+{
+    if ( llTickCountNow - entry.ullCreated >= llLifeTime )
+        return false;
+
+    // Due again after one more turn, so it does not hold up the queue
+    entry.ullTime = llTickCountNow;
+    m_Queue.push_back ( entry );
+    return true;
+}
@@ -12,8 +12,6 @@
 
 #pragma once
 
-#include <list>
-
 #ifndef _MSC_VER
 #include <stdint.h>
 typedef int64_t __int64;
@@ -45,10 +43,14 @@ private:
     struct SEntry
     {
         __int64             ullTime;
+        __int64             ullCreated;         // Markers only
         CPlayer*            pPlayer;
         EEntryType          eType;
         unsigned int        uiContext;
     };
 
-    std::list < SEntry >     m_Queue;
+    bool            KeepMarker              ( SEntry& entry, long long llTickCountNow, long long llLifeTime );
+
+    CRingBuffer < SEntry >  m_Queue;
+    unsigned int            m_uiFragmentContext;
 };
@@ -0,0 +1,316 @@
+/*****************************************************************************
+*
+*  PROJECT:     Multi Theft Auto v1.0
+*  LICENSE:     See LICENSE in the top level directory
+*  FILE:        mods/deathmatch/logic/CLogWriter.cpp
+*  PURPOSE:     Background writer for log files
+*
+*  Multi Theft Auto is available from http://www.multitheftauto.com/
+*
+*****************************************************************************/
+
+#include "StdInc.h"
+
+
+///////////////////////////////////////////////////////////////
+//
+// CLogWriter::CLogWriter
+//
+//
+//
+///////////////////////////////////////////////////////////////
+CLogWriter::CLogWriter ( void )
+{
+    m_Ring.resize ( LOG_WRITER_MAX_QUEUED_LINES );
+    m_uiHead = 0;
+    m_uiCount = 0;
+    m_uiQueuedBytes = 0;
+    m_bThreadRunning = false;
+    m_bStopThread = false;
+    m_bWriterWaiting = false;
+    m_uiNumDropped = 0;
+    m_uiNumDroppedUnreported = 0;
+    m_pDroppedFile = NULL;
+    m_uiNumBatches = 0;
+    m_uiNumLines = 0;
+    m_tTimeStamp = 0;
+}
+
+
+///////////////////////////////////////////////////////////////
+//
+// CLogWriter::~CLogWriter
+//
+//
+//
+///////////////////////////////////////////////////////////////
+CLogWriter::~CLogWriter ( void )
+{
+    StopThread ();
+}
+
+
+///////////////////////////////////////////////////////////////
+//
+// CLogWriter::StartThread
+//
+//
+//
+///////////////////////////////////////////////////////////////
+void CLogWriter::StartThread ( void )
+{
+    std::lock_guard < std::mutex > lock ( m_Mutex );
+    if ( !m_bThreadRunning && !m_Thread.joinable () )
+    {
+        m_bThreadRunning = true;
+        m_Thread = std::thread ( &CLogWriter::ThreadProc, this );
+    }
+}
+
+
+///////////////////////////////////////////////////////////////
+//
+// CLogWriter::StopThread
+//
+// Write everything still queued and stop the thread
+// Writes after this are done immediately by the calling thread
+//
+///////////////////////////////////////////////////////////////
+void CLogWriter::StopThread ( void )
+{
+    if ( !m_Thread.joinable () )
+        return;
+
+    {
+        std::lock_guard < std::mutex > lock ( m_Mutex );
+        m_bStopThread = true;
+        m_Signal.notify_all ();
+    }
+
+    m_Thread.join ();
+    m_bStopThread = false;
+}
+
+
+///////////////////////////////////////////////////////////////
+//
+// CLogWriter::Write
+//
+// Queue text to be appended to the file
+//
+///////////////////////////////////////////////////////////////
+void CLogWriter::Write ( FILE* pFile, const SString& strText )
+{
+    if ( pFile && !strText.empty () )
+        Push ( pFile, strText, false );
+}
+
+
+///////////////////////////////////////////////////////////////
+//
+// CLogWriter::Close
+//
+// Queue closing of the file after everything before it has been written
+//
+///////////////////////////////////////////////////////////////
+void CLogWriter::Close ( FILE* pFile )
+{
+    if ( pFile )
+        Push ( pFile, "", true );
+}
+
+
+///////////////////////////////////////////////////////////////
+//
+// CLogWriter::Push
+//
+// Add an entry to the ring buffer
+// Lines are dropped when the buffer is full, but closes wait for space
+//
+///////////////////////////////////////////////////////////////
+void CLogWriter::Push ( FILE* pFile, const SString& strText, bool bClose )
+{
+    std::unique_lock < std::mutex > lock ( m_Mutex );
+
+    if ( !m_bThreadRunning )
+    {
+        // No writer thread, so do it now
+        lock.unlock ();
+        std::vector < SEntry > entryList ( 1 );
+        entryList[0].pFile = pFile;
+        entryList[0].strText = strText;
+        entryList[0].bClose = bClose;
+        WriteEntries ( entryList );
+        return;
+    }
+
+    if ( !bClose && ( m_uiCount + 1 >= m_Ring.size () || m_uiQueuedBytes + strText.length () > LOG_WRITER_MAX_QUEUED_BYTES ) )
+    {
+        // Leave a slot for the dropped lines warning
+        if ( m_uiNumDroppedUnreported++ == 0 )
+            m_pDroppedFile = pFile;
+        m_uiNumDropped++;
+        return;
+    }
+
+    while ( m_uiCount + 2 > m_Ring.size () )
+        m_Signal.wait ( lock );
+
+    if ( m_uiNumDroppedUnreported )
+    {
+        SString strTimeStampShort, strTimeStampLong;
+        GetTimeStamps ( strTimeStampShort, strTimeStampLong );
+
+        SEntry& entry = m_Ring[ ( m_uiHead + m_uiCount++ ) % m_Ring.size () ];
+        entry.pFile = m_pDroppedFile;
+        entry.strText = SString ( "%sWARNING: %u log lines were dropped as the log file could not keep up\n", *strTimeStampLong, m_uiNumDroppedUnreported );
+        entry.bClose = false;
+        m_uiQueuedBytes += entry.strText.length ();
+        m_uiNumDroppedUnreported = 0;
+        m_pDroppedFile = NULL;
+    }
+
+    SEntry& entry = m_Ring[ ( m_uiHead + m_uiCount++ ) % m_Ring.size () ];
+    entry.pFile = pFile;
+    entry.strText = strText;
+    entry.bClose = bClose;
+    m_uiQueuedBytes += strText.length ();
+
+    // Only wake the writer if it is idle, it will check for more entries after each batch anyway
+    if ( m_bWriterWaiting )
+        m_Signal.notify_all ();
+}
+
+
+///////////////////////////////////////////////////////////////
+//
+// CLogWriter::ThreadProc
+//
+// Take everything queued and write it as a batch, flushing each file once per batch
+//
+///////////////////////////////////////////////////////////////
+void CLogWriter::ThreadProc ( void )
+{
+    std::vector < SEntry > batchList;
+
+    std::unique_lock < std::mutex > lock ( m_Mutex );
+    while ( true )
+    {
+        if ( m_uiCount == 0 )
+        {
+            if ( m_bStopThread )
+            {
+                m_bThreadRunning = false;
+                break;
+            }
+            m_bWriterWaiting = true;
+            m_Signal.wait ( lock );
+            m_bWriterWaiting = false;
+            continue;
+        }
+
+        // Move out of the ring buffer so the lock is not held while writing
+        batchList.resize ( m_uiCount );
+        for ( uint i = 0 ; i < m_uiCount ; i++ )
+        {
+            SEntry& entry = m_Ring[ ( m_uiHead + i ) % m_Ring.size () ];
+            batchList[i].pFile = entry.pFile;
+            batchList[i].bClose = entry.bClose;
+            batchList[i].strText.swap ( entry.strText );
+        }
+        m_uiHead = ( m_uiHead + m_uiCount ) % m_Ring.size ();
+        m_uiCount = 0;
+        m_uiQueuedBytes = 0;
+        m_uiNumBatches++;
+        m_uiNumLines += batchList.size ();
+
+        // Wake anything waiting for space
+        m_Signal.notify_all ();
+        lock.unlock ();
+
+        WriteEntries ( batchList );
+
+        // Keep string buffers for reuse
+        for ( uint i = 0 ; i < batchList.size () ; i++ )
+            batchList[i].strText.clear ();
+
+        lock.lock ();
+    }
+}
+
+
+///////////////////////////////////////////////////////////////
+//
+// CLogWriter::WriteEntries
+//
+//
+//
+///////////////////////////////////////////////////////////////
+void CLogWriter::WriteEntries ( std::vector < SEntry >& entryList )
+{
+    std::vector < FILE* > dirtyList;
+    for ( uint i = 0 ; i < entryList.size () ; i++ )
+    {
+        const SEntry& entry = entryList[i];
+        if ( entry.bClose )
+        {
+            ListRemove ( dirtyList, entry.pFile );
+            fclose ( entry.pFile );
+        }
+        else
+        {
+            fwrite ( entry.strText.data (), 1, entry.strText.length (), entry.pFile );
+            if ( !ListContains ( dirtyList, entry.pFile ) )
+                dirtyList.push_back ( entry.pFile );
+        }
+    }
+
+    for ( uint i = 0 ; i < dirtyList.size () ; i++ )
+        fflush ( dirtyList[i] );
+}
+
+
+///////////////////////////////////////////////////////////////
+//
+// CLogWriter::GetTimeStamps
+//
+// Get "[H:M:S] " and "[Y-m-d H:M:S] " for the current time
+//
+///////////////////////////////////////////////////////////////
+void CLogWriter::GetTimeStamps ( SString& strOutShort, SString& strOutLong )
+{
+    time_t timeNow = time ( NULL );
+
+    LOCK_SCOPE ( m_TimeStampCS );
+    if ( timeNow != m_tTimeStamp || m_strTimeStampLong.empty () )
+    {
+        m_tTimeStamp = timeNow;
+        char szBuffer [64];
+        tm* pCurrentTime = localtime ( &timeNow );
+        if ( !strftime ( szBuffer, sizeof ( szBuffer ) - 1, "[%H:%M:%S] ", pCurrentTime ) )
+            szBuffer[0] = 0;
+        m_strTimeStampShort = szBuffer;
+        if ( !strftime ( szBuffer, sizeof ( szBuffer ) - 1, "[%Y-%m-%d %H:%M:%S] ", pCurrentTime ) )
+            szBuffer[0] = 0;
+        m_strTimeStampLong = szBuffer;
+    }
+    strOutShort = m_strTimeStampShort;
+    strOutLong = m_strTimeStampLong;
+}
+
+
+///////////////////////////////////////////////////////////////
+//
+// CLogWriter::GetStats
+//
+//
+//
+///////////////////////////////////////////////////////////////
+void CLogWriter::GetStats ( SLogWriterStats& outStats )
+{
+    std::lock_guard < std::mutex > lock ( m_Mutex );
+    outStats.uiNumQueued = m_uiCount;
+    outStats.uiNumDropped = m_uiNumDropped;
+    outStats.uiNumBatches = m_uiNumBatches;
+    outStats.uiNumLines = m_uiNumLines;
+}
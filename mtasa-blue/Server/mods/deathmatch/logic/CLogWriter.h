@@ -0,0 +1,80 @@
+/*****************************************************************************
+*
+*  PROJECT:     Multi Theft Auto v1.0
+*  LICENSE:     See LICENSE in the top level directory
+*  FILE:        mods/deathmatch/logic/CLogWriter.h
+*  PURPOSE:     Background writer for log files
+*
+*  Multi Theft Auto is available from http://www.multitheftauto.com/
+*
+*****************************************************************************/
+#pragma once
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+#define LOG_WRITER_MAX_QUEUED_LINES     8192
+#define LOG_WRITER_MAX_QUEUED_BYTES     ( 8 * 1024 * 1024 )
+
+struct SLogWriterStats
+{
+    uint        uiNumQueued;
+    uint        uiNumDropped;
+    uint        uiNumBatches;
+    uint        uiNumLines;
+};
+
+//
+// Queues log file writes in a bounded ring buffer, and writes them in batches from a background thread
+// If the queue is full, lines are dropped and a warning is written once the writer catches up
+//
+class CLogWriter
+{
+public:
+                                CLogWriter              ( void );
+                                ~CLogWriter             ( void );
+
+    void                        StartThread             ( void );
+    void                        StopThread              ( void );
+
+    void                        Write                   ( FILE* pFile, const SString& strText );
+    void                        Close                   ( FILE* pFile );
+    void                        GetTimeStamps           ( SString& strOutShort, SString& strOutLong );
+    void                        GetStats                ( SLogWriterStats& outStats );
+
+protected:
+    struct SEntry
+    {
+        FILE*       pFile;
+        SString     strText;
+        bool        bClose;
+    };
+
+    void                        Push                    ( FILE* pFile, const SString& strText, bool bClose );
+    static void                 WriteEntries            ( std::vector < SEntry >& entryList );
+    void                        ThreadProc              ( void );
+
+    // Shared between threads
+    std::mutex                  m_Mutex;
+    std::condition_variable     m_Signal;
+    std::vector < SEntry >      m_Ring;
+    uint                        m_uiHead;
+    uint                        m_uiCount;
+    uint                        m_uiQueuedBytes;
+    bool                        m_bThreadRunning;
+    bool                        m_bStopThread;
+    bool                        m_bWriterWaiting;
+    uint                        m_uiNumDropped;
+    uint                        m_uiNumDroppedUnreported;
+    FILE*                       m_pDroppedFile;
+    uint                        m_uiNumBatches;
+    uint                        m_uiNumLines;
+    std::thread                 m_Thread;
+
+    // Time stamp strings are only formatted once per second
+    CCriticalSection            m_TimeStampCS;
+    time_t                      m_tTimeStamp;
+    SString                     m_strTimeStampShort;
+    SString                     m_strTimeStampLong;
+};
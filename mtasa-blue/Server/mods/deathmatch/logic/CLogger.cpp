@@ -21,6 +21,7 @@ bool CLogger::m_bPrintingDots = false;
 SString CLogger::m_strCaptureBuffer;
 bool CLogger::m_bCaptureConsole = false;
 CCriticalSection CLogger::m_CaptureBufferMutex;
+CLogWriter CLogger::ms_LogWriter;
 
 #define MAX_STRING_LENGTH 2048
 void CLogger::LogPrintf ( const char* szFormat, ... )
@@ -135,7 +136,7 @@ bool CLogger::SetLogFile ( const char* szLogFile )
     // Eventually delete our current file
     if ( m_pLogFile )
     {
-        fclose ( m_pLogFile );
+        ms_LogWriter.Close ( m_pLogFile );
         m_pLogFile = NULL;
     }
 
@@ -145,8 +146,9 @@ bool CLogger::SetLogFile ( const char* szLogFile )
         // Make sure the path to it exists
         MakeSureDirExists ( szLogFile );
 
-        // Create the file
+        // Create the file and make sure there is something to write it
         m_pLogFile = File::Fopen ( szLogFile, "a+" );
+        StartLogWriter ();
         return m_pLogFile != NULL;
     }
 
@@ -160,7 +162,7 @@ bool CLogger::SetAuthFile ( const char* szAuthFile )
     // Eventually delete our current file
     if ( m_pAuthFile )
     {
-        fclose ( m_pAuthFile );
+        ms_LogWriter.Close ( m_pAuthFile );
         m_pAuthFile = NULL;
     }
 
@@ -240,29 +242,21 @@ void CLogger::HandleLogPrint ( bool bTimeStamp, const char* szPrePend, const cha
         ProgressDotsEnd ();
 
     // Put the timestamp at the beginning of the string
-    string strOutputShort;
-    string strOutputLong;
+    SString strTimeStampShort;
+    SString strTimeStampLong;
     if ( bTimeStamp )
-    {
-        char szBuffer [MAX_STRING_LENGTH] = { "\0" };
-        time_t timeNow;
-        time ( &timeNow );
-        tm* pCurrentTime = localtime ( &timeNow );
-        if ( !strftime ( szBuffer, MAX_STRING_LENGTH - 1, "[%H:%M:%S] ", pCurrentTime ) )
-            szBuffer[0] = 0;
-        strOutputShort = szBuffer;
-        if ( !strftime ( szBuffer, MAX_STRING_LENGTH - 1, "[%Y-%m-%d %H:%M:%S] ", pCurrentTime ) )
-            szBuffer[0] = 0;
-        strOutputLong = szBuffer;
-    }
-
-    // Build the final string
-    strOutputShort = strOutputShort + szPrePend + szMessage;
-    strOutputLong = strOutputLong + szPrePend + szMessage;
+        ms_LogWriter.GetTimeStamps ( strTimeStampShort, strTimeStampLong );
 
     // Maybe print it in the console
     if ( bToConsole )
-        g_pServerInterface->Printf ( "%s", strOutputShort.c_str () );
+    {
+        SString strOutputShort;
+        strOutputShort.reserve ( strTimeStampShort.length () + strlen ( szPrePend ) + strlen ( szMessage ) );
+        strOutputShort += strTimeStampShort;
+        strOutputShort += szPrePend;
+        strOutputShort += szMessage;
+        g_pServerInterface->Printf ( "%s", *strOutputShort );
+    }
 
     // Maybe print to temp buffer
     if ( bToConsole && m_bCaptureConsole )
@@ -275,17 +269,54 @@ void CLogger::HandleLogPrint ( bool bTimeStamp, const char* szPrePend, const cha
         m_CaptureBufferMutex.Unlock ();
     }
 
-    // Maybe print it to the log file
-    if ( bToLogFile && m_pLogFile )
+    // Maybe print it to the log file and/or auth file
+    FILE* pLogFile = bToLogFile ? m_pLogFile : NULL;
+    FILE* pAuthFile = bToAuthFile ? m_pAuthFile : NULL;
+    if ( pLogFile || pAuthFile )
     {
-        fprintf ( m_pLogFile, "%s", strOutputLong.c_str () );
-        fflush ( m_pLogFile );
+        SString strOutputLong;
+        strOutputLong.reserve ( strTimeStampLong.length () + strlen ( szPrePend ) + strlen ( szMessage ) );
+        strOutputLong += strTimeStampLong;
+        strOutputLong += szPrePend;
+        strOutputLong += szMessage;
+        ms_LogWriter.Write ( pLogFile, strOutputLong );
+        ms_LogWriter.Write ( pAuthFile, strOutputLong );
     }
+}
 
-    // Maybe print it to the auth file
-    if ( bToAuthFile && m_pAuthFile )
-    {
-        fprintf ( m_pAuthFile, "%s", strOutputLong.c_str () );
-        fflush ( m_pAuthFile );
-    }
+
+//
+// Log file writes are done by a background thread while it is running
+//
+void CLogger::StartLogWriter ( void )
+{
+    ms_LogWriter.StartThread ();
+}
+
+void CLogger::StopLogWriter ( void )
+{
+    ms_LogWriter.StopThread ();
+}
+
+void CLogger::WriteToFile ( FILE* pFile, const SString& strText )
+{
+    ms_LogWriter.Write ( pFile, strText );
+}
+
+void CLogger::CloseFile ( FILE* pFile )
+{
+    ms_LogWriter.Close ( pFile );
+}
+
+// Returns "[Y-m-d H:M:S] "
+SString CLogger::GetTimeStamp ( void )
+{
+    SString strTimeStampShort, strTimeStampLong;
+    ms_LogWriter.GetTimeStamps ( strTimeStampShort, strTimeStampLong );
+    return strTimeStampLong;
+}
+
+void CLogger::GetLogWriterStats ( SLogWriterStats& outStats )
+{
+    ms_LogWriter.GetStats ( outStats );
 }
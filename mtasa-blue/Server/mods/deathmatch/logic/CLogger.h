@@ -22,6 +22,9 @@ enum eLogLevel
     LOGLEVEL_MEDIUM    = 2,
 };
 
+class CLogWriter;
+struct SLogWriterStats;
+
 class CLogger
 {
 public:
@@ -50,6 +53,13 @@ public:
     static void         BeginConsoleOutputCapture  ( void );
     static SString      EndConsoleOutputCapture    ( void );
 
+    static void         StartLogWriter      ( void );
+    static void         StopLogWriter       ( void );
+    static void         WriteToFile         ( FILE* pFile, const SString& strText );
+    static void         CloseFile           ( FILE* pFile );
+    static SString      GetTimeStamp        ( void );
+    static void         GetLogWriterStats   ( SLogWriterStats& outStats );
+
 private:
     static void         HandleLogPrint     ( bool bTimeStamp, const char* szPrePend, const char* szMessage, bool bToConsole, bool bToLogFile, bool bToAuthFile, eLogLevel logLevel = LOGLEVEL_MEDIUM );
 
@@ -60,6 +70,7 @@ private:
     static SString      m_strCaptureBuffer;
     static bool         m_bCaptureConsole;
     static CCriticalSection m_CaptureBufferMutex;
+    static CLogWriter   ms_LogWriter;
 };
 
 #endif
@@ -836,7 +836,12 @@ bool CMainConfig::LoadExtended ( void )
     RegisterCommand ( "authserial", CConsoleCommands::AuthorizeSerial, false );
     RegisterCommand ( "debugjoinflood", CConsoleCommands::DebugJoinFlood, false );
     RegisterCommand ( "debuguptime", CConsoleCommands::DebugUpTime, false );
+    RegisterCommand ( "debugeventbench", CConsoleCommands::DebugEventBench, false );
+    RegisterCommand ( "debugqueuebench", CConsoleCommands::DebugQueueBench, false );
     RegisterCommand ( "sfakelag", CConsoleCommands::FakeLag, false );
+    RegisterCommand ( "capturepackets", CConsoleCommands::CapturePackets, false );
+    RegisterCommand ( "replaypackets", CConsoleCommands::ReplayPackets, false );
+    RegisterCommand ( "simclients", CConsoleCommands::SimClients, false );
     return true;
 }
 
@@ -1521,6 +1526,11 @@ const std::vector < SIntSetting >& CMainConfig::GetIntSettingList ( void )
             { true, true,   0,      1,      1,      "filter_duplicate_log_lines",           &m_bFilterDuplicateLogLinesEnabled,         NULL },
             { false, false, 0,      1,      1,      "database_credentials_protection",      &m_bDatabaseCredentialsProtectionEnabled,   NULL },
             { false, false, 0,      0,      1,      "fakelag",                              &m_bFakeLagCommandEnabled,                  NULL },
+            { true, true,   0,      0,      10000,  "slow_frame_log_threshold",             &m_iSlowFrameLogThreshold,                  NULL },
+            { false, false, 0,      0,      4096,   "sim_clients",                          &m_iSimClientCount,                         NULL },
+            { true, true,   0,      4096,   1048576, "packet_compression_threshold",        &m_iPacketCompressionThreshold,             NULL },
+            { true, true,   0,      0,      1000000000, "latent_send_bandwidth_limit",       &m_iLatentSendBandwidthLimit,               NULL },
+            { true, true,   100,    200,    1000,   "sync_rate_max_scale",                  &m_iSyncRateMaxScale,                       NULL },
         };
 
     static std::vector < SIntSetting > settingsList;
@@ -133,6 +133,11 @@ public:
     const std::vector< SString >&   GetOwnerEmailAddressList        ( void ) const                      { return m_OwnerEmailAddressList; }
     bool                            IsDatabaseCredentialsProtectionEnabled ( void ) const               { return m_bDatabaseCredentialsProtectionEnabled != 0; }
     bool                            IsFakeLagCommandEnabled         ( void ) const                      { return m_bFakeLagCommandEnabled != 0; }
+    uint                            GetPacketCompressionThreshold   ( void ) const                      { return m_iPacketCompressionThreshold; }
+    uint                            GetLatentSendBandwidthLimit     ( void ) const                      { return m_iLatentSendBandwidthLimit; }
+    uint                            GetSyncRateMaxScale             ( void ) const                      { return m_iSyncRateMaxScale; }
+    int                             GetSlowFrameLogThreshold        ( void ) const                      { return m_iSlowFrameLogThreshold; }
+    int                             GetSimClientCount               ( void ) const                      { return m_iSimClientCount; }
 
     SString                         GetSetting                      ( const SString& configSetting );
     bool                            GetSetting                      ( const SString& configSetting, SString& strValue );
@@ -229,6 +234,11 @@ private:
     int                             m_bFilterDuplicateLogLinesEnabled;
     int                             m_bDatabaseCredentialsProtectionEnabled;
     int                             m_bFakeLagCommandEnabled;
+    int                             m_iSlowFrameLogThreshold;
+    int                             m_iSimClientCount;
+    int                             m_iPacketCompressionThreshold;
+    int                             m_iLatentSendBandwidthLimit;
+    int                             m_iSyncRateMaxScale;
 };
 
 #endif
@@ -14,7 +14,7 @@
 
 #include "StdInc.h"
 
-CMapEvent::CMapEvent ( CLuaMain* pMain, const char* szName, const CLuaFunctionRef& iLuaFunction, bool bPropagated, EEventPriorityType eventPriority, float fPriorityMod )
+CMapEvent::CMapEvent ( CLuaMain* pMain, const char* szName, uint uiNameId, const CLuaFunctionRef& iLuaFunction, bool bPropagated, EEventPriorityType eventPriority, float fPriorityMod )
 {
     // Init
     m_pMain = pMain;
@@ -24,7 +24,9 @@ CMapEvent::CMapEvent ( CLuaMain* pMain, const char* szName, const CLuaFunctionRe
     m_bBeingDestroyed = false;
     m_eventPriority = eventPriority;
     m_fPriorityMod = fPriorityMod;
+    m_uiTimingId = 0;
     m_strName.AssignLeft ( szName, MAPEVENT_MAX_LENGTH_NAME );
+    m_uiNameId = uiNameId;
 }
 
 
@@ -27,15 +27,18 @@ class CMapEvent
 public:
     inline class CLuaMain*  GetVM               ( void )                                { return m_pMain; };
     inline const SString&   GetName             ( void )                                { return m_strName; };
+    inline uint             GetNameId           ( void )                                { return m_uiNameId; };
     const CLuaFunctionRef&  GetLuaFunction      ( void )                                { return m_iLuaFunction; };
     inline bool             IsPropagated        ( void )                                { return m_bPropagated; }
     inline bool             IsBeingDestroyed    ( void )                                { return m_bBeingDestroyed; }
+    inline uint             GetTimingId         ( void )                                { return m_uiTimingId; }
+    inline void             SetTimingId         ( uint uiTimingId )                     { m_uiTimingId = uiTimingId; }
 
     void                    Call                ( const class CLuaArguments& Arguments );
     bool                    IsHigherPriorityThan ( const CMapEvent* pOther );
 
 private:
-                            CMapEvent           ( class CLuaMain* pMain, const char* szName, const CLuaFunctionRef& iLuaFunction, bool bPropagated, EEventPriorityType eventPriority, float fPriorityMod );
+                            CMapEvent           ( class CLuaMain* pMain, const char* szName, uint uiNameId, const CLuaFunctionRef& iLuaFunction, bool bPropagated, EEventPriorityType eventPriority, float fPriorityMod );
                             ~CMapEvent          ( void );
 
     inline void             SetBeingDestroyed   ( bool bBeingDestroyed )                { m_bBeingDestroyed = bBeingDestroyed; }
@@ -43,11 +46,13 @@ private:
     class CLuaMain*         m_pMain;
     CLuaFunctionRef         m_iLuaFunction;
     SString                 m_strName;
+    uint                    m_uiNameId;
     bool                    m_bPropagated;
     bool                    m_bDestroyFunction;
     bool                    m_bBeingDestroyed;
     EEventPriorityType      m_eventPriority;
     float                   m_fPriorityMod;
+    uint                    m_uiTimingId;           // Handler timing slot, 0 if not assigned yet
 };
 
 #endif
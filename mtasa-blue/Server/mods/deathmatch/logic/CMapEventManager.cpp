@@ -15,6 +15,12 @@
 #include "StdInc.h"
 
 
+CHashMap < SString, uint >                  CMapEventManager::ms_EventNameIdMap;
+std::vector < SString >                     CMapEventManager::ms_EventNameList ( 1 );
+std::deque < std::vector < CMapEvent* > >   CMapEventManager::ms_CallBufferStack;
+uint                                        CMapEventManager::ms_uiCallDepth = 0;
+
+
 CMapEventManager::CMapEventManager ( void )
 {
     m_bIteratingList = false;
@@ -35,13 +41,42 @@ CMapEventManager::~CMapEventManager ( void )
 }
 
 
+// Get id for event name, adding it if required
+uint CMapEventManager::GetEventNameId ( const char* szName )
+{
+    SString strName = SStringX ( szName ).Left ( MAPEVENT_MAX_LENGTH_NAME );
+    if ( uint* pNameId = MapFind ( ms_EventNameIdMap, strName ) )
+        return *pNameId;
+
+    uint uiNameId = ms_EventNameList.size ();
+    ms_EventNameList.push_back ( strName );
+    MapSet ( ms_EventNameIdMap, strName, uiNameId );
+    return uiNameId;
+}
+
+
+// Get id for event name, or 0 if no handler has ever been added for it
+uint CMapEventManager::FindEventNameId ( const char* szName )
+{
+    uint* pNameId = MapFind ( ms_EventNameIdMap, SStringX ( szName ) );
+    return pNameId ? *pNameId : 0;
+}
+
+
+const SString& CMapEventManager::GetEventName ( uint uiNameId )
+{
+    dassert ( uiNameId < ms_EventNameList.size () );
+    return ms_EventNameList[ uiNameId ];
+}
+
+
 bool CMapEventManager::Add ( CLuaMain* pLuaMain, const char* szName, const CLuaFunctionRef& iLuaFunction, bool bPropagated, EEventPriorityType eventPriority, float fPriorityMod )
 {
     // Check for max name length
     if ( strlen ( szName ) <= MAPEVENT_MAX_LENGTH_NAME )
     {
         // Make a new event
-        CMapEvent* pEvent = new CMapEvent ( pLuaMain, szName, iLuaFunction, bPropagated, eventPriority, fPriorityMod );
+        CMapEvent* pEvent = new CMapEvent ( pLuaMain, szName, GetEventNameId ( szName ), iLuaFunction, bPropagated, eventPriority, fPriorityMod );
 
         // Add now
         AddInternal ( pEvent );
@@ -58,49 +93,53 @@ bool CMapEventManager::Delete ( CLuaMain* pLuaMain, const char* szName, const CL
     // Delete all the events with matching names
     bool bRemovedSomeone = false;
 
-    EventsIter iter = m_EventsMap.begin ();
-    while ( iter != m_EventsMap.end () )
+    for ( uint i = 0 ; i < m_HandlerLists.size () ; i++ )
     {
-        CMapEvent* pMapEvent = iter->second;
-
-        // Matching VM?
-        if ( pLuaMain == pMapEvent->GetVM () )
+        std::vector < CMapEvent* >& eventList = m_HandlerLists[i].eventList;
+        std::vector < CMapEvent* >::iterator iter = eventList.begin ();
+        while ( iter != eventList.end () )
         {
-            // If name supplied, check name and function
-            if ( !szName || ( ( strcmp ( pMapEvent->GetName (), szName ) == 0 ) && ( pMapEvent->GetLuaFunction () == iLuaFunction ) ) )
+            CMapEvent* pMapEvent = *iter;
+
+            // Matching VM?
+            if ( pLuaMain == pMapEvent->GetVM () )
             {
-                // Not alredy being destroyed?
-                if ( !pMapEvent->IsBeingDestroyed () )
+                // If name supplied, check name and function
+                if ( !szName || ( ( strcmp ( pMapEvent->GetName (), szName ) == 0 ) && ( pMapEvent->GetLuaFunction () == iLuaFunction ) ) )
                 {
-                    // Are we in an event handler?
-                    if ( m_bIteratingList )
+                    // Not alredy being destroyed?
+                    if ( !pMapEvent->IsBeingDestroyed () )
                     {
-                        // Put it in the trashcan
-                        pMapEvent->SetBeingDestroyed ( true );
-                        m_TrashCan.push_back ( pMapEvent );
-
-                        // Remember that we deleted something
-                        bRemovedSomeone = true;
-                    }
-                    else
-                    {
-                        // Delete the object
-                        delete pMapEvent;
-
-                        // Remove from list and remember that we deleted something
-                        m_EventsMap.erase ( iter++ );
-                        bRemovedSomeone = true;
-                        continue;
+                        // Are we in an event handler?
+                        if ( m_bIteratingList )
+                        {
+                            // Put it in the trashcan
+                            pMapEvent->SetBeingDestroyed ( true );
+                            m_TrashCan.push_back ( pMapEvent );
+
+                            // Remember that we deleted something
+                            bRemovedSomeone = true;
+                        }
+                        else
+                        {
+                            // Delete the object
+                            delete pMapEvent;
+
+                            // Remove from list and remember that we deleted something
+                            iter = eventList.erase ( iter );
+                            bRemovedSomeone = true;
+                            continue;
+                        }
                     }
                 }
             }
-        }
 
-        // Increment iterator
-        ++iter;
+            // Increment iterator
+            ++iter;
+        }
     }
 
-    m_bHasEvents = !m_EventsMap.empty ();
+    RemoveEmptyHandlerLists ();
 
     // Return whether we actually destroyed someone or not
     return bRemovedSomeone;
@@ -110,33 +149,37 @@ bool CMapEventManager::Delete ( CLuaMain* pLuaMain, const char* szName, const CL
 void CMapEventManager::DeleteAll ( void )
 {
     // Delete all the events
-    EventsIter iter = m_EventsMap.begin ();
-    while ( iter != m_EventsMap.end () )
+    for ( uint i = 0 ; i < m_HandlerLists.size () ; i++ )
     {
-        CMapEvent* pMapEvent = iter->second;
-
-        // Delete it if it's not already being destroyed
-        if ( !pMapEvent->IsBeingDestroyed () )
+        std::vector < CMapEvent* >& eventList = m_HandlerLists[i].eventList;
+        std::vector < CMapEvent* >::iterator iter = eventList.begin ();
+        while ( iter != eventList.end () )
         {
-            delete pMapEvent;
-            m_EventsMap.erase ( iter++ );
+            CMapEvent* pMapEvent = *iter;
+
+            // Delete it if it's not already being destroyed
+            if ( !pMapEvent->IsBeingDestroyed () )
+            {
+                delete pMapEvent;
+                iter = eventList.erase ( iter );
+            }
+            else
+                ++iter;
         }
-        else
-            ++iter;
     }
-    m_bHasEvents = !m_EventsMap.empty ();
+    RemoveEmptyHandlerLists ();
 }
 
 
-bool CMapEventManager::Call ( const char* szName, const CLuaArguments& Arguments, class CElement* pSource, class CElement* pThis, CPlayer* pCaller )
+bool CMapEventManager::Call ( uint uiNameId, const CLuaArguments& Arguments, class CElement* pSource, class CElement* pThis, CPlayer* pCaller )
 {
     // Check if no events
     if ( !m_bHasEvents )
         return false;
 
     // Check if no events with a name match
-    EventsIterPair itPair = m_EventsMap.equal_range ( szName );
-    if ( itPair.first == itPair.second )
+    SHandlerList* pHandlerList = FindHandlerList ( uiNameId );
+    if ( !pHandlerList )
         return false;
 
     // Call all the events with matching names
@@ -144,133 +187,75 @@ bool CMapEventManager::Call ( const char* szName, const CLuaArguments& Arguments
     bool bIsAlreadyIterating = m_bIteratingList;
     m_bIteratingList = true;
 
-    // Copy the results into a array in case m_EventsMap is modified during the call
-    std::vector< CMapEvent* > matchingEvents;
-    for ( EventsIter iter = itPair.first ; iter != itPair.second ; ++iter )
-        matchingEvents.push_back(iter->second);
-
-    for ( std::vector< CMapEvent* >::iterator iter = matchingEvents.begin() ; iter != matchingEvents.end() ; ++iter )
+    // Copy the handlers in case the list is modified during the call
+    // Buffers are kept for reuse to save allocating a new one each time
+    if ( ms_CallBufferStack.size () <= ms_uiCallDepth )
+        ms_CallBufferStack.resize ( ms_uiCallDepth + 1 );
+    std::vector < CMapEvent* >& matchingEvents = ms_CallBufferStack[ ms_uiCallDepth++ ];
+    matchingEvents = pHandlerList->eventList;
+
+    const SString& strName = GetEventName ( uiNameId );
+
+    // Context which is the same for every handler
+    CLuaMain* pLuaMain = g_pGame->GetScriptDebugging()->GetTopLuaMain();
+    CResource* pSourceResource = pLuaMain ? pLuaMain->GetResource() : NULL;
+    SLuaEventContext context;
+    context.pSource = pSource;
+    context.pThis = pThis;
+    context.pSourceResource = pSourceResource;
+    context.pSourceResourceRoot = pSourceResource ? pSourceResource->GetResourceRootElement () : NULL;
+    context.szEventName = strName;
+    context.pClient = pCaller;
+
+    for ( uint i = 0 ; i < matchingEvents.size () ; i++ )
     {
-        CMapEvent* pMapEvent = *iter;
+        CMapEvent* pMapEvent = matchingEvents[i];
 
         // If it's not being destroyed
         if ( !pMapEvent->IsBeingDestroyed () )
         {
             // Compare the names
-            dassert ( strcmp ( pMapEvent->GetName (), szName ) == 0 );
+            dassert ( pMapEvent->GetNameId () == uiNameId );
             {
                 // Call if propagated?
                 if ( pSource == pThis || pMapEvent->IsPropagated () )
                 {
-                    // Grab the current VM
-                    lua_State* pState = pMapEvent->GetVM ()->GetVM ();
-
-                    LUA_CHECKSTACK ( pState, 1 );   // Ensure some room
+                    CLuaMain* pHandlerLuaMain = pMapEvent->GetVM ();
 
                     #if MTA_DEBUG
-                        int luaStackPointer = lua_gettop ( pState );
+                        int luaStackPointer = lua_gettop ( pHandlerLuaMain->GetVM () );
                     #endif
 
+                    // Get the timing slot now, as the handler could be removed during the call
+                    uint uiTimingId = CPerfStatHandlerTiming::GetSingleton ()->GetEventTimingId ( pMapEvent );
                     TIMEUS startTime = GetTimeUs();
 
-                    // Store the current values of the globals
-                    lua_getglobal ( pState, "source" );
-                    CLuaArgument OldSource ( pState, -1 );
-                    lua_pop( pState, 1 );
-
-                    lua_getglobal ( pState, "this" );
-                    CLuaArgument OldThis ( pState, -1 );
-                    lua_pop( pState, 1 );
-
-                    lua_getglobal ( pState, "sourceResource" );
-                    CLuaArgument OldResource ( pState, -1 );
-                    lua_pop( pState, 1 );
-
-                    lua_getglobal ( pState, "sourceResourceRoot" );
-                    CLuaArgument OldResourceRoot ( pState, -1 );
-                    lua_pop( pState, 1 );
-
-                    lua_getglobal ( pState, "eventName" );
-                    CLuaArgument OldEventName ( pState, -1 );
-                    lua_pop( pState, 1 );
-
-                    lua_getglobal ( pState, "client" );
-                    CLuaArgument OldClient ( pState, -1 );
-                    lua_pop( pState, 1 );
-
-                    // Set the "source", "this", "sourceResource" and "sourceResourceRoot" globals on that VM
-                    lua_pushelement ( pState, pSource );
-                    lua_setglobal ( pState, "source" );
-
-                    lua_pushelement ( pState, pThis );
-                    lua_setglobal ( pState, "this" );
-
-                    CLuaMain* pLuaMain = g_pGame->GetScriptDebugging()->GetTopLuaMain();
-                    CResource* pSourceResource = pLuaMain ? pLuaMain->GetResource() : NULL;
-                    if ( pSourceResource )
-                    {
-                        lua_pushresource ( pState, pSourceResource );
-                        lua_setglobal ( pState, "sourceResource" );
-
-                        lua_pushelement ( pState, pSourceResource->GetResourceRootElement() );
-                        lua_setglobal ( pState, "sourceResourceRoot" );
-                    }
-                    else
-                    {
-                        lua_pushnil ( pState );
-                        lua_setglobal ( pState, "sourceResource" );
-
-                        lua_pushnil ( pState );
-                        lua_setglobal ( pState, "sourceResourceRoot" );
-                    }
-
-                    lua_pushstring ( pState, szName );
-                    lua_setglobal ( pState, "eventName" );
-
-                    if ( pCaller )
-                    {
-                        lua_pushelement ( pState, pCaller );
-                        lua_setglobal ( pState, "client" );
-                    }
-                    else
-                    {
-                        lua_pushnil ( pState );
-                        lua_setglobal ( pState, "client" );
-                    }
+                    // Set the "source", "this", "sourceResource", "sourceResourceRoot", "eventName" and "client" globals on that VM
+                    pHandlerLuaMain->PushEventContext ( context );
 
                     // Call it
                     pMapEvent->Call ( Arguments );
                     bCalled = true;
+                    g_pStats->events.llHandlerCalls++;
 
                     // Reset the globals on that VM
-                    OldSource.Push ( pState );
-                    lua_setglobal ( pState, "source" );
-
-                    OldThis.Push ( pState );
-                    lua_setglobal ( pState, "this" );                
-
-                    OldResource.Push ( pState );
-                    lua_setglobal ( pState, "sourceResource" );
-
-                    OldResourceRoot.Push ( pState );
-                    lua_setglobal ( pState, "sourceResourceRoot" );
-
-                    OldEventName.Push ( pState );
-                    lua_setglobal ( pState, "eventName" );
-
-                    OldClient.Push ( pState );
-                    lua_setglobal ( pState, "client" );
+                    pHandlerLuaMain->PopEventContext ();
 
                     #if MTA_DEBUG
-                        assert ( lua_gettop ( pState ) == luaStackPointer );
+                        assert ( lua_gettop ( pHandlerLuaMain->GetVM () ) == luaStackPointer );
                     #endif
 
-                    CPerfStatLuaTiming::GetSingleton ()->UpdateLuaTiming ( pMapEvent->GetVM (), szName, GetTimeUs() - startTime );
+                    TIMEUS deltaTimeUs = GetTimeUs() - startTime;
+                    CPerfStatLuaTiming::GetSingleton ()->UpdateLuaTiming ( pHandlerLuaMain, strName, deltaTimeUs );
+                    CPerfStatHandlerTiming::GetSingleton ()->UpdateEventTiming ( uiTimingId, deltaTimeUs );
+                    g_pGame->GetSlowFrameRecorder ()->OnLuaCall ( pHandlerLuaMain, strName, startTime, true );
                 }
             }
         }
     }
 
+    ms_uiCallDepth--;
+
     // Clean out the trash if we're no longer calling events.
     if ( !bIsAlreadyIterating )
     {
@@ -294,20 +279,14 @@ void CMapEventManager::TakeOutTheTrash ( void )
         CMapEvent* pMapEvent = *iterTrash;
 
         // Remove from the eventhandler list
-        EventsIter iterMap = m_EventsMap.begin ();
-        while ( iterMap != m_EventsMap.end () )
-        {
-            if ( pMapEvent == iterMap->second )
-                m_EventsMap.erase ( iterMap++ );
-            else
-                ++iterMap;
-        }
+        if ( SHandlerList* pHandlerList = FindHandlerList ( pMapEvent->GetNameId () ) )
+            ListRemove ( pHandlerList->eventList, pMapEvent );
 
         // Delete it
         delete pMapEvent;
     }
 
-    m_bHasEvents = !m_EventsMap.empty ();
+    RemoveEmptyHandlerLists ();
 
     // Clear the trashcan
     m_TrashCan.clear ();
@@ -317,10 +296,13 @@ void CMapEventManager::TakeOutTheTrash ( void )
 bool CMapEventManager::HandleExists ( CLuaMain* pLuaMain, const char* szName, const CLuaFunctionRef& iLuaFunction )
 {
     // Return true if we find an event which matches the handle
-    EventsIterPair itPair = m_EventsMap.equal_range ( szName );
-    for ( EventsIter iter = itPair.first ; iter != itPair.second ; ++iter )
+    SHandlerList* pHandlerList = FindHandlerList ( FindEventNameId ( szName ) );
+    if ( !pHandlerList )
+        return false;
+
+    for ( uint i = 0 ; i < pHandlerList->eventList.size () ; i++ )
     {
-        CMapEvent* pMapEvent = iter->second;
+        CMapEvent* pMapEvent = pHandlerList->eventList[i];
 
         // Is it not being destroyed?
         if ( !pMapEvent->IsBeingDestroyed () )
@@ -349,26 +331,73 @@ bool CMapEventManager::HandleExists ( CLuaMain* pLuaMain, const char* szName, co
 
 void CMapEventManager::AddInternal ( CMapEvent* pEvent )
 {
+    // Find handler list for this name, or add a new one
+    std::vector < SHandlerList >::iterator iterList = m_HandlerLists.begin ();
+    while ( iterList != m_HandlerLists.end () && iterList->uiNameId < pEvent->GetNameId () )
+        ++iterList;
+    if ( iterList == m_HandlerLists.end () || iterList->uiNameId != pEvent->GetNameId () )
+    {
+        SHandlerList newList;
+        newList.uiNameId = pEvent->GetNameId ();
+        iterList = m_HandlerLists.insert ( iterList, newList );
+    }
+
     // Find place to insert
-    EventsIterPair itPair = m_EventsMap.equal_range ( pEvent->GetName () );
-    EventsIter iter;
-    for ( iter = itPair.first ; iter != itPair.second ; ++iter )
+    std::vector < CMapEvent* >& eventList = iterList->eventList;
+    std::vector < CMapEvent* >::iterator iter;
+    for ( iter = eventList.begin () ; iter != eventList.end () ; ++iter )
     {
-        if ( pEvent->IsHigherPriorityThan ( iter->second ) )
+        if ( pEvent->IsHigherPriorityThan ( *iter ) )
             break;
     }
     // Do insert
-    m_EventsMap.insert ( iter, std::pair < SString, CMapEvent* > ( pEvent->GetName (), pEvent ) );
+    eventList.insert ( iter, pEvent );
+}
+
+
+CMapEventManager::SHandlerList* CMapEventManager::FindHandlerList ( uint uiNameId )
+{
+    // Binary search as the list is sorted by id
+    uint uiLow = 0;
+    uint uiHigh = m_HandlerLists.size ();
+    while ( uiLow < uiHigh )
+    {
+        uint uiMid = ( uiLow + uiHigh ) / 2;
+        if ( m_HandlerLists[uiMid].uiNameId < uiNameId )
+            uiLow = uiMid + 1;
+        else
+            uiHigh = uiMid;
+    }
+    if ( uiLow < m_HandlerLists.size () && m_HandlerLists[uiLow].uiNameId == uiNameId )
+        return &m_HandlerLists[uiLow];
+    return NULL;
+}
+
+
+void CMapEventManager::RemoveEmptyHandlerLists ( void )
+{
+    std::vector < SHandlerList >::iterator iter = m_HandlerLists.begin ();
+    while ( iter != m_HandlerLists.end () )
+    {
+        if ( iter->eventList.empty () )
+            iter = m_HandlerLists.erase ( iter );
+        else
+            ++iter;
+    }
+    m_bHasEvents = !m_HandlerLists.empty ();
 }
 
 
 void CMapEventManager::GetHandles ( CLuaMain* pLuaMain, const char* szName, lua_State* luaVM )
 {
+    SHandlerList* pHandlerList = FindHandlerList ( FindEventNameId ( szName ) );
+    if ( !pHandlerList )
+        return;
+
     unsigned int uiIndex = 0;
-    EventsIterPair itPair = m_EventsMap.equal_range ( szName );
-    for ( EventsIter iter = itPair.first ; iter != itPair.second ; ++iter )
+    for ( uint i = 0 ; i < pHandlerList->eventList.size () ; i++ )
     {
-        CMapEvent* pMapEvent = iter->second;
+        CMapEvent* pMapEvent = pHandlerList->eventList[i];
 
         // Is it not being destroyed?
         if ( !pMapEvent->IsBeingDestroyed () )
@@ -386,4 +415,4 @@ void CMapEventManager::GetHandles ( CLuaMain* pLuaMain, const char* szName, lua_
             }
         }
     }
-}
\ No newline at end of file
+}
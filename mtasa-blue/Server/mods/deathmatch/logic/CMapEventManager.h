@@ -18,6 +18,7 @@
 #include "lua/CLuaArguments.h"
 #include "CMapEvent.h"
 #include <list>
+#include <deque>
 
 class CMapEventManager
 {
@@ -32,21 +33,34 @@ public:
     bool                    HasEvents                       ( void ) const          { return m_bHasEvents; }
     void                    GetHandles                      ( CLuaMain* pLuaMain, const char* szName, lua_State* luaVM );
 
-    bool                    Call                            ( const char* szName, const CLuaArguments& Arguments, class CElement* pSource, class CElement* pThis, class CPlayer* pCaller = NULL );
+    bool                    Call                            ( uint uiNameId, const CLuaArguments& Arguments, class CElement* pSource, class CElement* pThis, class CPlayer* pCaller = NULL );
+
+    // Event names are given an id when a handler is first added for them
+    static uint             GetEventNameId                  ( const char* szName );
+    static uint             FindEventNameId                 ( const char* szName );
+    static const SString&   GetEventName                    ( uint uiNameId );
 
 private:
+    struct SHandlerList
+    {
+        uint                        uiNameId;
+        std::vector < CMapEvent* >  eventList;      // In priority order
+    };
+
     void                    TakeOutTheTrash                 ( void );
     void                    AddInternal                     ( CMapEvent* pEvent );
+    SHandlerList*           FindHandlerList                 ( uint uiNameId );
+    void                    RemoveEmptyHandlerLists         ( void );
 
     bool                                    m_bHasEvents;
     bool                                    m_bIteratingList;
-    std::multimap < SString, CMapEvent* >   m_EventsMap;
+    std::vector < SHandlerList >            m_HandlerLists;     // Sorted by name id
     std::list < CMapEvent* >                m_TrashCan;
 
-    // Types for m_EventsMap access
-    typedef std::multimap < SString, CMapEvent* > ::const_iterator  EventsConstIter;
-    typedef std::multimap < SString, CMapEvent* > ::iterator        EventsIter;
-    typedef std::pair < EventsIter, EventsIter >                    EventsIterPair;
+    static CHashMap < SString, uint >       ms_EventNameIdMap;
+    static std::vector < SString >          ms_EventNameList;
+    static std::deque < std::vector < CMapEvent* > >   ms_CallBufferStack;     // Reused for copies of handler lists during calls
+    static uint                             ms_uiCallDepth;
 };
 
 #endif
@@ -0,0 +1,381 @@
+/*****************************************************************************
+*
+*  PROJECT:     Multi Theft Auto v1.0
+*  LICENSE:     See LICENSE in the top level directory
+*  FILE:        mods/deathmatch/logic/CMapFileCache.cpp
+*  PURPOSE:     Binary cache of parsed .map files
+*
+*  Multi Theft Auto is available from http://www.multitheftauto.com/
+*
+*****************************************************************************/
+
+#include "StdInc.h"
+
+#define MAP_CACHE_ID            "MTAMAPC"
+#define MAP_CACHE_VERSION       1
+#define MAP_CACHE_MAX_SIZE      ( 256LL * 1024 * 1024 )
+
+namespace
+{
+    //
+    // Helpers for strings which may be longer than WriteString allows
+    //
+    void WriteLongString ( CBufferWriteStream& stream, const std::string& str )
+    {
+        stream.Write ( (uint)str.length () );
+        if ( !str.empty () )
+            stream.WriteBytes ( str.data (), str.length () );
+    }
+
+    bool ReadLongString ( CBufferReadStream& stream, std::string& strOut )
+    {
+        uint uiLength;
+        if ( !stream.Read ( uiLength ) || !stream.CanReadNumberOfBytes ( uiLength ) )
+            return false;
+        strOut.resize ( uiLength );
+        return uiLength == 0 || stream.ReadBytes ( &strOut[0], uiLength );
+    }
+
+    uint GetStringIndex ( std::map < std::string, uint >& stringIndexMap, const std::string& str )
+    {
+        if ( uint* pIndex = MapFind ( stringIndexMap, str ) )
+            return *pIndex;
+        uint uiIndex = stringIndexMap.size ();
+        MapSet ( stringIndexMap, str, uiIndex );
+        return uiIndex;
+    }
+
+    SString GetCacheRootPath ( void )
+    {
+        return PathJoin ( g_pServerInterface->GetServerModPath (), "resource-cache", "maps" );
+    }
+
+    // Delete the files in a directory and then the directory
+    void DeleteDirectory ( const SString& strPath )
+    {
+        for ( const SString& strFilename : FindFiles ( PathJoin ( strPath, "*" ), true, false ) )
+            FileDelete ( PathJoin ( strPath, strFilename ) );
+        File::Rmdir ( strPath );
+    }
+
+    void WriteNode ( CBufferWriteStream& stream, CXMLNode& node, std::map < std::string, uint >& stringIndexMap )
+    {
+        stream.Write ( GetStringIndex ( stringIndexMap, node.GetTagName () ) );
+        stream.Write ( node.GetLine () );
+
+        CXMLAttributes& attributes = node.GetAttributes ();
+        uint uiAttributeCount = attributes.Count ();
+        stream.Write ( uiAttributeCount );
+        for ( uint i = 0 ; i < uiAttributeCount ; i++ )
+        {
+            CXMLAttribute* pAttribute = attributes.Get ( i );
+            stream.Write ( GetStringIndex ( stringIndexMap, pAttribute->GetName () ) );
+            WriteLongString ( stream, pAttribute->GetValue () );
+        }
+
+        // Comments have no tag name and are skipped when loading, so leave them out
+        std::vector < CXMLNode* > childList;
+        for ( std::list < CXMLNode* >::iterator iter = node.ChildrenBegin () ; iter != node.ChildrenEnd () ; ++iter )
+            if ( *iter && !(*iter)->GetTagName ().empty () )
+                childList.push_back ( *iter );
+
+        stream.Write ( (uint)childList.size () );
+        for ( uint i = 0 ; i < childList.size () ; i++ )
+            WriteNode ( stream, *childList[i], stringIndexMap );
+    }
+}
+
+
+///////////////////////////////////////////////////////////////
+//
+// CMapCacheAttributes
+//
+//
+//
+///////////////////////////////////////////////////////////////
+CMapCacheAttributes::~CMapCacheAttributes ( void )
+{
+    for ( uint i = 0 ; i < m_Array.size () ; i++ )
+        delete m_Array[i];
+}
+
+void CMapCacheAttributes::Add ( CMapCacheAttribute* pAttribute )
+{
+    m_List.push_back ( pAttribute );
+    m_Array.push_back ( pAttribute );
+}
+
+CXMLAttribute* CMapCacheAttributes::Find ( const char* szName )
+{
+    for ( uint i = 0 ; i < m_Array.size () ; i++ )
+        if ( m_Array[i]->GetName () == szName )
+            return m_Array[i];
+    return NULL;
+}
+
+CXMLAttribute* CMapCacheAttributes::Get ( unsigned int uiIndex )
+{
+    return uiIndex < m_Array.size () ? m_Array[uiIndex] : NULL;
+}
+
+
+///////////////////////////////////////////////////////////////
+//
+// CMapCacheNode
+//
+//
+//
+///////////////////////////////////////////////////////////////
+CMapCacheNode::CMapCacheNode ( CMapCacheNode* pParent, const std::string* pTagName, int iLine )
+    : m_pParent ( pParent )
+    , m_pTagName ( pTagName )
+    , m_iLine ( iLine )
+{
+    if ( m_pParent )
+        m_pParent->m_Children.push_back ( this );
+}
+
+CMapCacheNode::~CMapCacheNode ( void )
+{
+    for ( std::list < CXMLNode* >::iterator iter = m_Children.begin () ; iter != m_Children.end () ; ++iter )
+        delete *iter;
+}
+
+CXMLNode* CMapCacheNode::GetSubNode ( unsigned int uiIndex )
+{
+    for ( std::list < CXMLNode* >::iterator iter = m_Children.begin () ; iter != m_Children.end () ; ++iter )
+        if ( uiIndex-- == 0 )
+            return *iter;
+    return NULL;
+}
+
+CXMLNode* CMapCacheNode::FindSubNode ( const char* szTagName, unsigned int uiIndex )
+{
+    for ( std::list < CXMLNode* >::iterator iter = m_Children.begin () ; iter != m_Children.end () ; ++iter )
+        if ( (*iter)->GetTagName () == szTagName && uiIndex-- == 0 )
+            return *iter;
+    return NULL;
+}
+
+SString CMapCacheNode::GetAttributeValue ( const SString& strAttributeName )
+{
+    CXMLAttribute* pAttribute = m_Attributes.Find ( strAttributeName );
+    return pAttribute ? pAttribute->GetValue () : "";
+}
+
+
+///////////////////////////////////////////////////////////////
+//
+// CMapFileCache::~CMapFileCache
+//
+//
+//
+///////////////////////////////////////////////////////////////
+CMapFileCache::~CMapFileCache ( void )
+{
+    Clear ();
+}
+
+
+///////////////////////////////////////////////////////////////
+//
+// CMapFileCache::Clear
+//
+// Delete loaded nodes and strings
+//
+///////////////////////////////////////////////////////////////
+void CMapFileCache::Clear ( void )
+{
+    SAFE_DELETE ( m_pRootNode );
+    for ( uint i = 0 ; i < m_StringTable.size () ; i++ )
+        delete m_StringTable[i];
+    m_StringTable.clear ();
+}
+
+
+///////////////////////////////////////////////////////////////
+//
+// CMapFileCache::GetCachePathFilename
+//
+// Cache files are kept in a directory for each resource, and named after the
+// map name and checksum of the .map file, so a changed map will never match
+// an old cache file
+//
+///////////////////////////////////////////////////////////////
+SString CMapFileCache::GetCachePathFilename ( const SString& strResourceName, const SString& strMapName, const CChecksum& mapChecksum )
+{
+    char szMD5[33];
+    CMD5Hasher::ConvertToHex ( mapChecksum.md5, szMD5 );
+    SString strNameHash = GenerateSha256HexString ( strMapName.ToLower () ).Left ( 16 );
+    return PathJoin ( GetCacheRootPath (), strResourceName, SString ( "%s_%s_%08x.bin", *strNameHash, szMD5, mapChecksum.ulCRC ) );
+}
+
+
+///////////////////////////////////////////////////////////////
+//
+// CMapFileCache::Save
+//
+// Write the node tree of a parsed .map file to the cache
+// Cache files for older versions of the same map are deleted
+//
+///////////////////////////////////////////////////////////////
+bool CMapFileCache::Save ( CXMLNode& rootNode, const SString& strCachePathFilename )
+{
+    // Write nodes first to build the string table
+    std::map < std::string, uint > stringIndexMap;
+    CBuffer nodeData;
+    CBufferWriteStream nodeStream ( nodeData );
+    WriteNode ( nodeStream, rootNode, stringIndexMap );
+
+    std::vector < const std::string* > stringList ( stringIndexMap.size () );
+    for ( std::map < std::string, uint >::const_iterator iter = stringIndexMap.begin () ; iter != stringIndexMap.end () ; ++iter )
+        stringList[ iter->second ] = &iter->first;
+
+    CBuffer fileData;
+    CBufferWriteStream stream ( fileData );
+    stream.WriteString ( MAP_CACHE_ID );
+    stream.Write ( (uint)MAP_CACHE_VERSION );
+    stream.Write ( (uint)stringList.size () );
+    for ( uint i = 0 ; i < stringList.size () ; i++ )
+        WriteLongString ( stream, *stringList[i] );
+    stream.WriteBytes ( nodeData.GetData (), nodeData.GetSize () );
+
+    SString strPath = ExtractPath ( strCachePathFilename );
+    SString strFilename = ExtractFilename ( strCachePathFilename );
+    for ( const SString& strOtherFilename : FindFiles ( PathJoin ( strPath, strFilename.SplitLeft ( "_" ) + "_*.bin" ), true, false ) )
+        if ( strOtherFilename != strFilename )
+            FileDelete ( PathJoin ( strPath, strOtherFilename ) );
+
+    return FileSave ( strCachePathFilename, fileData.GetData (), fileData.GetSize () );
+}
+
+
+///////////////////////////////////////////////////////////////
+//
+// CMapFileCache::RemoveResource
+//
+// Delete the cache files of a resource which has been deleted
+//
+///////////////////////////////////////////////////////////////
+void CMapFileCache::RemoveResource ( const SString& strResourceName )
+{
+    if ( !strResourceName.empty () )
+        DeleteDirectory ( PathJoin ( GetCacheRootPath (), strResourceName ) );
+}
+
+
+///////////////////////////////////////////////////////////////
+//
+// CMapFileCache::Prune
+//
+// Delete cache files of resources which are no longer loaded, and
+// the oldest files if the cache is too big
+//
+///////////////////////////////////////////////////////////////
+void CMapFileCache::Prune ( CResourceManager* pResourceManager )
+{
+    SString strRootPath = GetCacheRootPath ();
+
+    // Files from before the cache was split by resource
+    for ( const SString& strFilename : FindFiles ( PathJoin ( strRootPath, "*.bin" ), true, false ) )
+        FileDelete ( PathJoin ( strRootPath, strFilename ) );
+
+    for ( const SString& strResourceName : FindFiles ( PathJoin ( strRootPath, "*" ), false, true ) )
+    {
+        if ( !pResourceManager->GetResource ( strResourceName ) )
+            DeleteDirectory ( PathJoin ( strRootPath, strResourceName ) );
+    }
+
+    // Oldest written first. A deleted file is made again the next time its map is loaded
+    PruneFilesBySize ( strRootPath, "*.bin", MAP_CACHE_MAX_SIZE );
+}
+
+
+///////////////////////////////////////////////////////////////
+//
+// CMapFileCache::Load
+//
+// Returns the root node, or NULL if the cache file is missing or invalid
+// Nodes remain valid until this object is deleted
+//
+///////////////////////////////////////////////////////////////
+CMapCacheNode* CMapFileCache::Load ( const SString& strCachePathFilename )
+{
+    Clear ();
+
+    CBuffer fileData;
+    if ( !fileData.LoadFromFile ( strCachePathFilename ) )
+        return NULL;
+
+    CBufferReadStream stream ( fileData );
+    SString strId;
+    uint uiVersion = 0;
+    uint uiNumStrings = 0;
+    if ( !stream.ReadString ( strId ) || strId != MAP_CACHE_ID
+        || !stream.Read ( uiVersion ) || uiVersion != MAP_CACHE_VERSION
+        || !stream.Read ( uiNumStrings ) )
+        return NULL;
+
+    for ( uint i = 0 ; i < uiNumStrings ; i++ )
+    {
+        std::string* pString = new std::string ();
+        m_StringTable.push_back ( pString );
+        if ( !ReadLongString ( stream, *pString ) )
+        {
+            Clear ();
+            return NULL;
+        }
+    }
+
+    if ( !ReadNode ( stream, NULL, m_pRootNode ) )
+    {
+        Clear ();
+        return NULL;
+    }
+    return m_pRootNode;
+}
+
+
+///////////////////////////////////////////////////////////////
+//
+// CMapFileCache::ReadNode
+//
+// Read a node and all its children
+//
+///////////////////////////////////////////////////////////////
+bool CMapFileCache::ReadNode ( CBufferReadStream& stream, CMapCacheNode* pParent, CMapCacheNode*& pOutNode )
+{
+    uint uiTagIndex;
+    int iLine;
+    uint uiAttributeCount;
+    if ( !stream.Read ( uiTagIndex ) || uiTagIndex >= m_StringTable.size ()
+        || !stream.Read ( iLine )
+        || !stream.Read ( uiAttributeCount ) )
+        return false;
+
+    // Node is owned by the parent as soon as it is created (or by the caller if it is the root)
+    CMapCacheNode* pNode = new CMapCacheNode ( pParent, m_StringTable[ uiTagIndex ], iLine );
+    pOutNode = pNode;
+
+    for ( uint i = 0 ; i < uiAttributeCount ; i++ )
+    {
+        uint uiNameIndex;
+        std::string strValue;
+        if ( !stream.Read ( uiNameIndex ) || uiNameIndex >= m_StringTable.size ()
+            || !ReadLongString ( stream, strValue ) )
+            return false;
+        pNode->GetCacheAttributes ().Add ( new CMapCacheAttribute ( m_StringTable[ uiNameIndex ], strValue ) );
+    }
+
+    uint uiChildCount;
+    if ( !stream.Read ( uiChildCount ) )
+        return false;
+
+    for ( uint i = 0 ; i < uiChildCount ; i++ )
+    {
+        CMapCacheNode* pChild;
+        if ( !ReadNode ( stream, pNode, pChild ) )
+            return false;
+    }
+    return true;
+}
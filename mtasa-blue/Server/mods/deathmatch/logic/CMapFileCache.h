@@ -0,0 +1,160 @@
+/*****************************************************************************
+*
+*  PROJECT:     Multi Theft Auto v1.0
+*  LICENSE:     See LICENSE in the top level directory
+*  FILE:        mods/deathmatch/logic/CMapFileCache.h
+*  PURPOSE:     Binary cache of parsed .map files
+*
+*  Multi Theft Auto is available from http://www.multitheftauto.com/
+*
+*****************************************************************************/
+#pragma once
+
+class CMapCacheNode;
+
+//
+// Read only attribute of a CMapCacheNode
+//
+class CMapCacheAttribute : public CXMLAttribute
+{
+public:
+                                CMapCacheAttribute      ( const std::string* pName, const std::string& strValue ) : m_pName ( pName ), m_strValue ( strValue ) {}
+
+    eXMLClass                   GetClassType            ( void )                        { return CXML_ATTR; }
+    unsigned long               GetID                   ( void )                        { return INVALID_XML_ID; }
+
+    const std::string           GetName                 ( void ) const                  { return *m_pName; }
+    const std::string&          GetValue                ( void ) const                  { return m_strValue; }
+
+    void                        SetValue                ( const char* szValue )         { m_strValue = szValue; }
+    void                        SetValue                ( bool bValue )                 { m_strValue = bValue ? "1" : "0"; }
+    void                        SetValue                ( int iValue )                  { m_strValue = SString ( "%d", iValue ); }
+    void                        SetValue                ( unsigned int uiValue )        { m_strValue = SString ( "%u", uiValue ); }
+    void                        SetValue                ( float fValue )                { m_strValue = SString ( "%f", fValue ); }
+
+    void                        DeleteWrapper           ( void )                        {}
+
+protected:
+    const std::string*          m_pName;        // Owned by the string table of the cache
+    std::string                 m_strValue;
+};
+
+
+//
+// Read only attribute list of a CMapCacheNode
+//
+class CMapCacheAttributes : public CXMLAttributes
+{
+public:
+                                ~CMapCacheAttributes    ( void );
+
+    unsigned int                Count                   ( void )                        { return m_List.size (); }
+    CXMLAttribute*              Find                    ( const char* szName );
+    CXMLAttribute*              Get                     ( unsigned int uiIndex );
+
+    CXMLAttribute*              Create                  ( const char* szName )          { return NULL; }
+    CXMLAttribute*              Create                  ( const CXMLAttribute& Copy )   { return NULL; }
+    bool                        Delete                  ( const char* szName )          { return false; }
+    void                        DeleteAll               ( void )                        {}
+
+    std::list < CXMLAttribute* >::iterator  ListBegin   ( void )                        { return m_List.begin (); }
+    std::list < CXMLAttribute* >::iterator  ListEnd     ( void )                        { return m_List.end (); }
+
+    void                        Add                     ( CMapCacheAttribute* pAttribute );
+
+protected:
+    std::list < CXMLAttribute* >    m_List;
+    std::vector < CXMLAttribute* >  m_Array;        // For fast Get ( index )
+};
+
+
+//
+// Lightweight read only substitute for CXMLNode, built from the binary cache
+// Only supports what is needed by CResourceMapItem::HandleNode and element creation
+//
+class CMapCacheNode : public CXMLNode
+{
+public:
+                                CMapCacheNode           ( CMapCacheNode* pParent, const std::string* pTagName, int iLine );
+                                ~CMapCacheNode          ( void );
+
+    eXMLClass                   GetClassType            ( void )                        { return CXML_NODE; }
+    unsigned long               GetID                   ( void )                        { return INVALID_XML_ID; }
+
+    CXMLNode*                   CreateSubNode           ( const char* szTagName, CXMLNode* pInsertAfter = nullptr )     { return NULL; }
+    void                        DeleteSubNode           ( CXMLNode* pNode )             {}
+    void                        DeleteAllSubNodes       ( void )                        {}
+
+    unsigned int                GetSubNodeCount         ( void )                        { return m_Children.size (); }
+    CXMLNode*                   GetSubNode              ( unsigned int uiIndex );
+    CXMLNode*                   FindSubNode             ( const char* szTagName, unsigned int uiIndex = 0 );
+
+    std::list < CXMLNode* > ::iterator  ChildrenBegin   ( void )                        { return m_Children.begin (); }
+    std::list < CXMLNode* > ::iterator  ChildrenEnd     ( void )                        { return m_Children.end (); }
+
+    CXMLAttributes&             GetAttributes           ( void )                        { return m_Attributes; }
+    CXMLNode*                   GetParent               ( void )                        { return m_pParent; }
+
+    int                         GetLine                 ( void )                        { return m_iLine; }
+    const std::string&          GetTagName              ( void )                        { return *m_pTagName; }
+    void                        SetTagName              ( const std::string& strString ) {}
+
+    const std::string           GetTagContent           ( void )                        { return ""; }
+    bool                        GetTagContent           ( bool& bContent )              { return false; }
+    bool                        GetTagContent           ( int& iContent )               { return false; }
+    bool                        GetTagContent           ( unsigned int& uiContent )     { return false; }
+    bool                        GetTagContent           ( float& fContent )             { return false; }
+
+    void                        SetTagContent           ( const char* szContent, bool bCDATA = false ) {}
+    void                        SetTagContent           ( bool bContent )               {}
+    void                        SetTagContent           ( int iContent )                {}
+    void                        SetTagContent           ( unsigned int uiContent )      {}
+    void                        SetTagContent           ( float fContent )              {}
+    void                        SetTagContentf          ( const char* szFormat, ... )   {}
+
+    CXMLNode*                   CopyNode                ( CXMLNode* pParent )           { return NULL; }
+    bool                        CopyChildrenInto        ( CXMLNode* pDestination, bool bRecursive ) { return false; }
+
+    bool                        IsValid                 ( void )                        { return true; }
+
+    SString                     GetAttributeValue       ( const SString& strAttributeName );
+    SString                     GetCommentText          ( void )                        { return ""; }
+    void                        SetCommentText          ( const char* szCommentText, bool bLeadingBlankLine = false ) {}
+
+    CMapCacheAttributes&        GetCacheAttributes      ( void )                        { return m_Attributes; }
+
+protected:
+    CMapCacheNode*              m_pParent;
+    const std::string*          m_pTagName;     // Owned by the string table of the cache
+    int                         m_iLine;
+    CMapCacheAttributes         m_Attributes;
+    std::list < CXMLNode* >     m_Children;
+};
+
+
+//
+// Converts .map files to and from a compact binary form stored in resource-cache
+// so unchanged maps can be loaded without parsing XML.
+// Only the parse is cached. Elements are still created one at a time by
+// CResourceMapItem::HandleNode, and their spatial database updates are queued
+// by CSpatialDatabase until the next query as usual.
+//
+class CMapFileCache
+{
+public:
+                                ~CMapFileCache          ( void );
+
+    static SString              GetCachePathFilename    ( const SString& strResourceName, const SString& strMapName, const CChecksum& mapChecksum );
+    static bool                 Save                    ( CXMLNode& rootNode, const SString& strCachePathFilename );
+    static void                 RemoveResource          ( const SString& strResourceName );
+    static void                 Prune                   ( CResourceManager* pResourceManager );
+
+    CMapCacheNode*              Load                    ( const SString& strCachePathFilename );
+
+protected:
+    bool                        ReadNode                ( CBufferReadStream& stream, CMapCacheNode* pParent, CMapCacheNode*& pOutNode );
+    void                        Clear                   ( void );
+
+    std::vector < std::string* >    m_StringTable;
+    CMapCacheNode*                  m_pRootNode = NULL;
+};
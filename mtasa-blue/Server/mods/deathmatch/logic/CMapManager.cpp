@@ -710,26 +710,25 @@ void CMapManager::DoPickupRespawning ( void )
     // Grab the current time
     CTickCount currentTime = CTickCount::Now();
 
-    // Loop through each pickup looking for respawnable ones
-    CPickup* pPickup;
-    list < CPickup* > ::const_iterator iterPickups = m_pPickupManager->IterBegin ();
-    for ( ; iterPickups != m_pPickupManager->IterEnd (); iterPickups++ )
+    // Only look at pickups which are due to be enabled or respawned
+    std::vector < CPickup* > dueList;
+    m_pPickupManager->GetDueRespawnChecks ( dueList );
+
+    for ( uint i = 0 ; i < dueList.size () ; i++ )
     {
-        pPickup = *iterPickups;
+        CPickup* pPickup = dueList[i];
 
         // Do we have to respawn this one and is it time to?
         const CTickCount lastUsedTime = pPickup->GetLastUsedTime ();
         const CTickCount creationTime = pPickup->GetCreationTime ();
 
-        if ( pPickup->IsEnabled () == false )
+        // Allow time for the element to be at least sent client side before allowing collisions otherwise it's possible to get a collision before the pickup is created. DO NOT WANT! - Caz
+        if ( currentTime >= ( creationTime + CTickCount( 100LL ) ) && pPickup->HasDoneDelayHack() == false )
         {
-            // Allow time for the element to be at least sent client side before allowing collisions otherwise it's possible to get a collision before the pickup is created. DO NOT WANT! - Caz
-            if ( currentTime >= ( creationTime + CTickCount( 100LL ) ) && pPickup->HasDoneDelayHack() == false )
-            {
-                // make sure we only happen once.
-                pPickup->SetDoneDelayHack ( true );
+            // make sure we only happen once.
+            pPickup->SetDoneDelayHack ( true );
+            if ( pPickup->IsEnabled () == false )
                 pPickup->SetEnabled ( true );
-            }
         }
 
         if ( !pPickup->IsSpawned () && lastUsedTime != CTickCount( 0LL ) && currentTime >= ( lastUsedTime + CTickCount( (long long)pPickup->GetRespawnIntervals() ) ) )
@@ -752,6 +751,9 @@ void CMapManager::DoPickupRespawning ( void )
             CLuaArguments Arguments;
             pPickup->CallEvent ( "onPickupSpawn", Arguments );
         }
+
+        // Queue the next check
+        pPickup->UpdateRespawnCheck ();
     }
 }
 
@@ -826,17 +828,17 @@ void CMapManager::DoVehicleRespawning ( void )
 {
     CVehicleSpawnPacket VehicleSpawnPacket;
 
-    // Loop through all vehicles with respawn enabled
-    // Use a copy of the list in case toggleVehicleRespawn is called during 'onVehicleRespawn'
-    const list < CVehicle* > respawnEnabledList = m_pVehicleManager->GetRespawnEnabledVehicles ( );
+    // Only look at vehicles which have a blow or idle timer finishing
+    // (Deleted vehicles are removed from the queue, and element deletion is delayed until after this)
+    std::vector < CVehicle* > dueList;
+    m_pVehicleManager->GetDueRespawnChecks ( dueList );
 
-    list < CVehicle* > ::const_iterator iter = respawnEnabledList.begin ( );
-    for ( ; iter != respawnEnabledList.end ( ); ++iter )
+    for ( uint i = 0 ; i < dueList.size () ; i++ )
     {
-        CVehicle* pVehicle = *iter;
+        CVehicle* pVehicle = dueList[i];
 
         // No need to respawn vehicles if they're being deleted anyway
-        if ( pVehicle->IsBeingDeleted ( ) )
+        if ( pVehicle->IsBeingDeleted ( ) || !pVehicle->GetRespawnEnabled ( ) )
             continue;
 
         // Did we get deserted?
@@ -887,6 +889,9 @@ void CMapManager::DoVehicleRespawning ( void )
             Arguments.PushBoolean ( bExploded );
             pVehicle->CallEvent ( "onVehicleRespawn", Arguments );
         }
+
+        // Queue the next check
+        pVehicle->UpdateRespawnCheck ( );
     }
 
     // Send it
@@ -255,6 +255,7 @@ void CObject::SetPosition ( const CVector& vecPosition )
         // Update our vectors
         m_vecPosition = vecPosition;
         UpdateSpatialData ();
+        IncrementSyncRevision ();
     }
 }
 
@@ -294,6 +295,7 @@ void CObject::SetRotation ( const CVector& vecRotation )
     {
         // Set the new rotation
         m_vecRotation = vecRotation;
+        IncrementSyncRevision ();
     }
 }
 
@@ -329,6 +331,7 @@ void CObject::Move ( const CPositionRotationAnimation& a_rMoveAnimation )
         m_pMoveAnimation = new CPositionRotationAnimation ( a_rMoveAnimation );
         // Update the values since they might have changed since StopMoving () was called above
         m_pMoveAnimation->SetSourceValue( SPositionRotation ( m_vecPosition, m_vecRotation ) );
+        IncrementSyncRevision ();
     }
     // If we have a time of 0, move there now
     else
@@ -355,6 +358,7 @@ void CObject::StopMoving ( void )
         m_pMoveAnimation = NULL;
        
         UpdateSpatialData ();
+        IncrementSyncRevision ();
     }
 }
 
@@ -422,6 +426,7 @@ bool CObject::SetLowLodObject ( CObject* pNewLowLodObject )
         // Clear there and here
         ListRemove ( m_pLowLodObject->m_HighLodObjectList, this );
         m_pLowLodObject = NULL;
+        IncrementSyncRevision ();
         return true;
     }
     else
@@ -436,6 +441,7 @@ bool CObject::SetLowLodObject ( CObject* pNewLowLodObject )
         // Make new link
         m_pLowLodObject = pNewLowLodObject;
         pNewLowLodObject->m_HighLodObjectList.push_back ( this );
+        IncrementSyncRevision ();
         return true;
     }
 }
@@ -21,6 +21,7 @@
 #include "CEasingCurve.h"
 #include "TInterpolation.h"
 #include "CPositionRotationAnimation.h"
+#include "CBitStreamFragment.h"
 
 class CObject : public CElement
 {
@@ -51,22 +52,22 @@ public:
     const CPositionRotationAnimation*   GetMoveAnimation    ( );
 
     inline unsigned char        GetAlpha                ( void )                        { return m_ucAlpha; }
-    inline void                 SetAlpha                ( unsigned char ucAlpha )       { m_ucAlpha = ucAlpha; }
+    inline void                 SetAlpha                ( unsigned char ucAlpha )       { m_ucAlpha = ucAlpha; IncrementSyncRevision (); }
 
     inline unsigned short       GetModel                ( void )                        { return m_usModel; }
-    inline void                 SetModel                ( unsigned short usModel )      { m_usModel = usModel; }
+    inline void                 SetModel                ( unsigned short usModel )      { m_usModel = usModel; IncrementSyncRevision (); }
 
     const CVector&              GetScale                ( void )                        { return m_vecScale; }
-    inline void                 SetScale                ( const CVector& vecScale )     { m_vecScale = vecScale; }
+    inline void                 SetScale                ( const CVector& vecScale )     { m_vecScale = vecScale; IncrementSyncRevision (); }
 
     inline bool                 GetCollisionEnabled     ( void )                        { return m_bCollisionsEnabled; }
-    inline void                 SetCollisionEnabled     ( bool bCollisionEnabled )      { m_bCollisionsEnabled = bCollisionEnabled; }
+    inline void                 SetCollisionEnabled     ( bool bCollisionEnabled )      { m_bCollisionsEnabled = bCollisionEnabled; IncrementSyncRevision (); }
 
     inline bool                 IsFrozen                ( void )                        { return m_bIsFrozen; }
-    inline void                 SetFrozen               ( bool bFrozen )                { m_bIsFrozen = bFrozen; }
+    inline void                 SetFrozen               ( bool bFrozen )                { m_bIsFrozen = bFrozen; IncrementSyncRevision (); }
 
     inline float                GetHealth               ( void )                        { return m_fHealth; }
-    inline void                 SetHealth               ( float fHealth )               { m_fHealth = fHealth; }
+    inline void                 SetHealth               ( float fHealth )               { m_fHealth = fHealth; IncrementSyncRevision (); }
 
     inline bool                 IsSyncable              ( void )                        { return m_bSyncable; }
     inline void                 SetSyncable             ( bool bSyncable )              { m_bSyncable = bSyncable; }
@@ -78,8 +79,10 @@ public:
     bool                        SetLowLodObject         ( CObject* pLowLodObject );
     CObject*                    GetLowLodObject         ( void );
 
+    CBitStreamFragment&         GetEntityAddFragment    ( void )                        { return m_EntityAddFragment; }
+
     inline bool                 IsVisibleInAllDimensions ( void )                       { return m_bVisibleInAllDimensions; };
-    inline void                 SetVisibleInAllDimensions ( bool bVisible )             { m_bVisibleInAllDimensions = bVisible; };
+    inline void                 SetVisibleInAllDimensions ( bool bVisible )             { m_bVisibleInAllDimensions = bVisible; IncrementSyncRevision (); };
 
 private:
     CObjectManager*             m_pObjectManager;
@@ -101,6 +104,8 @@ protected:
     CObject*                    m_pLowLodObject;        // Pointer to low LOD version of this object
     std::vector < CObject* >    m_HighLodObjectList;    // List of objects that use this object as a low LOD version
 
+    CBitStreamFragment          m_EntityAddFragment;    // Last entity add data, valid while the sync revision is unchanged
+
 public:
     CPositionRotationAnimation* m_pMoveAnimation;
 };
@@ -0,0 +1,146 @@
+/*****************************************************************************
+*
+*  PROJECT:     Multi Theft Auto v1.0
+*  LICENSE:     See LICENSE in the top level directory
+*  FILE:        mods/deathmatch/logic/CPacketCompressor.cpp
+*  PURPOSE:     Compression of large reliable packets sent to clients
+*
+*  Multi Theft Auto is available from http://www.multitheftauto.com/
+*
+*****************************************************************************/
+
+#include "StdInc.h"
+
+
+///////////////////////////////////////////////////////////////
+//
+// CPacketCompressor::CPacketCompressor
+//
+//
+//
+///////////////////////////////////////////////////////////////
+CPacketCompressor::CPacketCompressor ( void )
+{
+}
+
+
+///////////////////////////////////////////////////////////////
+//
+// CPacketCompressor::~CPacketCompressor
+//
+//
+//
+///////////////////////////////////////////////////////////////
+CPacketCompressor::~CPacketCompressor ( void )
+{
+    ClearCache ();
+}
+
+
+///////////////////////////////////////////////////////////////
+//
+// CPacketCompressor::IsCompressiblePacket
+//
+// Packets which can get big and are mostly repeated floats, model ids and strings
+//
+///////////////////////////////////////////////////////////////
+bool CPacketCompressor::IsCompressiblePacket ( uchar ucPacketID, NetServerPacketReliability reliability )
+{
+    if ( reliability != PACKET_RELIABILITY_RELIABLE && reliability != PACKET_RELIABILITY_RELIABLE_ORDERED )
+        return false;
+
+    switch ( ucPacketID )
+    {
+        case PACKET_ID_MAP_INFO:
+        case PACKET_ID_ENTITY_ADD:
+        case PACKET_ID_RESOURCE_START:
+        case PACKET_ID_LUA_EVENT:
+            return true;
+    }
+    return false;
+}
+
+
+///////////////////////////////////////////////////////////////
+//
+// CPacketCompressor::Compress
+//
+// Returns the bitstream to send instead, or NULL to send the original
+//
+///////////////////////////////////////////////////////////////
+NetBitStreamInterface* CPacketCompressor::Compress ( uchar ucPacketID, NetServerPacketReliability reliability, NetBitStreamInterface* pBitStream )
+{
+    if ( pBitStream->Version () < 0x06B )
+        return NULL;
+
+    if ( !IsCompressiblePacket ( ucPacketID, reliability ) )
+        return NULL;
+
+    uint uiThreshold = g_pGame->GetConfig ()->GetPacketCompressionThreshold ();
+    if ( uiThreshold == 0 || (uint)pBitStream->GetNumberOfBytesUsed () < uiThreshold )
+        return NULL;
+
+    // Same bitstream as last time?
+    if ( pBitStream != m_pCacheSource )
+    {
+        ClearCache ();
+        m_pCacheSource = pBitStream;
+        m_pCacheResult = DoCompress ( ucPacketID, pBitStream );
+    }
+    return m_pCacheResult;
+}
+
+
+///////////////////////////////////////////////////////////////
+//
+// CPacketCompressor::DoCompress
+//
+//
+//
+///////////////////////////////////////////////////////////////
+NetBitStreamInterface* CPacketCompressor::DoCompress ( uchar ucPacketID, NetBitStreamInterface* pBitStream )
+{
+    TIMEUS startTime = GetTimeUs ();
+
+    uint uiNumBits = pBitStream->GetNumberOfBitsUsed ();
+    uLong ulSrcSize = pBitStream->GetNumberOfBytesUsed ();
+    uLongf ulDestSize = compressBound ( ulSrcSize );
+    m_Buffer.resize ( ulDestSize );
+
+    // Speed matters more than size here as it is done in the main thread
+    NetBitStreamInterface* pResult = NULL;
+    if ( compress2 ( &m_Buffer[0], &ulDestSize, pBitStream->GetData (), ulSrcSize, Z_BEST_SPEED ) == Z_OK && ulDestSize < ulSrcSize )
+    {
+        pResult = g_pNetServer->AllocateNetServerBitStream ( pBitStream->Version () );
+        if ( pResult )
+        {
+            pResult->Write ( ucPacketID );
+            pResult->Write ( uiNumBits );
+            pResult->Write ( (uint)ulDestSize );
+            pResult->Write ( reinterpret_cast < const char* > ( &m_Buffer[0] ), ulDestSize );
+        }
+    }
+
+    SPacketCompressStat& stat = m_Stats [ ucPacketID ];
+    stat.llCount++;
+    stat.llBytesIn += ulSrcSize;
+    stat.llBytesOut += pResult ? pResult->GetNumberOfBytesUsed () : ulSrcSize;
+    stat.llTimeUs += GetTimeUs () - startTime;
+    return pResult;
+}
+
+
+///////////////////////////////////////////////////////////////
+//
+// CPacketCompressor::ClearCache
+//
+// Must be called before the source bitstream is deallocated
+//
+///////////////////////////////////////////////////////////////
+void CPacketCompressor::ClearCache ( void )
+{
+    if ( m_pCacheResult )
+        g_pNetServer->DeallocateNetServerBitStream ( m_pCacheResult );
+    m_pCacheResult = NULL;
+    m_pCacheSource = NULL;
+}
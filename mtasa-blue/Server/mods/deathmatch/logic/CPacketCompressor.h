@@ -0,0 +1,44 @@
+/*****************************************************************************
+*
+*  PROJECT:     Multi Theft Auto v1.0
+*  LICENSE:     See LICENSE in the top level directory
+*  FILE:        mods/deathmatch/logic/CPacketCompressor.h
+*  PURPOSE:     Compression of large reliable packets sent to clients
+*
+*  Multi Theft Auto is available from http://www.multitheftauto.com/
+*
+*****************************************************************************/
+#pragma once
+
+struct SPacketCompressStat
+{
+    long long   llCount;
+    long long   llBytesIn;
+    long long   llBytesOut;
+    long long   llTimeUs;
+};
+
+//
+// Wraps big map/element/resource/event packets in a PACKET_ID_COMPRESSED packet for clients which understand it.
+// When one bitstream is sent to many players, it is only compressed once.
+//
+class CPacketCompressor
+{
+public:
+    ZERO_ON_NEW
+                                CPacketCompressor       ( void );
+                                ~CPacketCompressor      ( void );
+
+    NetBitStreamInterface*      Compress                ( uchar ucPacketID, NetServerPacketReliability reliability, NetBitStreamInterface* pBitStream );
+    void                        ClearCache              ( void );
+    const SPacketCompressStat*  GetStats                ( void ) const          { return m_Stats; }
+
+protected:
+    static bool                 IsCompressiblePacket    ( uchar ucPacketID, NetServerPacketReliability reliability );
+    NetBitStreamInterface*      DoCompress              ( uchar ucPacketID, NetBitStreamInterface* pBitStream );
+
+    NetBitStreamInterface*      m_pCacheSource;
+    NetBitStreamInterface*      m_pCacheResult;         // NULL if the source was not worth compressing
+    std::vector < Bytef >       m_Buffer;
+    SPacketCompressStat         m_Stats [ 256 ];
+};
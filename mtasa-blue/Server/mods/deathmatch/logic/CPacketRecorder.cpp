@@ -0,0 +1,340 @@
+/*****************************************************************************
+*
+*  PROJECT:     Multi Theft Auto v1.0
+*  LICENSE:     See LICENSE in the top level directory
+*  FILE:        mods/deathmatch/logic/CPacketRecorder.cpp
+*  PURPOSE:     Capture of incoming packets to a file, and replay from the file
+*
+*  Multi Theft Auto is available from http://www.multitheftauto.com/
+*
+*****************************************************************************/
+
+#include "StdInc.h"
+#include "net/SimHeaders.h"
+
+
+///////////////////////////////////////////////////////////////
+//
+// CPacketRecorder::CPacketRecorder
+//
+//
+//
+///////////////////////////////////////////////////////////////
+CPacketRecorder::CPacketRecorder ( void )
+{
+}
+
+
+///////////////////////////////////////////////////////////////
+//
+// CPacketRecorder::~CPacketRecorder
+//
+//
+//
+///////////////////////////////////////////////////////////////
+CPacketRecorder::~CPacketRecorder ( void )
+{
+    StopCapture ();
+    StopReplay ();
+    RemoveReplayNetServer ();
+}
+
+
+///////////////////////////////////////////////////////////////
+//
+// CPacketRecorder::StartCapture
+//
+// Captured packets are appended to the file until StopCapture
+//
+///////////////////////////////////////////////////////////////
+bool CPacketRecorder::StartCapture ( const SString& strPathFilename )
+{
+    StopCapture ();
+
+    MakeSureDirExists ( strPathFilename );
+    m_pCaptureFile = File::Fopen ( strPathFilename, "wb" );
+    if ( !m_pCaptureFile )
+        return false;
+
+    fwrite ( PACKET_CAPTURE_MAGIC, 1, 8, m_pCaptureFile );
+    m_strCapturePathFilename = strPathFilename;
+    m_CaptureTime.Reset ();
+    m_uiNumCaptured = 0;
+    m_llCapturedBytes = 8;
+    return true;
+}
+
+
+///////////////////////////////////////////////////////////////
+//
+// CPacketRecorder::StopCapture
+//
+//
+//
+///////////////////////////////////////////////////////////////
+void CPacketRecorder::StopCapture ( void )
+{
+    if ( m_pCaptureFile )
+    {
+        fclose ( m_pCaptureFile );
+        m_pCaptureFile = NULL;
+    }
+}
+
+
+///////////////////////////////////////////////////////////////
+//
+// CPacketRecorder::CapturePacket
+//
+// Save everything needed to recreate the bitstream as given to CGame
+//
+///////////////////////////////////////////////////////////////
+void CPacketRecorder::CapturePacket ( uchar ucPacketID, const NetServerPlayerID& Socket, NetBitStreamInterface* pBitStream )
+{
+    SPacketCaptureRecord record;
+    record.uiTimeMs = static_cast < uint > ( m_CaptureTime.Get () );
+    record.uiBinaryAddress = Socket.GetBinaryAddress ();
+    record.usPort = Socket.GetPort ();
+    record.ucPacketID = ucPacketID;
+    record.ucReserved = 0;
+    record.usBitStreamVersion = pBitStream ? pBitStream->Version () : 0;
+    record.usReadOffsetBits = pBitStream ? static_cast < ushort > ( pBitStream->GetReadOffsetAsBits () ) : 0;
+    record.uiNumBytes = pBitStream ? pBitStream->GetNumberOfBytesUsed () : 0;
+
+    fwrite ( &record, 1, sizeof ( record ), m_pCaptureFile );
+    if ( record.uiNumBytes )
+        fwrite ( pBitStream->GetData (), 1, record.uiNumBytes, m_pCaptureFile );
+
+    m_uiNumCaptured++;
+    m_llCapturedBytes += sizeof ( record ) + record.uiNumBytes;
+}
+
+
+///////////////////////////////////////////////////////////////
+//
+// CPacketRecorder::StartReplay
+//
+// fSpeed is a multiplier of the captured timing, or 0 to go as fast as possible
+//
+///////////////////////////////////////////////////////////////
+bool CPacketRecorder::StartReplay ( const SString& strPathFilename, float fSpeed )
+{
+    StopReplay ();
+
+    m_pReplayFile = File::Fopen ( strPathFilename, "rb" );
+    if ( !m_pReplayFile )
+        return false;
+
+    char szMagic[8];
+    if ( fread ( szMagic, 1, 8, m_pReplayFile ) != 8 || memcmp ( szMagic, PACKET_CAPTURE_MAGIC, 8 ) != 0 )
+    {
+        StopReplay ();
+        return false;
+    }
+
+    m_strReplayPathFilename = strPathFilename;
+    m_fReplaySpeed = std::max ( 0.f, fSpeed );
+    m_ReplayTime.Reset ();
+    m_llReplayProcessUs = 0;
+    m_uiNumReplayed = 0;
+    m_bHasNextRecord = ReadNextRecord ();
+    return true;
+}
+
+
+///////////////////////////////////////////////////////////////
+//
+// CPacketRecorder::StopReplay
+//
+//
+//
+///////////////////////////////////////////////////////////////
+void CPacketRecorder::StopReplay ( void )
+{
+    if ( m_pReplayFile )
+    {
+        fclose ( m_pReplayFile );
+        m_pReplayFile = NULL;
+    }
+    m_bHasNextRecord = false;
+}
+
+
+///////////////////////////////////////////////////////////////
+//
+// CPacketRecorder::ReadNextRecord
+//
+//
+//
+///////////////////////////////////////////////////////////////
+bool CPacketRecorder::ReadNextRecord ( void )
+{
+    if ( fread ( &m_NextRecord, 1, sizeof ( m_NextRecord ), m_pReplayFile ) != sizeof ( m_NextRecord ) )
+        return false;
+
+    // Sanity check
+    if ( m_NextRecord.uiNumBytes > 0x1000000 )
+        return false;
+
+    m_NextRecordData.resize ( m_NextRecord.uiNumBytes );
+    if ( m_NextRecord.uiNumBytes && fread ( &m_NextRecordData[0], 1, m_NextRecord.uiNumBytes, m_pReplayFile ) != m_NextRecord.uiNumBytes )
+        return false;
+
+    return true;
+}
+
+
+///////////////////////////////////////////////////////////////
+//
+// CPacketRecorder::DoPulse
+//
+// Replay packets which are due
+//
+///////////////////////////////////////////////////////////////
+void CPacketRecorder::DoPulse ( void )
+{
+    if ( !m_pReplayFile )
+    {
+        // Keep handling calls for replayed players until they have all gone
+        if ( m_pReplayNetServer )
+        {
+            if ( m_pReplayNetServer->HasReplayPlayers () )
+                InstallReplayNetServer ();
+            else
+                RemoveReplayNetServer ();
+        }
+        return;
+    }
+
+    CElapsedTime pulseTime;
+    while ( m_bHasNextRecord )
+    {
+        if ( m_fReplaySpeed > 0 )
+        {
+            // Wait until the packet is due
+            if ( m_ReplayTime.Get () * m_fReplaySpeed < m_NextRecord.uiTimeMs )
+                break;
+        }
+        else
+        {
+            // Give the rest of the server a chance to run
+            if ( pulseTime.Get () >= PACKET_REPLAY_MAX_PULSE_MS )
+                break;
+        }
+
+        ReplayRecord ();
+        m_bHasNextRecord = ReadNextRecord ();
+    }
+
+    if ( !m_bHasNextRecord )
+    {
+        CLogger::LogPrintf ( "Packet replay finished: %s\n", *GetStatus () );
+        StopReplay ();
+    }
+}
+
+
+///////////////////////////////////////////////////////////////
+//
+// CPacketRecorder::ReplayRecord
+//
+// Feed the packet into the same path as packets from the net module
+//
+///////////////////////////////////////////////////////////////
+void CPacketRecorder::ReplayRecord ( void )
+{
+    const SPacketCaptureRecord& record = m_NextRecord;
+
+    InstallReplayNetServer ();
+
+    NetBitStreamInterface* pBitStream = g_pNetServer->AllocateNetServerBitStream ( record.usBitStreamVersion, record.uiNumBytes ? &m_NextRecordData[0] : NULL, record.uiNumBytes, true );
+    if ( !pBitStream )
+        return;
+    pBitStream->SetReadOffsetAsBits ( record.usReadOffsetBits );
+
+    NetServerPlayerID socket ( record.uiBinaryAddress, record.usPort );
+    m_pReplayNetServer->AddReplaySocket ( socket );
+
+    TIMEUS startTime = GetTimeUs ();
+    m_bReplayingPacket = true;
+    CGame::StaticProcessPacket ( record.ucPacketID, socket, pBitStream, NULL );
+    m_bReplayingPacket = false;
+    m_llReplayProcessUs += GetTimeUs () - startTime;
+    m_uiNumReplayed++;
+
+    g_pNetServer->DeallocateNetServerBitStream ( pBitStream );
+}
+
+
+///////////////////////////////////////////////////////////////
+//
+// CPacketRecorder::InstallReplayNetServer
+//
+// Put the replay net server in front of g_pNetServer
+// Done before every replayed packet, as enabling or disabling threadnet replaces g_pNetServer
+//
+///////////////////////////////////////////////////////////////
+void CPacketRecorder::InstallReplayNetServer ( void )
+{
+    if ( !m_pReplayNetServer )
+        m_pReplayNetServer = new CReplayNetServer ( g_pNetServer );
+
+    if ( g_pNetServer != m_pReplayNetServer )
+    {
+        m_pReplayNetServer->SetNextNetServer ( g_pNetServer );
+        g_pNetServer = m_pReplayNetServer;
+    }
+}
+
+
+///////////////////////////////////////////////////////////////
+//
+// CPacketRecorder::RemoveReplayNetServer
+//
+//
+//
+///////////////////////////////////////////////////////////////
+void CPacketRecorder::RemoveReplayNetServer ( void )
+{
+    if ( !m_pReplayNetServer )
+        return;
+
+    if ( g_pNetServer == m_pReplayNetServer )
+        g_pNetServer = m_pReplayNetServer->GetNextNetServer ();
+    SAFE_DELETE ( m_pReplayNetServer );
+}
+
+
+///////////////////////////////////////////////////////////////
+//
+// CPacketRecorder::GetStatus
+//
+//
+//
+///////////////////////////////////////////////////////////////
+SString CPacketRecorder::GetStatus ( void )
+{
+    SString strStatus;
+    if ( m_pCaptureFile )
+        strStatus += SString ( "Capturing to %s (%u packets, %lld KB, %u seconds)", *m_strCapturePathFilename, m_uiNumCaptured, m_llCapturedBytes / 1024, (uint)( m_CaptureTime.Get () / 1000 ) );
+    else
+        strStatus += "Not capturing";
+
+    strStatus += ". ";
+
+    if ( m_strReplayPathFilename.empty () )
+        strStatus += "Not replaying";
+    else
+        strStatus += SString ( "%s %s (%u packets in %.1f seconds, %.1f ms processing, %.1f us per packet)"
+                                    , m_pReplayFile ? "Replaying" : "Replayed"
+                                    , *m_strReplayPathFilename
+                                    , m_uiNumReplayed
+                                    , m_ReplayTime.Get () / 1000.f
+                                    , m_llReplayProcessUs / 1000.f
+                                    , m_uiNumReplayed ? (float)m_llReplayProcessUs / m_uiNumReplayed : 0.f
+                                );
+
+    if ( m_pReplayNetServer )
+        strStatus += ". " + m_pReplayNetServer->GetStatus ();
+    return strStatus;
+}
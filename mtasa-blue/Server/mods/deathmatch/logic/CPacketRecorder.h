@@ -0,0 +1,89 @@
+/*****************************************************************************
+*
+*  PROJECT:     Multi Theft Auto v1.0
+*  LICENSE:     See LICENSE in the top level directory
+*  FILE:        mods/deathmatch/logic/CPacketRecorder.h
+*  PURPOSE:     Capture of incoming packets to a file, and replay from the file
+*
+*  Multi Theft Auto is available from http://www.multitheftauto.com/
+*
+*****************************************************************************/
+#pragma once
+
+#define PACKET_CAPTURE_MAGIC            "MTAPCAP1"
+#define PACKET_REPLAY_MAX_PULSE_MS      20          // Max time spent replaying per pulse when running flat out
+
+//
+// Fixed size header before the bitstream data of each captured packet
+//
+struct SPacketCaptureRecord
+{
+    uint        uiTimeMs;               // Since the start of the capture
+    uint        uiBinaryAddress;
+    ushort      usPort;
+    uchar       ucPacketID;
+    uchar       ucReserved;
+    ushort      usBitStreamVersion;
+    ushort      usReadOffsetBits;
+    uint        uiNumBytes;
+};
+static_assert ( sizeof ( SPacketCaptureRecord ) == 20, "SPacketCaptureRecord layout must not change" );
+
+//
+// Records packets as they are given to CGame::StaticProcessPacket, and can feed them back in later
+// Replayed packets use the captured player addresses, so replay should be done on a server without real players
+// While replayed players exist, g_pNetServer is wrapped by a CReplayNetServer so nothing for them reaches the net module
+//
+class CPacketRecorder
+{
+public:
+    ZERO_ON_NEW
+                        CPacketRecorder         ( void );
+                        ~CPacketRecorder        ( void );
+
+    void                DoPulse                 ( void );
+
+    bool                StartCapture            ( const SString& strPathFilename );
+    void                StopCapture             ( void );
+    bool                IsCapturing             ( void ) const          { return m_pCaptureFile != NULL; }
+
+    bool                StartReplay             ( const SString& strPathFilename, float fSpeed );
+    void                StopReplay              ( void );
+    bool                IsReplaying             ( void ) const          { return m_pReplayFile != NULL; }
+    bool                IsReplayingPacket       ( void ) const          { return m_bReplayingPacket; }
+
+    SString             GetStatus               ( void );
+
+    void OnPacket ( uchar ucPacketID, const NetServerPlayerID& Socket, NetBitStreamInterface* pBitStream )
+    {
+        if ( m_pCaptureFile && !m_bReplayingPacket )
+            CapturePacket ( ucPacketID, Socket, pBitStream );
+    }
+
+protected:
+    void                CapturePacket           ( uchar ucPacketID, const NetServerPlayerID& Socket, NetBitStreamInterface* pBitStream );
+    bool                ReadNextRecord          ( void );
+    void                ReplayRecord            ( void );
+    void                InstallReplayNetServer  ( void );
+    void                RemoveReplayNetServer   ( void );
+
+    // Capture
+    FILE*                               m_pCaptureFile;
+    SString                             m_strCapturePathFilename;
+    CElapsedTime                        m_CaptureTime;
+    uint                                m_uiNumCaptured;
+    long long                           m_llCapturedBytes;
+
+    // Replay
+    FILE*                               m_pReplayFile;
+    SString                             m_strReplayPathFilename;
+    float                               m_fReplaySpeed;         // 0 = as fast as possible
+    CElapsedTime                        m_ReplayTime;
+    long long                           m_llReplayProcessUs;
+    SPacketCaptureRecord                m_NextRecord;
+    std::vector < char >                m_NextRecordData;
+    bool                                m_bHasNextRecord;
+    bool                                m_bReplayingPacket;
+    uint                                m_uiNumReplayed;
+    class CReplayNetServer*             m_pReplayNetServer;
+};
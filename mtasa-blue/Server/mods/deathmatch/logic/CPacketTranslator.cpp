@@ -18,171 +18,258 @@
 CPacketTranslator::CPacketTranslator ( CPlayerManager* pPlayerManager )
 {
     m_pPlayerManager = pPlayerManager;
+    memset ( &m_AllocStats, 0, sizeof ( m_AllocStats ) );
 }
 
 
 CPacketTranslator::~CPacketTranslator ( void )
 {
+    for ( uint i = 0 ; i < 256 ; i++ )
+    {
+        for ( uint p = 0 ; p < m_PacketPools[i].size () ; p++ )
+            delete m_PacketPools[i][p];
+        m_PacketPools[i].clear ();
+    }
+}
+
+
+///////////////////////////////////////////////////////////////
+//
+// CPacketTranslator::IsPooledPacketType
+//
+// Packet types which arrive many times a second from every player
+//
+///////////////////////////////////////////////////////////////
+bool CPacketTranslator::IsPooledPacketType ( ePacketID PacketID )
+{
+    switch ( (int)PacketID )
+    {
+        case PACKET_ID_PLAYER_PURESYNC:
+        case PACKET_ID_PLAYER_VEHICLE_PURESYNC:
+        case PACKET_ID_PLAYER_KEYSYNC:
+        case PACKET_ID_PLAYER_BULLETSYNC:
+        case PACKET_ID_WEAPON_BULLETSYNC:
+        case PACKET_ID_PED_TASK:
+        case PACKET_ID_UNOCCUPIED_VEHICLE_SYNC:
+        case PACKET_ID_PED_SYNC:
+        case PACKET_ID_OBJECT_SYNC:
+        case PACKET_ID_CAMERA_SYNC:
+            return true;
+
+        default:
+            return false;
+    }
+}
+
+
+///////////////////////////////////////////////////////////////
+//
+// CPacketTranslator::AcquirePooledPacket
+//
+// Returns NULL if there is nothing in the pool for this type
+//
+///////////////////////////////////////////////////////////////
+CPacket* CPacketTranslator::AcquirePooledPacket ( ePacketID PacketID )
+{
+    std::vector < CPacket* >& pool = m_PacketPools [ PacketID ];
+    if ( pool.empty () )
+        return NULL;
 
+    CPacket* pPacket = pool.back ();
+    pool.pop_back ();
+    return pPacket;
+}
+
+
+///////////////////////////////////////////////////////////////
+//
+// CPacketTranslator::ReleasePacket
+//
+// Call instead of delete for packets returned from Translate
+//
+///////////////////////////////////////////////////////////////
+void CPacketTranslator::ReleasePacket ( CPacket* pPacket )
+{
+    ePacketID PacketID = pPacket->GetPacketID ();
+    if ( IsPooledPacketType ( PacketID ) )
+    {
+        std::vector < CPacket* >& pool = m_PacketPools [ PacketID ];
+        if ( pool.size () < PACKET_POOL_MAX_PER_TYPE )
+        {
+            pPacket->Recycle ();
+            pPacket->SetSourceElement ( NULL );
+            pool.push_back ( pPacket );
+            return;
+        }
+    }
+    delete pPacket;
 }
 
 
 CPacket* CPacketTranslator::Translate ( const NetServerPlayerID& Socket, ePacketID PacketID, NetBitStreamInterface& BitStream, SNetExtraInfo* pNetExtraInfo )
 {
-    // Create the packet class
-    CPacket* pTemp = NULL;
-    switch ( (int)PacketID )
+    // Reuse a previous packet class if possible
+    CPacket* pTemp = AcquirePooledPacket ( PacketID );
+
+    // Otherwise create the packet class
+    bool bFromPool = pTemp != NULL;
+    if ( !pTemp )
     {
-        case PACKET_ID_PLAYER_JOIN:
-            pTemp = new CPlayerJoinPacket;
-            break;
+        switch ( (int)PacketID )
+        {
+            case PACKET_ID_PLAYER_JOIN:
+                pTemp = new CPlayerJoinPacket;
+                break;
 
-        case PACKET_ID_PLAYER_JOINDATA:
-            pTemp = new CPlayerJoinDataPacket;
-            break;
+            case PACKET_ID_PLAYER_JOINDATA:
+                pTemp = new CPlayerJoinDataPacket;
+                break;
 
-        case PACKET_ID_PED_WASTED:
-            pTemp = new CPedWastedPacket;
-            break;
+            case PACKET_ID_PED_WASTED:
+                pTemp = new CPedWastedPacket;
+                break;
 
-        case PACKET_ID_PLAYER_WASTED:
-            pTemp = new CPlayerWastedPacket;
-            break;
+            case PACKET_ID_PLAYER_WASTED:
+                pTemp = new CPlayerWastedPacket;
+                break;
 
-        case PACKET_ID_PLAYER_QUIT:
-            pTemp = new CPlayerQuitPacket;
-            break;
+            case PACKET_ID_PLAYER_QUIT:
+                pTemp = new CPlayerQuitPacket;
+                break;
 
-        case PACKET_ID_PLAYER_TIMEOUT:
-            pTemp = new CPlayerTimeoutPacket;
-            break;
+            case PACKET_ID_PLAYER_TIMEOUT:
+                pTemp = new CPlayerTimeoutPacket;
+                break;
 
-        case PACKET_ID_PLAYER_PURESYNC:
-            pTemp = new CPlayerPuresyncPacket;
-            break;
+            case PACKET_ID_PLAYER_PURESYNC:
+                pTemp = new CPlayerPuresyncPacket;
+                break;
 
-        case PACKET_ID_PLAYER_VEHICLE_PURESYNC:
-            pTemp = new CVehiclePuresyncPacket;
-            break;
+            case PACKET_ID_PLAYER_VEHICLE_PURESYNC:
+                pTemp = new CVehiclePuresyncPacket;
+                break;
 
-        case PACKET_ID_PLAYER_KEYSYNC:
-            pTemp = new CKeysyncPacket;
-            break;
+            case PACKET_ID_PLAYER_KEYSYNC:
+                pTemp = new CKeysyncPacket;
+                break;
 
-        case PACKET_ID_PLAYER_BULLETSYNC:
-            pTemp = new CBulletsyncPacket;
-            break;
+            case PACKET_ID_PLAYER_BULLETSYNC:
+                pTemp = new CBulletsyncPacket;
+                break;
 
-        case PACKET_ID_PED_TASK:
-            pTemp = new CPedTaskPacket;
-            break;
+            case PACKET_ID_PED_TASK:
+                pTemp = new CPedTaskPacket;
+                break;
 
-        case PACKET_ID_WEAPON_BULLETSYNC:
-            pTemp = new CCustomWeaponBulletSyncPacket;
-            break;
+            case PACKET_ID_WEAPON_BULLETSYNC:
+                pTemp = new CCustomWeaponBulletSyncPacket;
+                break;
 
-        case PACKET_ID_DETONATE_SATCHELS:
-            pTemp = new CDetonateSatchelsPacket;
-            break;
+            case PACKET_ID_DETONATE_SATCHELS:
+                pTemp = new CDetonateSatchelsPacket;
+                break;
 
-        case PACKET_ID_DESTROY_SATCHELS:
-            pTemp = new CDestroySatchelsPacket;
-            break;
+            case PACKET_ID_DESTROY_SATCHELS:
+                pTemp = new CDestroySatchelsPacket;
+                break;
 
-        case PACKET_ID_COMMAND:
-            pTemp = new CCommandPacket;
-            break;
+            case PACKET_ID_COMMAND:
+                pTemp = new CCommandPacket;
+                break;
 
-        case PACKET_ID_EXPLOSION:
-            pTemp = new CExplosionSyncPacket;
-            break;
+            case PACKET_ID_EXPLOSION:
+                pTemp = new CExplosionSyncPacket;
+                break;
 
-        case PACKET_ID_PROJECTILE:
-            pTemp = new CProjectileSyncPacket;
-            break;
+            case PACKET_ID_PROJECTILE:
+                pTemp = new CProjectileSyncPacket;
+                break;
 
-        case PACKET_ID_VEHICLE_INOUT:
-            pTemp = new CVehicleInOutPacket;
-            break;
+            case PACKET_ID_VEHICLE_INOUT:
+                pTemp = new CVehicleInOutPacket;
+                break;
 
-        case PACKET_ID_VEHICLE_DAMAGE_SYNC:
-            pTemp = new CVehicleDamageSyncPacket;
-            break;
+            case PACKET_ID_VEHICLE_DAMAGE_SYNC:
+                pTemp = new CVehicleDamageSyncPacket;
+                break;
 
-        case PACKET_ID_VEHICLE_TRAILER:
-            pTemp = new CVehicleTrailerPacket;
-            break;
+            case PACKET_ID_VEHICLE_TRAILER:
+                pTemp = new CVehicleTrailerPacket;
+                break;
 
-        case PACKET_ID_VOICE_DATA:
-            pTemp = new CVoiceDataPacket;
-            break;
+            case PACKET_ID_VOICE_DATA:
+                pTemp = new CVoiceDataPacket;
+                break;
 
-        case PACKET_ID_VOICE_END:
-            pTemp = new CVoiceEndPacket;
-            break;
+            case PACKET_ID_VOICE_END:
+                pTemp = new CVoiceEndPacket;
+                break;
 
-        case PACKET_ID_UNOCCUPIED_VEHICLE_SYNC:
-            pTemp = new CUnoccupiedVehicleSyncPacket;
-            break;
+            case PACKET_ID_UNOCCUPIED_VEHICLE_SYNC:
+                pTemp = new CUnoccupiedVehicleSyncPacket;
+                break;
 
-        case PACKET_ID_PED_SYNC:
-            pTemp = new CPedSyncPacket;
-            break;
+            case PACKET_ID_PED_SYNC:
+                pTemp = new CPedSyncPacket;
+                break;
 
-        case PACKET_ID_LUA_EVENT:
-            pTemp = new CLuaEventPacket;
-            break;
+            case PACKET_ID_LUA_EVENT:
+                pTemp = new CLuaEventPacket;
+                break;
 
-        case PACKET_ID_CUSTOM_DATA:
-            pTemp = new CCustomDataPacket;
-            break;
+            case PACKET_ID_CUSTOM_DATA:
+                pTemp = new CCustomDataPacket;
+                break;
 
-        case PACKET_ID_CAMERA_SYNC:
-            pTemp = new CCameraSyncPacket;
-            break;
+            case PACKET_ID_CAMERA_SYNC:
+                pTemp = new CCameraSyncPacket;
+                break;
 
-        case PACKET_ID_OBJECT_SYNC:
-            pTemp = new CObjectSyncPacket;
-            break;
+            case PACKET_ID_OBJECT_SYNC:
+                pTemp = new CObjectSyncPacket;
+                break;
 
-        case PACKET_ID_PLAYER_TRANSGRESSION:
-            pTemp = new CPlayerTransgressionPacket;
-            break;
+            case PACKET_ID_PLAYER_TRANSGRESSION:
+                pTemp = new CPlayerTransgressionPacket;
+                break;
 
-        case PACKET_ID_PLAYER_DIAGNOSTIC:
-            pTemp = new CPlayerDiagnosticPacket;
-            break;
+            case PACKET_ID_PLAYER_DIAGNOSTIC:
+                pTemp = new CPlayerDiagnosticPacket;
+                break;
 
-        case PACKET_ID_PLAYER_MODINFO:
-            pTemp = new CPlayerModInfoPacket;
-            break;
+            case PACKET_ID_PLAYER_MODINFO:
+                pTemp = new CPlayerModInfoPacket;
+                break;
 
-        case PACKET_ID_PLAYER_ACINFO:
-            pTemp = new CPlayerACInfoPacket;
-            break;
+            case PACKET_ID_PLAYER_ACINFO:
+                pTemp = new CPlayerACInfoPacket;
+                break;
 
-        case PACKET_ID_PLAYER_SCREENSHOT:
-            pTemp = new CPlayerScreenShotPacket;
-            break;
+            case PACKET_ID_PLAYER_SCREENSHOT:
+                pTemp = new CPlayerScreenShotPacket;
+                break;
 
-        case PACKET_ID_VEHICLE_PUSH_SYNC:
-            pTemp = new CUnoccupiedVehiclePushPacket;
-            break;
+            case PACKET_ID_VEHICLE_PUSH_SYNC:
+                pTemp = new CUnoccupiedVehiclePushPacket;
+                break;
 
-        case PACKET_ID_PLAYER_NO_SOCKET:
-            pTemp = new CPlayerNoSocketPacket;
-            break;
+            case PACKET_ID_PLAYER_NO_SOCKET:
+                pTemp = new CPlayerNoSocketPacket;
+                break;
  
-        case PACKET_ID_PLAYER_NETWORK_STATUS:
-            pTemp = new CPlayerNetworkStatusPacket;
-            break;
+            case PACKET_ID_PLAYER_NETWORK_STATUS:
+                pTemp = new CPlayerNetworkStatusPacket;
+                break;
 
-        default: break;
+            default: break;
+        }
     }
 
     // Could we create the packet?
     if ( pTemp )
     {
+        if ( !bFromPool )
+            m_AllocStats[ PacketID ].llAllocated++;
         // Set the source socket and player
         pTemp->SetSourceSocket ( Socket );
 
@@ -202,18 +289,21 @@ CPacket* CPacketTranslator::Translate ( const NetServerPlayerID& Socket, ePacket
         // Check we have a source player if the packet type needs it
         if ( !pSourcePlayer && pTemp->RequiresSourcePlayer () )
         {
-            delete pTemp;
+            ReleasePacket ( pTemp );
             pTemp = NULL;
         }
         else
         // Attempt to read the content, if we fail, delete the packet again
         if ( !pTemp->Read ( BitStream ) )
         {
-            delete pTemp;
+            ReleasePacket ( pTemp );
             pTemp = NULL;
         }
     }
 
+    if ( pTemp )
+        m_AllocStats[ PacketID ].llTranslated++;
+
     // Return the class
     return pTemp;
 }
@@ -23,6 +23,14 @@ class CPacketTranslator;
 // Left in for dummy purposes
 #include "packets/CVoiceDataPacket.h"
 
+#define PACKET_POOL_MAX_PER_TYPE        64
+
+struct SPacketAllocStat
+{
+    long long               llTranslated;       // Packets returned from Translate
+    long long               llAllocated;        // Packets which had to be created with new
+};
+
 class CPacketTranslator
 {
 public:
@@ -30,9 +38,19 @@ public:
                             ~CPacketTranslator      ( void );
 
     CPacket*                Translate               ( const NetServerPlayerID& Socket, ePacketID PacketID, NetBitStreamInterface& BitStream, SNetExtraInfo* pNetExtraInfo );
+    void                    ReleasePacket           ( CPacket* pPacket );
+
+    const SPacketAllocStat* GetAllocStats           ( void ) const      { return m_AllocStats.data; }
 
 private:
+    static bool             IsPooledPacketType      ( ePacketID PacketID );
+    CPacket*                AcquirePooledPacket     ( ePacketID PacketID );
+
     CPlayerManager*         m_pPlayerManager;
+
+    // High frequency packet types are reused instead of being deleted after processing
+    SFixedArray < std::vector < CPacket* >, 256 >   m_PacketPools;
+    SFixedArray < SPacketAllocStat, 256 >           m_AllocStats;
 };
 
 #endif
@@ -79,29 +79,31 @@ void CPerPlayerEntity::OnReferencedSubtreeRemove ( CElement* pElement )
 
 void CPerPlayerEntity::UpdatePerPlayer ( void )
 {
-    if ( m_PlayersAdded.empty () && m_PlayersRemoved.empty () )    // This check reduces cpu usage when loading large maps (due to recursion)
+    if ( m_PlayersAdded.IsEmpty () && m_PlayersRemoved.IsEmpty () )    // This check reduces cpu usage when loading large maps (due to recursion)
         return;
 
     // Remove entries that match in both added and removed lists
-    RemoveIdenticalEntries ( m_PlayersAdded, m_PlayersRemoved );
+    m_PlayersAdded.RemoveCommon ( m_PlayersRemoved );
+
+    CPlayerManager* pPlayerManager = g_pGame->GetPlayerManager ();
 
     // Delete us for every player in our deleted list
-    std::set < CPlayer* > ::const_iterator iter = m_PlayersRemoved.begin ();
-    for ( ; iter != m_PlayersRemoved.end (); iter++ )
-    {
-        DestroyEntity ( *iter );
-    }
+    m_PlayersRemoved.ForEach ( [&] ( uint uiSlot )
+        {
+            if ( CPlayer* pPlayer = pPlayerManager->GetFromSlot ( uiSlot ) )
+                DestroyEntity ( pPlayer );
+        } );
 
     // Add us for every player in our added list
-    iter = m_PlayersAdded.begin ();
-    for ( ; iter != m_PlayersAdded.end (); iter++ )
-    {
-        CreateEntity ( *iter );
-    }
+    m_PlayersAdded.ForEach ( [&] ( uint uiSlot )
+        {
+            if ( CPlayer* pPlayer = pPlayerManager->GetFromSlot ( uiSlot ) )
+                CreateEntity ( pPlayer );
+        } );
 
     // Clear both lists
-    m_PlayersAdded.clear ();
-    m_PlayersRemoved.clear ();
+    m_PlayersAdded.ClearAll ();
+    m_PlayersRemoved.ClearAll ();
 }
 
 
@@ -187,7 +189,7 @@ bool CPerPlayerEntity::IsVisibleToReferenced ( CElement* pElement )
 bool CPerPlayerEntity::IsVisibleToPlayer ( CPlayer& Player )
 {
     // Return true if we're visible to the given player
-    return MapContains( m_Players, &Player );
+    return m_Players.IsSet ( Player.GetPlayerSlot () );
 }
 
 
@@ -212,7 +214,7 @@ void CPerPlayerEntity::CreateEntity ( CPlayer* pPlayer )
         }
         else
         {
-            //CLogger::DebugPrintf ( "Created %u (%s) for everyone (%u)\n", GetID (), GetName (), m_Players.size () );
+            //CLogger::DebugPrintf ( "Created %u (%s) for everyone (%u)\n", GetID (), GetName (), m_Players.Count () );
             BroadcastOnlyVisible ( Packet );
         }
     }
@@ -239,7 +241,7 @@ void CPerPlayerEntity::DestroyEntity ( CPlayer* pPlayer )
         }
         else
         {
-            //CLogger::DebugPrintf ( "Destroyed %u (%s) for everyone (%u)\n", GetID (), GetName (), m_Players.size () );
+            //CLogger::DebugPrintf ( "Destroyed %u (%s) for everyone (%u)\n", GetID (), GetName (), m_Players.Count () );
             BroadcastOnlyVisible ( Packet );
         }
     }
@@ -252,17 +254,15 @@ void CPerPlayerEntity::BroadcastOnlyVisible ( const CPacket& Packet )
     if ( m_bIsSynced )
     {
         CPlayerManager* pPlayerManager = g_pGame->GetPlayerManager();
-        for ( std::set < CPlayer* >::iterator iter = m_Players.begin() ; iter != m_Players.end() ; )
-        {
-            if ( !pPlayerManager->Exists( *iter ) )
+        m_Players.ForEach ( [&] ( uint uiSlot )
             {
-                // Why does this happen?
-                // CLogger::ErrorPrintf( "CPerPlayerEntity removed invalid player from list: %08x", *iter );
-                m_Players.erase( iter++ );
-            }
-            else
-                ++iter;
-        }
+                if ( !pPlayerManager->GetFromSlot ( uiSlot ) )
+                {
+                    // Why does this happen?
+                    // CLogger::ErrorPrintf( "CPerPlayerEntity removed invalid player slot from list: %u", uiSlot );
+                    m_Players.Clear ( uiSlot );
+                }
+            } );
 
         // Send it to all players we're visible to
         CPlayerManager::Broadcast ( Packet, m_Players );
@@ -270,25 +270,7 @@ void CPerPlayerEntity::BroadcastOnlyVisible ( const CPacket& Packet )
 }
 
 
-void CPerPlayerEntity::RemoveIdenticalEntries ( std::set < CPlayer* >& List1, std::set < CPlayer* >& List2 )
-{
-    std::vector < CPlayer* > dupList;
-
-    // Make list of dups
-    for ( std::set < CPlayer* > ::iterator it = List1.begin (); it != List1.end (); it++ )
-        if ( MapContains( List2, *it ) )
-            dupList.push_back( *it );
-
-    // Remove dups from both lists
-    for ( std::vector < CPlayer* > ::iterator it = dupList.begin (); it != dupList.end (); it++ )
-    {
-        MapRemove( List1, *it );
-        MapRemove( List2, *it );
-    }
-}
-
-
-void CPerPlayerEntity::AddPlayersBelow ( CElement* pElement, std::set < CPlayer* >& Added )
+void CPerPlayerEntity::AddPlayersBelow ( CElement* pElement, CPlayerBitSet& Added )
 {
     assert ( pElement );
 
@@ -299,7 +281,7 @@ void CPerPlayerEntity::AddPlayersBelow ( CElement* pElement, std::set < CPlayer*
         CPlayer* pPlayer = static_cast < CPlayer* > ( pElement );
         if ( !IsVisibleToPlayer ( *pPlayer ) )
         {
-            MapInsert( Added, pPlayer );
+            Added.Set ( pPlayer->GetPlayerSlot () );
         }
 
         // Add it to our reference list
@@ -317,7 +299,7 @@ void CPerPlayerEntity::AddPlayersBelow ( CElement* pElement, std::set < CPlayer*
 }
 
 
-void CPerPlayerEntity::RemovePlayersBelow ( CElement* pElement, std::set < CPlayer* >& Removed )
+void CPerPlayerEntity::RemovePlayersBelow ( CElement* pElement, CPlayerBitSet& Removed )
 {
     assert ( pElement );
 
@@ -331,7 +313,7 @@ void CPerPlayerEntity::RemovePlayersBelow ( CElement* pElement, std::set < CPlay
         // Did we just loose the last reference to that player? Add him to the list over removed players.
         if ( !IsVisibleToPlayer ( *pPlayer ) )
         {
-            MapInsert( Removed, pPlayer );
+            Removed.Set ( pPlayer->GetPlayerSlot () );
         }
     }
 
@@ -349,7 +331,7 @@ void CPerPlayerEntity::RemovePlayersBelow ( CElement* pElement, std::set < CPlay
 void CPerPlayerEntity::AddPlayerReference ( CPlayer* pPlayer )
 {
     if ( g_pGame->GetPlayerManager()->Exists( pPlayer ) )
-        MapInsert( m_Players, pPlayer );
+        m_Players.Set ( pPlayer->GetPlayerSlot () );
     else
         CLogger::ErrorPrintf( "CPerPlayerEntity tried to add reference for non existing player: %08x\n", pPlayer );
 }
@@ -357,7 +339,7 @@ void CPerPlayerEntity::AddPlayerReference ( CPlayer* pPlayer )
 
 void CPerPlayerEntity::RemovePlayerReference ( CPlayer* pPlayer )
 {
-    MapRemove( m_Players, pPlayer );
+    m_Players.Clear ( pPlayer->GetPlayerSlot () );
 }
 
 
@@ -366,6 +348,9 @@ void CPerPlayerEntity::RemovePlayerReference ( CPlayer* pPlayer )
 //
 void CPerPlayerEntity::StaticOnPlayerDelete ( CPlayer* pPlayer )
 {
+    if ( pPlayer->GetPlayerSlot () == INVALID_PLAYER_SLOT )
+        return;
+
     for ( std::set < CPerPlayerEntity* >::iterator iter = ms_AllPerPlayerEntityMap.begin (); iter != ms_AllPerPlayerEntityMap.end () ; ++iter )
     {
         (*iter)->OnPlayerDelete ( pPlayer );
@@ -375,28 +360,9 @@ void CPerPlayerEntity::StaticOnPlayerDelete ( CPlayer* pPlayer )
 
 void CPerPlayerEntity::OnPlayerDelete ( CPlayer* pPlayer )
 {
-    /* Caz - Debug code disabled because it is being fixed by removing them from the map and the error is misleading users*/
-    //SString strStatus;
-    if ( MapContains( m_Players, pPlayer ) )
-    {
-        //strStatus += "m_Players ";
-        MapRemove( m_Players, pPlayer );
-    }
-
-    if ( MapContains( m_PlayersAdded, pPlayer ) )
-    {
-        //strStatus += "m_PlayersAdded ";
-        MapRemove( m_PlayersAdded, pPlayer );
-    }
-
-    if ( MapContains( m_PlayersRemoved, pPlayer ) )
-    {
-        //strStatus += "m_PlayersRemoved ";
-        MapRemove( m_PlayersRemoved, pPlayer );
-    }
-
-    /*if ( !strStatus.empty() )
-    {
-        CLogger::ErrorPrintf( "CPerPlayerEntity problem: %s\n", *strStatus );
-    }*/
+    // The slot will be given to the next player who connects, so make sure nothing is left set
+    uint uiSlot = pPlayer->GetPlayerSlot ();
+    m_Players.Clear ( uiSlot );
+    m_PlayersAdded.Clear ( uiSlot );
+    m_PlayersRemoved.Clear ( uiSlot );
 }
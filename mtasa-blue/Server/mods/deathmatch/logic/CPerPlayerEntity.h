@@ -14,6 +14,7 @@
 #define __CPERPLAYERENTITY_H
 
 #include "CElement.h"
+#include "CPlayerBitSet.h"
 #include "packets/CPacket.h"
 
 class CPerPlayerEntity : public CElement
@@ -42,7 +43,7 @@ public:
 
     bool                        IsVisibleToPlayer               ( CPlayer& Player );
 
-    const std::set < CPlayer * >&   GetPlayersList              ( void )                    { return m_Players; }
+    const CPlayerBitSet&        GetPlayersList                  ( void )                    { return m_Players; }
 
     static void                 StaticOnPlayerDelete            ( CPlayer* pPlayer );
     void                        OnPlayerDelete                  ( CPlayer* pPlayer );
@@ -57,17 +58,15 @@ protected:
     list < CElement* >          m_ElementReferences;
 
 private:
-    void                        RemoveIdenticalEntries          ( std::set < class CPlayer* >& List1, std::set < class CPlayer* >& List2 );
-
-    void                        AddPlayersBelow                 ( CElement* pElement, std::set < class CPlayer* >& Added );
-    void                        RemovePlayersBelow              ( CElement* pElement, std::set < class CPlayer* >& Removed );
+    void                        AddPlayersBelow                 ( CElement* pElement, CPlayerBitSet& Added );
+    void                        RemovePlayersBelow              ( CElement* pElement, CPlayerBitSet& Removed );
 
     void                        AddPlayerReference              ( class CPlayer* pPlayer );
     void                        RemovePlayerReference           ( class CPlayer* pPlayer );
 
-    std::set < CPlayer* >       m_PlayersAdded;
-    std::set < CPlayer* >       m_PlayersRemoved;
-    std::set < CPlayer* >       m_Players;
+    CPlayerBitSet               m_PlayersAdded;
+    CPlayerBitSet               m_PlayersRemoved;
+    CPlayerBitSet               m_Players;
 
     static std::set < CPerPlayerEntity* > ms_AllPerPlayerEntityMap;
 };
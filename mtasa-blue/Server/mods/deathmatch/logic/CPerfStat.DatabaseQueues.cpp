@@ -0,0 +1,167 @@
+/*****************************************************************************
+*
+*  PROJECT:     Multi Theft Auto v1.0
+*  LICENSE:     See LICENSE in the top level directory
+*  FILE:        mods/deathmatch/logic/CPerfStat.DatabaseQueues.cpp
+*  PURPOSE:     Performance stats manager class
+*
+*  Multi Theft Auto is available from http://www.multitheftauto.com/
+*
+*****************************************************************************/
+
+#include "StdInc.h"
+
+///////////////////////////////////////////////////////////////
+//
+// CPerfStatDatabaseQueuesImpl
+//
+//
+//
+///////////////////////////////////////////////////////////////
+class CPerfStatDatabaseQueuesImpl : public CPerfStatDatabaseQueues
+{
+public:
+    ZERO_ON_NEW
+                                CPerfStatDatabaseQueuesImpl  ( void );
+    virtual                     ~CPerfStatDatabaseQueuesImpl ( void );
+
+    // CPerfStatModule
+    virtual const SString&      GetCategoryName         ( void );
+    virtual void                DoPulse                 ( void );
+    virtual void                GetStats                ( CPerfStatResult* pOutResult, const std::map < SString, int >& optionMap, const SString& strFilter );
+
+    SString                     m_strCategoryName;
+};
+
+
+///////////////////////////////////////////////////////////////
+//
+// Temporary home for global object
+//
+//
+//
+///////////////////////////////////////////////////////////////
+static std::unique_ptr<CPerfStatDatabaseQueuesImpl> g_pPerfStatDatabaseQueuesImp;
+
+CPerfStatDatabaseQueues* CPerfStatDatabaseQueues::GetSingleton ()
+{
+    if ( !g_pPerfStatDatabaseQueuesImp )
+        g_pPerfStatDatabaseQueuesImp.reset(new CPerfStatDatabaseQueuesImpl ());
+    return g_pPerfStatDatabaseQueuesImp.get();
+}
+
+
+///////////////////////////////////////////////////////////////
+//
+// CPerfStatDatabaseQueuesImpl::CPerfStatDatabaseQueuesImpl
+//
+//
+//
+///////////////////////////////////////////////////////////////
+CPerfStatDatabaseQueuesImpl::CPerfStatDatabaseQueuesImpl ( void )
+{
+    m_strCategoryName = "Database queues";
+}
+
+
+///////////////////////////////////////////////////////////////
+//
+// CPerfStatDatabaseQueuesImpl::~CPerfStatDatabaseQueuesImpl
+//
+//
+//
+///////////////////////////////////////////////////////////////
+CPerfStatDatabaseQueuesImpl::~CPerfStatDatabaseQueuesImpl ( void )
+{
+}
+
+
+///////////////////////////////////////////////////////////////
+//
+// CPerfStatDatabaseQueuesImpl::GetCategoryName
+//
+//
+//
+///////////////////////////////////////////////////////////////
+const SString& CPerfStatDatabaseQueuesImpl::GetCategoryName ( void )
+{
+    return m_strCategoryName;
+}
+
+
+///////////////////////////////////////////////////////////////
+//
+// CPerfStatDatabaseQueuesImpl::DoPulse
+//
+// Timings are collected by the job queues
+//
+///////////////////////////////////////////////////////////////
+void CPerfStatDatabaseQueuesImpl::DoPulse ( void )
+{
+}
+
+
+///////////////////////////////////////////////////////////////
+//
+// CPerfStatDatabaseQueuesImpl::GetStats
+//
+//
+//
+///////////////////////////////////////////////////////////////
+void CPerfStatDatabaseQueuesImpl::GetStats ( CPerfStatResult* pResult, const std::map < SString, int >& optionMap, const SString& strFilter )
+{
+    //
+    // Set option flags
+    //
+    bool bHelp = MapContains ( optionMap, "h" );
+
+    //
+    // Process help
+    //
+    if ( bHelp )
+    {
+        pResult->AddColumn ( "Database queues help" );
+        pResult->AddRow ()[0] ="Option h - This help";
+        pResult->AddRow ()[0] ="Timings cover queries completed in the last 10 to 20 seconds";
+        return;
+    }
+
+    //
+    // Set column names
+    //
+    pResult->AddColumn ( "Queue" );
+    pResult->AddColumn ( "Workers" );
+    pResult->AddColumn ( "Connections" );
+    pResult->AddColumn ( "Waiting" );
+    pResult->AddColumn ( "Running" );
+    pResult->AddColumn ( "Uncollected" );
+    pResult->AddColumn ( "Queries" );
+    pResult->AddColumn ( "Wait p50/p99/max" );
+    pResult->AddColumn ( "Exec p50/p99/max" );
+
+    //
+    // Set rows
+    //
+    std::vector < SDbQueueStats > statsList;
+    g_pGame->GetDatabaseManager ()->GetQueueStats ( statsList );
+
+    for ( uint i = 0 ; i < statsList.size () ; i++ )
+    {
+        const SDbQueueStats& stats = statsList[i];
+
+        if ( !strFilter.empty () && !stats.strName.ContainsI ( strFilter ) )
+            continue;
+
+        SString* row = pResult->AddRow ();
+        int c = 0;
+        row[c++] = stats.strName;
+        row[c++] = SString ( "%u", stats.uiNumWorkers );
+        row[c++] = SString ( "%u (%u handles)", stats.uiNumConnections, stats.uiNumHandles );
+        row[c++] = SString ( "%u", stats.uiNumWaiting );
+        row[c++] = SString ( "%u", stats.uiNumProcessing );
+        row[c++] = SString ( "%u", stats.uiNumResults );
+        row[c++] = SString ( "%u", stats.uiNumQueries );
+        row[c++] = stats.strWaitTime;
+        row[c++] = stats.strExecTime;
+    }
+}
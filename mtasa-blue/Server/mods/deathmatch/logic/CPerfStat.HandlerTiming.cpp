@@ -0,0 +1,340 @@
+/*****************************************************************************
+*
+*  PROJECT:     Multi Theft Auto v1.0
+*  LICENSE:     See LICENSE in the top level directory
+*  FILE:        mods/deathmatch/logic/CPerfStat.HandlerTiming.cpp
+*  PURPOSE:     Performance stats manager class
+*
+*  Multi Theft Auto is available from http://www.multitheftauto.com/
+*
+*****************************************************************************/
+
+#include "StdInc.h"
+
+#define HANDLER_TIMING_PERIOD_MS    10000
+
+namespace
+{
+    //
+    // Timings for one packet type or event handler
+    // Histograms are swapped every period, so there is always one complete period available
+    //
+    struct SHandlerTiming
+    {
+        SString             strName;
+        CLatencyHistogram   histograms[2];
+    };
+
+    struct SHandlerTimingRow
+    {
+        const SHandlerTiming*   pTiming;
+        CLatencyHistogram       histogram;
+    };
+
+    bool SortByTotalTime ( const SHandlerTimingRow* a, const SHandlerTimingRow* b )
+    {
+        return a->histogram.GetTotal () > b->histogram.GetTotal ();
+    }
+}
+
+
+///////////////////////////////////////////////////////////////
+//
+// CPerfStatHandlerTimingImpl
+//
+//
+//
+///////////////////////////////////////////////////////////////
+class CPerfStatHandlerTimingImpl : public CPerfStatHandlerTiming
+{
+public:
+    ZERO_ON_NEW
+                                CPerfStatHandlerTimingImpl  ( void );
+    virtual                     ~CPerfStatHandlerTimingImpl ( void );
+
+    // CPerfStatModule
+    virtual const SString&      GetCategoryName         ( void );
+    virtual void                DoPulse                 ( void );
+    virtual void                GetStats                ( CPerfStatResult* pOutResult, const std::map < SString, int >& optionMap, const SString& strFilter );
+
+    // CPerfStatHandlerTiming
+    virtual void                UpdatePacketTiming      ( uchar ucPacketID, TIMEUS timeUs );
+    virtual uint                GetEventTimingId        ( CMapEvent* pMapEvent );
+    virtual void                UpdateEventTiming       ( uint uiTimingId, TIMEUS timeUs );
+
+    // CPerfStatHandlerTimingImpl
+    SHandlerTiming*             GetPacketTiming         ( uchar ucPacketID );
+    void                        AddRows                 ( CPerfStatResult* pResult, const char* szType, const std::vector < SHandlerTiming* >& timingList, const SString& strFilter, uint uiMaxRows );
+
+    SString                                 m_strCategoryName;
+    uint                                    m_uiCurrent;
+    CElapsedTime                            m_TimeSinceSwap;
+    std::vector < SHandlerTiming* >         m_PacketTimingList;         // Indexed by packet id
+    std::vector < SHandlerTiming* >         m_EventTimingList;          // Indexed by CMapEvent timing id - 1
+    CHashMap < SString, uint >              m_EventTimingIdMap;
+};
+
+
+///////////////////////////////////////////////////////////////
+//
+// Temporary home for global object
+//
+//
+//
+///////////////////////////////////////////////////////////////
+static std::unique_ptr<CPerfStatHandlerTimingImpl> g_pPerfStatHandlerTimingImp;
+
+CPerfStatHandlerTiming* CPerfStatHandlerTiming::GetSingleton ()
+{
+    if ( !g_pPerfStatHandlerTimingImp )
+        g_pPerfStatHandlerTimingImp.reset(new CPerfStatHandlerTimingImpl ());
+    return g_pPerfStatHandlerTimingImp.get();
+}
+
+
+///////////////////////////////////////////////////////////////
+//
+// CPerfStatHandlerTimingImpl::CPerfStatHandlerTimingImpl
+//
+//
+//
+///////////////////////////////////////////////////////////////
+CPerfStatHandlerTimingImpl::CPerfStatHandlerTimingImpl ( void )
+{
+    m_strCategoryName = "Handler timing";
+    m_PacketTimingList.resize ( 256 );
+}
+
+
+///////////////////////////////////////////////////////////////
+//
+// CPerfStatHandlerTimingImpl::~CPerfStatHandlerTimingImpl
+//
+//
+//
+///////////////////////////////////////////////////////////////
+CPerfStatHandlerTimingImpl::~CPerfStatHandlerTimingImpl ( void )
+{
+    for ( uint i = 0 ; i < m_PacketTimingList.size () ; i++ )
+        delete m_PacketTimingList[i];
+    for ( uint i = 0 ; i < m_EventTimingList.size () ; i++ )
+        delete m_EventTimingList[i];
+}
+
+
+///////////////////////////////////////////////////////////////
+//
+// CPerfStatHandlerTimingImpl::GetCategoryName
+//
+//
+//
+///////////////////////////////////////////////////////////////
+const SString& CPerfStatHandlerTimingImpl::GetCategoryName ( void )
+{
+    return m_strCategoryName;
+}
+
+
+///////////////////////////////////////////////////////////////
+//
+// CPerfStatHandlerTimingImpl::DoPulse
+//
+// Start a new period
+//
+///////////////////////////////////////////////////////////////
+void CPerfStatHandlerTimingImpl::DoPulse ( void )
+{
+    if ( m_TimeSinceSwap.Get () < HANDLER_TIMING_PERIOD_MS )
+        return;
+    m_TimeSinceSwap.Reset ();
+
+    m_uiCurrent ^= 1;
+    for ( uint i = 0 ; i < m_PacketTimingList.size () ; i++ )
+        if ( m_PacketTimingList[i] )
+            m_PacketTimingList[i]->histograms[ m_uiCurrent ].Clear ();
+    for ( uint i = 0 ; i < m_EventTimingList.size () ; i++ )
+        m_EventTimingList[i]->histograms[ m_uiCurrent ].Clear ();
+}
+
+
+///////////////////////////////////////////////////////////////
+//
+// CPerfStatHandlerTimingImpl::GetPacketTiming
+//
+//
+//
+///////////////////////////////////////////////////////////////
+SHandlerTiming* CPerfStatHandlerTimingImpl::GetPacketTiming ( uchar ucPacketID )
+{
+    SHandlerTiming*& pTiming = m_PacketTimingList[ ucPacketID ];
+    if ( !pTiming )
+    {
+        // Turn "PACKET_ID_PED_SYNC" into "64_Ped_sync"
+        SString strPacketDesc = EnumToString ( (ePacketID)ucPacketID ).SplitRight ( "PACKET_ID", NULL, -1 ).ToLower ();
+        pTiming = new SHandlerTiming ();
+        pTiming->strName = SString ( "%d", ucPacketID ) + strPacketDesc.Left ( 2 ).ToUpper () + strPacketDesc.SubStr ( 2 );
+    }
+    return pTiming;
+}
+
+
+///////////////////////////////////////////////////////////////
+//
+// CPerfStatHandlerTimingImpl::GetEventTimingId
+//
+// Handlers with the same event name, resource and function location share timings,
+// so they are kept when a resource is restarted
+//
+///////////////////////////////////////////////////////////////
+uint CPerfStatHandlerTimingImpl::GetEventTimingId ( CMapEvent* pMapEvent )
+{
+    uint uiTimingId = pMapEvent->GetTimingId ();
+    if ( uiTimingId == 0 )
+    {
+        CLuaMain* pLuaMain = pMapEvent->GetVM ();
+        CResource* pResource = pLuaMain->GetResource ();
+        SString strName ( "%s %s %s", *pMapEvent->GetName (), pResource ? pResource->GetName ().c_str () : "", *pLuaMain->GetFunctionTag ( pMapEvent->GetLuaFunction ().ToInt () ) );
+
+        uint* pId = MapFind ( m_EventTimingIdMap, strName );
+        if ( pId )
+            uiTimingId = *pId;
+        else
+        {
+            SHandlerTiming* pTiming = new SHandlerTiming ();
+            pTiming->strName = strName;
+            m_EventTimingList.push_back ( pTiming );
+            uiTimingId = m_EventTimingList.size ();
+            MapSet ( m_EventTimingIdMap, strName, uiTimingId );
+        }
+        pMapEvent->SetTimingId ( uiTimingId );
+    }
+    return uiTimingId;
+}
+
+
+///////////////////////////////////////////////////////////////
+//
+// CPerfStatHandlerTimingImpl::UpdatePacketTiming
+//
+// Time taken to translate and process one packet
+//
+///////////////////////////////////////////////////////////////
+void CPerfStatHandlerTimingImpl::UpdatePacketTiming ( uchar ucPacketID, TIMEUS timeUs )
+{
+    GetPacketTiming ( ucPacketID )->histograms[ m_uiCurrent ].AddSample ( timeUs );
+}
+
+
+///////////////////////////////////////////////////////////////
+//
+// CPerfStatHandlerTimingImpl::UpdateEventTiming
+//
+// Time taken by one call of an event handler
+//
+///////////////////////////////////////////////////////////////
+void CPerfStatHandlerTimingImpl::UpdateEventTiming ( uint uiTimingId, TIMEUS timeUs )
+{
+    if ( uiTimingId > 0 && uiTimingId <= m_EventTimingList.size () )
+        m_EventTimingList[ uiTimingId - 1 ]->histograms[ m_uiCurrent ].AddSample ( timeUs );
+}
+
+
+///////////////////////////////////////////////////////////////
+//
+// CPerfStatHandlerTimingImpl::GetStats
+//
+//
+//
+///////////////////////////////////////////////////////////////
+void CPerfStatHandlerTimingImpl::GetStats ( CPerfStatResult* pResult, const std::map < SString, int >& optionMap, const SString& strFilter )
+{
+    //
+    // Set option flags
+    //
+    bool bHelp = MapContains ( optionMap, "h" );
+    bool bPackets = MapContains ( optionMap, "p" );
+    bool bEvents = MapContains ( optionMap, "e" );
+    bool bAll = MapContains ( optionMap, "a" );
+    if ( !bPackets && !bEvents )
+        bPackets = bEvents = true;
+
+    //
+    // Process help
+    //
+    if ( bHelp )
+    {
+        pResult->AddColumn ( "Handler timing help" );
+        pResult->AddRow ()[0] ="Option h - This help";
+        pResult->AddRow ()[0] ="Option p - Only show packets";
+        pResult->AddRow ()[0] ="Option e - Only show event handlers";
+        pResult->AddRow ()[0] ="Option a - Show all rows instead of the top 50 of each type";
+        pResult->AddRow ()[0] ="Timings cover the last 10 to 20 seconds";
+        pResult->AddRow ()[0] ="Event handler timings include any events triggered by the handler";
+        return;
+    }
+
+    //
+    // Set column names
+    //
+    pResult->AddColumn ( "Type" );
+    pResult->AddColumn ( "Name" );
+    pResult->AddColumn ( "Calls" );
+    pResult->AddColumn ( "Total" );
+    pResult->AddColumn ( "Avg" );
+    pResult->AddColumn ( "p50 / p99 / max" );
+
+    //
+    // Set rows
+    //
+    uint uiMaxRows = bAll ? -1 : 50;
+    if ( bPackets )
+        AddRows ( pResult, "Packet", m_PacketTimingList, strFilter, uiMaxRows );
+    if ( bEvents )
+        AddRows ( pResult, "Event", m_EventTimingList, strFilter, uiMaxRows );
+}
+
+
+///////////////////////////////////////////////////////////////
+//
+// CPerfStatHandlerTimingImpl::AddRows
+//
+// Add rows sorted by total time
+//
+///////////////////////////////////////////////////////////////
+void CPerfStatHandlerTimingImpl::AddRows ( CPerfStatResult* pResult, const char* szType, const std::vector < SHandlerTiming* >& timingList, const SString& strFilter, uint uiMaxRows )
+{
+    std::list < SHandlerTimingRow > rowList;
+    std::vector < SHandlerTimingRow* > sortList;
+    for ( uint i = 0 ; i < timingList.size () ; i++ )
+    {
+        const SHandlerTiming* pTiming = timingList[i];
+        if ( !pTiming || pTiming->histograms[0].GetCount () + pTiming->histograms[1].GetCount () == 0 )
+            continue;
+
+        if ( !strFilter.empty () && !pTiming->strName.ContainsI ( strFilter ) )
+            continue;
+
+        rowList.push_back ( SHandlerTimingRow () );
+        SHandlerTimingRow& row = rowList.back ();
+        row.pTiming = pTiming;
+        row.histogram = pTiming->histograms[0];
+        row.histogram.Merge ( pTiming->histograms[1] );
+        sortList.push_back ( &row );
+    }
+
+    std::sort ( sortList.begin (), sortList.end (), SortByTotalTime );
+
+    for ( uint i = 0 ; i < sortList.size () && i < uiMaxRows ; i++ )
+    {
+        const CLatencyHistogram& histogram = sortList[i]->histogram;
+
+        SString* row = pResult->AddRow ();
+        int c = 0;
+        row[c++] = szType;
+        row[c++] = sortList[i]->pTiming->strName;
+        row[c++] = SString ( "%u", histogram.GetCount () );
+        row[c++] = CLatencyHistogram::FormatMs ( histogram.GetTotal () ) + " ms";
+        row[c++] = CLatencyHistogram::FormatMs ( histogram.GetAverage () ) + " ms";
+        row[c++] = histogram.GetSummaryString ();
+    }
+}
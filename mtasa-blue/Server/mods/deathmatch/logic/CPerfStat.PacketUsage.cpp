@@ -42,6 +42,10 @@ public:
     SString                     m_strCategoryName;
     SPacketStat                 m_PrevPacketStats [ 2 ] [ 256 ];
     SPacketStat                 m_PacketStats [ 2 ] [ 256 ];
+    SPacketAllocStat            m_PrevAllocStats [ 256 ];
+    SPacketAllocStat            m_AllocStats [ 256 ];
+    SPacketCompressStat         m_PrevCompressStats [ 256 ];
+    SPacketCompressStat         m_CompressStats [ 256 ];
     SFixedArray < long long, 256 > m_ShownPacketStats;
 };
 
@@ -135,11 +139,17 @@ void CPerfStatPacketUsageImpl::MaybeRecordStats ( void )
             // Save previous sample so we can calc the delta values
             memcpy ( m_PrevPacketStats, m_PacketStats, sizeof ( m_PacketStats ) );
             memcpy ( m_PacketStats, g_pNetServer->GetPacketStats (), sizeof ( m_PacketStats ) );
+            memcpy ( m_PrevAllocStats, m_AllocStats, sizeof ( m_AllocStats ) );
+            memcpy ( m_AllocStats, g_pGame->GetPacketTranslator ()->GetAllocStats (), sizeof ( m_AllocStats ) );
+            memcpy ( m_PrevCompressStats, m_CompressStats, sizeof ( m_CompressStats ) );
+            memcpy ( m_CompressStats, g_pGame->GetPacketCompressor ()->GetStats (), sizeof ( m_CompressStats ) );
 
             if ( m_iStatsCleared == 1 )
             {
                 // Prime if was zeroed
                 memcpy ( m_PrevPacketStats, m_PacketStats, sizeof ( m_PacketStats ) );
+                memcpy ( m_PrevAllocStats, m_AllocStats, sizeof ( m_AllocStats ) );
+                memcpy ( m_PrevCompressStats, m_CompressStats, sizeof ( m_CompressStats ) );
                 m_iStatsCleared = 2;
             }
             else
@@ -154,6 +164,10 @@ void CPerfStatPacketUsageImpl::MaybeRecordStats ( void )
         {
             memset ( m_PrevPacketStats, 0, sizeof ( m_PacketStats ) );
             memset ( m_PacketStats, 0, sizeof ( m_PacketStats ) );
+            memset ( m_PrevAllocStats, 0, sizeof ( m_AllocStats ) );
+            memset ( m_AllocStats, 0, sizeof ( m_AllocStats ) );
+            memset ( m_PrevCompressStats, 0, sizeof ( m_CompressStats ) );
+            memset ( m_CompressStats, 0, sizeof ( m_CompressStats ) );
             m_iStatsCleared = 1;
         }
     }
@@ -192,9 +206,12 @@ void CPerfStatPacketUsageImpl::GetStats ( CPerfStatResult* pResult, const std::m
     pResult->AddColumn ( "Incoming.msgs/sec" );
     pResult->AddColumn ( "Incoming.bytes/sec" );
     pResult->AddColumn ( "Incoming.logic cpu" );
+    pResult->AddColumn ( "Incoming.allocs/msg" );
     pResult->AddColumn ( "Outgoing.msgs/sec" );
     pResult->AddColumn ( "Outgoing.bytes/sec" );
     pResult->AddColumn ( "Outgoing.msgs share" );
+    pResult->AddColumn ( "Outgoing.compressed size" );
+    pResult->AddColumn ( "Outgoing.compress cpu" );
 
     if ( m_iStatsCleared )
     {
@@ -225,6 +242,10 @@ void CPerfStatPacketUsageImpl::GetStats ( CPerfStatResult* pResult, const std::m
             statInDelta.totalTime   = statInNow.totalTime - statInPrev.totalTime;
         }
 
+        // Calc packet class allocations per translated packet
+        long long llTranslatedDelta = m_AllocStats[i].llTranslated - m_PrevAllocStats[i].llTranslated;
+        long long llAllocatedDelta = m_AllocStats[i].llAllocated - m_PrevAllocStats[i].llAllocated;
+
         // Calc outgoing delta values
         SPacketStat statOutDelta;
         {
@@ -235,7 +256,15 @@ void CPerfStatPacketUsageImpl::GetStats ( CPerfStatResult* pResult, const std::m
             statOutDelta.totalTime   = statOutNow.totalTime - statOutPrev.totalTime;
         }
 
-        if ( !statInDelta.iCount && !statOutDelta.iCount )
+        // Calc compression of packets which were big enough to try
+        const SPacketCompressStat& statCompressPrev = m_PrevCompressStats[i];
+        const SPacketCompressStat& statCompressNow = m_CompressStats[i];
+        long long llCompressCountDelta = statCompressNow.llCount - statCompressPrev.llCount;
+        long long llCompressBytesInDelta = statCompressNow.llBytesIn - statCompressPrev.llBytesIn;
+        long long llCompressBytesOutDelta = statCompressNow.llBytesOut - statCompressPrev.llBytesOut;
+        long long llCompressTimeDelta = statCompressNow.llTimeUs - statCompressPrev.llTimeUs;
+
+        if ( !statInDelta.iCount && !statOutDelta.iCount && !llCompressCountDelta )
         {
             // Once displayed, keep a row displayed for at least 20 seconds
             if ( llTickCountNow - m_ShownPacketStats[i] > 20000 )
@@ -258,12 +287,14 @@ void CPerfStatPacketUsageImpl::GetStats ( CPerfStatResult* pResult, const std::m
             row[c++] = SString ( "%d", ( statInDelta.iCount + 4 ) / 5 );
             row[c++] = CPerfStatManager::GetScaledByteString ( ( statInDelta.iTotalBytes + 4 ) / 5 );
             row[c++] = SString ( "%2.2f%%", statInDelta.totalTime / 50000.f );   // Number of microseconds in sample period ( 5sec * 1000000 ) into percent ( * 100 )
+            row[c++] = llTranslatedDelta ? SString ( "%.2f", llAllocatedDelta / (float)llTranslatedDelta ) : "-";
         }
         else
         {
             row[c++] = "-";
             row[c++] = "-";
             row[c++] = "-";
+            row[c++] = "-";
         }
 
         if ( statOutDelta.iCount )
@@ -278,5 +309,16 @@ void CPerfStatPacketUsageImpl::GetStats ( CPerfStatResult* pResult, const std::m
             row[c++] = "-";
             row[c++] = "-";
         }
+
+        if ( llCompressCountDelta && llCompressBytesInDelta )
+        {
+            row[c++] = SString ( "%d%%", (int)( llCompressBytesOutDelta * 100 / llCompressBytesInDelta ) );
+            row[c++] = SString ( "%2.2f%%", llCompressTimeDelta / 50000.f );
+        }
+        else
+        {
+            row[c++] = "-";
+            row[c++] = "-";
+        }
     }
 }
@@ -20,6 +20,7 @@
 #endif
 
 extern SThreadCPUTimesStore g_SyncThreadCPUTimes;
+extern CLatencyHistogram g_PacketWaitTimeHistogram;
 
 namespace
 {
@@ -333,6 +334,7 @@ void CPerfStatServerInfoImpl::GetStats ( CPerfStatResult* pResult, const std::ma
     m_StatusList.push_back ( StringPair ( "Approx network usage",       CPerfStatManager::GetScaledBitString ( llNetworkUsageBytesPS * 8LL ) + "/s" ) );
     if ( ASE* pAse = ASE::GetInstance() )
         m_StatusList.push_back ( StringPair ( "ASE queries",            SString ( "%d (%d/min)", pAse->GetTotalQueryCount (), pAse->GetQueriesPerMinute () ) ) );
+    m_StatusList.push_back ( StringPair ( "Script bytecode cache",      SString ( "%lld hits, %lld misses", g_pStats->scriptcache.llBytecodeCacheHits, g_pStats->scriptcache.llBytecodeCacheMisses ) ) );
 
     m_OptionsList.push_back ( StringPair ( "MinClientVersion",          g_pGame->CalculateMinClientRequirement () ) );
     m_OptionsList.push_back ( StringPair ( "RecommendedClientVersion",  pConfig->GetRecommendedClientVersion () ) );
@@ -377,8 +379,19 @@ void CPerfStatServerInfoImpl::GetStats ( CPerfStatResult* pResult, const std::ma
         {
             m_StatusList.push_back ( StringPair ( "Msg queue incoming (finished)",       SString ( "%d (%d)", CNetBufferWatchDog::ms_uiInResultQueueSize, CNetBufferWatchDog::ms_uiFinishedListSize ) ) );
             m_StatusList.push_back ( StringPair ( "Msg queue outgoing (finished)",       SString ( "%d (%d)", CNetBufferWatchDog::ms_uiOutCommandQueueSize, CNetBufferWatchDog::ms_uiOutResultQueueSize  ) ) );
+            m_StatusList.push_back ( StringPair ( "Msg wait time p50/p99/max",           g_PacketWaitTimeHistogram.GetSummaryString () ) );
         }
 
+        SLogWriterStats logWriterStats;
+        CLogger::GetLogWriterStats ( logWriterStats );
+        m_StatusList.push_back ( StringPair ( "Log lines queued (dropped)",   SString ( "%u (%u)", logWriterStats.uiNumQueued, logWriterStats.uiNumDropped ) ) );
+        m_StatusList.push_back ( StringPair ( "Log lines written (batches)",  SString ( "%u (%u)", logWriterStats.uiNumLines, logWriterStats.uiNumBatches ) ) );
+
+        SRegexCacheStats regexCacheStats;
+        CRegexCache::GetStats ( regexCacheStats );
+        m_StatusList.push_back ( StringPair ( "Regex cache size",           SString ( "%u", regexCacheStats.uiNumEntries ) ) );
+        m_StatusList.push_back ( StringPair ( "Regex cache hits (misses)",  SString ( "%lld (%lld)", regexCacheStats.llHits, regexCacheStats.llMisses ) ) );
+
         m_StatusList.push_back ( StringPair ( "Bytes/sec outgoing resent",  CPerfStatManager::GetScaledByteString ( llOutgoingBytesResentPS ) ) );
         m_StatusList.push_back ( StringPair ( "Msgs/sec outgoing resent",   strOutgoingMessagesResentPS ) );
         //m_StatusList.push_back ( StringPair ( "Bytes/sec blocked",          CPerfStatManager::GetScaledByteString ( llIncomingBytesPSBlocked ) ) );
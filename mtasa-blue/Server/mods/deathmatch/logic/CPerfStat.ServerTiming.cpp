@@ -32,6 +32,7 @@ public:
     virtual void                GetStats                ( CPerfStatResult* pOutResult, const std::map < SString, int >& optionMap, const SString& strFilter );
 
     // CPerfStatServerTiming
+    virtual bool                IsActive                ( void )        { return m_bIsActive; }
 
     // CPerfStatServerTimingImpl functions
     void                        SetActive               ( bool bActive );
@@ -113,7 +114,10 @@ void CPerfStatServerTimingImpl::DoPulse ( void )
         SetActive ( false );
 
     if ( m_bIsActive )
+    {
+        g_pGame->GetSlowFrameRecorder ()->SaveStatEvents ();
         m_StatResults.FrameEnd ();
+    }
 }
 
 
@@ -129,7 +133,7 @@ void CPerfStatServerTimingImpl::SetActive ( bool bActive )
     if ( bActive != m_bIsActive )
     {
         m_bIsActive = bActive;
-        g_StatEvents.SetEnabled ( m_bIsActive );
+        g_StatEvents.SetEnabled ( m_bIsActive || g_pGame->GetSlowFrameRecorder ()->IsEnabled () );
     }
 }
 
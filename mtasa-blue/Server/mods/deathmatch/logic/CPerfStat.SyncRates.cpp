@@ -0,0 +1,174 @@
+/*****************************************************************************
+*
+*  PROJECT:     Multi Theft Auto v1.0
+*  LICENSE:     See LICENSE in the top level directory
+*  FILE:        mods/deathmatch/logic/CPerfStat.SyncRates.cpp
+*  PURPOSE:     Performance stats manager class
+*
+*  Multi Theft Auto is available from http://www.multitheftauto.com/
+*
+*****************************************************************************/
+
+#include "StdInc.h"
+
+///////////////////////////////////////////////////////////////
+//
+// CPerfStatSyncRatesImpl
+//
+//
+//
+///////////////////////////////////////////////////////////////
+class CPerfStatSyncRatesImpl : public CPerfStatSyncRates
+{
+public:
+    ZERO_ON_NEW
+                                CPerfStatSyncRatesImpl  ( void );
+    virtual                     ~CPerfStatSyncRatesImpl ( void );
+
+    // CPerfStatModule
+    virtual const SString&      GetCategoryName         ( void );
+    virtual void                DoPulse                 ( void );
+    virtual void                GetStats                ( CPerfStatResult* pOutResult, const std::map < SString, int >& optionMap, const SString& strFilter );
+
+    SString                     m_strCategoryName;
+};
+
+
+///////////////////////////////////////////////////////////////
+//
+// Temporary home for global object
+//
+//
+//
+///////////////////////////////////////////////////////////////
+static std::unique_ptr<CPerfStatSyncRatesImpl> g_pPerfStatSyncRatesImp;
+
+CPerfStatSyncRates* CPerfStatSyncRates::GetSingleton ()
+{
+    if ( !g_pPerfStatSyncRatesImp )
+        g_pPerfStatSyncRatesImp.reset(new CPerfStatSyncRatesImpl ());
+    return g_pPerfStatSyncRatesImp.get();
+}
+
+
+///////////////////////////////////////////////////////////////
+//
+// CPerfStatSyncRatesImpl::CPerfStatSyncRatesImpl
+//
+//
+//
+///////////////////////////////////////////////////////////////
+CPerfStatSyncRatesImpl::CPerfStatSyncRatesImpl ( void )
+{
+    m_strCategoryName = "Sync rates";
+}
+
+
+///////////////////////////////////////////////////////////////
+//
+// CPerfStatSyncRatesImpl::~CPerfStatSyncRatesImpl
+//
+//
+//
+///////////////////////////////////////////////////////////////
+CPerfStatSyncRatesImpl::~CPerfStatSyncRatesImpl ( void )
+{
+}
+
+
+///////////////////////////////////////////////////////////////
+//
+// CPerfStatSyncRatesImpl::GetCategoryName
+//
+//
+//
+///////////////////////////////////////////////////////////////
+const SString& CPerfStatSyncRatesImpl::GetCategoryName ( void )
+{
+    return m_strCategoryName;
+}
+
+
+///////////////////////////////////////////////////////////////
+//
+// CPerfStatSyncRatesImpl::DoPulse
+//
+// Rates are updated by the player manager
+//
+///////////////////////////////////////////////////////////////
+void CPerfStatSyncRatesImpl::DoPulse ( void )
+{
+}
+
+
+///////////////////////////////////////////////////////////////
+//
+// CPerfStatSyncRatesImpl::GetStats
+//
+//
+//
+///////////////////////////////////////////////////////////////
+void CPerfStatSyncRatesImpl::GetStats ( CPerfStatResult* pResult, const std::map < SString, int >& optionMap, const SString& strFilter )
+{
+    //
+    // Set option flags
+    //
+    bool bHelp = MapContains ( optionMap, "h" );
+    bool bShowAll = MapContains ( optionMap, "a" );
+
+    //
+    // Process help
+    //
+    if ( bHelp )
+    {
+        pResult->AddColumn ( "Sync rates help" );
+        pResult->AddRow ()[0] ="Option h - This help";
+        pResult->AddRow ()[0] ="Option a - Show all players (default is only players with slowed sync)";
+        pResult->AddRow ()[0] ="Intervals are used when sending to the player. Near zone 0 is never slowed";
+        return;
+    }
+
+    //
+    // Set column names
+    //
+    pResult->AddColumn ( "Player" );
+    pResult->AddColumn ( "Ping" );
+    pResult->AddColumn ( "Lowest ping" );
+    pResult->AddColumn ( "Packet loss" );
+    pResult->AddColumn ( "Send queue" );
+    pResult->AddColumn ( "Scale" );
+    pResult->AddColumn ( "Zone 1/2/3 interval" );
+    pResult->AddColumn ( "Lightsync interval" );
+    pResult->AddColumn ( "Skipped" );
+
+    //
+    // Set rows
+    //
+    CPlayerManager* pPlayerManager = g_pGame->GetPlayerManager ();
+    for ( std::list < CPlayer* > ::const_iterator iter = pPlayerManager->IterBegin () ; iter != pPlayerManager->IterEnd () ; ++iter )
+    {
+        CPlayer* pPlayer = *iter;
+
+        if ( !bShowAll && !pPlayer->IsSyncRateScaled () )
+            continue;
+
+        if ( !strFilter.empty () && !SStringX ( pPlayer->GetNick () ).ContainsI ( strFilter ) )
+            continue;
+
+        const CPlayer::SSyncRateData& data = pPlayer->GetSyncRateData ();
+
+        SString* row = pResult->AddRow ();
+        int c = 0;
+        row[c++] = pPlayer->GetNick ();
+        row[c++] = SString ( "%u ms", data.uiPing );
+        row[c++] = SString ( "%u ms", data.uiMinPing );
+        row[c++] = SString ( "%0.1f%%", data.fPacketLoss );
+        row[c++] = SString ( "%u", data.uiSendQueueSize );
+        row[c++] = SString ( "%u%%", data.uiScalePercent );
+        row[c++] = SString ( "%d/%d/%d ms", pPlayer->ScaleSyncInterval ( g_pBandwidthSettings->ZoneUpdateIntervals [ ZONE1 ] )
+                                          , pPlayer->ScaleSyncInterval ( g_pBandwidthSettings->ZoneUpdateIntervals [ ZONE2 ] )
+                                          , pPlayer->ScaleSyncInterval ( g_pBandwidthSettings->ZoneUpdateIntervals [ ZONE3 ] ) );
+        row[c++] = g_pBandwidthSettings->bLightSyncEnabled ? SString ( "%d ms", pPlayer->ScaleSyncInterval ( g_TickRateSettings.iLightSync ) ) : "-";
+        row[c++] = SString ( "%u", data.uiSkippedCount );
+    }
+}
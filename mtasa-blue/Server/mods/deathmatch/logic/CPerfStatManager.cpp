@@ -80,11 +80,14 @@ CPerfStatManagerImpl::CPerfStatManagerImpl ( void )
     AddModule ( CPerfStatEventPacketUsage::GetSingleton () );
     AddModule ( CPerfStatPlayerPacketUsage::GetSingleton () );
     AddModule ( CPerfStatSqliteTiming::GetSingleton () );
+    AddModule ( CPerfStatDatabaseQueues::GetSingleton () );
     AddModule ( CPerfStatBandwidthReduction::GetSingleton () );
     AddModule ( CPerfStatBandwidthUsage::GetSingleton () );
+    AddModule ( CPerfStatSyncRates::GetSingleton () );
     AddModule ( CPerfStatServerInfo::GetSingleton () );
     AddModule ( CPerfStatServerTiming::GetSingleton () );
     AddModule ( CPerfStatFunctionTiming::GetSingleton () );
+    AddModule ( CPerfStatHandlerTiming::GetSingleton () );
     AddModule ( CPerfStatDebugInfo::GetSingleton () );
     AddModule ( CPerfStatDebugTable::GetSingleton () );
 }
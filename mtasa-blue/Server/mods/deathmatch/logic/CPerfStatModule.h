@@ -31,6 +31,15 @@ struct SStatData
         long long llLightSyncBytesSent;
     } lightsync;
 
+    struct {
+        long long llBytecodeCacheHits;
+        long long llBytecodeCacheMisses;
+    } scriptcache;
+
+    struct {
+        long long llHandlerCalls;
+    } events;
+
     bool bFunctionTimingActive;
     int iDbJobDataCount;
     int iDbConnectionCount;
@@ -269,6 +278,23 @@ public:
 };
 
 
+//
+// CPerfStatSyncRates
+//
+class CPerfStatSyncRates : public CPerfStatModule
+{
+public:
+    // CPerfStatModule
+    virtual const SString&      GetCategoryName     ( void ) = 0;
+    virtual void                DoPulse             ( void ) = 0;
+    virtual void                GetStats            ( CPerfStatResult* pOutResult, const std::map < SString, int >& optionMap, const SString& strFilter ) = 0;
+
+    // CPerfStatSyncRates
+
+    static CPerfStatSyncRates*  GetSingleton        ( void );
+};
+
+
 //
 // CPerfStatSqliteTiming
 //
@@ -290,6 +316,23 @@ public:
 };
 
 
+//
+// CPerfStatDatabaseQueues
+//
+class CPerfStatDatabaseQueues : public CPerfStatModule
+{
+public:
+    // CPerfStatModule
+    virtual const SString&      GetCategoryName     ( void ) = 0;
+    virtual void                DoPulse             ( void ) = 0;
+    virtual void                GetStats            ( CPerfStatResult* pOutResult, const std::map < SString, int >& optionMap, const SString& strFilter ) = 0;
+
+    // CPerfStatDatabaseQueues
+
+    static CPerfStatDatabaseQueues*  GetSingleton      ( void );
+};
+
+
 //
 // CPerfStatBandwidthReduction
 //
@@ -335,6 +378,9 @@ public:
     virtual void                DoPulse             ( void ) = 0;
     virtual void                GetStats            ( CPerfStatResult* pOutResult, const std::map < SString, int >& optionMap, const SString& strFilter ) = 0;
 
+    // CPerfStatServerTiming
+    virtual bool                IsActive            ( void ) = 0;
+
     static CPerfStatServerTiming*  GetSingleton        ( void );
 };
 
@@ -358,6 +404,26 @@ public:
 };
 
 
+//
+// CPerfStatHandlerTiming
+//
+class CPerfStatHandlerTiming : public CPerfStatModule
+{
+public:
+    // CPerfStatModule
+    virtual const SString&      GetCategoryName     ( void ) = 0;
+    virtual void                DoPulse             ( void ) = 0;
+    virtual void                GetStats            ( CPerfStatResult* pOutResult, const std::map < SString, int >& optionMap, const SString& strFilter ) = 0;
+
+    // CPerfStatHandlerTiming
+    virtual void                UpdatePacketTiming  ( uchar ucPacketID, TIMEUS timeUs ) = 0;
+    virtual uint                GetEventTimingId    ( class CMapEvent* pMapEvent ) = 0;
+    virtual void                UpdateEventTiming   ( uint uiTimingId, TIMEUS timeUs ) = 0;
+
+    static CPerfStatHandlerTiming*  GetSingleton    ( void );
+};
+
+
 //
 // CPerfStatDebugInfo
 //
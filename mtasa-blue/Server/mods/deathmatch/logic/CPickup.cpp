@@ -47,6 +47,7 @@ CPickup::CPickup ( CElement* pParent, CXMLNode* pNode, CPickupManager* pPickupMa
     m_bDoneDelayHack = false;
 
     UpdateSpatialData ();
+    UpdateRespawnCheck ();
 }
 
 
@@ -68,6 +69,36 @@ void CPickup::Unlink ( void )
 }
 
 
+void CPickup::SetRespawnIntervals ( unsigned long ulRespawnIntervals )
+{
+    m_ulRespawnIntervals = ulRespawnIntervals;
+    UpdateRespawnCheck ();
+}
+
+
+// Get when CMapManager::DoPickupRespawning next needs to look at us, or 0 if never
+long long CPickup::GetNextRespawnCheckTime ( void )
+{
+    long long llTime = 0;
+    if ( !m_bDoneDelayHack )
+        llTime = ( m_CreationTime + CTickCount ( 100LL ) ).ToLongLong ();
+
+    if ( !m_bSpawned && m_LastUsedTime != CTickCount ( 0LL ) )
+    {
+        long long llRespawnTime = ( m_LastUsedTime + CTickCount ( (long long)m_ulRespawnIntervals ) ).ToLongLong ();
+        if ( llTime == 0 || llRespawnTime < llTime )
+            llTime = llRespawnTime;
+    }
+    return llTime;
+}
+
+
+void CPickup::UpdateRespawnCheck ( void )
+{
+    m_pPickupManager->UpdateRespawnCheck ( this );
+}
+
+
 bool CPickup::ReadSpecialData ( void )
 {
     unsigned short usBuffer = 0;
@@ -414,6 +445,7 @@ void CPickup::Use ( CPlayer& Player )
                 m_LastUsedTime = CTickCount::Now();
                 // Mark us as not spawned
                 m_bSpawned = false;
+                UpdateRespawnCheck ();
         
                 // Mark us as hidden
                 SetVisible ( false );
@@ -118,7 +118,7 @@ public:
     inline bool                     IsHealthRandom              ( void )                                { return m_bIsHealthRandom; };
 
     inline unsigned long            GetRespawnIntervals         ( void )                                { return m_ulRespawnIntervals; };
-    inline void                     SetRespawnIntervals         ( unsigned long ulRespawnIntervals )    { m_ulRespawnIntervals = ulRespawnIntervals; };
+    void                            SetRespawnIntervals         ( unsigned long ulRespawnIntervals );
 
     CTickCount                      GetLastUsedTime             ( void )                                { return m_LastUsedTime; }
     CTickCount                      GetCreationTime             ( void )                                { return m_CreationTime; }
@@ -144,6 +144,9 @@ public:
     inline void                     SetDoneDelayHack            ( bool bDone )                          { m_bDoneDelayHack = bDone; }
     inline bool                     HasDoneDelayHack            ( void )                                { return m_bDoneDelayHack; }
 
+    long long                       GetNextRespawnCheckTime     ( void );
+    void                            UpdateRespawnCheck          ( void );
+
 
 private:
     void                            Callback_OnCollision        ( CColShape& Shape, CElement& Element );
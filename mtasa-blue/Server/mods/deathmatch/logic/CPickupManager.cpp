@@ -74,6 +74,28 @@ bool CPickupManager::Exists ( CPickup* pPickup )
 }
 
 
+//
+// Queue the pickup to be checked when it is next due to be enabled or respawned
+//
+void CPickupManager::UpdateRespawnCheck ( CPickup* pPickup )
+{
+    long long llTime = pPickup->GetNextRespawnCheckTime ();
+    if ( llTime == 0 )
+        m_RespawnCheckQueue.Remove ( pPickup );
+    else
+        m_RespawnCheckQueue.Set ( pPickup, llTime );
+}
+
+
+//
+// Take pickups which are due to be enabled or respawned
+//
+void CPickupManager::GetDueRespawnChecks ( std::vector < CPickup* >& outList )
+{
+    m_RespawnCheckQueue.PopDue ( CTickCount::Now ().ToLongLong (), outList );
+}
+
+
 bool CPickupManager::IsValidWeaponID ( unsigned int uiWeaponID )
 {
     return ( uiWeaponID > 0 &&
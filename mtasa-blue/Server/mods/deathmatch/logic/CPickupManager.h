@@ -17,6 +17,7 @@ class CPickupManager;
 
 #include "CColManager.h"
 #include "CPickup.h"
+#include "CDeadlineQueue.h"
 #include <list>
 
 class CPickupManager
@@ -42,12 +43,16 @@ public:
     inline static unsigned short    GetHealthModel                          ( void )                    { return 1240; };
     inline static unsigned short    GetArmorModel                           ( void )                    { return 1242; };
 
+    void                            UpdateRespawnCheck                      ( CPickup* pPickup );
+    void                            GetDueRespawnChecks                     ( std::vector < CPickup* >& outList );
+
 private:
     inline void                     AddToList                               ( CPickup* pPickup )        { m_List.push_back ( pPickup ); };
-    inline void                     RemoveFromList                          ( CPickup* pPickup )        { m_List.remove ( pPickup); };
+    inline void                     RemoveFromList                          ( CPickup* pPickup )        { m_List.remove ( pPickup); m_RespawnCheckQueue.Remove ( pPickup ); };
 
     CColManager*                    m_pColManager;
     list < CPickup* >               m_List;
+    CDeadlineQueue < CPickup >      m_RespawnCheckQueue;
 };
 
 #endif
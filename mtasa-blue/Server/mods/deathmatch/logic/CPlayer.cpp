@@ -93,6 +93,7 @@ CPlayer::CPlayer ( CPlayerManager* pPlayerManager, class CScriptDebugging* pScri
     m_uiWeaponIncorrectCount = 0;
 
     // Add us to the manager
+    m_uiPlayerSlot = INVALID_PLAYER_SLOT;
     pPlayerManager->AddToList ( this );
 
     // DO NOT DEFAULT THIS TO THE CURRENT TIME OR YOU WILL BREAK EVERYTHING.
@@ -185,6 +186,9 @@ void CPlayer::Unlink ( void )
 
     // Remove us from all and any PerPlayerEntity list
     CPerPlayerEntity::StaticOnPlayerDelete( this );
+
+    // Slot can be reused now nothing refers to it
+    m_pPlayerManager->ReleasePlayerSlot ( this );
 }
 
 
@@ -237,6 +241,48 @@ uint CPlayer::Send ( const CPacket& Packet )
     if ( !CNetBufferWatchDog::CanSendPacket ( Packet.GetPacketID () ) )
         return 0; 
 
+    // Element RPCs wait for the end of the pulse
+    if ( CElementRPCBatch::IsBatchable ( Packet, GetBitStreamVersion () ) )
+    {
+        uint uiBitsUsed = 0;
+        NetBitStreamInterface* pBitStream = g_pNetServer->AllocateNetServerBitStream ( GetBitStreamVersion () );
+        if ( pBitStream )
+        {
+            if ( Packet.Write ( *pBitStream ) )
+            {
+                uiBitsUsed = pBitStream->GetNumberOfBitsUsed ();
+                QueueElementRPC ( Packet, pBitStream );
+            }
+            g_pNetServer->DeallocateNetServerBitStream ( pBitStream );
+        }
+        return uiBitsUsed;
+    }
+
+    // Anything else has to arrive after the waiting element RPCs
+    FlushElementRPCs ();
+    return DoSend ( Packet );
+}
+
+
+//
+// Add an encoded element RPC to the batch for the end of the pulse
+//
+void CPlayer::QueueElementRPC ( const CPacket& Packet, NetBitStreamInterface* pBitStream )
+{
+    if ( m_ElementRPCBatch.IsFull () )
+        FlushElementRPCs ();
+    m_ElementRPCBatch.Add ( Packet, pBitStream );
+}
+
+
+void CPlayer::FlushElementRPCs ( void )
+{
+    m_ElementRPCBatch.Flush ( m_PlayerSocket, GetBitStreamVersion () );
+}
+
+
+uint CPlayer::DoSend ( const CPacket& Packet )
+{
     // Use the flags to determine how to send it
     NetServerPacketReliability Reliability;
     unsigned long ulFlags = Packet.GetFlags ();
@@ -980,7 +1026,7 @@ bool CPlayer::IsTimeToReceivePuresyncNearFrom ( CPlayer* pOther, SViewerInfo& ne
     int iZone = GetPuresyncZone ( pOther );
     nearInfo.iZone = iZone;
 
-    int iUpdateInterval = g_pBandwidthSettings->ZoneUpdateIntervals [ iZone ];
+    int iUpdateInterval = ScaleSyncInterval ( g_pBandwidthSettings->ZoneUpdateIntervals [ iZone ] );
 
 #if MTA_DEBUG
     if ( m_iLastPuresyncZoneDebug != iZone )
@@ -1034,6 +1080,25 @@ bool CPlayer::IsTimeToReceivePuresyncNearFrom ( CPlayer* pOther, SViewerInfo& ne
 }
 
 
+//
+// Check if a sync which is sent at iInterval should be skipped this time,
+// because this player's connection is struggling
+//
+bool CPlayer::IsTimeToReceiveScaledSync ( long long llLastTime, int iInterval )
+{
+    if ( !IsSyncRateScaled () )
+        return true;
+
+    // Half an interval of leeway, as the caller only checks once per interval
+    if ( GetModuleTickCount64 () - llLastTime < ScaleSyncInterval ( iInterval ) - iInterval / 2 )
+    {
+        m_SyncRateData.uiSkippedCount++;
+        return false;
+    }
+    return true;
+}
+
+
 //
 // Get the size pure sync packet will be for stats only
 //
@@ -26,6 +26,8 @@ class CPlayer;
 #include "CTeam.h"
 #include "CPad.h"
 #include "CObject.h"
+#include "CBitStreamFragment.h"
+#include "CElementRPCBatch.h"
 #include "packets/CPacket.h"
 #include "packets/CPlayerStatsPacket.h"
 class CKeyBinds;
@@ -144,6 +146,8 @@ public:
     inline NetServerPlayerID&                   GetSocket                   ( void )                        { return m_PlayerSocket; };
     const char*                                 GetSourceIP                 ( void );
     inline unsigned short                       GetSourcePort               ( void )                        { return m_PlayerSocket.GetPort (); };
+    inline uint                                 GetPlayerSlot               ( void )                        { return m_uiPlayerSlot; };
+    inline void                                 SetPlayerSlot               ( uint uiSlot )                 { m_uiPlayerSlot = uiSlot; };
 
     void                                        SetPing                     ( uint uiPing )                 { m_uiPing = uiPing; }
     unsigned int                                GetPing                     ( void )                        { return m_uiPing; }
@@ -152,6 +156,8 @@ public:
     inline void                                 SetNickChangeTime           ( time_t tNickChange )          { m_tNickChange = tNickChange; };
 
     uint                                        Send                        ( const CPacket& Packet );
+    void                                        QueueElementRPC             ( const CPacket& Packet, NetBitStreamInterface* pBitStream );
+    void                                        FlushElementRPCs            ( void );
     void                                        SendEcho                    ( const char* szEcho );
     void                                        SendConsole                 ( const char* szEcho );
 
@@ -308,6 +314,9 @@ public:
             unsigned int    uiContext;
         } vehicleHealth;
 
+        // This player's record as sent to everyone, so it is only encoded once per lightsync pulse
+        CBitStreamFragment fragment;
+
         bool m_bSyncPosition;
     };
     SLightweightSyncData&                       GetLightweightSyncData      ( void )                      { return m_lightweightSyncData; }
@@ -320,6 +329,41 @@ public:
     // End Light Sync
     //
 
+    //
+    // Sync rate control
+    //
+    struct SSyncRateData
+    {
+        SSyncRateData ()
+        {
+            uiScalePercent = 100;
+            uiPing = 0;
+            uiMinPing = 0;
+            uiWindowMinPing = 0;
+            uiPrevWindowMinPing = 0;
+            uiWindowSampleCount = 0;
+            fPacketLoss = 0;
+            uiSendQueueSize = 0;
+            llLastLightSyncTime = 0;
+            uiSkippedCount = 0;
+        }
+
+        uint            uiScalePercent;         // Applied to sync intervals when sending to this player. 100 is as configured
+        uint            uiPing;
+        uint            uiMinPing;              // Ping above this is put down to packets queuing up
+        uint            uiWindowMinPing;        // Lowest ping in the current half of the window
+        uint            uiPrevWindowMinPing;    // Lowest ping in the previous half
+        uint            uiWindowSampleCount;
+        float           fPacketLoss;
+        uint            uiSendQueueSize;
+        long long       llLastLightSyncTime;
+        uint            uiSkippedCount;
+    };
+    SSyncRateData&                              GetSyncRateData             ( void )                        { return m_SyncRateData; }
+    bool                                        IsSyncRateScaled            ( void )                        { return m_SyncRateData.uiScalePercent > 100; }
+    int                                         ScaleSyncInterval           ( int iInterval )               { return iInterval * (int)m_SyncRateData.uiScalePercent / 100; }
+    bool                                        IsTimeToReceiveScaledSync   ( long long llLastTime, int iInterval );
+
     eVoiceState                                 GetVoiceState               ( void )                      { return m_VoiceState; }
     void                                        SetVoiceState               ( eVoiceState State )         { m_VoiceState = State; }
 
@@ -353,7 +397,10 @@ public:
     SString                                     m_strD3d9Sha256;
 private:
     SLightweightSyncData                        m_lightweightSyncData;
+    SSyncRateData                               m_SyncRateData;
+    CElementRPCBatch                            m_ElementRPCBatch;
 
+    uint                                        DoSend                      ( const CPacket& Packet );
     void                                        WriteCameraModePacket       ( void );
     void                                        WriteCameraPositionPacket   ( void );
 
@@ -385,6 +432,7 @@ private:
     CElapsedTime                                m_ConnectedTimer;
 
     NetServerPlayerID                           m_PlayerSocket;
+    uint                                        m_uiPlayerSlot;         // Index used by CPlayerBitSet
     uint                                        m_uiPing;
 
     time_t                                      m_tNickChange;
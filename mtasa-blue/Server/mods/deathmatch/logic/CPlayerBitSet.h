@@ -0,0 +1,113 @@
+/*****************************************************************************
+*
+*  PROJECT:     Multi Theft Auto v1.0
+*  LICENSE:     See LICENSE in the top level directory
+*  FILE:        mods/deathmatch/logic/CPlayerBitSet.h
+*  PURPOSE:     Set of players stored as one bit per player slot
+*
+*  Multi Theft Auto is available from http://www.multitheftauto.com/
+*
+*****************************************************************************/
+#pragma once
+
+#ifdef WIN32
+    #include <intrin.h>
+#endif
+
+#define INVALID_PLAYER_SLOT     0xFFFFFFFF
+
+//
+// Players are given a small slot number by CPlayerManager which is reused after they leave.
+// Words are 32 bit so the bit scan is available on all server builds.
+//
+class CPlayerBitSet
+{
+public:
+    bool IsSet ( uint uiSlot ) const
+    {
+        uint uiWord = uiSlot >> 5;
+        return uiWord < m_Words.size () && ( m_Words[ uiWord ] & ( 1U << ( uiSlot & 31 ) ) ) != 0;
+    }
+
+    void Set ( uint uiSlot )
+    {
+        if ( uiSlot == INVALID_PLAYER_SLOT )
+            return;     // Player has already been unlinked
+        uint uiWord = uiSlot >> 5;
+        if ( uiWord >= m_Words.size () )
+            m_Words.resize ( uiWord + 1, 0 );
+        m_Words[ uiWord ] |= 1U << ( uiSlot & 31 );
+    }
+
+    void Clear ( uint uiSlot )
+    {
+        uint uiWord = uiSlot >> 5;
+        if ( uiWord < m_Words.size () )
+            m_Words[ uiWord ] &= ~( 1U << ( uiSlot & 31 ) );
+    }
+
+    // Clear all bits but keep the storage
+    void ClearAll ( void )
+    {
+        for ( uint i = 0 ; i < m_Words.size () ; i++ )
+            m_Words[ i ] = 0;
+    }
+
+    bool IsEmpty ( void ) const
+    {
+        for ( uint i = 0 ; i < m_Words.size () ; i++ )
+            if ( m_Words[ i ] )
+                return false;
+        return true;
+    }
+
+    uint Count ( void ) const
+    {
+        uint uiCount = 0;
+        for ( uint i = 0 ; i < m_Words.size () ; i++ )
+            for ( uint uiBits = m_Words[ i ] ; uiBits ; uiBits &= uiBits - 1 )
+                uiCount++;
+        return uiCount;
+    }
+
+    // Remove bits which are set in both this and other
+    void RemoveCommon ( CPlayerBitSet& other )
+    {
+        uint uiNumWords = std::min ( m_Words.size (), other.m_Words.size () );
+        for ( uint i = 0 ; i < uiNumWords ; i++ )
+        {
+            uint uiCommon = m_Words[ i ] & other.m_Words[ i ];
+            m_Words[ i ] ^= uiCommon;
+            other.m_Words[ i ] ^= uiCommon;
+        }
+    }
+
+    // Call func ( uiSlot ) for each set bit, in slot order. func may clear the current bit.
+    template < class FUNC >
+    void ForEach ( FUNC func ) const
+    {
+        for ( uint i = 0 ; i < m_Words.size () ; i++ )
+        {
+            uint uiBits = m_Words[ i ];
+            while ( uiBits )
+            {
+                func ( ( i << 5 ) + LowestBit ( uiBits ) );
+                uiBits &= uiBits - 1;
+            }
+        }
+    }
+
+protected:
+    static uint LowestBit ( uint uiBits )
+    {
+    #ifdef WIN32
+        unsigned long ulIndex;
+        _BitScanForward ( &ulIndex, uiBits );
+        return ulIndex;
+    #else
+        return __builtin_ctz ( uiBits );
+    #endif
+    }
+
+    std::vector < uint >    m_Words;
+};
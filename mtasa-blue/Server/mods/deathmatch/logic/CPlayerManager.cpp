@@ -19,6 +19,8 @@ CPlayerManager::CPlayerManager ( void )
     // Init
     m_pScriptDebugging = NULL;
     m_ZombieCheckTimer.SetUseModuleTickCount( true );
+    m_SyncRateSampleTimer.SetUseModuleTickCount ( true );
+    m_uiHighestSyncRateScale = 100;
 }
 
 
@@ -31,6 +33,7 @@ CPlayerManager::~CPlayerManager ( void )
 void CPlayerManager::DoPulse ( void )
 {
     PulseZombieCheck();
+    PulseSyncRates ();
 
     list < CPlayer* > ::const_iterator iter = m_Players.begin ();
     for ( ; iter != m_Players.end (); iter++ )
@@ -40,6 +43,77 @@ void CPlayerManager::DoPulse ( void )
 }
 
 
+//
+// Adjust how often one player receives puresync/lightsync from far and out of view players.
+// Players who are near and in view (zone 0) are always sent everything.
+// Back off quickly when the player's connection shows signs of congestion, and recover slowly.
+//
+void CPlayerManager::PulseSyncRates ( void )
+{
+    if ( m_SyncRateSampleTimer.Get () < SYNC_RATE_SAMPLE_INTERVAL_MS )
+        return;
+    m_SyncRateSampleTimer.Reset ();
+
+    uint uiMaxScale = g_pGame->GetConfig ()->GetSyncRateMaxScale ();
+
+    // Lightsync delta markers need to last as long as the slowest player's interval
+    m_uiHighestSyncRateScale = 100;
+    for ( std::list < CPlayer* > ::const_iterator iter = m_Players.begin () ; iter != m_Players.end () ; ++iter )
+    {
+        CPlayer* pPlayer = *iter;
+        CPlayer::SSyncRateData& data = pPlayer->GetSyncRateData ();
+        data.uiScalePercent = Clamp < uint > ( 100, data.uiScalePercent, std::max < uint > ( 100, uiMaxScale ) );
+
+        // Stats are non blocking here, and may be missing for a player who has only just joined
+        NetStatistics stats;
+        if ( uiMaxScale > 100 && pPlayer->IsJoined () && CSimControl::GetNetworkStatistics ( &stats, pPlayer->GetSocket () ) )
+        {
+            data.uiPing = pPlayer->GetPing ();
+            if ( data.uiPing )
+            {
+                // Lowest ping over a window made of two halves, so it can rise again
+                if ( !data.uiWindowMinPing || data.uiPing < data.uiWindowMinPing )
+                    data.uiWindowMinPing = data.uiPing;
+                data.uiMinPing = data.uiWindowMinPing;
+                if ( data.uiPrevWindowMinPing )
+                    data.uiMinPing = std::min ( data.uiMinPing, data.uiPrevWindowMinPing );
+
+                if ( ++data.uiWindowSampleCount >= SYNC_RATE_MIN_PING_WINDOW / 2 )
+                {
+                    data.uiPrevWindowMinPing = data.uiWindowMinPing;
+                    data.uiWindowMinPing = 0;
+                    data.uiWindowSampleCount = 0;
+                }
+            }
+            data.fPacketLoss = stats.packetlossLastSecond;
+            data.uiSendQueueSize = stats.messagesInSendBuffer + stats.messagesInResendBuffer;
+
+            bool bCongested = data.fPacketLoss > SYNC_RATE_PACKET_LOSS
+                           || data.uiSendQueueSize > SYNC_RATE_SEND_QUEUE_SIZE
+                           || data.uiPing > data.uiMinPing + SYNC_RATE_PING_RISE;
+
+            if ( bCongested )
+                data.uiScalePercent = std::min ( uiMaxScale, data.uiScalePercent + std::max < uint > ( SYNC_RATE_RECOVER_STEP, data.uiScalePercent / 2 ) );
+            else
+                data.uiScalePercent = std::max < uint > ( 100, data.uiScalePercent - SYNC_RATE_RECOVER_STEP );
+        }
+
+        m_uiHighestSyncRateScale = std::max ( m_uiHighestSyncRateScale, data.uiScalePercent );
+    }
+}
+
+
+// Send the element RPCs which are waiting for each player
+void CPlayerManager::FlushElementRPCs ( void )
+{
+    list < CPlayer* > ::const_iterator iter = m_Players.begin ();
+    for ( ; iter != m_Players.end (); iter++ )
+    {
+        (*iter)->FlushElementRPCs ();
+    }
+}
+
+
 void CPlayerManager::PulseZombieCheck( void )
 {
     // Only check once a second
@@ -260,10 +334,24 @@ static void DoBroadcast( const CPacket& Packet, const std::multimap < ushort, CP
         // Write the content
         if ( Packet.Write ( *pBitStream ) )
         {
+            const pair < mapIter , mapIter > keyRange = groupMap.equal_range ( usBitStreamVersion );
+
+            // Element RPCs wait for the end of the pulse, and share the bitstream
+            if ( CElementRPCBatch::IsBatchable ( Packet, usBitStreamVersion ) )
+            {
+                for ( s_it = keyRange.first ; s_it != keyRange.second ; ++s_it )
+                    s_it->second->QueueElementRPC ( Packet, pBitStream );
+                g_pNetServer->DeallocateNetServerBitStream ( pBitStream );
+                continue;
+            }
+
+            // Anything else has to arrive after the waiting element RPCs
+            for ( s_it = keyRange.first ; s_it != keyRange.second ; ++s_it )
+                s_it->second->FlushElementRPCs ();
+
             g_pGame->SendPacketBatchBegin ( Packet.GetPacketID (), pBitStream );
 
             // For each player, send the packet
-            const pair < mapIter , mapIter > keyRange = groupMap.equal_range ( usBitStreamVersion );
             for ( s_it = keyRange.first ; s_it != keyRange.second ; ++s_it )
             {
                 CPlayer* pPlayer = s_it->second;
@@ -328,6 +416,23 @@ void CPlayerManager::Broadcast ( const CPacket& Packet, const std::multimap < us
     DoBroadcast ( Packet, groupMap );
 }
 
+// Send one packet to a set of player slots
+void CPlayerManager::Broadcast ( const CPacket& Packet, const CPlayerBitSet& sendSet )
+{
+    CPlayerManager* pPlayerManager = g_pGame->GetPlayerManager ();
+
+    // Group players by bitstream version
+    std::multimap < ushort, CPlayer* > groupMap;
+    sendSet.ForEach ( [&] ( uint uiSlot )
+        {
+            CPlayer* pPlayer = pPlayerManager->GetFromSlot ( uiSlot );
+            if ( pPlayer )
+                MapInsert ( groupMap, pPlayer->GetBitStreamVersion (), pPlayer );
+        } );
+
+    DoBroadcast( Packet, groupMap );
+}
+
 
 bool CPlayerManager::IsValidPlayerModel(unsigned short usPlayerModel)
 {
@@ -372,6 +477,21 @@ void CPlayerManager::AddToList ( CPlayer* pPlayer )
         (*iter)->AddPlayerToDistLists ( pPlayer );
     }
 
+    // Give the player a slot for CPlayerBitSet
+    uint uiSlot;
+    if ( !m_FreePlayerSlots.empty () )
+    {
+        uiSlot = m_FreePlayerSlots.back ();
+        m_FreePlayerSlots.pop_back ();
+        m_PlayerSlots[ uiSlot ] = pPlayer;
+    }
+    else
+    {
+        uiSlot = m_PlayerSlots.size ();
+        m_PlayerSlots.push_back ( pPlayer );
+    }
+    pPlayer->SetPlayerSlot ( uiSlot );
+
     assert( !m_Players.Contains( pPlayer ) );
     m_Players.push_back ( pPlayer );
     MapSet ( m_SocketPlayerMap, pPlayer->GetSocket (), pPlayer );
@@ -399,6 +519,22 @@ void CPlayerManager::RemoveFromList ( CPlayer* pPlayer )
     g_pGame->CalculateMinClientRequirement();    
 }
 
+
+//
+// Called after the player has been removed from all CPlayerBitSets
+//
+void CPlayerManager::ReleasePlayerSlot ( CPlayer* pPlayer )
+{
+    uint uiSlot = pPlayer->GetPlayerSlot ();
+    if ( uiSlot == INVALID_PLAYER_SLOT )
+        return;
+
+    assert ( m_PlayerSlots[ uiSlot ] == pPlayer );
+    m_PlayerSlots[ uiSlot ] = NULL;
+    m_FreePlayerSlots.push_back ( uiSlot );
+    pPlayer->SetPlayerSlot ( INVALID_PLAYER_SLOT );
+}
+
 void CPlayerManager::OnPlayerJoin ( CPlayer* pPlayer )
 {
     if ( pPlayer->GetPlayerVersion() < m_strLowestConnectedPlayerVersion || m_strLowestConnectedPlayerVersion.empty() )
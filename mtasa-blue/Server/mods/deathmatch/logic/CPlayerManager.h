@@ -19,8 +19,17 @@ class CPlayerManager;
 #include "CCommon.h"
 #include "packets/CPacket.h"
 #include "CPlayer.h"
+#include "CPlayerBitSet.h"
 #include "../Config.h"
 
+// Sync rate control
+#define SYNC_RATE_SAMPLE_INTERVAL_MS    500     // Matches NET_STATISTICS_PUBLISH_INTERVAL_MS, as every player is checked each time
+#define SYNC_RATE_PACKET_LOSS           2.0f    // Percent in the last second
+#define SYNC_RATE_SEND_QUEUE_SIZE       200     // Messages waiting to be sent or resent
+#define SYNC_RATE_PING_RISE             150     // Ms above the lowest recent ping for the player
+#define SYNC_RATE_MIN_PING_WINDOW       40      // Checks. The lowest ping is taken from the last 20 to 40 checks, so a lasting route change is accepted
+#define SYNC_RATE_RECOVER_STEP          25      // Percent per check
+
 class CPlayerManager
 {
     friend class CPlayer;
@@ -30,7 +39,10 @@ public:
                                                 ~CPlayerManager                 ( void );
 
     void                                        DoPulse                         ( void );
+    void                                        FlushElementRPCs                ( void );
     void                                        PulseZombieCheck                ( void );
+    void                                        PulseSyncRates                  ( void );
+    uint                                        GetHighestSyncRateScale         ( void )                                            { return m_uiHighestSyncRateScale; }
 
     inline void                                 SetScriptDebugging              ( class CScriptDebugging* pScriptDebugging )        { m_pScriptDebugging = pScriptDebugging; };
 
@@ -44,6 +56,8 @@ public:
 
     CPlayer*                                    Get                             ( const NetServerPlayerID& PlayerSocket );
     CPlayer*                                    Get                             ( const char* szNick, bool bCaseSensitive = false );
+    CPlayer*                                    GetFromSlot                     ( uint uiSlot )                                     { return uiSlot < m_PlayerSlots.size () ? m_PlayerSlots[ uiSlot ] : NULL; }
+    void                                        ReleasePlayerSlot               ( CPlayer* pPlayer );
 
     inline std::list < CPlayer* > ::const_iterator  IterBegin                   ( void )                                            { return m_Players.begin (); };
     inline std::list < CPlayer* > ::const_iterator  IterEnd                     ( void )                                            { return m_Players.end (); };
@@ -55,6 +69,7 @@ public:
     static void                                 Broadcast                       ( const CPacket& Packet, const std::list < CPlayer* >& sendList );
     static void                                 Broadcast                       ( const CPacket& Packet, const std::vector < CPlayer* >& sendList );
     static void                                 Broadcast                       ( const CPacket& Packet, const std::multimap < ushort, CPlayer* >& groupMap );
+    static void                                 Broadcast                       ( const CPacket& Packet, const CPlayerBitSet& sendSet );
 
     static bool                                 IsValidPlayerModel              ( unsigned short usPlayerModel );
 
@@ -70,8 +85,12 @@ private:
 
     CMappedList < CPlayer* >                    m_Players;
     std::map < NetServerPlayerID, CPlayer* >    m_SocketPlayerMap;
+    std::vector < CPlayer* >                    m_PlayerSlots;          // Indexed by CPlayer::GetPlayerSlot
+    std::vector < uint >                        m_FreePlayerSlots;
     SString                                     m_strLowestConnectedPlayerVersion;
     CElapsedTime                                m_ZombieCheckTimer;
+    CElapsedTime                                m_SyncRateSampleTimer;
+    uint                                        m_uiHighestSyncRateScale;
 };
 
 #endif
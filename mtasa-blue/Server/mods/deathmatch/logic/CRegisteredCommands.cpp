@@ -48,9 +48,12 @@ bool CRegisteredCommands::AddCommand ( CLuaMain* pLuaMain, const char* szKey, co
     pCommand->iLuaFunction = iLuaFunction;
     pCommand->bRestricted = bRestricted;
     pCommand->bCaseSensitive = bCaseSensitive;
+    pCommand->bRemoved = false;
 
-    // Add it to our list
-    m_Commands.push_back ( pCommand );
+    // Add it to our lists
+    m_CommandList.push_back ( pCommand );
+    m_CommandsByKey[ pCommand->strKey.ToLower () ].push_back ( pCommand );
+    m_VMCommandListMap[ pLuaMain ].push_back ( pCommand );
 
     return true;
 }
@@ -61,59 +64,38 @@ bool CRegisteredCommands::RemoveCommand ( CLuaMain* pLuaMain, const char* szKey,
     assert ( pLuaMain );
     assert ( szKey );
 
-    // Call the handler for every virtual machine that matches the given key
-    int iCompareResult;
-    bool bFound = false;
-    list < SCommand* > ::iterator iter = m_Commands.begin ();
+    std::vector < SCommand* >* pKeyCommands = MapFind ( m_CommandsByKey, SStringX ( szKey ).ToLower () );
+    if ( !pKeyCommands )
+        return false;
 
-    while ( iter != m_Commands.end () )
+    // Find every entry for this VM that matches the given key
+    std::vector < SCommand* > removeList;
+    for ( uint i = 0 ; i < pKeyCommands->size () ; i++ )
     {
-        if ( ( *iter )->bCaseSensitive )
-            iCompareResult = strcmp ( (*iter)->strKey.c_str (), szKey );
-        else
-            iCompareResult = stricmp ( (*iter)->strKey.c_str (), szKey );
+        SCommand* pCommand = (*pKeyCommands)[i];
 
         // Matching VM's and names?
-        if ( ( *iter )->pLuaMain == pLuaMain && iCompareResult == 0 )
+        if ( pCommand->pLuaMain == pLuaMain && IsKeyMatch ( pCommand, szKey ) )
         {
-            if ( VERIFY_FUNCTION ( iLuaFunction ) && ( *iter )->iLuaFunction != iLuaFunction )
-            {
-                iter++;
+            if ( VERIFY_FUNCTION ( iLuaFunction ) && pCommand->iLuaFunction != iLuaFunction )
                 continue;
-            }
 
-            // Delete it and remove it from our list
-            if ( m_bIteratingList )
-            {
-                m_TrashCan.push_back ( *iter );
-                ++iter;
-            }
-            else
-            {
-                delete *iter;
-                iter = m_Commands.erase ( iter );
-            }
-
-            bFound = true;
+            removeList.push_back ( pCommand );
         }
-        else
-            ++iter;
     }
 
-    return bFound;
+    for ( uint i = 0 ; i < removeList.size () ; i++ )
+        RemoveCommandEntry ( removeList[i] );
+
+    return !removeList.empty ();
 }
 
 
 void CRegisteredCommands::ClearCommands ( void )
 {
     // Delete all the commands
-    list < SCommand* > ::const_iterator iter = m_Commands.begin ();
-
-    for ( ; iter != m_Commands.end (); iter++ )
-        delete *iter;
-
-    // Clear the list
-    m_Commands.clear ();
+    while ( !m_CommandList.empty () )
+        RemoveCommandEntry ( *m_CommandList.begin () );
 }
 
 
@@ -121,21 +103,59 @@ void CRegisteredCommands::CleanUpForVM ( CLuaMain* pLuaMain )
 {
     assert ( pLuaMain );
 
-    // Delete every command that matches
-    list < SCommand* > ::iterator iter = m_Commands.begin ();
+    // Delete every command that belongs to this VM
+    CVMCommandList* pVMCommands = MapFind ( m_VMCommandListMap, pLuaMain );
+    while ( pVMCommands && !pVMCommands->empty () )
+    {
+        // Map entry is erased with the last command
+        bool bLast = pVMCommands->size () == 1;
+        RemoveCommandEntry ( *pVMCommands->begin () );
+        if ( bLast )
+            break;
+    }
+}
+
 
-    while ( iter != m_Commands.end () )
+///////////////////////////////////////////////////////////////
+//
+// CRegisteredCommands::RemoveCommandEntry
+//
+// Unlink from all lookups. Deletion is delayed if a handler is running.
+//
+///////////////////////////////////////////////////////////////
+void CRegisteredCommands::RemoveCommandEntry ( SCommand* pCommand )
+{
+    m_CommandList.remove ( pCommand );
+
+    SString strLowerKey = pCommand->strKey.ToLower ();
+    if ( std::vector < SCommand* >* pKeyCommands = MapFind ( m_CommandsByKey, strLowerKey ) )
     {
-        // Matching VM's?
-        if ( ( *iter )->pLuaMain == pLuaMain )
-        {
-            // Delete the entry and remove it from the list
-            delete *iter;
-            iter = m_Commands.erase ( iter );
-        }
-        else
-            ++iter;
+        ListRemove ( *pKeyCommands, pCommand );
+        if ( pKeyCommands->empty () )
+            MapRemove ( m_CommandsByKey, strLowerKey );
+    }
+
+    if ( CVMCommandList* pVMCommands = MapFind ( m_VMCommandListMap, pCommand->pLuaMain ) )
+    {
+        pVMCommands->remove ( pCommand );
+        if ( pVMCommands->empty () )
+            MapRemove ( m_VMCommandListMap, pCommand->pLuaMain );
     }
+
+    pCommand->bRemoved = true;
+    if ( m_bIteratingList )
+        m_TrashCan.push_back ( pCommand );
+    else
+        delete pCommand;
+}
+
+
+bool CRegisteredCommands::IsKeyMatch ( const SCommand* pCommand, const char* szKey )
+{
+    if ( pCommand->bCaseSensitive )
+        return strcmp ( pCommand->strKey.c_str (), szKey ) == 0;
+    else
+        return stricmp ( pCommand->strKey.c_str (), szKey ) == 0;
 }
 
 
@@ -151,38 +171,44 @@ bool CRegisteredCommands::ProcessCommand ( const char* szKey, const char* szArgu
 {
     assert ( szKey );
 
+    std::vector < SCommand* >* pKeyCommands = MapFind ( m_CommandsByKey, SStringX ( szKey ).ToLower () );
+    if ( !pKeyCommands )
+        return false;
+
+    // Copy the matches as handlers can add and remove commands
+    std::vector < SCommand* > matchList;
+    for ( uint i = 0 ; i < pKeyCommands->size () ; i++ )
+        if ( IsKeyMatch ( (*pKeyCommands)[i], szKey ) )
+            matchList.push_back ( (*pKeyCommands)[i] );
+
     // Call the handler for every virtual machine that matches the given key
     bool bHandled = false;
-    int iCompareResult;
-    list < SCommand* > ::const_iterator iter = m_Commands.begin ();
-
+    bool bWasIterating = m_bIteratingList;
     m_bIteratingList = true;
 
-    for ( ; iter != m_Commands.end (); iter++ )
+    for ( uint i = 0 ; i < matchList.size () ; i++ )
     {
-        if ( ( *iter )->bCaseSensitive )
-            iCompareResult = strcmp ( ( *iter )->strKey.c_str(), szKey );
-        else
-            iCompareResult = stricmp ( ( *iter )->strKey.c_str(), szKey );
+        SCommand* pCommand = matchList[i];
+
+        // Removed by a previous handler?
+        if ( pCommand->bRemoved )
+            continue;
 
-        // Matching names?
-        if ( iCompareResult == 0 )
+        if ( m_pACLManager->CanObjectUseRight ( pClient->GetAccount ()->GetName ().c_str (),
+                                                CAccessControlListGroupObject::OBJECT_TYPE_USER,
+                                                pCommand->strKey,
+                                                CAccessControlListRight::RIGHT_TYPE_COMMAND,
+                                                !pCommand->bRestricted ) )   // If this command is restricted, the default access should be false unless granted specially
         {
-            if ( m_pACLManager->CanObjectUseRight ( pClient->GetAccount ()->GetName ().c_str (),
-                                                    CAccessControlListGroupObject::OBJECT_TYPE_USER,
-                                                    ( *iter )->strKey,
-                                                    CAccessControlListRight::RIGHT_TYPE_COMMAND,
-                                                    !( *iter )->bRestricted ) )   // If this command is restricted, the default access should be false unless granted specially
-            {
-                // Call it
-                CallCommandHandler ( ( *iter )->pLuaMain, ( *iter )->iLuaFunction, ( *iter )->strKey, szArguments, pClient );
-                bHandled = true;
-            }
+            // Call it
+            CallCommandHandler ( pCommand->pLuaMain, pCommand->iLuaFunction, pCommand->strKey, szArguments, pClient );
+            bHandled = true;
         }
     }
 
-    m_bIteratingList = false;
-    TakeOutTheTrash ();
+    m_bIteratingList = bWasIterating;
+    if ( !m_bIteratingList )
+        TakeOutTheTrash ();
 
     // Return whether some handler was called or not
     return bHandled;
@@ -193,20 +219,18 @@ CRegisteredCommands::SCommand* CRegisteredCommands::GetCommand ( const char* szK
 {
     assert ( szKey );
 
-    // Try to find an entry with a matching name in our list
-    int iCompareResult;
-    list < SCommand* > ::const_iterator iter = m_Commands.begin ();
+    // Try to find an entry with a matching name
+    std::vector < SCommand* >* pKeyCommands = MapFind ( m_CommandsByKey, SStringX ( szKey ).ToLower () );
+    if ( !pKeyCommands )
+        return NULL;
 
-    for ( ; iter != m_Commands.end (); iter++ )
+    for ( uint i = 0 ; i < pKeyCommands->size () ; i++ )
     {
-        if ( ( *iter )->bCaseSensitive )
-            iCompareResult = strcmp ( ( *iter )->strKey.c_str (), szKey );
-        else
-            iCompareResult = stricmp ( ( *iter )->strKey.c_str (), szKey );
+        SCommand* pCommand = (*pKeyCommands)[i];
 
         // Matching name and no given VM or matching VM
-        if ( iCompareResult == 0 && ( !pLuaMain || pLuaMain == ( *iter )->pLuaMain ) )
-            return *iter;
+        if ( IsKeyMatch ( pCommand, szKey ) && ( !pLuaMain || pLuaMain == pCommand->pLuaMain ) )
+            return pCommand;
     }
 
     // Doesn't exist
@@ -274,13 +298,12 @@ void CRegisteredCommands::CallCommandHandler ( CLuaMain* pLuaMain, const CLuaFun
 void CRegisteredCommands::GetCommands ( lua_State* luaVM )
 {
     unsigned int uiIndex = 0;
-    m_bIteratingList = true;
-    list < SCommand* > ::iterator iter = m_Commands.begin ();
+    CCommandList::iterator iter = m_CommandList.begin ();
 
     // Create the main table
     lua_newtable( luaVM );
 
-    for ( ; iter != m_Commands.end (); iter++ )
+    for ( ; iter != m_CommandList.end (); iter++ )
     {
         // Create a subtable ({'command', resource})
         lua_pushinteger ( luaVM, ++uiIndex );
@@ -294,34 +317,28 @@ void CRegisteredCommands::GetCommands ( lua_State* luaVM )
         }
         lua_settable ( luaVM, -3 );
     }
-
-    m_bIteratingList = false;
 }
 
 
 void CRegisteredCommands::GetCommands ( lua_State* luaVM, CLuaMain* pTargetLuaMain )
 {
     unsigned int uiIndex = 0;
-    m_bIteratingList = true;
-    list < SCommand* > ::iterator iter = m_Commands.begin ();
 
     // Create the table
     lua_newtable( luaVM );
 
-    for ( ; iter != m_Commands.end (); iter++ )
+    // Commands for the target VM
+    CVMCommandList* pVMCommands = MapFind ( m_VMCommandListMap, pTargetLuaMain );
+    if ( !pVMCommands )
+        return;
+
+    CVMCommandList::iterator iter = pVMCommands->begin ();
+    for ( ; iter != pVMCommands->end (); iter++ )
     {
-        // Matching VMs?
-        if ( (*iter)->pLuaMain == pTargetLuaMain )
-        {
-            lua_pushinteger ( luaVM, ++uiIndex );
-            lua_pushstring ( luaVM, (*iter)->strKey );
-            lua_settable ( luaVM, -3 );
-        }
+        lua_pushinteger ( luaVM, ++uiIndex );
+        lua_pushstring ( luaVM, (*iter)->strKey );
+        lua_settable ( luaVM, -3 );
     }
-
-    //lua_settable ( luaVM, -3 );
-
-    m_bIteratingList = false;
 }
 
 
@@ -331,7 +348,7 @@ void CRegisteredCommands::TakeOutTheTrash ( void )
 
     for ( ; iter != m_TrashCan.end (); iter++ )
     {
-        m_Commands.remove ( *iter );
+        // Already unlinked in RemoveCommandEntry
         delete *iter;
     }
 
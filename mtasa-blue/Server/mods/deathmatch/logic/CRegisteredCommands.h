@@ -26,13 +26,21 @@ class CRegisteredCommands
 {
     struct SCommand
     {
+        SCommand ( void ) : listNode ( this ), vmListNode ( this ) {}
+
         class CLuaMain* pLuaMain;
         SString strKey;
         CLuaFunctionRef iLuaFunction;
         bool bRestricted;
         bool bCaseSensitive;
+        bool bRemoved;
+        CIntrusiveListNode < SCommand > listNode;       // In m_CommandList
+        CIntrusiveListNode < SCommand > vmListNode;     // In m_VMCommandListMap
     };
 
+    typedef CIntrusiveListExt < SCommand, &SCommand::listNode >     CCommandList;
+    typedef CIntrusiveListExt < SCommand, &SCommand::vmListNode >   CVMCommandList;
+
 public:
                                         CRegisteredCommands             ( class CAccessControlListManager* pACLManager );
                                         ~CRegisteredCommands            ( void );
@@ -51,11 +59,15 @@ public:
 
 private:
     SCommand*                           GetCommand                      ( const char* szKey, class CLuaMain* pLuaMain = NULL );
+    void                                RemoveCommandEntry              ( SCommand* pCommand );
+    static bool                         IsKeyMatch                      ( const SCommand* pCommand, const char* szKey );
     void                                CallCommandHandler              ( class CLuaMain* pLuaMain, const CLuaFunctionRef& iLuaFunction, const char* szKey, const char* szArguments, class CClient* pClient );
 
     void                                TakeOutTheTrash                 ( void );
 
-    list < SCommand* >                  m_Commands;
+    CCommandList                        m_CommandList;          // All commands in the order they were added
+    CHashMap < SString, std::vector < SCommand* > >         m_CommandsByKey;    // Keyed by lower case name, so holds all case variations
+    std::map < class CLuaMain*, CVMCommandList >            m_VMCommandListMap;
     list < SCommand* >                  m_TrashCan;
     bool                                m_bIteratingList;
 
@@ -123,12 +123,18 @@ EDownloadModeType CRemoteCalls::GetDownloadModeForQueueName( const SString& strQ
 }
 
 
-void CRemoteCalls::ProcessQueuedFiles( void )
+// Returns true if all queues are empty
+bool CRemoteCalls::ProcessQueuedFiles( void )
 {
+    bool bAllEmpty = true;
     for ( auto iter = m_QueueIndexMap.cbegin(); iter != m_QueueIndexMap.cend(); )
     {
         EDownloadModeType downloadMode = GetDownloadModeFromQueueIndex( iter->second );
-        if ( g_pNetServer->GetHTTPDownloadManager( downloadMode )->ProcessQueuedFiles() )
+        if ( !g_pNetServer->GetHTTPDownloadManager( downloadMode )->ProcessQueuedFiles() )
+        {
+            bAllEmpty = false;
+        }
+        else
         {
             // Queue empty, so remove name mapping if not default queue
             if ( iter->first != CALL_REMOTE_DEFAULT_QUEUE_NAME )
@@ -139,6 +145,7 @@ void CRemoteCalls::ProcessQueuedFiles( void )
         }
         ++iter;
     }
+    return bAllEmpty;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -220,6 +227,9 @@ void CRemoteCall::MakeCall()
 
 void CRemoteCall::DownloadFinishedCallback(const SHttpDownloadResult& result)
 {
+    // The Lua callback may queue more work, so run the next pulse without sleeping
+    g_MainThreadWorkSignal.Notify();
+
     CRemoteCall* pCall = (CRemoteCall*)result.pObj;
     if (!g_pGame->GetRemoteCalls()->CallExists(pCall))
         return;
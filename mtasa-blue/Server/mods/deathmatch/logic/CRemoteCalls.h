@@ -65,7 +65,7 @@ public:
     void                Remove ( CLuaMain * luaMain );
     void                Remove ( CRemoteCall * call );
     bool                CallExists ( CRemoteCall * call );
-    void                ProcessQueuedFiles ( void );
+    bool                ProcessQueuedFiles ( void );
     EDownloadModeType   GetDownloadModeForQueueName( const SString& strQueueName );
     EDownloadModeType   GetDownloadModeFromQueueIndex( uint uiIndex );
 };
@@ -599,6 +599,24 @@ void CResource::SetInfoValue ( const char * szKey, const char * szValue, bool bS
 bool CResource::GenerateChecksums ( void )
 {
     bool bOk = true;
+    CFileChecksumCache* pChecksumCache = m_resourceManager->GetChecksumCache ();
+
+    // Hash all changed files in one go so the work can be spread over several threads
+    std::vector < SString > pathList;
+    for ( list < CResourceFile* > ::iterator iterf = m_resourceFiles.begin (); iterf != m_resourceFiles.end (); iterf++ )
+    {
+        CResourceFile* pResourceFile = *iterf;
+        SString strPath;
+        if ( GetFilePath ( pResourceFile->GetName(), strPath ) )
+        {
+            pathList.push_back ( strPath );
+            if ( pResourceFile->GetType () == CResourceFile::RESOURCE_FILE_TYPE_CLIENT_SCRIPT
+                || pResourceFile->GetType () == CResourceFile::RESOURCE_FILE_TYPE_CLIENT_CONFIG
+                || pResourceFile->GetType () == CResourceFile::RESOURCE_FILE_TYPE_CLIENT_FILE )
+                pathList.push_back ( pResourceFile->GetCachedPathFilename () );
+        }
+    }
+    pChecksumCache->PrecacheChecksums ( pathList );
 
     list < CResourceFile* > ::iterator iterf = m_resourceFiles.begin ();
     for ( ; iterf != m_resourceFiles.end (); iterf++ )
@@ -607,14 +625,10 @@ bool CResource::GenerateChecksums ( void )
         SString strPath;
         if ( GetFilePath ( pResourceFile->GetName(), strPath ) )
         {
-            std::vector < char > buffer;
-            FileLoad ( strPath, buffer );
-            uint uiFileSize = buffer.size ();
-            const char* pFileContents = uiFileSize ? &buffer[0] : "";
-
-            CChecksum checksum = CChecksum::GenerateChecksumFromBuffer ( pFileContents, uiFileSize );
+            uint64 uiFileSize;
+            CChecksum checksum = pChecksumCache->GetChecksum ( strPath, &uiFileSize );
             pResourceFile->SetLastChecksum ( checksum );
-            pResourceFile->SetLastFileSize ( uiFileSize );
+            pResourceFile->SetLastFileSize ( static_cast < uint > ( uiFileSize ) );
 
             // Check if file is blocked
             char szHashResult[33];
@@ -644,14 +658,20 @@ bool CResource::GenerateChecksums ( void )
                         continue;
                     }
                     
-                    CChecksum cachedChecksum = CChecksum::GenerateChecksumFromFile ( strCachedFilePath );
+                    CChecksum cachedChecksum = pChecksumCache->GetChecksum ( strCachedFilePath );
                     if ( checksum != cachedChecksum )
                     {
-                        if ( !FileSave ( strCachedFilePath, pFileContents, uiFileSize ) )
+                        if ( !FileCopy ( strPath, strCachedFilePath ) )
                         {
                             CLogger::LogPrintf ( "Could not copy '%s' to '%s'\n", *strPath, *strCachedFilePath );
                             bOk = false;
+
+                            // Remove the stale copy so requests are served from the resource file
+                            FileDelete ( strCachedFilePath );
+                            pChecksumCache->InvalidateChecksum ( strCachedFilePath );
                         }
+                        else
+                            pChecksumCache->UpdateChecksum ( strCachedFilePath, checksum );
 
                         // If script is 'no client cache', make sure there is no trace of it in the output dir
                         if ( pResourceFile->IsNoClientCache () )
@@ -670,7 +690,7 @@ bool CResource::GenerateChecksums ( void )
     SString strPath;
     if ( GetFilePath ( "meta.xml", strPath ) )
     {
-        m_metaChecksum = CChecksum::GenerateChecksumFromFile ( strPath );
+        m_metaChecksum = pChecksumCache->GetChecksum ( strPath );
     }
 
     return bOk;
@@ -680,13 +700,14 @@ bool CResource::GenerateChecksums ( void )
 bool CResource::HasResourceChanged ()
 {
     string strPath;
+    CFileChecksumCache* pChecksumCache = m_resourceManager->GetChecksumCache ();
 
     list < CResourceFile* > ::iterator iterf = m_resourceFiles.begin ();
     for ( ; iterf != m_resourceFiles.end (); iterf++ )
     {
         if ( GetFilePath ( (*iterf)->GetName(), strPath ) )
         {
-            CChecksum checksum = CChecksum::GenerateChecksumFromFile ( strPath );
+            CChecksum checksum = pChecksumCache->GetChecksum ( strPath );
             if ( ( *iterf )->GetLastChecksum() != checksum )
                 return true;
 
@@ -699,7 +720,7 @@ bool CResource::HasResourceChanged ()
                 case CResourceFile::RESOURCE_FILE_TYPE_CLIENT_FILE:
                 {
                     string strCachedFilePath = pResourceFile->GetCachedPathFilename ();
-                    CChecksum cachedChecksum = CChecksum::GenerateChecksumFromFile ( strCachedFilePath );
+                    CChecksum cachedChecksum = pChecksumCache->GetChecksum ( strCachedFilePath );
                     if ( cachedChecksum != checksum )
                         return true;
                 }
@@ -713,7 +734,7 @@ bool CResource::HasResourceChanged ()
 
     if ( GetFilePath ( "meta.xml", strPath ) )
     {
-        CChecksum checksum = CChecksum::GenerateChecksumFromFile ( strPath );
+        CChecksum checksum = pChecksumCache->GetChecksum ( strPath );
         if ( checksum != m_metaChecksum )
             return true;
     }
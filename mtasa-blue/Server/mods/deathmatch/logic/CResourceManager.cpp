@@ -42,6 +42,7 @@ CResourceManager::CResourceManager ( void )
 
     m_strResourceDirectory.Format ( "%s/resources", g_pServerInterface->GetServerModPath () );
     LoadBlockedFileReasons();
+    m_pChecksumCache = new CFileChecksumCache ();
 }
 
 CResourceManager::~CResourceManager ( void )
@@ -59,6 +60,8 @@ CResourceManager::~CResourceManager ( void )
         delete pResource;
         m_resources.remove ( pResource );
     }
+
+    SAFE_DELETE ( m_pChecksumCache );
 }
 
 
@@ -233,6 +236,11 @@ bool CResourceManager::Refresh ( bool bRefreshAll, const SString& strJustThisRes
 
     marker.Set( "StartChanged" );
 
+    m_pChecksumCache->Save ();
+
+    if ( strJustThisResource.empty () )
+        CMapFileCache::Prune ( this );
+
     if ( bShowTiming )
         CLogger::LogPrintf( "Timing info: %s\n", *marker.GetString() );
 
@@ -353,6 +361,7 @@ void CResourceManager::UnloadRemovedResources ( void )
     iter = resourcesToDelete.begin ();
     for ( ; iter != resourcesToDelete.end (); iter++ )
     {
+        CMapFileCache::RemoveResource ( (*iter)->GetName () );
         UnloadAndDelete ( *iter );
     }
 }
@@ -1114,6 +1123,8 @@ CResource* CResourceManager::RenameResource ( CResource* pSourceResource, const
         return pResource;
     }
 
+    CMapFileCache::RemoveResource ( strSrcResourceName );
+
     // reload as new name
     CResource* pResource = Load ( bIsZip, strDstAbsPath, strNewResourceName );
     return pResource;
@@ -1157,6 +1168,8 @@ bool CResourceManager::DeleteResource ( const SString& strResourceName, SString&
     UnloadAndDelete ( pSourceResource );
     pSourceResource = NULL;
 
+    CMapFileCache::RemoveResource ( strSrcResourceName );
+
     // Move resource dir/zip to the trash
     return MoveDirToTrash ( strSrcResourceLocation );
 }
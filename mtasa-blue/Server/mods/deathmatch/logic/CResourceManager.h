@@ -26,6 +26,7 @@
 #include <list>
 
 class CResource;
+class CFileChecksumCache;
 #define INVALID_RESOURCE_NET_ID     0xFFFF
 
 class CResourceManager 
@@ -133,6 +134,8 @@ public:
     void                        AddBlockedFileReason            ( const SString& strFileHash, const SString& strReason );
     SString                     GetBlockedFileReason            ( const SString& strFileHash );
 
+    CFileChecksumCache*         GetChecksumCache                ( void )            { return m_pChecksumCache; }
+
 private:
     SString                     m_strResourceDirectory;
     CMappedList < CResource* >  m_resources;
@@ -155,4 +158,5 @@ private:
 
     ushort                      m_usNextNetId;
     std::map < SString, SString > m_BlockedFileReasonMap;
+    CFileChecksumCache*         m_pChecksumCache;
 };
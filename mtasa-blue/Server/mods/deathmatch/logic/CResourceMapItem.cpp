@@ -46,6 +46,7 @@ CResourceMapItem::CResourceMapItem ( CResource * resource, const char* szShortNa
 
     m_pMapElement = NULL;
     m_pXMLFile = NULL;
+    m_pMapFileCache = NULL;
     m_pXMLRootNode = NULL;
     m_pRootElement = NULL;
     m_pVM = NULL;
@@ -88,6 +89,12 @@ bool CResourceMapItem::Stop ( void )
         m_pXMLFile = NULL;
         m_pXMLRootNode = NULL;
     }
+    if ( m_pMapFileCache )
+    {
+        delete m_pMapFileCache;
+        m_pMapFileCache = NULL;
+        m_pXMLRootNode = NULL;
+    }
 
     // Map element is deleted by element group
     m_pMapElement = NULL;
@@ -110,42 +117,64 @@ bool CResourceMapItem::LoadMap ( const char * szMapFilename )
         m_pMapElement->SetTypeName ( "map" );
         m_pMapElement->SetName ( m_strShortName );
 
-        // Load and parse it
-        m_pXMLFile = g_pServerInterface->GetXML ()->CreateXML ( szMapFilename );
-        if ( m_pXMLFile )
+        // Try the binary cache first, as it is much quicker than parsing XML
+        CChecksum mapChecksum = g_pGame->GetResourceManager ()->GetChecksumCache ()->GetChecksum ( szMapFilename );
+        SString strCachePathFilename = CMapFileCache::GetCachePathFilename ( m_resource->GetName (), m_strShortName, mapChecksum );
+        m_pMapFileCache = new CMapFileCache ();
+        m_pXMLRootNode = m_pMapFileCache->Load ( strCachePathFilename );
+        if ( !m_pXMLRootNode )
         {
-            // Try to parse it
-            if ( m_pXMLFile->Parse () )
+            SAFE_DELETE ( m_pMapFileCache );
+
+            // Load and parse it
+            m_pXMLFile = g_pServerInterface->GetXML ()->CreateXML ( szMapFilename );
+            if ( m_pXMLFile )
             {
-                // Grab the root item
-                m_pXMLRootNode = m_pXMLFile->GetRootNode ();
-                if ( m_pXMLRootNode )
+                // Try to parse it
+                if ( m_pXMLFile->Parse () )
                 {
-                    // Is the rootnode's name <map>?
-                    std::string strBuffer;
-                    strBuffer = m_pXMLRootNode->GetTagName ();
-                    if ( strBuffer.compare ( "map" ) == 0 )
-                    {
-                        // Load the data
-                        m_bIsLoaded = LoadSubNodes ( *m_pXMLRootNode, m_pMapElement, NULL, true );
-                        if ( m_bIsLoaded )
-                        {
-                            LinkupElements ();
-
-                            // Add map element to element group
-                            m_pElementGroup->Add ( m_pMapElement );
-
-                            // Success
-                            return true;
-                        }
-                    }
+                    // Grab the root item
+                    m_pXMLRootNode = m_pXMLFile->GetRootNode ();
+
+                    // Save for next time
+                    if ( m_pXMLRootNode && m_pXMLRootNode->GetTagName () == "map" )
+                        CMapFileCache::Save ( *m_pXMLRootNode, strCachePathFilename );
                 }
             }
+        }
+
+        if ( m_pXMLRootNode )
+        {
+            // Is the rootnode's name <map>?
+            std::string strBuffer;
+            strBuffer = m_pXMLRootNode->GetTagName ();
+            if ( strBuffer.compare ( "map" ) == 0 )
+            {
+                // Load the data
+                m_bIsLoaded = LoadSubNodes ( *m_pXMLRootNode, m_pMapElement, NULL, true );
+                if ( m_bIsLoaded )
+                {
+                    LinkupElements ();
 
-            // Failed, destroy the XML
+                    // Add map element to element group
+                    m_pElementGroup->Add ( m_pMapElement );
+
+                    // Success
+                    return true;
+                }
+            }
+        }
+
+        // Failed, destroy the XML
+        if ( m_pMapFileCache )
+        {
+            SAFE_DELETE ( m_pMapFileCache );
+        }
+        else if ( m_pXMLFile )
+        {
             delete m_pXMLRootNode;
-            m_pXMLRootNode = NULL;
         }
+        m_pXMLRootNode = NULL;
 
         // Delete map element
         delete m_pMapElement;
@@ -30,6 +30,7 @@
 #include "CVehicleManager.h"
 #include "CTeamManager.h"
 #include "CResourceFile.h"
+#include "CMapFileCache.h"
 
 class CResourceMapItem : public CResourceFile
 {
@@ -74,6 +75,7 @@ private:
     bool                                m_bIsLoaded;
 
     CXMLFile*                           m_pXMLFile;
+    CMapFileCache*                      m_pMapFileCache;
     CXMLNode*                           m_pXMLRootNode;
     CDummy*                             m_pRootElement;
     CDummy*                             m_pMapElement;
@@ -18,6 +18,7 @@ extern CGame * g_pGame;
 
 #define MAX_STRING_LENGTH 2048
 CScriptDebugging::CScriptDebugging ( CLuaManager* pLuaManager )
+    : m_DuplicateLineFilter ( 4, 5, 5 )
 {
     m_pLuaManager = pLuaManager;
     m_uiLogFileLevel = 0;
@@ -254,13 +255,14 @@ bool CScriptDebugging::SetLogfile ( const char* szFilename, unsigned int uiLevel
         // Close the previously loaded file
         if ( m_pLogFile )
         {
-            fprintf ( m_pLogFile, "INFO: Logging to this file ended\n" );
-            fclose ( m_pLogFile );
+            CLogger::WriteToFile ( m_pLogFile, "INFO: Logging to this file ended\n" );
+            CLogger::CloseFile ( m_pLogFile );
         }
 
         // Set the new pointer and level and return true
         m_uiLogFileLevel = uiLevel;
         m_pLogFile = pFile;
+        CLogger::StartLogWriter ();
         return true;
     }
 
@@ -446,13 +448,7 @@ void CScriptDebugging::PrintLog ( const char* szText )
     if ( m_pLogFile )
     {
         // Log it, timestamped
-        char szBuffer [64];
-        time_t timeNow;
-        time ( &timeNow );
-        strftime ( szBuffer, 32, "[%Y-%m-%d %H:%M:%S]", localtime ( &timeNow ) );
-
-        fprintf ( m_pLogFile, "%s %s\n", szBuffer, szText );
-        fflush ( m_pLogFile );
+        CLogger::WriteToFile ( m_pLogFile, SString ( "%s%s\n", *CLogger::GetTimeStamp (), szText ) );
     }
 }
 
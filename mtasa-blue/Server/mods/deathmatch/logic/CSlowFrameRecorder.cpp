@@ -0,0 +1,415 @@
+/*****************************************************************************
+*
+*  PROJECT:     Multi Theft Auto v1.0
+*  LICENSE:     See LICENSE in the top level directory
+*  FILE:        mods/deathmatch/logic/CSlowFrameRecorder.cpp
+*  PURPOSE:     Records what happened during server frames which took too long
+*
+*  Multi Theft Auto is available from http://www.multitheftauto.com/
+*
+*****************************************************************************/
+
+#include "StdInc.h"
+
+namespace
+{
+    struct SSectionTime
+    {
+        SString     strName;
+        TIMEUS      clockTime;
+        int         iDepth;
+        TIMEUS      totalUs;
+        uint        uiCalls;
+    };
+
+    bool SortSectionsByTime ( const SSectionTime* a, const SSectionTime* b )
+    {
+        return a->totalUs > b->totalUs;
+    }
+
+    SString FormatMs ( TIMEUS timeUs )
+    {
+        return SString ( "%.1f", timeUs / 1000.0 );
+    }
+}
+
+
+///////////////////////////////////////////////////////////////
+//
+// CSlowFrameRecorder::CSlowFrameRecorder
+//
+//
+//
+///////////////////////////////////////////////////////////////
+CSlowFrameRecorder::CSlowFrameRecorder ( void )
+{
+    m_FrameHistory.resize ( SLOW_FRAME_HISTORY_SIZE );
+    m_LuaCallList.reserve ( SLOW_FRAME_MAX_LUA_CALLS );
+}
+
+
+///////////////////////////////////////////////////////////////
+//
+// CSlowFrameRecorder::FrameStart
+//
+// Called at the start of CGame::DoPulse
+//
+///////////////////////////////////////////////////////////////
+void CSlowFrameRecorder::FrameStart ( void )
+{
+    int iThresholdMs = g_pGame->GetConfig ()->GetSlowFrameLogThreshold ();
+    bool bEnabled = iThresholdMs > 0;
+    if ( bEnabled != m_bEnabled )
+    {
+        m_bEnabled = bEnabled;
+        g_StatEvents.SetEnabled ( m_bEnabled || CPerfStatServerTiming::GetSingleton ()->IsActive () );
+    }
+
+    if ( !m_bEnabled )
+        return;
+
+    // Only record Lua calls which could be a noticeable part of a slow frame
+    m_ThresholdUs = iThresholdMs * 1000;
+    m_MinLuaCallUs = std::max < TIMEUS > ( 1000, m_ThresholdUs / 20 );
+
+    // Clock events are only kept for one frame, unless the server timing stats are using them
+    if ( !CPerfStatServerTiming::GetSingleton ()->IsActive () )
+        g_StatEvents.ClearBuffer ( true );
+    m_iStatEventsStartPos = g_StatEvents.GetBufferPos ();
+    m_SavedStatEvents.clear ();
+
+    if ( m_uiNumPackets )
+    {
+        for ( uint i = 0 ; i < NUMELMS( m_PacketCounts ) ; i++ )
+        {
+            m_PacketCounts[i] = 0;
+            m_PacketTimes[i] = 0;
+        }
+    }
+    m_uiNumPackets = 0;
+    m_uiNumLuaCalls = 0;
+    m_LuaCallList.clear ();
+
+    m_FrameStartTime = GetTimeUs ();
+}
+
+
+///////////////////////////////////////////////////////////////
+//
+// CSlowFrameRecorder::FrameEnd
+//
+// Called at the end of CGame::DoPulse
+//
+///////////////////////////////////////////////////////////////
+void CSlowFrameRecorder::FrameEnd ( void )
+{
+    if ( !m_bEnabled )
+        return;
+
+    TIMEUS frameEndTime = GetTimeUs ();
+    TIMEUS frameTimeUs = frameEndTime - m_FrameStartTime;
+
+    if ( frameTimeUs >= m_ThresholdUs )
+        WriteSnapshot ( frameEndTime );
+
+    SFrameRecord& record = m_FrameHistory[ m_uiFrameHistoryPos ];
+    record.llEndTime = CTickCount::Now ().ToLongLong ();
+    record.timeUs = frameTimeUs;
+    record.uiNumPackets = m_uiNumPackets;
+    record.uiNumLuaCalls = m_uiNumLuaCalls;
+    m_uiFrameHistoryPos = ( m_uiFrameHistoryPos + 1 ) % m_FrameHistory.size ();
+}
+
+
+///////////////////////////////////////////////////////////////
+//
+// CSlowFrameRecorder::SaveStatEvents
+//
+// Called before the server timing stats empty the clock event buffer
+//
+///////////////////////////////////////////////////////////////
+void CSlowFrameRecorder::SaveStatEvents ( void )
+{
+    if ( !m_bEnabled )
+        return;
+
+    const CStatEvents::SItem* pItems = g_StatEvents.GetBufferItems ();
+    int iEndPos = g_StatEvents.GetBufferPos ();
+    for ( int i = m_iStatEventsStartPos ; i < iEndPos ; i++ )
+        m_SavedStatEvents.push_back ( pItems[i] );
+    m_iStatEventsStartPos = 0;
+}
+
+
+///////////////////////////////////////////////////////////////
+//
+// CSlowFrameRecorder::AddLuaCall
+//
+// Keep a copy of the names, as the resource could be gone by the end of the frame
+//
+///////////////////////////////////////////////////////////////
+void CSlowFrameRecorder::AddLuaCall ( CLuaMain* pLuaMain, const char* szName, TIMEUS startTime, TIMEUS timeUs, bool bIsEvent )
+{
+    if ( m_LuaCallList.size () >= SLOW_FRAME_MAX_LUA_CALLS )
+        return;
+
+    CResource* pResource = pLuaMain ? pLuaMain->GetResource () : NULL;
+
+    m_LuaCallList.push_back ( SLuaCallRecord () );
+    SLuaCallRecord& record = m_LuaCallList.back ();
+    record.strResourceName = pResource ? pResource->GetName () : "";
+    record.strName = szName;
+    record.startOffsetUs = startTime - m_FrameStartTime;
+    record.timeUs = timeUs;
+    record.bIsEvent = bIsEvent;
+}
+
+
+///////////////////////////////////////////////////////////////
+//
+// CSlowFrameRecorder::WriteSnapshot
+//
+// Append what happened during this frame to logs/slowframes.log
+//
+///////////////////////////////////////////////////////////////
+void CSlowFrameRecorder::WriteSnapshot ( TIMEUS frameEndTime )
+{
+    if ( m_bSnapshotDone && m_TimeSinceSnapshot.Get () < SLOW_FRAME_MIN_SNAPSHOT_INTERVAL_MS )
+    {
+        m_uiNumSkippedSnapshots++;
+        return;
+    }
+    m_bSnapshotDone = true;
+    m_TimeSinceSnapshot.Reset ();
+
+    TIMEUS frameTimeUs = frameEndTime - m_FrameStartTime;
+
+    SString strOutput;
+    strOutput += SString ( "[%s] Slow frame: %s ms (threshold %s ms)\n", *GetLocalTimeString ( true, true ), *FormatMs ( frameTimeUs ), *FormatMs ( m_ThresholdUs ) );
+    if ( m_uiNumSkippedSnapshots )
+        strOutput += SString ( "  %u slow frames since the last snapshot were not recorded\n", m_uiNumSkippedSnapshots );
+    m_uiNumSkippedSnapshots = 0;
+
+    AddSectionInfo ( strOutput, frameEndTime );
+    AddLuaCallInfo ( strOutput );
+    AddPacketInfo ( strOutput );
+    AddHistoryInfo ( strOutput );
+    strOutput += "\n";
+
+    FileAppend ( g_pServerInterface->GetModManager ()->GetAbsolutePath ( "logs/slowframes.log" ), strOutput );
+    CLogger::LogPrintf ( "WARNING: Server frame took %s ms, details written to logs/slowframes.log\n", *FormatMs ( frameTimeUs ) );
+}
+
+
+///////////////////////////////////////////////////////////////
+//
+// CSlowFrameRecorder::AddSectionInfo
+//
+// Add up time between each CLOCK/UNCLOCK pair during this frame
+//
+///////////////////////////////////////////////////////////////
+void CSlowFrameRecorder::AddSectionInfo ( SString& strOutput, TIMEUS frameEndTime )
+{
+    std::vector < CStatEvents::SItem > itemList = m_SavedStatEvents;
+    const CStatEvents::SItem* pItems = g_StatEvents.GetBufferItems ();
+    int iEndPos = g_StatEvents.GetBufferPos ();
+    for ( int i = std::min ( m_iStatEventsStartPos, iEndPos ) ; i < iEndPos ; i++ )
+        itemList.push_back ( pItems[i] );
+
+    std::map < SString, SSectionTime > sectionMap;
+    for ( uint i = 0 ; i < itemList.size () ; i++ )
+    {
+        const CStatEvents::SItem& item = itemList[i];
+        SString strName ( "%s.%s", item.szSection, item.szName );
+        SSectionTime* pSection = MapFind ( sectionMap, strName );
+        if ( !pSection )
+        {
+            MapSet ( sectionMap, strName, SSectionTime () );
+            pSection = MapFind ( sectionMap, strName );
+            pSection->strName = strName;
+            pSection->clockTime = 0;
+            pSection->iDepth = 0;
+            pSection->totalUs = 0;
+            pSection->uiCalls = 0;
+        }
+
+        if ( item.type == STATS_CLOCK )
+        {
+            if ( pSection->iDepth++ == 0 )
+                pSection->clockTime = item.timeStamp;
+        }
+        else
+        if ( pSection->iDepth > 0 )
+        {
+            if ( --pSection->iDepth == 0 )
+            {
+                pSection->totalUs += item.timeStamp - pSection->clockTime;
+                pSection->uiCalls++;
+            }
+        }
+    }
+
+    // Sort by time, and close anything still clocked at the end of the frame
+    std::vector < SSectionTime* > sortList;
+    for ( std::map < SString, SSectionTime >::iterator iter = sectionMap.begin () ; iter != sectionMap.end () ; ++iter )
+    {
+        SSectionTime& section = iter->second;
+        if ( section.iDepth > 0 )
+        {
+            section.totalUs += frameEndTime - section.clockTime;
+            section.uiCalls++;
+        }
+        sortList.push_back ( &section );
+    }
+    std::sort ( sortList.begin (), sortList.end (), SortSectionsByTime );
+
+    strOutput += "  Top sections:\n";
+    if ( sortList.empty () )
+        strOutput += "    No clock data\n";
+    for ( uint i = 0 ; i < sortList.size () && i < 15 ; i++ )
+        strOutput += SString ( "    %8s ms  %5u calls  %s\n", *FormatMs ( sortList[i]->totalUs ), sortList[i]->uiCalls, *sortList[i]->strName );
+}
+
+
+///////////////////////////////////////////////////////////////
+//
+// CSlowFrameRecorder::AddLuaCallInfo
+//
+// Inner calls always finish, and so are recorded, before the calls they are nested in
+//
+///////////////////////////////////////////////////////////////
+void CSlowFrameRecorder::AddLuaCallInfo ( SString& strOutput )
+{
+    strOutput += SString ( "  Lua calls: %u, of which %u took %s ms or more\n", m_uiNumLuaCalls, (uint)m_LuaCallList.size (), *FormatMs ( m_MinLuaCallUs ) );
+    if ( m_LuaCallList.empty () )
+        return;
+
+    // Find which calls are not nested in another recorded call
+    std::vector < int > outerList;
+    for ( uint i = 0 ; i < m_LuaCallList.size () ; i++ )
+    {
+        const SLuaCallRecord& inner = m_LuaCallList[i];
+        bool bIsNested = false;
+        for ( uint j = i + 1 ; j < m_LuaCallList.size () && !bIsNested ; j++ )
+        {
+            const SLuaCallRecord& outer = m_LuaCallList[j];
+            bIsNested = inner.startOffsetUs >= outer.startOffsetUs && inner.startOffsetUs + inner.timeUs <= outer.startOffsetUs + outer.timeUs;
+        }
+        if ( !bIsNested )
+            outerList.push_back ( i );
+    }
+
+    // Time per resource
+    std::map < SString, TIMEUS > resourceTimeMap;
+    for ( uint i = 0 ; i < outerList.size () ; i++ )
+    {
+        const SLuaCallRecord& record = m_LuaCallList[ outerList[i] ];
+        MapGet ( resourceTimeMap, record.strResourceName ) += record.timeUs;
+    }
+    std::vector < std::pair < TIMEUS, SString > > resourceSortList;
+    for ( std::map < SString, TIMEUS >::iterator iter = resourceTimeMap.begin () ; iter != resourceTimeMap.end () ; ++iter )
+        resourceSortList.push_back ( std::make_pair ( iter->second, iter->first ) );
+    std::sort ( resourceSortList.begin (), resourceSortList.end (), std::greater < std::pair < TIMEUS, SString > > () );
+
+    strOutput += "  Top resources:\n";
+    for ( uint i = 0 ; i < resourceSortList.size () && i < 10 ; i++ )
+        strOutput += SString ( "    %8s ms  %s\n", *FormatMs ( resourceSortList[i].first ), *resourceSortList[i].second );
+
+    // Slowest call, followed by the slowest call nested in that, and so on
+    int iSlowest = outerList[0];
+    for ( uint i = 1 ; i < outerList.size () ; i++ )
+        if ( m_LuaCallList[ outerList[i] ].timeUs > m_LuaCallList[ iSlowest ].timeUs )
+            iSlowest = outerList[i];
+
+    strOutput += "  Slowest Lua call stack:\n";
+    SString strIndent = "    ";
+    while ( iSlowest >= 0 )
+    {
+        const SLuaCallRecord& outer = m_LuaCallList[ iSlowest ];
+        strOutput += SString ( "%s%s ms  [%s] %s%s  (at +%s ms)\n", *strIndent, *FormatMs ( outer.timeUs ), *outer.strResourceName, outer.bIsEvent ? "event " : "", *outer.strName, *FormatMs ( outer.startOffsetUs ) );
+        strIndent += "  ";
+
+        int iNext = -1;
+        for ( int i = 0 ; i < iSlowest ; i++ )
+        {
+            const SLuaCallRecord& inner = m_LuaCallList[i];
+            if ( inner.startOffsetUs >= outer.startOffsetUs && inner.startOffsetUs + inner.timeUs <= outer.startOffsetUs + outer.timeUs )
+                if ( iNext == -1 || inner.timeUs > m_LuaCallList[ iNext ].timeUs )
+                    iNext = i;
+        }
+        iSlowest = iNext;
+    }
+}
+
+
+///////////////////////////////////////////////////////////////
+//
+// CSlowFrameRecorder::AddPacketInfo
+//
+//
+//
+///////////////////////////////////////////////////////////////
+void CSlowFrameRecorder::AddPacketInfo ( SString& strOutput )
+{
+    strOutput += SString ( "  Packets: %u\n", m_uiNumPackets );
+    for ( uint i = 0 ; i < NUMELMS( m_PacketCounts ) ; i++ )
+    {
+        if ( m_PacketCounts[i] == 0 )
+            continue;
+
+        // Turn "PACKET_ID_PED_SYNC" into "64_Ped_sync"
+        SString strPacketDesc = EnumToString ( (ePacketID)i ).SplitRight ( "PACKET_ID", NULL, -1 ).ToLower ();
+        SString strPacketName = SString ( "%d", i ) + strPacketDesc.Left ( 2 ).ToUpper () + strPacketDesc.SubStr ( 2 );
+        strOutput += SString ( "    %8s ms  %5u x %s\n", *FormatMs ( m_PacketTimes[i] ), m_PacketCounts[i], *strPacketName );
+    }
+}
+
+
+///////////////////////////////////////////////////////////////
+//
+// CSlowFrameRecorder::AddHistoryInfo
+//
+// Summary of the frames leading up to this one
+//
+///////////////////////////////////////////////////////////////
+void CSlowFrameRecorder::AddHistoryInfo ( SString& strOutput )
+{
+    long long llNow = CTickCount::Now ().ToLongLong ();
+    uint uiNumFrames = 0;
+    uint uiNumSlowFrames = 0;
+    uint uiNumPackets = 0;
+    uint uiNumLuaCalls = 0;
+    TIMEUS totalUs = 0;
+    TIMEUS maxUs = 0;
+    SString strRecent;
+
+    // Go backwards from the most recent
+    for ( uint i = 1 ; i <= m_FrameHistory.size () ; i++ )
+    {
+        const SFrameRecord& record = m_FrameHistory[ ( m_uiFrameHistoryPos + m_FrameHistory.size () - i ) % m_FrameHistory.size () ];
+        if ( record.llEndTime == 0 || llNow - record.llEndTime > SLOW_FRAME_HISTORY_MS )
+            break;
+
+        uiNumFrames++;
+        uiNumPackets += record.uiNumPackets;
+        uiNumLuaCalls += record.uiNumLuaCalls;
+        totalUs += record.timeUs;
+        maxUs = std::max ( maxUs, record.timeUs );
+        if ( record.timeUs >= m_ThresholdUs )
+            uiNumSlowFrames++;
+
+        if ( i <= 10 )
+            strRecent += SString ( "    %6d ms ago: %8s ms  %5u packets  %5u Lua calls\n", (int)( llNow - record.llEndTime ), *FormatMs ( record.timeUs ), record.uiNumPackets, record.uiNumLuaCalls );
+    }
+
+    strOutput += SString ( "  Previous %d seconds: %u frames, %u slow, avg %s ms, max %s ms, %u packets, %u Lua calls\n"
+                                , SLOW_FRAME_HISTORY_MS / 1000
+                                , uiNumFrames
+                                , uiNumSlowFrames
+                                , *FormatMs ( uiNumFrames ? totalUs / uiNumFrames : 0 )
+                                , *FormatMs ( maxUs )
+                                , uiNumPackets
+                                , uiNumLuaCalls
+                            );
+    strOutput += strRecent;
+}
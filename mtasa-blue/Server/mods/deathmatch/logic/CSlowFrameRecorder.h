@@ -0,0 +1,103 @@
+/*****************************************************************************
+*
+*  PROJECT:     Multi Theft Auto v1.0
+*  LICENSE:     See LICENSE in the top level directory
+*  FILE:        mods/deathmatch/logic/CSlowFrameRecorder.h
+*  PURPOSE:     Records what happened during server frames which took too long
+*
+*  Multi Theft Auto is available from http://www.multitheftauto.com/
+*
+*****************************************************************************/
+#pragma once
+
+#define SLOW_FRAME_HISTORY_SIZE             1024        // Number of recent frames kept for context
+#define SLOW_FRAME_HISTORY_MS               5000        // How far back a snapshot looks
+#define SLOW_FRAME_MAX_LUA_CALLS            1000        // Per frame
+#define SLOW_FRAME_MIN_SNAPSHOT_INTERVAL_MS 30000       // Stop a struggling server from filling the disk
+
+//
+// Flight recorder for the main server pulse
+// Keeps a cheap summary of recent frames and, when a frame takes longer than 'slow_frame_log_threshold',
+// writes the clock sections, long Lua calls and packets handled during that frame to logs/slowframes.log
+//
+class CSlowFrameRecorder
+{
+public:
+    ZERO_ON_NEW
+                        CSlowFrameRecorder      ( void );
+
+    void                FrameStart              ( void );
+    void                FrameEnd                ( void );
+    void                SaveStatEvents          ( void );
+    bool                IsEnabled               ( void ) const              { return m_bEnabled; }
+
+    // Called for every packet and Lua call, so only does anything when needed
+    void OnPacket ( uchar ucPacketID, TIMEUS timeUs )
+    {
+        if ( m_bEnabled )
+        {
+            m_PacketCounts[ ucPacketID ]++;
+            m_PacketTimes[ ucPacketID ] += timeUs;
+            m_uiNumPackets++;
+        }
+    }
+
+    void OnLuaCall ( CLuaMain* pLuaMain, const char* szName, TIMEUS startTime, bool bIsEvent = false )
+    {
+        if ( m_bEnabled )
+        {
+            if ( !bIsEvent )
+                m_uiNumLuaCalls++;
+            TIMEUS timeUs = GetTimeUs () - startTime;
+            if ( timeUs >= m_MinLuaCallUs )
+                AddLuaCall ( pLuaMain, szName, startTime, timeUs, bIsEvent );
+        }
+    }
+
+protected:
+    struct SFrameRecord
+    {
+        long long           llEndTime;
+        TIMEUS              timeUs;
+        uint                uiNumPackets;
+        uint                uiNumLuaCalls;
+    };
+
+    struct SLuaCallRecord
+    {
+        SString             strResourceName;
+        SString             strName;
+        TIMEUS              startOffsetUs;          // From start of the frame
+        TIMEUS              timeUs;
+        bool                bIsEvent;
+    };
+
+    void                AddLuaCall              ( CLuaMain* pLuaMain, const char* szName, TIMEUS startTime, TIMEUS timeUs, bool bIsEvent );
+    void                WriteSnapshot           ( TIMEUS frameEndTime );
+    void                AddSectionInfo          ( SString& strOutput, TIMEUS frameEndTime );
+    void                AddLuaCallInfo          ( SString& strOutput );
+    void                AddPacketInfo           ( SString& strOutput );
+    void                AddHistoryInfo          ( SString& strOutput );
+
+    bool                                        m_bEnabled;
+    TIMEUS                                      m_ThresholdUs;
+    TIMEUS                                      m_MinLuaCallUs;
+    TIMEUS                                      m_FrameStartTime;
+
+    // Current frame
+    uint                                        m_uiNumPackets;
+    uint                                        m_uiNumLuaCalls;
+    SFixedArray < uint, 256 >                   m_PacketCounts;
+    SFixedArray < TIMEUS, 256 >                 m_PacketTimes;
+    std::vector < SLuaCallRecord >              m_LuaCallList;
+    int                                         m_iStatEventsStartPos;
+    std::vector < CStatEvents::SItem >          m_SavedStatEvents;
+
+    // Recent frames
+    std::vector < SFrameRecord >                m_FrameHistory;
+    uint                                        m_uiFrameHistoryPos;
+
+    CElapsedTime                                m_TimeSinceSnapshot;
+    bool                                        m_bSnapshotDone;
+    uint                                        m_uiNumSkippedSnapshots;
+};
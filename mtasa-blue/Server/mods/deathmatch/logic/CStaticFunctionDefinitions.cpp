@@ -6876,6 +6876,7 @@ bool CStaticFunctionDefinitions::ResetVehicleIdleTime ( CElement* pElement )
     {
         CVehicle* pVehicle = static_cast < CVehicle* > ( pElement );
         pVehicle->StopIdleTimer ();
+        pVehicle->UpdateRespawnCheck ();
 
         return true;
     }
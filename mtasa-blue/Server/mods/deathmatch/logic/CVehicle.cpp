@@ -424,6 +424,11 @@ void CVehicle::SetPosition ( const CVector & vecPosition )
         // Update our stored vectors
         m_vecPosition = vecPosition;
         UpdateSpatialData ();
+
+        // Moving a deserted vehicle restarts the idle timer
+        // (The respawn check will find the later time when it is next due)
+        if ( m_bRespawnEnabled && !GetFirstOccupant () && !IsStationary () )
+            RestartIdleTimer ();
     }
 }
 
@@ -597,6 +602,7 @@ bool CVehicle::SetOccupant ( CPed* pPed, unsigned int uiSeat )
         if ( GetFirstOccupant () )
             StopIdleTimer ();
 
+        UpdateRespawnCheck ();
         return true;
     }
 
@@ -734,6 +740,7 @@ void CVehicle::SpawnAt ( const CVector& vecPosition, const CVector& vecRotation
     m_vecPosition = vecPosition;
     m_vecRotationDegrees = vecRotation;
     UpdateSpatialData ();
+    UpdateRespawnCheck ();
 }
 
 
@@ -884,6 +891,8 @@ void CVehicle::SetIsBlown ( bool bBlown )
         m_llBlowTime = CTickCount ( 0LL );
     else
         m_llBlowTime = CTickCount::Now ();
+
+    UpdateRespawnCheck ();
 }
 
 
@@ -935,6 +944,37 @@ bool CVehicle::IsStationary ( void )
 }
 
 
+// Get when the blow or idle timer will finish, or 0 if neither is running
+long long CVehicle::GetNextRespawnCheckTime ( void )
+{
+    if ( !m_bRespawnEnabled )
+        return 0;
+
+    long long llTime = 0;
+    if ( GetIsBlown () )
+        llTime = ( m_llBlowTime + CTickCount ( (long long)m_ulBlowRespawnInterval ) ).ToLongLong ();
+
+    if ( IsIdleTimerRunning () )
+    {
+        long long llIdleTime = ( m_llIdleTime + CTickCount ( (long long)m_ulIdleRespawnInterval ) ).ToLongLong ();
+        if ( llTime == 0 || llIdleTime < llTime )
+            llTime = llIdleTime;
+    }
+    return llTime;
+}
+
+
+// Make sure CMapManager::DoVehicleRespawning will look at us when a timer finishes
+void CVehicle::UpdateRespawnCheck ( void )
+{
+    // Deserted vehicles always have the idle timer running
+    if ( m_bRespawnEnabled && !GetFirstOccupant () && !IsIdleTimerRunning () )
+        RestartIdleTimer ();
+
+    m_pVehicleManager->UpdateRespawnCheck ( this );
+}
+
+
 void CVehicle::SetJackingPlayer ( CPlayer* pPlayer )
 {
     if ( pPlayer == m_pJackingPlayer )
@@ -985,5 +1025,20 @@ void CVehicle::SetRespawnEnabled ( bool bEnabled )
             m_pVehicleManager->GetRespawnEnabledVehicles ( ).remove ( this );
 
         m_bRespawnEnabled = bEnabled;
+        UpdateRespawnCheck ();
     }
+}
+
+
+void CVehicle::SetBlowRespawnInterval ( unsigned long ulTime )
+{
+    m_ulBlowRespawnInterval = ulTime;
+    UpdateRespawnCheck ();
+}
+
+
+void CVehicle::SetIdleRespawnInterval ( unsigned long ulTime )
+{
+    m_ulIdleRespawnInterval = ulTime;
+    UpdateRespawnCheck ();
 }
\ No newline at end of file
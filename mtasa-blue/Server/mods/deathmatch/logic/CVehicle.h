@@ -317,8 +317,8 @@ public:
     inline void                     SetRespawnHealth        ( float fHealth )               { m_fRespawnHealth = fHealth; };
     inline bool                     GetRespawnEnabled       ( void )                        { return m_bRespawnEnabled; }
     void                            SetRespawnEnabled       ( bool bEnabled );
-    void                            SetBlowRespawnInterval  ( unsigned long ulTime )        { m_ulBlowRespawnInterval = ulTime; }
-    void                            SetIdleRespawnInterval  ( unsigned long ulTime )        { m_ulIdleRespawnInterval = ulTime; }
+    void                            SetBlowRespawnInterval  ( unsigned long ulTime );
+    void                            SetIdleRespawnInterval  ( unsigned long ulTime );
 
     void                            SpawnAt                 ( const CVector& vecPosition, const CVector& vecRotation );
     void                            Respawn                 ( void );
@@ -346,6 +346,8 @@ public:
     bool                            IsIdleTimerRunning      ( void );
     bool                            IsIdleTimerFinished     ( void );
     bool                            IsStationary            ( void );
+    long long                       GetNextRespawnCheckTime ( void );
+    void                            UpdateRespawnCheck      ( void );
     void                            OnRelayUnoccupiedSync   ( void );
     void                            HandleDimensionResync   ( void );
 
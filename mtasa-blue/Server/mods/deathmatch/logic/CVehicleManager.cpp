@@ -433,6 +433,30 @@ void CVehicleManager::DeleteAll ( void )
 void CVehicleManager::RemoveFromList ( CVehicle* pVehicle )
 {
     m_List.remove ( pVehicle );
+    m_RespawnCheckQueue.Remove ( pVehicle );
+}
+
+
+//
+// Queue the vehicle to be checked for respawning when its blow or idle timer finishes
+// If the time has moved later, the earlier check will queue it again
+//
+void CVehicleManager::UpdateRespawnCheck ( CVehicle* pVehicle )
+{
+    long long llTime = pVehicle->GetNextRespawnCheckTime ();
+    if ( llTime == 0 )
+        m_RespawnCheckQueue.Remove ( pVehicle );
+    else
+        m_RespawnCheckQueue.SetIfEarlier ( pVehicle, llTime );
+}
+
+
+//
+// Take vehicles which have a timer that has finished
+//
+void CVehicleManager::GetDueRespawnChecks ( std::vector < CVehicle* >& outList )
+{
+    m_RespawnCheckQueue.PopDue ( CTickCount::Now ().ToLongLong (), outList );
 }
 
 
@@ -19,6 +19,7 @@ class CVehicleManager;
 
 #include "CVehicle.h"
 #include "CVehicleColorManager.h"
+#include "CDeadlineQueue.h"
 #include <list>
 #include "lua/CLuaMain.h"
 
@@ -65,6 +66,8 @@ public:
     list < CVehicle* > ::const_iterator IterEnd                     ( void )                            { return m_List.end (); };
 
     list < CVehicle* >&                 GetRespawnEnabledVehicles   ( void )                            { return m_RespawnEnabledVehicles; };
+    void                                UpdateRespawnCheck          ( CVehicle* pVehicle );
+    void                                GetDueRespawnChecks         ( std::vector < CVehicle* >& outList );
 
 private:
     inline void                         AddToList                   ( CVehicle* pVehicle )              { m_List.push_back ( pVehicle ); };
@@ -74,6 +77,7 @@ private:
 
     list < CVehicle* >                  m_List;
     list < CVehicle* >                  m_RespawnEnabledVehicles;
+    CDeadlineQueue < CVehicle >         m_RespawnCheckQueue;
 };
 
 #endif
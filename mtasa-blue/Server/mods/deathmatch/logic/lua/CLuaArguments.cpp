@@ -257,7 +257,9 @@ bool CLuaArguments::Call ( CLuaMain* pLuaMain, const CLuaFunctionRef& iLuaFuncti
             lua_pop ( luaVM, 1 );
     }
 
-    CPerfStatLuaTiming::GetSingleton ()->UpdateLuaTiming ( pLuaMain, pLuaMain->GetFunctionTag ( iLuaFunction.ToInt() ), GetTimeUs() - startTime );
+    const SString& strFunctionTag = pLuaMain->GetFunctionTag ( iLuaFunction.ToInt() );
+    CPerfStatLuaTiming::GetSingleton ()->UpdateLuaTiming ( pLuaMain, strFunctionTag, GetTimeUs() - startTime );
+    g_pGame->GetSlowFrameRecorder ()->OnLuaCall ( pLuaMain, strFunctionTag, startTime );
     return true;
 }
 
@@ -312,6 +314,7 @@ bool CLuaArguments::CallGlobal ( CLuaMain* pLuaMain, const char* szFunction, CLu
     }
         
     CPerfStatLuaTiming::GetSingleton ()->UpdateLuaTiming ( pLuaMain, szFunction, GetTimeUs() - startTime );
+    g_pGame->GetSlowFrameRecorder ()->OnLuaCall ( pLuaMain, szFunction, startTime );
     return true;
 }
 
@@ -18,6 +18,7 @@
 #include "StdInc.h"
 
 #include "CLuaFunctionDefs.h"
+#include <SharedUtil.Crypto.h>
 #include <clocale>
 
 static CLuaManager* m_pLuaManager;
@@ -26,6 +27,13 @@ SString CLuaMain::ms_strExpectedUndumpHash;
 #define HOOK_INSTRUCTION_COUNT 1000000
 #define HOOK_MAXIMUM_TIME 5000
 
+// Change this to invalidate all cached bytecode
+#define BYTECODE_CACHE_VERSION 2
+// Least recently used cached bytecode is deleted when the total goes over this
+#define BYTECODE_CACHE_MAX_SIZE ( 64LL * 1024 * 1024 )
+// Secret for signing cached bytecode, stored next to internal.db
+#define BYTECODE_CACHE_KEY_FILENAME "bytecode-cache.key"
+
 extern CGame* g_pGame;
 extern CNetServer* g_pRealNetServer;
 
@@ -45,6 +53,7 @@ CLuaMain::CLuaMain ( CLuaManager* pLuaManager,
     // Initialise everything to be setup in the Start function
     m_pLuaManager = pLuaManager;
     m_luaVM = NULL;
+    m_AsyncTaskToken = CAsyncTaskToken::Create ();
     m_pResource = pResourceOwner;
     m_pResourceFile = NULL;
     m_bBeingDeleted = false;
@@ -71,6 +80,9 @@ CLuaMain::CLuaMain ( CLuaManager* pLuaManager,
 
 CLuaMain::~CLuaMain ( void )
 {
+    // Stop async task results from being delivered to this VM
+    m_AsyncTaskToken.Cancel ();
+
     // remove all current remote calls originating from this VM
     g_pGame->GetRemoteCalls()->Remove ( this );
     g_pGame->GetLuaCallbackManager ()->OnLuaMainDestroy ( this );
@@ -292,8 +304,20 @@ bool CLuaMain::LoadScriptFromBuffer ( const char* cpInBuffer, unsigned int uiInS
         else
             strUTFScript = std::string(cpBuffer, uiSize);
 
+        const char* cpScript = bUTF8 ? cpBuffer : strUTFScript.c_str();
+        SString strChunkName ( "@%s", *strNiceFilename );
+
+        // Use bytecode from a previous compile of the same source if possible
+        SString strSourceHash;
+        bool bLoadedFromCache = false;
+        if ( !IsLuaCompiledScript( cpScript, uiSize ) )
+        {
+            strSourceHash = GenerateSha256HexString ( SString ( "%d:%s:", BYTECODE_CACHE_VERSION, *strChunkName ) + SStringX ( cpScript, uiSize ) );
+            bLoadedFromCache = LoadCachedBytecode ( m_luaVM, strSourceHash, strChunkName );
+        }
+
         // Run the script
-        if ( CLuaMain::LuaLoadBuffer ( m_luaVM, bUTF8 ? cpBuffer : strUTFScript.c_str(), uiSize, SString ( "@%s", *strNiceFilename ) ) )
+        if ( !bLoadedFromCache && CLuaMain::LuaLoadBuffer ( m_luaVM, cpScript, uiSize, strChunkName ) )
         {
             // Print the error
             std::string strRes = lua_tostring( m_luaVM, -1 );
@@ -310,6 +334,9 @@ bool CLuaMain::LoadScriptFromBuffer ( const char* cpInBuffer, unsigned int uiInS
         }
         else
         {
+            if ( !bLoadedFromCache && !strSourceHash.empty () )
+                SaveCachedBytecode ( m_luaVM, strSourceHash );
+
             ResetInstructionCount ();
             int luaSavedTop = lua_gettop ( m_luaVM );
             int iret = this->PCall ( m_luaVM, 0, LUA_MULTRET, 0 ) ;
@@ -666,6 +693,161 @@ int CLuaMain::LuaLoadBuffer( lua_State *L, const char *buff, size_t sz, const ch
 }
 
 
+namespace
+{
+    SString             ms_strBytecodeCacheKey;
+    long long           ms_llBytecodeCacheSize = -1;       // -1 if not scanned yet
+    std::set < SString > ms_BytecodeCacheTouchedList;
+}
+
+
+///////////////////////////////////////////////////////////////
+//
+// GetBytecodeCachePath
+//
+// Location in resource-cache for compiled scripts
+//
+///////////////////////////////////////////////////////////////
+static SString GetBytecodeCachePath( void )
+{
+    return PathJoin( g_pServerInterface->GetServerModPath(), "resource-cache", "bytecode" );
+}
+
+
+///////////////////////////////////////////////////////////////
+//
+// GetBytecodeCachePathFilename
+//
+// Content addressed location in resource-cache for a compiled script
+//
+///////////////////////////////////////////////////////////////
+static SString GetBytecodeCachePathFilename( const SString& strSourceHash )
+{
+    return PathJoin( GetBytecodeCachePath(), strSourceHash.Left( 2 ), strSourceHash + ".luac" );
+}
+
+
+///////////////////////////////////////////////////////////////
+//
+// GetBytecodeCacheSignature
+//
+// HMAC of the source hash and chunk, using a secret kept outside resource-cache
+// A new secret is made if the file is missing, which just makes old cache files miss
+//
+///////////////////////////////////////////////////////////////
+static SString GetBytecodeCacheSignature( const SString& strSourceHash, const SString& strChunk )
+{
+    if ( ms_strBytecodeCacheKey.empty() )
+    {
+        SString strKeyPathFilename = g_pServerInterface->GetModManager()->GetAbsolutePath( BYTECODE_CACHE_KEY_FILENAME );
+        FileLoad( strKeyPathFilename, ms_strBytecodeCacheKey );
+        if ( ms_strBytecodeCacheKey.length() != 64 )
+        {
+            char randomData[32];
+            g_pNetServer->GenerateRandomData( randomData, sizeof( randomData ) );
+            ms_strBytecodeCacheKey = ConvertDataToHexString( randomData, sizeof( randomData ) );
+            FileSave( strKeyPathFilename, ms_strBytecodeCacheKey );
+        }
+    }
+    return HmacSha256HexString( ms_strBytecodeCacheKey, strSourceHash + strChunk );
+}
+
+
+///////////////////////////////////////////////////////////////
+//
+// PruneBytecodeCache
+//
+// Measure the cache and delete the least recently used files if it is too big
+//
+///////////////////////////////////////////////////////////////
+static void PruneBytecodeCache( void )
+{
+    ms_llBytecodeCacheSize = PruneFilesBySize( GetBytecodeCachePath(), "*.luac", BYTECODE_CACHE_MAX_SIZE );
+}
+
+
+///////////////////////////////////////////////////////////////
+//
+// CLuaMain::LoadCachedBytecode
+//
+// Try to load a previously compiled chunk for the source hash
+// Cache file is the HMAC of the source hash and chunk, followed by the chunk
+// Returns true if the function was pushed onto the stack
+//
+///////////////////////////////////////////////////////////////
+bool CLuaMain::LoadCachedBytecode( lua_State *L, const SString& strSourceHash, const char *name )
+{
+    SString strPathFilename = GetBytecodeCachePathFilename( strSourceHash );
+    SString strFileContents;
+    if ( !FileLoad( strPathFilename, strFileContents ) || strFileContents.length() <= 64 )
+    {
+        g_pStats->scriptcache.llBytecodeCacheMisses++;
+        return false;
+    }
+
+    SString strChunk = strFileContents.SubStr( 64 );
+    if ( strFileContents.Left( 64 ) == GetBytecodeCacheSignature( strSourceHash, strChunk ) && IsLuaCompiledScript( strChunk.data(), strChunk.length() ) )
+    {
+        ms_strExpectedUndumpHash = GenerateSha256HexString( strChunk );
+        int iResult = luaL_loadbuffer( L, strChunk.data(), strChunk.length(), name );
+        ms_strExpectedUndumpHash = "";
+
+        if ( iResult == 0 )
+        {
+            // Save again once per run, so the modified time shows which files are still used
+            if ( ms_BytecodeCacheTouchedList.insert( strSourceHash ).second )
+                FileSave( strPathFilename, strFileContents );
+
+            g_pStats->scriptcache.llBytecodeCacheHits++;
+            return true;
+        }
+        lua_pop( L, 1 );
+    }
+
+    // Corrupt, tampered with or made with a different secret
+    FileDelete( strPathFilename );
+    g_pStats->scriptcache.llBytecodeCacheMisses++;
+    return false;
+}
+
+
+// lua_Writer for SaveCachedBytecode
+static int WriteChunkToString( lua_State *L, const void* p, size_t sz, void* ud )
+{
+    static_cast < std::string* > ( ud )->append( (const char*)p, sz );
+    return 0;
+}
+
+
+///////////////////////////////////////////////////////////////
+//
+// CLuaMain::SaveCachedBytecode
+//
+// Save the compiled function on the top of the stack for next time
+//
+///////////////////////////////////////////////////////////////
+void CLuaMain::SaveCachedBytecode( lua_State *L, const SString& strSourceHash )
+{
+    std::string strChunk;
+    if ( lua_dumpchunk( L, WriteChunkToString, &strChunk ) != 0 )
+        return;
+
+    SString strFileContents = GetBytecodeCacheSignature( strSourceHash, strChunk ) + strChunk;
+
+    SString strPathFilename = GetBytecodeCachePathFilename( strSourceHash );
+    if ( !FileSave( strPathFilename, strFileContents ) )
+        return;
+    MapInsert( ms_BytecodeCacheTouchedList, strSourceHash );
+
+    // Keep the cache size in check
+    if ( ms_llBytecodeCacheSize < 0 )
+        PruneBytecodeCache();
+    else
+    if ( ( ms_llBytecodeCacheSize += strFileContents.length() ) > BYTECODE_CACHE_MAX_SIZE )
+        PruneBytecodeCache();
+}
+
+
 ///////////////////////////////////////////////////////////////
 //
 // CLuaMain::OnUndump
@@ -685,3 +867,75 @@ int CLuaMain::OnUndump( const char* p, size_t n )
     }
     return 1;
 }
+
+
+// Globals set while an event handler is running
+static const char* const g_EventContextGlobalNames[] = { "source", "this", "sourceResource", "sourceResourceRoot", "eventName", "client" };
+
+
+///////////////////////////////////////////////////////////////
+//
+// CLuaMain::PushEventContext
+//
+// Set the event globals for a handler.
+// The previous values are kept on the Lua stack until PopEventContext,
+// which means nested events only cost a few stack operations
+//
+///////////////////////////////////////////////////////////////
+void CLuaMain::PushEventContext( const SLuaEventContext& context )
+{
+    lua_State* L = m_luaVM;
+    LUA_CHECKSTACK( L, NUMELMS( g_EventContextGlobalNames ) + 1 );
+
+    // Save current values
+    for ( uint i = 0 ; i < NUMELMS( g_EventContextGlobalNames ) ; i++ )
+        lua_getglobal( L, g_EventContextGlobalNames[i] );
+
+    // Set new values
+    lua_pushelement( L, context.pSource );
+    lua_setglobal( L, "source" );
+
+    lua_pushelement( L, context.pThis );
+    lua_setglobal( L, "this" );
+
+    if ( context.pSourceResource )
+    {
+        lua_pushresource( L, context.pSourceResource );
+        lua_setglobal( L, "sourceResource" );
+
+        lua_pushelement( L, context.pSourceResourceRoot );
+        lua_setglobal( L, "sourceResourceRoot" );
+    }
+    else
+    {
+        lua_pushnil( L );
+        lua_setglobal( L, "sourceResource" );
+
+        lua_pushnil( L );
+        lua_setglobal( L, "sourceResourceRoot" );
+    }
+
+    lua_pushstring( L, context.szEventName );
+    lua_setglobal( L, "eventName" );
+
+    if ( context.pClient )
+        lua_pushelement( L, context.pClient );
+    else
+        lua_pushnil( L );
+    lua_setglobal( L, "client" );
+}
+
+
+///////////////////////////////////////////////////////////////
+//
+// CLuaMain::PopEventContext
+//
+// Restore the event globals saved by PushEventContext
+//
+///////////////////////////////////////////////////////////////
+void CLuaMain::PopEventContext( void )
+{
+    lua_State* L = m_luaVM;
+    for ( uint i = NUMELMS( g_EventContextGlobalNames ) ; i-- > 0 ; )
+        lua_setglobal( L, g_EventContextGlobalNames[i] );
+}
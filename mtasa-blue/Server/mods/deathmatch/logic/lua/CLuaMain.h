@@ -43,6 +43,17 @@ struct CRefInfo
     int iFunction;
 };
 
+// Values for the event globals while a handler is running
+struct SLuaEventContext
+{
+    CElement*       pSource;
+    CElement*       pThis;
+    CResource*      pSourceResource;
+    CElement*       pSourceResourceRoot;
+    const char*     szEventName;
+    CPlayer*        pClient;
+};
+
 class CLuaMain //: public CClient
 {
 public:
@@ -107,6 +118,7 @@ public:
     void                            ResetInstructionCount   ( void );
 
     inline CResource *              GetResource             ( void ) { return m_pResource; }
+    const CAsyncTaskToken&          GetAsyncTaskToken       ( void ) const                  { return m_AsyncTaskToken; }
 
     inline void                     SetResourceFile         ( class CResourceFile * resourceFile ) { m_pResourceFile = resourceFile; }
     inline CResourceFile *          GetResourceFile         ( void ) { return m_pResourceFile; }
@@ -119,6 +131,11 @@ public:
     void                            CheckExecutionTime      ( void );
     static int                      LuaLoadBuffer           ( lua_State *L, const char *buff, size_t sz, const char *name );
     static int                      OnUndump                ( const char* p, size_t n );
+    static bool                     LoadCachedBytecode      ( lua_State *L, const SString& strSourceHash, const char *name );
+    static void                     SaveCachedBytecode      ( lua_State *L, const SString& strSourceHash );
+
+    void                            PushEventContext        ( const SLuaEventContext& context );
+    void                            PopEventContext         ( void );
 
 private:
     void                            InitSecurity            ( void );
@@ -135,6 +152,7 @@ private:
 
     lua_State*                      m_luaVM;
     CLuaTimerManager*               m_pLuaTimerManager;
+    CAsyncTaskToken                 m_AsyncTaskToken;       // Cancels async tasks when we are destroyed
 
     class CResource*                m_pResource;
     class CResourceFile*            m_pResourceFile;
@@ -12,6 +12,7 @@
 
 SThreadCPUTimesStore g_SyncThreadCPUTimes;
 uint g_uiNetSentByteCounter = 0;
+CLatencyHistogram g_PacketWaitTimeHistogram;    // Time from sync thread receiving a packet to main thread handling it (previous 5 seconds)
 
 namespace
 {
@@ -100,6 +101,55 @@ namespace
         ms_StatsSendCmdsTotal += ms_StatsSendNumCommands;
         ms_StatsSendCmdsMax = std::max( ms_StatsSendCmdsMax, ms_StatsSendNumCommands );
     }
+
+    // Per thread free list of job blocks, linked through the first word of each block
+    const size_t            NET_JOB_BLOCK_SIZE = 128;
+    const uint              NET_JOB_BLOCK_MAX_FREE = 4096;
+    thread_local void*      ms_pFreeJobBlocks = NULL;
+    thread_local uint       ms_uiNumFreeJobBlocks = 0;
+}
+
+
+///////////////////////////////////////////////////////////////////////////
+//
+// NetJobBlockCache::Allocate
+//
+// Any thread
+//
+///////////////////////////////////////////////////////////////////////////
+void* NetJobBlockCache::Allocate ( size_t size )
+{
+    if ( size > NET_JOB_BLOCK_SIZE )
+        return ::operator new ( size );
+
+    void* pBlock = ms_pFreeJobBlocks;
+    if ( !pBlock )
+        return ::operator new ( NET_JOB_BLOCK_SIZE );
+
+    ms_pFreeJobBlocks = *(void**)pBlock;
+    ms_uiNumFreeJobBlocks--;
+    return pBlock;
+}
+
+
+///////////////////////////////////////////////////////////////////////////
+//
+// NetJobBlockCache::Free
+//
+// Any thread
+//
+///////////////////////////////////////////////////////////////////////////
+void NetJobBlockCache::Free ( void* pBlock, size_t size )
+{
+    if ( !pBlock )
+        return;
+
+    if ( size > NET_JOB_BLOCK_SIZE || ms_uiNumFreeJobBlocks >= NET_JOB_BLOCK_MAX_FREE )
+        return ::operator delete ( pBlock );
+
+    *(void**)pBlock = ms_pFreeJobBlocks;
+    ms_pFreeJobBlocks = pBlock;
+    ms_uiNumFreeJobBlocks++;
 }
 
 
@@ -156,9 +206,8 @@ CNetServerBuffer::~CNetServerBuffer ( void )
 ///////////////////////////////////////////////////////////////
 void CNetServerBuffer::SetAutoPulseEnabled ( bool bEnable )
 {
-    shared.m_Mutex.Lock ();
     shared.m_bAutoPulse = bEnable;
-    shared.m_Mutex.Unlock ();
+    shared.m_CommandSignal.Notify ();
 }
 
 
@@ -172,10 +221,8 @@ void CNetServerBuffer::SetAutoPulseEnabled ( bool bEnable )
 void CNetServerBuffer::StopThread ( void )
 {
     // Stop the job queue processing thread
-    shared.m_Mutex.Lock ();
     shared.m_bTerminateThread = true;
-    shared.m_Mutex.Signal ();
-    shared.m_Mutex.Unlock ();
+    shared.m_CommandSignal.Notify ();
 
     for ( uint i = 0 ; i < 5000 ; i += 15 )
     {
@@ -235,14 +282,20 @@ void CNetServerBuffer::DoPulse ( void )
     // Read incoming packets
     ProcessIncoming ();
 
+    // Publish packet wait times every 5 seconds
+    if ( m_TimeSincePacketWaitTimeSaved.Get () > 5000 )
+    {
+        m_TimeSincePacketWaitTimeSaved.Reset ();
+        g_PacketWaitTimeHistogram = m_PacketWaitTimeHistogram;
+        m_PacketWaitTimeHistogram.Clear ();
+    }
+
     // See if it's time to check the thread 'fps'
     if ( m_TimeThreadFPSLastCalced.Get () > 1000 )
     {
         m_TimeThreadFPSLastCalced.Reset ();
-        float fSyncFPS;
+        float fSyncFPS = static_cast < float > ( shared.m_iThreadFrameCount.exchange ( 0 ) );
         shared.m_Mutex.Lock ();
-        fSyncFPS = static_cast < float > ( shared.m_iThreadFrameCount );
-        shared.m_iThreadFrameCount = 0;
         shared.m_iuGamePlayerCount = g_pGame->GetPlayerManager ()->Count (); // Also update player count here (for scaling buffer size checks)
         shared.m_Mutex.Unlock ();
 
@@ -284,7 +337,8 @@ void CNetServerBuffer::RegisterPacketHandler ( PPACKETHANDLER pfnPacketHandler )
 //
 // CNetServerBuffer::GetNetworkStatistics
 //
-// Blocking on first call with new PlayerID.
+// Non blocking if the sync thread has published stats for PlayerID.
+// Otherwise blocking on first call with new PlayerID.
 // Subsequent calls with the same PlayerID are non blocking but return previous results
 //
 ///////////////////////////////////////////////////////////////////////////
@@ -301,6 +355,9 @@ void GetNetworkStatisticsCallback ( CNetJobData* pJobData, void* pContext )
 
 bool CNetServerBuffer::GetNetworkStatistics ( NetStatistics* pDest, const NetServerPlayerID& PlayerID )
 {
+    if ( GetPublishedNetworkStatistics ( pDest, PlayerID ) )
+        return true;
+
     // Blocking read required?
     if ( !ms_bNetStatisticsLastSavedValid || ms_NetStatisticsLastFor != PlayerID )
     {
@@ -327,6 +384,24 @@ bool CNetServerBuffer::GetNetworkStatistics ( NetStatistics* pDest, const NetSer
 }
 
 
+///////////////////////////////////////////////////////////////////////////
+//
+// CNetServerBuffer::GetPublishedNetworkStatistics
+//
+// Non blocking. Returns false if the sync thread has not published stats for PlayerID
+//
+///////////////////////////////////////////////////////////////////////////
+bool CNetServerBuffer::GetPublishedNetworkStatistics ( NetStatistics* pDest, const NetServerPlayerID& PlayerID )
+{
+    shared.m_NetStatisticsCS.Lock ();
+    NetStatistics* pStats = MapFind ( shared.m_NetStatisticsMap, PlayerID );
+    if ( pStats )
+        *pDest = *pStats;
+    shared.m_NetStatisticsCS.Unlock ();
+    return pStats != NULL;
+}
+
+
 ///////////////////////////////////////////////////////////////////////////
 //
 // CNetServerBuffer::GetPacketStats
@@ -642,10 +717,7 @@ void CNetServerBuffer::SetChecks ( const char* szDisableComboACMap, const char*
 ///////////////////////////////////////////////////////////////////////////
 unsigned int CNetServerBuffer::GetPendingPacketCount ( void )
 {
-    shared.m_Mutex.Lock ();
-    uint uiCount = shared.m_InResultQueue.size ();
-    shared.m_Mutex.Unlock ();
-    return uiCount;
+    return shared.m_InResultQueue.GetSize ();
 }
 
 
@@ -810,19 +882,21 @@ CNetJobData* CNetServerBuffer::GetNewJobData ( void )
 // Can't fail
 //
 ///////////////////////////////////////////////////////////////
-CNetJobData* CNetServerBuffer::AddCommand ( SArgs* pArgs, bool bAutoFree )
+CNetJobData* CNetServerBuffer::AddCommand ( SArgs* pArgs, bool bAutoFree, PFN_NETRESULT pfnNetResult, void* pContext )
 {
     // Create command
     CNetJobData* pJobData = GetNewJobData ();
     pJobData->pArgs = pArgs;
     pJobData->bAutoFree = bAutoFree;
-
-    // Add to queue
-    shared.m_Mutex.Lock ();
     pJobData->stage = EJobStage::COMMAND_QUEUE;
-    shared.m_OutCommandQueue.push_back ( pJobData );
-    shared.m_Mutex.Signal ();
-    shared.m_Mutex.Unlock ();
+
+    // Callback must be set before the sync thread can see the job
+    if ( pfnNetResult )
+        pJobData->SetCallback ( pfnNetResult, pContext );
+
+    // Add to queue, and wake the sync thread if it could be waiting
+    if ( shared.m_OutCommandQueue.Push ( pJobData ) )
+        shared.m_CommandSignal.Notify ();
 
     return bAutoFree ? NULL : pJobData;
 }
@@ -870,11 +944,8 @@ void CNetServerBuffer::AddCommandAndWait ( SArgs* pArgs )
 ///////////////////////////////////////////////////////////////
 void CNetServerBuffer::AddCommandAndCallback ( SArgs* pArgs, PFN_NETRESULT pfnNetResult, void* pContext )
 {
-    // Start command
-    CNetJobData* pJobData = AddCommand ( pArgs, false );
-
-    // Set callback
-    pJobData->SetCallback ( pfnNetResult, pContext );
+    // Start command with callback
+    AddCommand ( pArgs, false, pfnNetResult, pContext );
 }
 
 
@@ -890,39 +961,38 @@ bool CNetServerBuffer::PollCommand ( CNetJobData* pJobData, uint uiTimeout )
 {
     bool bFound = false;
 
-    shared.m_Mutex.Lock ();
     while ( true )
     {
-        // Find result with the required job handle
-        for ( std::list < CNetJobData* >::iterator iter = shared.m_OutResultQueue.begin () ; iter != shared.m_OutResultQueue.end () ; ++iter )
-        {
-            if ( pJobData == *iter )
-            {
-                // Found result. Remove from the result queue and flag return value
-                shared.m_OutResultQueue.erase ( iter );
-                pJobData->stage = EJobStage::FINISHED;
-                MapInsert ( shared.m_FinishedList, pJobData );
-
-                // Do callback incase any cleanup is needed
-                if ( pJobData->HasCallback () )
-                {
-                    shared.m_Mutex.Unlock ();                 
-                    pJobData->ProcessCallback ();              
-                    shared.m_Mutex.Lock ();
-                }
-
-                bFound = true;
-                break;
-            }
-        }
+        CollectResults ();
 
-        if ( bFound || uiTimeout == 0 )
+        // Find result with the required job handle
+        if ( ListContains ( m_OutResultList, pJobData ) )
         {
+            // Found result. Remove from the result list and flag return value
+            ListRemove ( m_OutResultList, pJobData );
+            pJobData->stage = EJobStage::FINISHED;
+            shared.m_Mutex.Lock ();
+            MapInsert ( shared.m_FinishedList, pJobData );
             shared.m_Mutex.Unlock ();
+
+            // Do callback incase any cleanup is needed
+            if ( pJobData->HasCallback () )
+                pJobData->ProcessCallback ();
+
+            bFound = true;
             break;
         }
 
-        shared.m_Mutex.Wait ( uiTimeout );
+        if ( uiTimeout == 0 )
+            break;
+
+        // Make sure the sync thread has every command before waiting for it
+        if ( shared.m_OutCommandQueue.FlushOverflow () )
+            shared.m_CommandSignal.Notify ();
+
+        // Only sleep if nothing arrived since CollectResults
+        if ( shared.m_OutResultQueue.IsEmpty () )
+            shared.m_ResultSignal.Wait ( std::min < uint > ( uiTimeout, 100 ) );
 
         // If not infinite, break after next check
         if ( uiTimeout != (uint)-1 )
@@ -936,6 +1006,21 @@ bool CNetServerBuffer::PollCommand ( CNetJobData* pJobData, uint uiTimeout )
 }
 
 
+///////////////////////////////////////////////////////////////
+//
+// CNetServerBuffer::CollectResults
+//
+// Move results from the sync thread into m_OutResultList
+//
+///////////////////////////////////////////////////////////////
+void CNetServerBuffer::CollectResults ( void )
+{
+    CNetJobData* pJobData;
+    while ( shared.m_OutResultQueue.Pop ( pJobData ) )
+        m_OutResultList.push_back ( pJobData );
+}
+
+
 // Update info about one packet
 void CNetServerBuffer::AddPacketStat ( CNetServer::ENetworkUsageDirection eDirection, uchar ucPacketID, int iPacketSize, TIMEUS elapsedTime )
 {
@@ -958,26 +1043,23 @@ void CNetServerBuffer::ProcessIncoming ( void )
 {
     bool bTimePacketHandler = m_TimeSinceGetPacketStats.Get () < 10000;
 
-    // Get incoming packets
-    shared.m_Mutex.Lock ();
-    std::list < SProcessPacketArgs* > inResultQueue = shared.m_InResultQueue;
-    shared.m_InResultQueue.clear ();
-    shared.m_Mutex.Unlock ();
-
-    // Handle incoming packets
-    for ( std::list < SProcessPacketArgs* >::iterator iter = inResultQueue.begin () ; iter != inResultQueue.end () ; ++iter )
+    // Handle incoming packets which are waiting now
+    uint uiNumToDo = shared.m_InResultQueue.GetSize ();
+    SIncomingPacket incoming;
+    while ( uiNumToDo-- && shared.m_InResultQueue.Pop ( incoming ) )
     {
-        SProcessPacketArgs* pArgs = *iter;
+        SProcessPacketArgs* pArgs = incoming.pArgs;
 
         // Stats
         const int iPacketSize = ( pArgs->BitStream->GetNumberOfUnreadBits () + 8 + 7 ) / 8;
-        const TIMEUS startTime = bTimePacketHandler ? GetTimeUs () : 0;
+        const TIMEUS startTime = GetTimeUs ();
+        m_PacketWaitTimeHistogram.AddSample ( startTime - incoming.timeQueued );
 
         if ( m_pfnDMPacketHandler )
             m_pfnDMPacketHandler( pArgs->ucPacketID, pArgs->Socket, pArgs->BitStream, pArgs->pNetExtraInfo );
 
         // Stats
-        const TIMEUS elapsedTime = ( bTimePacketHandler ? GetTimeUs () : 0 ) - startTime;
+        const TIMEUS elapsedTime = bTimePacketHandler ? GetTimeUs () - startTime : 0;
         AddPacketStat ( STATS_INCOMING_TRAFFIC, pArgs->ucPacketID, iPacketSize, elapsedTime );
 
         SAFE_RELEASE( pArgs->pNetExtraInfo );
@@ -985,38 +1067,40 @@ void CNetServerBuffer::ProcessIncoming ( void )
         SAFE_DELETE( pArgs );
     }
 
-    shared.m_Mutex.Lock ();
+    // The sync thread only wakes us when the queue was empty, so come back soon for any left
+    if ( !shared.m_InResultQueue.IsEmpty () )
+        g_MainThreadWorkSignal.Notify ();
 
     // Delete finished
-    for ( std::set < CNetJobData* >::iterator iter = shared.m_FinishedList.begin () ; iter != shared.m_FinishedList.end () ; )
+    shared.m_Mutex.Lock ();
+    std::set < CNetJobData* > finishedList;
+    finishedList.swap ( shared.m_FinishedList );
+    shared.m_Mutex.Unlock ();
+
+    for ( std::set < CNetJobData* >::iterator iter = finishedList.begin () ; iter != finishedList.end () ; ++iter )
     {
         CNetJobData* pJobData = *iter;
-        shared.m_FinishedList.erase ( iter++ );
         // Check not refed
-        dassert ( !ListContains ( shared.m_OutCommandQueue, pJobData ) );
-        dassert ( !ListContains ( shared.m_OutResultQueue, pJobData ) );
-        dassert ( !MapContains ( shared.m_FinishedList, pJobData ) );
+        dassert ( !ListContains ( m_OutResultList, pJobData ) );
         SAFE_DELETE( pJobData );
     }
 
+    CollectResults ();
+
 again:
     // Do pending callbacks
-    for ( std::list < CNetJobData* >::iterator iter = shared.m_OutResultQueue.begin () ; iter != shared.m_OutResultQueue.end () ; ++iter )
+    for ( std::list < CNetJobData* >::iterator iter = m_OutResultList.begin () ; iter != m_OutResultList.end () ; ++iter )
     {
         CNetJobData* pJobData = *iter;
 
         if ( pJobData->HasCallback () )
         {
-            shared.m_Mutex.Unlock ();
             pJobData->ProcessCallback ();              
-            shared.m_Mutex.Lock ();
 
             // Redo from the top ensure everything is consistent
             goto again;
         }
     }
-
-    shared.m_Mutex.Unlock ();
 }
 
 
@@ -1052,7 +1136,6 @@ void* CNetServerBuffer::StaticThreadProc ( void* pContext )
 ///////////////////////////////////////////////////////////////
 void* CNetServerBuffer::ThreadProc ( void )
 {
-    shared.m_Mutex.Lock ();
     while ( !shared.m_bTerminateThread )
     {
         shared.m_iThreadFrameCount++;
@@ -1060,62 +1143,85 @@ void* CNetServerBuffer::ThreadProc ( void )
 
         if ( shared.m_bAutoPulse )
         {
-            shared.m_Mutex.Unlock ();
             m_pRealNetServer->DoPulse ();
             UpdateThreadCPUTimes( g_SyncThreadCPUTimes );
-            shared.m_Mutex.Lock ();
         }
 
-        UpdateStatsPreCommands( shared.m_OutCommandQueue.size() );
+        UpdateStatsPreCommands( shared.m_OutCommandQueue.GetSize () );
 
         // Is there a waiting command?
-        if ( shared.m_OutCommandQueue.empty () )
+        if ( shared.m_OutCommandQueue.IsEmpty () )
         {
-            shared.m_Mutex.Wait ( 10 );
+            shared.m_CommandSignal.Wait ( 10 );
         }
         else
         {
             // Number of commands to do before checking if a pulse is required
-            uint uiNumToDo = shared.m_OutCommandQueue.size ();
+            uint uiNumToDo = shared.m_OutCommandQueue.GetSize ();
 
-            while ( uiNumToDo-- && !shared.m_bTerminateThread )
+            CNetJobData* pJobData;
+            while ( uiNumToDo-- && !shared.m_bTerminateThread && shared.m_OutCommandQueue.Pop ( pJobData ) )
             {
-                // Get next command
-                CNetJobData* pJobData = shared.m_OutCommandQueue.front ();
-                pJobData->stage = EJobStage::PROCCESSING;
-                shared.m_Mutex.Unlock ();
-
                 // Process command
+                pJobData->stage = EJobStage::PROCCESSING;
                 ProcessCommand ( pJobData );
 
-                // Store result
-                shared.m_Mutex.Lock ();
-                // Check command has not been cancelled (this should not be possible)
-                assert ( pJobData == shared.m_OutCommandQueue.front () );
-
-                // Remove command
-                shared.m_OutCommandQueue.pop_front ();
                 // Add result
                 pJobData->stage = EJobStage::RESULT;
                 if ( pJobData->bAutoFree )
                     SAFE_DELETE( pJobData )
                 else
-                    shared.m_OutResultQueue.push_back ( pJobData );
-
-                shared.m_Mutex.Signal ();
+                if ( shared.m_OutResultQueue.Push ( pJobData ) )
+                    shared.m_ResultSignal.Notify ();
             }
         }
 
+        if ( m_NetStatisticsPublishTimer.Get () >= NET_STATISTICS_PUBLISH_INTERVAL_MS )
+            PublishNetworkStatistics ();
+
+        // Move along anything which did not fit in the rings
+        if ( shared.m_OutResultQueue.FlushOverflow () )
+            shared.m_ResultSignal.Notify ();
+        if ( shared.m_InResultQueue.FlushOverflow () )
+            g_MainThreadWorkSignal.Notify ();
+
         UpdateStatsFinish();
     }
 
     shared.m_bThreadTerminated = true;
-    shared.m_Mutex.Unlock ();
 
     return NULL;
 }
 
 
+///////////////////////////////////////////////////////////////
+//
+// CNetServerBuffer::PublishNetworkStatistics
+//
+// Read network stats for every player in one go, so the main thread
+// never has to wait on the sync thread for them
+//
+///////////////////////////////////////////////////////////////
+void CNetServerBuffer::PublishNetworkStatistics ( void )
+{
+    m_NetStatisticsPublishTimer.Reset ();
+
+    m_pSimPlayerManager->GetSocketList ( m_NetStatisticsSocketList );
+
+    std::map < NetServerPlayerID, NetStatistics > statsMap;
+    for ( uint i = 0 ; i < m_NetStatisticsSocketList.size () ; i++ )
+    {
+        NetStatistics stats;
+        if ( m_pRealNetServer->GetNetworkStatistics ( &stats, m_NetStatisticsSocketList[i] ) )
+            MapSet ( statsMap, m_NetStatisticsSocketList[i], stats );
+    }
+
+    shared.m_NetStatisticsCS.Lock ();
+    shared.m_NetStatisticsMap.swap ( statsMap );
+    shared.m_NetStatisticsCS.Unlock ();
+}
+
+
 ///////////////////////////////////////////////////////////////
 //
 // CNetServerBuffer::ProcessCommand
@@ -1284,12 +1390,13 @@ void CNetServerBuffer::ProcessPacket ( unsigned char ucPacketID, const NetServer
     BitStream->AddRef ();
     if ( pNetExtraInfo )
         pNetExtraInfo->AddRef ();
-    SProcessPacketArgs* pArgs = new SProcessPacketArgs ( ucPacketID, Socket, BitStream, pNetExtraInfo );
+    SIncomingPacket incoming;
+    incoming.pArgs = new SProcessPacketArgs ( ucPacketID, Socket, BitStream, pNetExtraInfo );
+    incoming.timeQueued = GetTimeUs ();
 
-    // Store result
-    shared.m_Mutex.Lock ();
-    shared.m_InResultQueue.push_back ( pArgs );
-    shared.m_Mutex.Unlock ();
+    // Store result, and wake the main thread if it could be idle
+    if ( shared.m_InResultQueue.Push ( incoming ) )
+        g_MainThreadWorkSignal.Notify ();
 }
 
 
@@ -1302,14 +1409,13 @@ void CNetServerBuffer::ProcessPacket ( unsigned char ucPacketID, const NetServer
 ///////////////////////////////////////////////////////////////
 void CNetServerBuffer::GetQueueSizes ( uint& uiFinishedList, uint& uiOutCommandQueue, uint& uiOutResultQueue, uint& uiInResultQueue, uint& uiGamePlayerCount )
 {
-    shared.m_Mutex.Lock ();
+    uiOutCommandQueue = shared.m_OutCommandQueue.GetSize ();
+    uiOutResultQueue = shared.m_OutResultQueue.GetSize ();
+    uiInResultQueue = shared.m_InResultQueue.GetSize ();
 
+    shared.m_Mutex.Lock ();
     uiFinishedList = shared.m_FinishedList.size ();
-    uiOutCommandQueue = shared.m_OutCommandQueue.size ();
-    uiOutResultQueue = shared.m_OutResultQueue.size ();
-    uiInResultQueue = shared.m_InResultQueue.size ();
     uiGamePlayerCount = shared.m_iuGamePlayerCount;
-
     shared.m_Mutex.Unlock ();
 }
 
@@ -7,6 +7,19 @@
 *
 *****************************************************************************/
 
+#define NET_STATISTICS_PUBLISH_INTERVAL_MS  500     // How often the sync thread reads network stats for every player
+
+//
+// Fixed size blocks for net jobs and their arguments.
+// Each thread keeps its own free list so no locking is needed. Blocks freed by the
+// sync thread when a send is done are reused there for incoming packet arguments.
+//
+namespace NetJobBlockCache
+{
+    void*   Allocate    ( size_t size );
+    void    Free        ( void* pBlock, size_t size );
+}
+
 
 // Base class for net function arguments
 struct SArgs
@@ -14,6 +27,9 @@ struct SArgs
                     SArgs       ( void )    { DEBUG_CREATE_COUNT( "SArgs" ); }
     virtual         ~SArgs      ( void )    { DEBUG_DESTROY_COUNT( "SArgs" ); }
     int type;
+
+    void* operator new ( size_t size )                  { return NetJobBlockCache::Allocate ( size ); }
+    void  operator delete ( void* ptr, size_t size )    { NetJobBlockCache::Free ( ptr, size ); }
 };
 
 
@@ -25,12 +41,21 @@ typedef void (*PFN_NETRESULT) ( class CNetJobData* pJobData, void* pContext );
 class CNetJobData
 {
 public:
-    ZERO_ON_NEW
+    void* operator new ( size_t size )                  { return NetJobBlockCache::Allocate ( size ); }
+    void  operator delete ( void* ptr, size_t size )    { NetJobBlockCache::Free ( ptr, size ); }
     bool        SetCallback     ( PFN_NETRESULT pfnNetResult, void* pContext );
     bool        HasCallback     ( void );
     void        ProcessCallback ( void );
 
-    CNetJobData                 ( void )    { DEBUG_CREATE_COUNT( "CNetJobData" ); }
+    // Blocks are reused, and the compiler can drop a memset done before construction, so set everything here
+    CNetJobData                 ( void )
+        : stage ( EJobStage::NONE )
+        , pArgs ( NULL )
+        , bAutoFree ( false )
+        , callback ()
+    {
+        DEBUG_CREATE_COUNT( "CNetJobData" );
+    }
     ~CNetJobData ( void )
     {
         SAFE_DELETE( pArgs );
@@ -157,13 +182,22 @@ public:
     DECLARE_FUNC_ARGS2 (                        GenerateRandomData              , void*, pOutData, uint, uiLength );
     DECLARE_FUNC_ARGS4R( bool,                  ProcessPacket                   , unsigned char, ucPacketID, const NetServerPlayerIDRef, Socket, NetBitStreamInterface*, BitStream, SNetExtraInfo*, pNetExtraInfo );
 
+    // Incoming packet with the time it was queued by the sync thread
+    struct SIncomingPacket
+    {
+        SProcessPacketArgs*     pArgs;
+        TIMEUS                  timeQueued;
+    };
+
     // Main thread functions
+    bool                        GetPublishedNetworkStatistics ( NetStatistics* pDest, const NetServerPlayerID& PlayerID );
     void                        StopThread                  ( void );
-    CNetJobData*                AddCommand                  ( SArgs* pArgs, bool bAutoFree );
+    CNetJobData*                AddCommand                  ( SArgs* pArgs, bool bAutoFree, PFN_NETRESULT pfnNetResult = NULL, void* pContext = NULL );
     void                        AddCommandAndFree           ( SArgs* pArgs );
     void                        AddCommandAndWait           ( SArgs* pArgs );
     void                        AddCommandAndCallback       ( SArgs* pArgs, PFN_NETRESULT pfnNetResult, void* pContext );
     bool                        PollCommand                 ( CNetJobData* pJobData, uint uiTimeout );
+    void                        CollectResults              ( void );
     CNetJobData*                GetNewJobData               ( void );
     void                        ProcessIncoming             ( void );
     void                        SetAutoPulseEnabled         ( bool bEnable );
@@ -172,6 +206,7 @@ public:
     // Sync thread functions
     static void*                StaticThreadProc            ( void* pContext );
     void*                       ThreadProc                  ( void );
+    void                        PublishNetworkStatistics    ( void );
     void                        ProcessCommand              ( CNetJobData* pJobData );
     static bool                 StaticProcessPacket         ( unsigned char ucPacketID, const NetServerPlayerID& Socket, NetBitStreamInterface* BitStream, SNetExtraInfo* pNetExtraInfo );
     void                        ProcessPacket               ( unsigned char ucPacketID, const NetServerPlayerID& Socket, NetBitStreamInterface* BitStream, SNetExtraInfo* pNetExtraInfo );
@@ -186,24 +221,33 @@ public:
     float                               m_fSmoothThreadFPS;
     CElapsedTime                        m_TimeSinceGetPacketStats;
     SPacketStat                         m_PacketStatList [ 2 ] [ 256 ];
+    CLatencyHistogram                   m_PacketWaitTimeHistogram;
+    CElapsedTime                        m_TimeSincePacketWaitTimeSaved;
+    std::list < CNetJobData* >          m_OutResultList;            // Results taken from shared.m_OutResultQueue, waiting to be polled
 
     // Sync thread variables
     CNetServer*                         m_pRealNetServer;
     CSimPlayerManager*                  m_pSimPlayerManager;
+    CElapsedTime                        m_NetStatisticsPublishTimer;
+    std::vector < NetServerPlayerID >   m_NetStatisticsSocketList;
 
     // Shared variables
     struct
     {
-        bool                                        m_bTerminateThread;
-        bool                                        m_bThreadTerminated;
-        bool                                        m_bAutoPulse;
-        std::list < CNetJobData* >                  m_OutCommandQueue;
-        std::list < CNetJobData* >                  m_OutResultQueue;
-        std::list < SProcessPacketArgs* >           m_InResultQueue;
+        std::atomic < bool >                        m_bTerminateThread;
+        std::atomic < bool >                        m_bThreadTerminated;
+        std::atomic < bool >                        m_bAutoPulse;
+        CSPSCQueue < CNetJobData*, 16384 >          m_OutCommandQueue;      // Main thread -> sync thread
+        CSPSCQueue < CNetJobData*, 1024 >           m_OutResultQueue;       // Sync thread -> main thread
+        CSPSCQueue < SIncomingPacket, 16384 >       m_InResultQueue;        // Sync thread -> main thread
+        CWorkSignal                                 m_CommandSignal;        // Wakes the sync thread when m_OutCommandQueue stops being empty
+        CWorkSignal                                 m_ResultSignal;         // Wakes PollCommand when m_OutResultQueue stops being empty
         std::set < CNetJobData* >                   m_FinishedList;         // Result has been used, will be deleted next pulse (shared access with watchdog thread)
-        CComboMutex                                 m_Mutex;
+        CComboMutex                                 m_Mutex;                // For m_FinishedList and m_iuGamePlayerCount
         CNetBufferWatchDog*                         m_pWatchDog;
-        int                                         m_iThreadFrameCount;
+        std::atomic < int >                         m_iThreadFrameCount;
         uint                                        m_iuGamePlayerCount;
+        CCriticalSection                            m_NetStatisticsCS;      // For m_NetStatisticsMap
+        std::map < NetServerPlayerID, NetStatistics > m_NetStatisticsMap;  // Published by the sync thread. Players whose stats could not be read are left out
     } shared;
 };
\ No newline at end of file
@@ -0,0 +1,249 @@
+/*****************************************************************************
+*
+*  PROJECT:     Multi Theft Auto v1.0
+*  LICENSE:     See LICENSE in the top level directory
+*
+*  Multi Theft Auto is available from http://www.multitheftauto.com/
+*
+*****************************************************************************/
+
+#include "StdInc.h"
+#include "SimHeaders.h"
+
+
+///////////////////////////////////////////////////////////////
+//
+// CNetServerPassThrough::CNetServerPassThrough
+//
+//
+//
+///////////////////////////////////////////////////////////////
+CNetServerPassThrough::CNetServerPassThrough ( CNetServer* pNextNetServer )
+{
+    m_pNextNetServer = pNextNetServer;
+    m_strPlayerVersion = CStaticFunctionDefinitions::GetVersionSortable ();
+}
+
+
+///////////////////////////////////////////////////////////////
+//
+// CNetServerPassThrough::~CNetServerPassThrough
+//
+//
+//
+///////////////////////////////////////////////////////////////
+CNetServerPassThrough::~CNetServerPassThrough ( void )
+{
+}
+
+
+///////////////////////////////////////////////////////////////
+//
+// CNetServer interface
+//
+// Fake players are handled here, everything else goes to the next net server
+//
+///////////////////////////////////////////////////////////////
+bool CNetServerPassThrough::StartNetwork ( const char* szIP, unsigned short usServerPort, unsigned int uiAllowedPlayers, const char* szServerName )
+{
+    return m_pNextNetServer->StartNetwork ( szIP, usServerPort, uiAllowedPlayers, szServerName );
+}
+
+void CNetServerPassThrough::StopNetwork ( void )
+{
+    m_pNextNetServer->StopNetwork ();
+}
+
+void CNetServerPassThrough::DoPulse ( void )
+{
+    m_pNextNetServer->DoPulse ();
+}
+
+void CNetServerPassThrough::RegisterPacketHandler ( PPACKETHANDLER pfnPacketHandler )
+{
+    m_pNextNetServer->RegisterPacketHandler ( pfnPacketHandler );
+}
+
+bool CNetServerPassThrough::GetNetworkStatistics ( NetStatistics* pDest, const NetServerPlayerID& PlayerID )
+{
+    if ( !IsFakeSocket ( PlayerID ) )
+        return m_pNextNetServer->GetNetworkStatistics ( pDest, PlayerID );
+
+    memset ( pDest, 0, sizeof ( *pDest ) );
+    return true;
+}
+
+const SPacketStat* CNetServerPassThrough::GetPacketStats ( void )
+{
+    return m_pNextNetServer->GetPacketStats ();
+}
+
+bool CNetServerPassThrough::GetBandwidthStatistics ( SBandwidthStatistics* pDest )
+{
+    return m_pNextNetServer->GetBandwidthStatistics ( pDest );
+}
+
+bool CNetServerPassThrough::GetNetPerformanceStatistics ( SNetPerformanceStatistics* pDest, bool bResetCounters )
+{
+    return m_pNextNetServer->GetNetPerformanceStatistics ( pDest, bResetCounters );
+}
+
+void CNetServerPassThrough::GetPingStatus ( SFixedString < 32 >* pstrStatus )
+{
+    m_pNextNetServer->GetPingStatus ( pstrStatus );
+}
+
+bool CNetServerPassThrough::GetSyncThreadStatistics ( SSyncThreadStatistics* pDest, bool bResetCounters )
+{
+    return m_pNextNetServer->GetSyncThreadStatistics ( pDest, bResetCounters );
+}
+
+NetBitStreamInterface* CNetServerPassThrough::AllocateNetServerBitStream ( unsigned short usBitStreamVersion, const void* pData, uint uiDataSize, bool bCopyData )
+{
+    return m_pNextNetServer->AllocateNetServerBitStream ( usBitStreamVersion, pData, uiDataSize, bCopyData );
+}
+
+void CNetServerPassThrough::DeallocateNetServerBitStream ( NetBitStreamInterface* bitStream )
+{
+    m_pNextNetServer->DeallocateNetServerBitStream ( bitStream );
+}
+
+bool CNetServerPassThrough::SendPacket ( unsigned char ucPacketID, const NetServerPlayerID& playerID, NetBitStreamInterface* bitStream, bool bBroadcast, NetServerPacketPriority packetPriority, NetServerPacketReliability packetReliability, ePacketOrdering packetOrdering )
+{
+    if ( !IsFakeSocket ( playerID ) )
+        return m_pNextNetServer->SendPacket ( ucPacketID, playerID, bitStream, bBroadcast, packetPriority, packetReliability, packetOrdering );
+    return true;
+}
+
+void CNetServerPassThrough::GetPlayerIP ( const NetServerPlayerID& playerID, char strIP[22], unsigned short* usPort )
+{
+    if ( !IsFakeSocket ( playerID ) )
+        return m_pNextNetServer->GetPlayerIP ( playerID, strIP, usPort );
+
+    uint uiAddress = playerID.GetBinaryAddress ();
+    STRNCPY ( strIP, SString ( "%u.%u.%u.%u", uiAddress >> 24, ( uiAddress >> 16 ) & 255, ( uiAddress >> 8 ) & 255, uiAddress & 255 ), 22 );
+    if ( usPort )
+        *usPort = playerID.GetPort ();
+}
+
+void CNetServerPassThrough::Kick ( const NetServerPlayerID &PlayerID )
+{
+    if ( !IsFakeSocket ( PlayerID ) )
+        m_pNextNetServer->Kick ( PlayerID );
+}
+
+void CNetServerPassThrough::SetPassword ( const char* szPassword )
+{
+    m_pNextNetServer->SetPassword ( szPassword );
+}
+
+void CNetServerPassThrough::SetMaximumIncomingConnections ( unsigned short numberAllowed )
+{
+    m_pNextNetServer->SetMaximumIncomingConnections ( numberAllowed );
+}
+
+CNetHTTPDownloadManagerInterface* CNetServerPassThrough::GetHTTPDownloadManager ( EDownloadModeType iMode )
+{
+    return m_pNextNetServer->GetHTTPDownloadManager ( iMode );
+}
+
+void CNetServerPassThrough::SetClientBitStreamVersion ( const NetServerPlayerID &PlayerID, unsigned short usBitStreamVersion )
+{
+    if ( !IsFakeSocket ( PlayerID ) )
+        m_pNextNetServer->SetClientBitStreamVersion ( PlayerID, usBitStreamVersion );
+}
+
+void CNetServerPassThrough::ClearClientBitStreamVersion ( const NetServerPlayerID &PlayerID )
+{
+    if ( !IsFakeSocket ( PlayerID ) )
+        m_pNextNetServer->ClearClientBitStreamVersion ( PlayerID );
+}
+
+void CNetServerPassThrough::SetChecks ( const char* szDisableComboACMap, const char* szDisableACMap, const char* szEnableSDMap, int iEnableClientChecks, bool bHideAC, const char* szImgMods )
+{
+    m_pNextNetServer->SetChecks ( szDisableComboACMap, szDisableACMap, szEnableSDMap, iEnableClientChecks, bHideAC, szImgMods );
+}
+
+unsigned int CNetServerPassThrough::GetPendingPacketCount ( void )
+{
+    return m_pNextNetServer->GetPendingPacketCount ();
+}
+
+void CNetServerPassThrough::GetNetRoute ( SFixedString < 32 >* pstrRoute )
+{
+    m_pNextNetServer->GetNetRoute ( pstrRoute );
+}
+
+bool CNetServerPassThrough::InitServerId ( const char* szPath )
+{
+    return m_pNextNetServer->InitServerId ( szPath );
+}
+
+void CNetServerPassThrough::ResendModPackets ( const NetServerPlayerID& playerID )
+{
+    if ( !IsFakeSocket ( playerID ) )
+        m_pNextNetServer->ResendModPackets ( playerID );
+}
+
+void CNetServerPassThrough::ResendACPackets ( const NetServerPlayerID& playerID )
+{
+    if ( !IsFakeSocket ( playerID ) )
+        m_pNextNetServer->ResendACPackets ( playerID );
+}
+
+void CNetServerPassThrough::GetClientSerialAndVersion ( const NetServerPlayerID& playerID, SFixedString < 32 >& strSerial, SFixedString < 64 >& strExtra, SFixedString < 32 >& strVersion )
+{
+    if ( !IsFakeSocket ( playerID ) )
+        return m_pNextNetServer->GetClientSerialAndVersion ( playerID, strSerial, strExtra, strVersion );
+
+    strSerial = SString ( "%032X", playerID.GetBinaryAddress () & 0xFFFFFF );
+    strExtra = "";
+    strVersion = m_strPlayerVersion;
+}
+
+void CNetServerPassThrough::SetNetOptions ( const SNetOptions& options )
+{
+    m_pNextNetServer->SetNetOptions ( options );
+}
+
+void CNetServerPassThrough::GenerateRandomData ( void* pOutData, uint uiLength )
+{
+    m_pNextNetServer->GenerateRandomData ( pOutData, uiLength );
+}
+
+bool CNetServerPassThrough::EncryptDumpfile ( const char* szClearPathFilename, const char* szEncryptedPathFilename )
+{
+    return m_pNextNetServer->EncryptDumpfile ( szClearPathFilename, szEncryptedPathFilename );
+}
+
+bool CNetServerPassThrough::ValidateHttpCacheFileName ( const char* szFilename )
+{
+    return m_pNextNetServer->ValidateHttpCacheFileName ( szFilename );
+}
+
+bool CNetServerPassThrough::GetScriptInfo ( const char* cpInBuffer, uint uiInSize, SScriptInfo* pOutInfo )
+{
+    return m_pNextNetServer->GetScriptInfo ( cpInBuffer, uiInSize, pOutInfo );
+}
+
+bool CNetServerPassThrough::DeobfuscateScript ( const char* cpInBuffer, uint uiInSize, const char** pcpOutBuffer, uint* puiOutSize, const char* szScriptName )
+{
+    return m_pNextNetServer->DeobfuscateScript ( cpInBuffer, uiInSize, pcpOutBuffer, puiOutSize, szScriptName );
+}
+
+bool CNetServerPassThrough::GetPlayerPacketUsageStats ( uchar* packetIdList, uint uiNumPacketIds, SPlayerPacketUsage* pOutStats, uint uiTopCount )
+{
+    return m_pNextNetServer->GetPlayerPacketUsageStats ( packetIdList, uiNumPacketIds, pOutStats, uiTopCount );
+}
+
+const char* CNetServerPassThrough::GetLogOutput ( void )
+{
+    return m_pNextNetServer->GetLogOutput ();
+}
+
+bool CNetServerPassThrough::IsValidSocket ( const NetServerPlayerID& playerID )
+{
+    if ( !IsFakeSocket ( playerID ) )
+        return m_pNextNetServer->IsValidSocket ( playerID );
+    return true;
+}
@@ -0,0 +1,81 @@
+/*****************************************************************************
+*
+*  PROJECT:     Multi Theft Auto v1.0
+*  LICENSE:     See LICENSE in the top level directory
+*
+*  Multi Theft Auto is available from http://www.multitheftauto.com/
+*
+*****************************************************************************/
+
+//
+// Base for net interfaces which wrap another one and add players that have no real connection
+// Calls for fake players get made up answers here, and everything else is passed to the next net interface.
+// Derived classes say which sockets are fake, and override the calls they handle differently.
+//
+class CNetServerPassThrough : public CNetServer
+{
+public:
+                                            CNetServerPassThrough           ( CNetServer* pNextNetServer );
+    virtual                                 ~CNetServerPassThrough          ( void );
+
+    void                                    SetNextNetServer                ( CNetServer* pNextNetServer )  { m_pNextNetServer = pNextNetServer; }
+    CNetServer*                             GetNextNetServer                ( void )                        { return m_pNextNetServer; }
+
+    // CNetServer interface
+    virtual bool                            StartNetwork                    ( const char* szIP, unsigned short usServerPort, unsigned int uiAllowedPlayers, const char* szServerName );
+    virtual void                            StopNetwork                     ( void );
+
+    virtual void                            DoPulse                         ( void );
+
+    virtual void                            RegisterPacketHandler           ( PPACKETHANDLER pfnPacketHandler );
+
+    virtual bool                            GetNetworkStatistics            ( NetStatistics* pDest, const NetServerPlayerID& PlayerID );
+    virtual const SPacketStat*              GetPacketStats                  ( void );
+    virtual bool                            GetBandwidthStatistics          ( SBandwidthStatistics* pDest );
+    virtual bool                            GetNetPerformanceStatistics     ( SNetPerformanceStatistics* pDest, bool bResetCounters );
+    virtual void                            GetPingStatus                   ( SFixedString < 32 >* pstrStatus );
+    virtual bool                            GetSyncThreadStatistics         ( SSyncThreadStatistics* pDest, bool bResetCounters );
+
+    virtual NetBitStreamInterface*          AllocateNetServerBitStream      ( unsigned short usBitStreamVersion, const void* pData, uint uiDataSize, bool bCopyData );
+    virtual void                            DeallocateNetServerBitStream    ( NetBitStreamInterface* bitStream );
+    virtual bool                            SendPacket                      ( unsigned char ucPacketID, const NetServerPlayerID& playerID, NetBitStreamInterface* bitStream, bool bBroadcast, NetServerPacketPriority packetPriority, NetServerPacketReliability packetReliability, ePacketOrdering packetOrdering );
+
+    virtual void                            GetPlayerIP                     ( const NetServerPlayerID& playerID, char strIP[22], unsigned short* usPort );
+
+    virtual void                            Kick                            ( const NetServerPlayerID &PlayerID );
+
+    virtual void                            SetPassword                     ( const char* szPassword );
+
+    virtual void                            SetMaximumIncomingConnections   ( unsigned short numberAllowed );
+
+    virtual CNetHTTPDownloadManagerInterface*   GetHTTPDownloadManager      ( EDownloadModeType iMode );
+
+    virtual void                            SetClientBitStreamVersion       ( const NetServerPlayerID &PlayerID, unsigned short usBitStreamVersion );
+    virtual void                            ClearClientBitStreamVersion     ( const NetServerPlayerID &PlayerID );
+
+    virtual void                            SetChecks                       ( const char* szDisableComboACMap, const char* szDisableACMap, const char* szEnableSDMap, int iEnableClientChecks, bool bHideAC, const char* szImgMods );
+
+    virtual unsigned int                    GetPendingPacketCount           ( void );
+    virtual void                            GetNetRoute                     ( SFixedString < 32 >* pstrRoute );
+
+    virtual bool                            InitServerId                    ( const char* szPath );
+    virtual void                            ResendModPackets                ( const NetServerPlayerID& playerID );
+    virtual void                            ResendACPackets                 ( const NetServerPlayerID& playerID );
+
+    virtual void                            GetClientSerialAndVersion       ( const NetServerPlayerID& playerID, SFixedString < 32 >& strSerial, SFixedString < 64 >& strExtra, SFixedString < 32 >& strVersion );
+    virtual void                            SetNetOptions                   ( const SNetOptions& options );
+    virtual void                            GenerateRandomData              ( void* pOutData, uint uiLength );
+    virtual bool                            EncryptDumpfile                 ( const char* szClearPathFilename, const char* szEncryptedPathFilename );
+    virtual bool                            ValidateHttpCacheFileName       ( const char* szFilename );
+    virtual bool                            GetScriptInfo                   ( const char* cpInBuffer, uint uiInSize, SScriptInfo* pOutInfo );
+    virtual bool                            DeobfuscateScript               ( const char* cpInBuffer, uint uiInSize, const char** pcpOutBuffer, uint* puiOutSize, const char* szScriptName );
+    virtual bool                            GetPlayerPacketUsageStats       ( uchar* packetIdList, uint uiNumPacketIds, SPlayerPacketUsage* pOutStats, uint uiTopCount );
+    virtual const char*                     GetLogOutput                    ( void );
+    virtual bool                            IsValidSocket                   ( const NetServerPlayerID& playerID );
+
+protected:
+    virtual bool                            IsFakeSocket                    ( const NetServerPlayerID& socket ) const = 0;
+
+    CNetServer*                             m_pNextNetServer;
+    SString                                 m_strPlayerVersion;
+};
@@ -0,0 +1,96 @@
+/*****************************************************************************
+*
+*  PROJECT:     Multi Theft Auto v1.0
+*  LICENSE:     See LICENSE in the top level directory
+*
+*  Multi Theft Auto is available from http://www.multitheftauto.com/
+*
+*****************************************************************************/
+
+#include "StdInc.h"
+#include "SimHeaders.h"
+
+
+///////////////////////////////////////////////////////////////
+//
+// CReplayNetServer::CReplayNetServer
+//
+//
+//
+///////////////////////////////////////////////////////////////
+CReplayNetServer::CReplayNetServer ( CNetServer* pNextNetServer )
+    : CNetServerPassThrough ( pNextNetServer )
+{
+}
+
+
+///////////////////////////////////////////////////////////////
+//
+// CReplayNetServer::~CReplayNetServer
+//
+//
+//
+///////////////////////////////////////////////////////////////
+CReplayNetServer::~CReplayNetServer ( void )
+{
+}
+
+
+///////////////////////////////////////////////////////////////
+//
+// CReplayNetServer::AddReplaySocket
+//
+// Called for each replayed packet, so calls for that player are kept away from the net module
+//
+///////////////////////////////////////////////////////////////
+void CReplayNetServer::AddReplaySocket ( const NetServerPlayerID& socket )
+{
+    MapInsert ( m_ReplaySocketList, socket );
+}
+
+
+///////////////////////////////////////////////////////////////
+//
+// CReplayNetServer::HasReplayPlayers
+//
+// Returns true if any replayed player is still in the game
+//
+///////////////////////////////////////////////////////////////
+bool CReplayNetServer::HasReplayPlayers ( void )
+{
+    for ( const NetServerPlayerID& socket : m_ReplaySocketList )
+        if ( g_pGame->GetPlayerManager ()->Get ( socket ) )
+            return true;
+    return false;
+}
+
+
+///////////////////////////////////////////////////////////////
+//
+// CReplayNetServer::GetStatus
+//
+//
+//
+///////////////////////////////////////////////////////////////
+SString CReplayNetServer::GetStatus ( void )
+{
+    return SString ( "%u replay players, %u packets to them dropped (%lld KB)", (uint)m_ReplaySocketList.size (), m_uiPacketsDropped, m_llBytesDropped / 1024 );
+}
+
+
+///////////////////////////////////////////////////////////////
+//
+// CReplayNetServer::SendPacket
+//
+// Packets for replayed players are counted and dropped
+//
+///////////////////////////////////////////////////////////////
+bool CReplayNetServer::SendPacket ( unsigned char ucPacketID, const NetServerPlayerID& playerID, NetBitStreamInterface* bitStream, bool bBroadcast, NetServerPacketPriority packetPriority, NetServerPacketReliability packetReliability, ePacketOrdering packetOrdering )
+{
+    if ( !IsFakeSocket ( playerID ) )
+        return m_pNextNetServer->SendPacket ( ucPacketID, playerID, bitStream, bBroadcast, packetPriority, packetReliability, packetOrdering );
+
+    m_uiPacketsDropped++;
+    m_llBytesDropped += bitStream ? bitStream->GetNumberOfBytesUsed () : 0;
+    return true;
+}
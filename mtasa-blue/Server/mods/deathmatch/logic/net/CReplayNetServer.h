@@ -0,0 +1,36 @@
+/*****************************************************************************
+*
+*  PROJECT:     Multi Theft Auto v1.0
+*  LICENSE:     See LICENSE in the top level directory
+*
+*  Multi Theft Auto is available from http://www.multitheftauto.com/
+*
+*****************************************************************************/
+
+//
+// Net interface installed while packets are replayed by CPacketRecorder
+// Calls for replayed players are handled here, so they never reach the net module:
+// packets sent to them are counted and dropped, and queries about them get made up answers.
+//
+class CReplayNetServer : public CNetServerPassThrough
+{
+public:
+    ZERO_ON_NEW
+                                            CReplayNetServer                ( CNetServer* pNextNetServer );
+    virtual                                 ~CReplayNetServer               ( void );
+
+    // Main thread methods
+    void                                    AddReplaySocket                 ( const NetServerPlayerID& socket );
+    bool                                    HasReplayPlayers                ( void );
+    SString                                 GetStatus                       ( void );
+
+    // CNetServer interface
+    virtual bool                            SendPacket                      ( unsigned char ucPacketID, const NetServerPlayerID& playerID, NetBitStreamInterface* bitStream, bool bBroadcast, NetServerPacketPriority packetPriority, NetServerPacketReliability packetReliability, ePacketOrdering packetOrdering );
+
+protected:
+    virtual bool                            IsFakeSocket                    ( const NetServerPlayerID& socket ) const   { return MapContains ( m_ReplaySocketList, socket ); }
+
+    std::set < NetServerPlayerID >          m_ReplaySocketList;
+    uint                                    m_uiPacketsDropped;
+    long long                               m_llBytesDropped;
+};
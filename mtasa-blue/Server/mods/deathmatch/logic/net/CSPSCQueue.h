@@ -0,0 +1,109 @@
+/*****************************************************************************
+*
+*  PROJECT:     Multi Theft Auto v1.0
+*  LICENSE:     See LICENSE in the top level directory
+*
+*  Multi Theft Auto is available from http://www.multitheftauto.com/
+*
+*****************************************************************************/
+#pragma once
+#include <atomic>
+
+
+//
+// Bounded lock-free queue for one producer thread and one consumer thread.
+// If the ring is full, items wait in a list owned by the producer and are moved
+// across by later pushes or FlushOverflow, so pushing never blocks or drops.
+//
+template < class T, uint CAPACITY >
+class CSPSCQueue
+{
+    static_assert ( ( CAPACITY & ( CAPACITY - 1 ) ) == 0, "CAPACITY must be a power of 2" );
+
+public:
+    CSPSCQueue ( void )
+        : m_Items ( CAPACITY )
+    {
+        m_uiHead = 0;
+        m_uiTail = 0;
+        m_uiOverflowSize = 0;
+    }
+
+    // Producer thread. Returns true if the consumer could have seen the queue as empty, and may need waking.
+    bool Push ( const T& item )
+    {
+        if ( !m_Overflow.empty () || !TryPush ( item ) )
+        {
+            m_Overflow.push_back ( item );
+            m_uiOverflowSize = m_Overflow.size ();
+            return FlushOverflow ();
+        }
+        // Pairs with the fence in IsEmpty, so either we see the consumer's last pop or it sees our item
+        std::atomic_thread_fence ( std::memory_order_seq_cst );
+        return m_uiHead.load ( std::memory_order_acquire ) == m_uiTail.load ( std::memory_order_relaxed ) - 1;
+    }
+
+    // Producer thread. Move waiting items into the ring. Returns true if the consumer may need waking.
+    bool FlushOverflow ( void )
+    {
+        if ( m_Overflow.empty () )
+            return false;
+
+        uint uiTailBefore = m_uiTail.load ( std::memory_order_relaxed );
+        while ( !m_Overflow.empty () && TryPush ( m_Overflow.front () ) )
+            m_Overflow.pop_front ();
+        m_uiOverflowSize = m_Overflow.size ();
+
+        std::atomic_thread_fence ( std::memory_order_seq_cst );
+        return m_uiTail.load ( std::memory_order_relaxed ) != uiTailBefore
+            && m_uiHead.load ( std::memory_order_acquire ) == uiTailBefore;
+    }
+
+    // Consumer thread
+    bool Pop ( T& outItem )
+    {
+        uint uiHead = m_uiHead.load ( std::memory_order_relaxed );
+        if ( uiHead == m_uiTail.load ( std::memory_order_acquire ) )
+            return false;
+
+        outItem = m_Items[ uiHead & ( CAPACITY - 1 ) ];
+        m_uiHead.store ( uiHead + 1, std::memory_order_release );
+        return true;
+    }
+
+    // Consumer thread. Call before waiting for a signal from the producer.
+    bool IsEmpty ( void ) const
+    {
+        // Pairs with the fence in Push/FlushOverflow
+        std::atomic_thread_fence ( std::memory_order_seq_cst );
+        return m_uiHead.load ( std::memory_order_relaxed ) == m_uiTail.load ( std::memory_order_acquire );
+    }
+
+    // Any thread. Includes items waiting in the overflow list.
+    uint GetSize ( void ) const
+    {
+        return m_uiTail.load ( std::memory_order_acquire ) - m_uiHead.load ( std::memory_order_acquire ) + m_uiOverflowSize.load ( std::memory_order_relaxed );
+    }
+
+protected:
+    bool TryPush ( const T& item )
+    {
+        uint uiTail = m_uiTail.load ( std::memory_order_relaxed );
+        if ( uiTail - m_uiHead.load ( std::memory_order_acquire ) >= CAPACITY )
+            return false;
+
+        m_Items[ uiTail & ( CAPACITY - 1 ) ] = item;
+        m_uiTail.store ( uiTail + 1, std::memory_order_release );
+        return true;
+    }
+
+    std::vector < T >       m_Items;
+
+    // Head and tail are padded apart so the two threads do not fight over one cache line
+    char                    m_Pad1 [ 64 ];
+    std::atomic < uint >    m_uiHead;           // Written by consumer
+    char                    m_Pad2 [ 64 ];
+    std::atomic < uint >    m_uiTail;           // Written by producer
+    std::atomic < uint >    m_uiOverflowSize;
+    std::deque < T >        m_Overflow;         // Producer only
+};
@@ -0,0 +1,665 @@
+/*****************************************************************************
+*
+*  PROJECT:     Multi Theft Auto v1.0
+*  LICENSE:     See LICENSE in the top level directory
+*
+*  Multi Theft Auto is available from http://www.multitheftauto.com/
+*
+*****************************************************************************/
+
+#include "StdInc.h"
+#include "SimHeaders.h"
+#include "net/SyncStructures.h"
+
+
+///////////////////////////////////////////////////////////////
+//
+// CSimClientNetServer::CSimClientNetServer
+//
+//
+//
+///////////////////////////////////////////////////////////////
+CSimClientNetServer::CSimClientNetServer ( CNetServer* pRealNetServer )
+    : CNetServerPassThrough ( pRealNetServer )
+{
+    m_uiNextIndex = 1;
+    m_llStatsStartTime = GetTickCount64_ ();
+}
+
+
+///////////////////////////////////////////////////////////////
+//
+// CSimClientNetServer::~CSimClientNetServer
+//
+//
+//
+///////////////////////////////////////////////////////////////
+CSimClientNetServer::~CSimClientNetServer ( void )
+{
+}
+
+
+///////////////////////////////////////////////////////////////
+//
+// CSimClientNetServer::SetClientCount
+//
+// Clients are added or removed gradually during DoPulse
+//
+///////////////////////////////////////////////////////////////
+void CSimClientNetServer::SetClientCount ( uint uiCount )
+{
+    std::lock_guard < std::mutex > guard ( m_Mutex );
+    m_uiTargetCount = std::min < uint > ( uiCount, SIM_CLIENT_MAX );
+}
+
+
+///////////////////////////////////////////////////////////////
+//
+// CSimClientNetServer::SetCongestedPercent
+//
+// Make some clients look like they are on a congested connection
+//
+///////////////////////////////////////////////////////////////
+void CSimClientNetServer::SetCongestedPercent ( uint uiPercent )
+{
+    std::lock_guard < std::mutex > guard ( m_Mutex );
+    m_uiCongestedPercent = std::min < uint > ( uiPercent, 100 );
+}
+
+
+///////////////////////////////////////////////////////////////
+//
+// CSimClientNetServer::IsCongested
+//
+// Must be called with the mutex locked
+//
+///////////////////////////////////////////////////////////////
+bool CSimClientNetServer::IsCongested ( const SSimClient& client )
+{
+    // Spread them out, so a small client count still gets about the right mix
+    return client.uiIndex * 37 % 100 < m_uiCongestedPercent;
+}
+
+
+///////////////////////////////////////////////////////////////
+//
+// CSimClientNetServer::AddMainPulseTime
+//
+// Called at the end of each CGame::DoPulse
+//
+///////////////////////////////////////////////////////////////
+void CSimClientNetServer::AddMainPulseTime ( TIMEUS timeUs )
+{
+    std::lock_guard < std::mutex > guard ( m_Mutex );
+    m_uiMainPulseCount++;
+    m_llMainPulseTotalUs += timeUs;
+    m_MainPulseMaxUs = std::max ( m_MainPulseMaxUs, timeUs );
+}
+
+
+///////////////////////////////////////////////////////////////
+//
+// CSimClientNetServer::GetStatus
+//
+// Result of the last stats interval
+//
+///////////////////////////////////////////////////////////////
+SString CSimClientNetServer::GetStatus ( void )
+{
+    std::lock_guard < std::mutex > guard ( m_Mutex );
+    if ( m_strStatus.empty () )
+        return SString ( "%u simulated clients requested, no stats yet", m_uiTargetCount );
+    return m_strStatus;
+}
+
+
+///////////////////////////////////////////////////////////////
+//
+// CSimClientNetServer::GetSimClient
+//
+// Must be called with the mutex locked
+//
+///////////////////////////////////////////////////////////////
+CSimClientNetServer::SSimClient* CSimClientNetServer::GetSimClient ( const NetServerPlayerID& socket )
+{
+    if ( !IsFakeSocket ( socket ) )
+        return NULL;
+    return MapFind ( m_ClientMap, socket.GetBinaryAddress () );
+}
+
+
+///////////////////////////////////////////////////////////////
+//
+// CSimClientNetServer::DoPulse
+//
+// Generate packets from the simulated clients and give them to the packet handler
+// Can be called from the sync thread
+//
+///////////////////////////////////////////////////////////////
+void CSimClientNetServer::DoPulse ( void )
+{
+    m_pNextNetServer->DoPulse ();
+
+    std::vector < SSimPacket > packetList;
+    {
+        std::lock_guard < std::mutex > guard ( m_Mutex );
+        long long llTime = GetTickCount64_ ();
+
+        // Adjust the number of clients
+        uint uiNumActive = 0;
+        for ( std::map < uint, SSimClient >::iterator iter = m_ClientMap.begin () ; iter != m_ClientMap.end () ; ++iter )
+            if ( iter->second.state != SIM_CLIENT_QUIT && iter->second.state != SIM_CLIENT_GONE )
+                uiNumActive++;
+
+        for ( uint i = 0 ; i < SIM_CLIENT_CONNECTS_PER_PULSE && uiNumActive < m_uiTargetCount ; i++ )
+        {
+            SSimClient client;
+            client.uiIndex = m_uiNextIndex++;
+            client.socket = NetServerPlayerID ( 0x7F000000 | ( client.uiIndex & 0xFFFFFF ), SIM_CLIENT_PORT );
+            client.state = SIM_CLIENT_CONNECT;
+            client.playerID = INVALID_ELEMENT_ID;
+            client.bSpawned = false;
+            client.ucTimeContext = 0;
+            client.vecPathCenter = CVector ( ( client.uiIndex % 64 ) * 8.f - 256.f, ( client.uiIndex / 64 % 64 ) * 8.f - 256.f, 3.f );
+            client.fPathRadius = 5.f + ( client.uiIndex * 7 % 26 );
+            client.fPathSpeed = 1.5f + ( client.uiIndex * 3 % 10 ) * 0.5f;
+            client.llNextPuresyncTime = llTime;
+            client.llNextKeysyncTime = llTime + client.uiIndex * 37 % SIM_CLIENT_KEYSYNC_INTERVAL;
+            client.llNextBulletsyncTime = llTime + client.uiIndex * 53 % SIM_CLIENT_BULLETSYNC_INTERVAL;
+            client.ucBulletOrderCounter = 0;
+            client.uiOutPackets = 0;
+            client.llOutBytes = 0;
+            client.llTotalOutBytes = 0;
+            MapSet ( m_ClientMap, client.socket.GetBinaryAddress (), client );
+            uiNumActive++;
+        }
+
+        for ( std::map < uint, SSimClient >::reverse_iterator iter = m_ClientMap.rbegin () ; iter != m_ClientMap.rend () && uiNumActive > m_uiTargetCount ; ++iter )
+        {
+            if ( iter->second.state != SIM_CLIENT_QUIT && iter->second.state != SIM_CLIENT_GONE )
+            {
+                iter->second.state = SIM_CLIENT_QUIT;
+                uiNumActive--;
+            }
+        }
+
+        // Pulse each client
+        for ( std::map < uint, SSimClient >::iterator iter = m_ClientMap.begin () ; iter != m_ClientMap.end () ; )
+        {
+            SSimClient& client = iter->second;
+            PulseClient ( client, llTime, packetList );
+            if ( client.state == SIM_CLIENT_GONE )
+                m_ClientMap.erase ( iter++ );
+            else
+                ++iter;
+        }
+
+        m_uiInPackets += packetList.size ();
+        UpdateStats ( llTime );
+    }
+
+    // Process outside of the lock, as the handler can call back into SendPacket
+    for ( uint i = 0 ; i < packetList.size () ; i++ )
+    {
+        const SSimPacket& packet = packetList[i];
+        if ( m_pfnPacketHandler )
+            m_pfnPacketHandler ( packet.ucPacketID, packet.socket, packet.pBitStream, NULL );
+        m_pNextNetServer->DeallocateNetServerBitStream ( packet.pBitStream );
+    }
+}
+
+
+///////////////////////////////////////////////////////////////
+//
+// CSimClientNetServer::AddPacket
+//
+// Allocate a bitstream for an incoming packet from the client
+//
+///////////////////////////////////////////////////////////////
+NetBitStreamInterface* CSimClientNetServer::AddPacket ( SSimClient& client, uchar ucPacketID, std::vector < SSimPacket >& outPacketList )
+{
+    SSimPacket packet;
+    packet.ucPacketID = ucPacketID;
+    packet.socket = client.socket;
+    packet.pBitStream = m_pNextNetServer->AllocateNetServerBitStream ( MTA_DM_BITSTREAM_VERSION, NULL, 0, false );
+    outPacketList.push_back ( packet );
+    return packet.pBitStream;
+}
+
+
+///////////////////////////////////////////////////////////////
+//
+// CSimClientNetServer::PulseClient
+//
+// Do whatever the client would do next
+//
+///////////////////////////////////////////////////////////////
+void CSimClientNetServer::PulseClient ( SSimClient& client, long long llTime, std::vector < SSimPacket >& outPacketList )
+{
+    switch ( client.state )
+    {
+        case SIM_CLIENT_CONNECT:
+        {
+            AddPacket ( client, PACKET_ID_PLAYER_JOIN, outPacketList );
+            WriteJoinData ( client, *AddPacket ( client, PACKET_ID_PLAYER_JOINDATA, outPacketList ) );
+            client.state = SIM_CLIENT_CONNECTING;
+            break;
+        }
+
+        case SIM_CLIENT_INGAME_NOTICE:
+        {
+            AddPacket ( client, PACKET_ID_RPC, outPacketList )->Write ( static_cast < uchar > ( CRPCFunctions::PLAYER_INGAME_NOTICE ) );
+            client.state = SIM_CLIENT_JOINING;
+            break;
+        }
+
+        case SIM_CLIENT_INITIAL_DATA:
+        {
+            AddPacket ( client, PACKET_ID_RPC, outPacketList )->Write ( static_cast < uchar > ( CRPCFunctions::INITIAL_DATA_STREAM ) );
+            client.state = SIM_CLIENT_JOINED;
+            break;
+        }
+
+        case SIM_CLIENT_JOINED:
+        {
+            if ( llTime >= client.llNextPuresyncTime )
+            {
+                WritePuresync ( client, llTime, *AddPacket ( client, PACKET_ID_PLAYER_PURESYNC, outPacketList ) );
+                client.llNextPuresyncTime = std::max ( client.llNextPuresyncTime + g_TickRateSettings.iPureSync, llTime );
+            }
+            if ( llTime >= client.llNextKeysyncTime )
+            {
+                WriteKeysync ( client, llTime, *AddPacket ( client, PACKET_ID_PLAYER_KEYSYNC, outPacketList ) );
+                client.llNextKeysyncTime = std::max ( client.llNextKeysyncTime + SIM_CLIENT_KEYSYNC_INTERVAL, llTime );
+            }
+            if ( llTime >= client.llNextBulletsyncTime )
+            {
+                WriteBulletsync ( client, llTime, *AddPacket ( client, PACKET_ID_PLAYER_BULLETSYNC, outPacketList ) );
+                client.llNextBulletsyncTime = std::max ( client.llNextBulletsyncTime + SIM_CLIENT_BULLETSYNC_INTERVAL, llTime );
+            }
+            break;
+        }
+
+        case SIM_CLIENT_QUIT:
+        {
+            AddPacket ( client, PACKET_ID_PLAYER_QUIT, outPacketList );
+            client.state = SIM_CLIENT_GONE;
+            break;
+        }
+
+        default:
+            break;
+    }
+}
+
+
+///////////////////////////////////////////////////////////////
+//
+// CSimClientNetServer::ReceivePacket
+//
+// Look for packets which move the client along
+//
+///////////////////////////////////////////////////////////////
+void CSimClientNetServer::ReceivePacket ( SSimClient& client, uchar ucPacketID, NetBitStreamInterface* pBitStream )
+{
+    client.uiOutPackets++;
+    client.llOutBytes += pBitStream->GetNumberOfBytesUsed () + 1;
+
+    switch ( ucPacketID )
+    {
+        case PACKET_ID_SERVER_JOIN_COMPLETE:
+        {
+            if ( client.state == SIM_CLIENT_CONNECTING )
+                client.state = SIM_CLIENT_INGAME_NOTICE;
+            break;
+        }
+
+        case PACKET_ID_SERVER_JOINEDGAME:
+        {
+            if ( client.state == SIM_CLIENT_JOINING && pBitStream->Read ( client.playerID ) )
+                client.state = SIM_CLIENT_INITIAL_DATA;
+            break;
+        }
+
+        case PACKET_ID_PLAYER_SPAWN:
+        {
+            // Start walking from where the server put us
+            ElementID playerID;
+            uchar ucUnused;
+            CVector vecPosition;
+            float fRotation;
+            ushort usSkin, usDimension;
+            uchar ucInterior, ucTimeContext;
+            ElementID teamID;
+            if ( pBitStream->Read ( playerID ) && playerID == client.playerID
+                    && pBitStream->Read ( ucUnused )
+                    && pBitStream->Read ( vecPosition.fX ) && pBitStream->Read ( vecPosition.fY ) && pBitStream->Read ( vecPosition.fZ )
+                    && pBitStream->Read ( fRotation ) && pBitStream->Read ( usSkin ) && pBitStream->Read ( ucInterior )
+                    && pBitStream->Read ( usDimension ) && pBitStream->Read ( teamID ) && pBitStream->Read ( ucTimeContext ) )
+            {
+                client.vecPathCenter = vecPosition - CVector ( client.fPathRadius, 0, 0 );
+                client.ucTimeContext = ucTimeContext;
+                client.bSpawned = true;
+            }
+            pBitStream->ResetReadPointer ();
+            break;
+        }
+
+        case PACKET_ID_SERVER_DISCONNECTED:
+        {
+            client.state = SIM_CLIENT_GONE;
+            break;
+        }
+
+        default:
+            break;
+    }
+}
+
+
+///////////////////////////////////////////////////////////////
+//
+// CSimClientNetServer::WriteJoinData
+//
+// Same layout as CPlayerJoinDataPacket::Read
+//
+///////////////////////////////////////////////////////////////
+void CSimClientNetServer::WriteJoinData ( SSimClient& client, NetBitStreamInterface& BitStream )
+{
+    BitStream.Write ( static_cast < ushort > ( MTA_DM_NETCODE_VERSION ) );
+    BitStream.Write ( static_cast < ushort > ( MTA_DM_VERSION ) );
+    BitStream.Write ( static_cast < ushort > ( MTA_DM_BITSTREAM_VERSION ) );
+    BitStream.WriteString ( m_strPlayerVersion );
+    BitStream.WriteBit ( false );
+    BitStream.Write ( static_cast < uchar > ( 0 ) );
+
+    SString strNick ( "SimClient%u", client.uiIndex );
+    strNick.resize ( MAX_PLAYER_NICK_LENGTH );
+    BitStream.WriteStringCharacters ( strNick, MAX_PLAYER_NICK_LENGTH );
+
+    MD5 password;
+    memset ( &password, 0, sizeof ( password ) );
+    BitStream.Write ( reinterpret_cast < const char* > ( &password ), 16 );
+
+    SString strSerialUser;
+    strSerialUser.resize ( MAX_SERIAL_LENGTH );
+    BitStream.WriteStringCharacters ( strSerialUser, MAX_SERIAL_LENGTH );
+}
+
+
+///////////////////////////////////////////////////////////////
+//
+// CSimClientNetServer::GetPathPosition
+//
+// Each client walks around its own loop at its own speed
+//
+///////////////////////////////////////////////////////////////
+void CSimClientNetServer::GetPathPosition ( SSimClient& client, long long llTime, CVector& vecOutPosition, float& fOutRotation )
+{
+    float fAngle = static_cast < float > ( fmod ( llTime * 0.001 * client.fPathSpeed / client.fPathRadius + client.uiIndex, 2 * PI ) );
+    vecOutPosition = client.vecPathCenter + CVector ( cos ( fAngle ), sin ( fAngle ), 0 ) * client.fPathRadius;
+    fOutRotation = WrapAround ( -PI, fAngle + PI / 2, PI );
+}
+
+
+///////////////////////////////////////////////////////////////
+//
+// CSimClientNetServer::WritePuresync
+//
+// Same layout as CPlayerPuresyncPacket::Read
+//
+///////////////////////////////////////////////////////////////
+void CSimClientNetServer::WritePuresync ( SSimClient& client, long long llTime, NetBitStreamInterface& BitStream )
+{
+    CVector vecPosition;
+    float fRotation;
+    GetPathPosition ( client, llTime, vecPosition, fRotation );
+
+    BitStream.Write ( client.ucTimeContext );
+
+    CControllerState controllerState;
+    controllerState.LeftStickY = -128;
+    WriteFullKeysync ( controllerState, BitStream );
+
+    SPlayerPuresyncFlags flags;
+    memset ( &flags.data, 0, sizeof ( flags.data ) );
+    flags.data.bIsOnGround = true;
+    flags.data.bSyncingVelocity = true;
+    BitStream.Write ( &flags );
+
+    SPositionSync position ( false );
+    position.data.vecPosition = vecPosition;
+    BitStream.Write ( &position );
+
+    SPedRotationSync rotation;
+    rotation.data.fRotation = fRotation;
+    BitStream.Write ( &rotation );
+
+    // Game units per frame at 50fps
+    SVelocitySync velocity;
+    velocity.data.vecVelocity = CVector ( -sin ( fRotation ), cos ( fRotation ), 0 ) * ( client.fPathSpeed * 0.02f );
+    BitStream.Write ( &velocity );
+
+    SPlayerHealthSync health;
+    health.data.fValue = 100;
+    BitStream.Write ( &health );
+
+    SPlayerArmorSync armor;
+    armor.data.fValue = 0;
+    BitStream.Write ( &armor );
+
+    SCameraRotationSync camRotation;
+    camRotation.data.fRotation = fRotation;
+    BitStream.Write ( &camRotation );
+
+    // Camera orientation - Same layout as ReadCameraOrientation, with the camera at the player position
+    SFloatAsBitsSync < 8 > camOrientation ( -PI, PI, false );
+    camOrientation.data.fValue = fRotation;
+    BitStream.Write ( &camOrientation );
+    camOrientation.data.fValue = 0;
+    BitStream.Write ( &camOrientation );
+    BitStream.WriteBit ( false );
+    uchar idx = 0;
+    BitStream.WriteBits ( reinterpret_cast < const char* > ( &idx ), 2 );
+    SFloatAsBitsSyncBase camOffset ( 3, -4.f, 4.f, false );
+    camOffset.data.fValue = 0;
+    BitStream.Write ( &camOffset );
+    BitStream.Write ( &camOffset );
+    BitStream.Write ( &camOffset );
+
+    // No damage
+    BitStream.WriteBit ( false );
+}
+
+
+///////////////////////////////////////////////////////////////
+//
+// CSimClientNetServer::WriteKeysync
+//
+// Same layout as CKeysyncPacket::Read
+//
+///////////////////////////////////////////////////////////////
+void CSimClientNetServer::WriteKeysync ( SSimClient& client, long long llTime, NetBitStreamInterface& BitStream )
+{
+    CVector vecPosition;
+    float fRotation;
+    GetPathPosition ( client, llTime, vecPosition, fRotation );
+
+    CControllerState controllerState;
+    controllerState.LeftStickY = -128;
+    WriteSmallKeysync ( controllerState, BitStream );
+
+    SKeysyncRotation rotation;
+    rotation.data.fPlayerRotation = fRotation;
+    rotation.data.fCameraRotation = fRotation;
+    BitStream.Write ( &rotation );
+
+    SKeysyncFlags flags;
+    memset ( &flags.data, 0, sizeof ( flags.data ) );
+    BitStream.Write ( &flags );
+}
+
+
+///////////////////////////////////////////////////////////////
+//
+// CSimClientNetServer::WriteBulletsync
+//
+// Same layout as CBulletsyncPacket::Read
+//
+///////////////////////////////////////////////////////////////
+void CSimClientNetServer::WriteBulletsync ( SSimClient& client, long long llTime, NetBitStreamInterface& BitStream )
+{
+    CVector vecStart;
+    float fRotation;
+    GetPathPosition ( client, llTime, vecStart, fRotation );
+    vecStart.fZ += 0.5f;
+    CVector vecEnd = vecStart + CVector ( -sin ( fRotation ), cos ( fRotation ), 0 ) * 50.f;
+
+    BitStream.Write ( static_cast < char > ( WEAPONTYPE_M4 ) );
+    BitStream.Write ( reinterpret_cast < const char* > ( &vecStart ), sizeof ( CVector ) );
+    BitStream.Write ( reinterpret_cast < const char* > ( &vecEnd ), sizeof ( CVector ) );
+    BitStream.Write ( client.ucBulletOrderCounter++ );
+    BitStream.WriteBit ( false );
+}
+
+
+///////////////////////////////////////////////////////////////
+//
+// CSimClientNetServer::UpdateStats
+//
+// Make a status line every SIM_CLIENT_STATS_INTERVAL
+//
+///////////////////////////////////////////////////////////////
+void CSimClientNetServer::UpdateStats ( long long llTime )
+{
+    long long llDeltaMs = llTime - m_llStatsStartTime;
+    if ( llDeltaMs < SIM_CLIENT_STATS_INTERVAL )
+        return;
+
+    uint uiNumJoined = 0;
+    uint uiNumSpawned = 0;
+    uint uiOutPackets = 0;
+    long long llOutBytes = 0;
+    long long llMaxOutBytes = 0;
+    uint uiNumCongested = 0;
+    long long llCongestedOutBytes = 0;
+    for ( std::map < uint, SSimClient >::iterator iter = m_ClientMap.begin () ; iter != m_ClientMap.end () ; ++iter )
+    {
+        SSimClient& client = iter->second;
+        if ( client.state == SIM_CLIENT_JOINED )
+        {
+            uiNumJoined++;
+            if ( client.bSpawned )
+                uiNumSpawned++;
+            uiOutPackets += client.uiOutPackets;
+            llOutBytes += client.llOutBytes;
+            llMaxOutBytes = std::max ( llMaxOutBytes, client.llOutBytes );
+            if ( IsCongested ( client ) )
+            {
+                uiNumCongested++;
+                llCongestedOutBytes += client.llOutBytes;
+            }
+        }
+        client.llTotalOutBytes += client.llOutBytes;
+        client.uiOutPackets = 0;
+        client.llOutBytes = 0;
+    }
+
+    float fSeconds = llDeltaMs / 1000.f;
+    float fNumJoined = static_cast < float > ( std::max < uint > ( 1, uiNumJoined ) );
+    m_strStatus = SString ( "%u clients (%u joined, %u spawned) | Pulse avg %.2f ms max %.2f ms | Out per player %.2f KB/s avg %.2f KB/s max %.1f pkts/s | In %.0f pkts/s"
+                                , m_ClientMap.size ()
+                                , uiNumJoined
+                                , uiNumSpawned
+                                , m_uiMainPulseCount ? m_llMainPulseTotalUs / 1000.f / m_uiMainPulseCount : 0.f
+                                , m_MainPulseMaxUs / 1000.f
+                                , llOutBytes / 1024.f / fNumJoined / fSeconds
+                                , llMaxOutBytes / 1024.f / fSeconds
+                                , uiOutPackets / fNumJoined / fSeconds
+                                , m_uiInPackets / fSeconds
+                            );
+    if ( uiNumCongested )
+    {
+        // Compare with the others to see how much sync rate scaling saves
+        uint uiNumOther = uiNumJoined - uiNumCongested;
+        m_strStatus += SString ( " | Out per congested player %.2f KB/s | Out per other player %.2f KB/s"
+                                    , llCongestedOutBytes / 1024.f / uiNumCongested / fSeconds
+                                    , ( llOutBytes - llCongestedOutBytes ) / 1024.f / std::max < uint > ( 1, uiNumOther ) / fSeconds
+                                );
+    }
+    CLogger::LogPrintf ( "SIMCLIENTS: %s\n", *m_strStatus );
+
+    // How the sync thread coped with relaying it all
+    SString strRelayStatus = CSimControl::GetRelayStatus ();
+    CLogger::LogPrintf ( "SIMCLIENTS: %s\n", *strRelayStatus );
+    m_strStatus += "\n" + strRelayStatus;
+
+    m_llStatsStartTime = llTime;
+    m_uiInPackets = 0;
+    m_uiMainPulseCount = 0;
+    m_llMainPulseTotalUs = 0;
+    m_MainPulseMaxUs = 0;
+}
+
+
+///////////////////////////////////////////////////////////////
+//
+// CNetServer interface
+//
+// Simulated clients are handled here, the rest is left to CNetServerPassThrough
+//
+///////////////////////////////////////////////////////////////
+void CSimClientNetServer::RegisterPacketHandler ( PPACKETHANDLER pfnPacketHandler )
+{
+    m_pfnPacketHandler = pfnPacketHandler;
+    m_pNextNetServer->RegisterPacketHandler ( pfnPacketHandler );
+}
+
+bool CSimClientNetServer::GetNetworkStatistics ( NetStatistics* pDest, const NetServerPlayerID& PlayerID )
+{
+    if ( !IsFakeSocket ( PlayerID ) )
+        return m_pNextNetServer->GetNetworkStatistics ( pDest, PlayerID );
+
+    std::lock_guard < std::mutex > guard ( m_Mutex );
+    memset ( pDest, 0, sizeof ( *pDest ) );
+    if ( SSimClient* pClient = GetSimClient ( PlayerID ) )
+    {
+        pDest->bytesSent = pClient->llTotalOutBytes + pClient->llOutBytes;
+        if ( IsCongested ( *pClient ) )
+        {
+            pDest->packetlossLastSecond = SIM_CLIENT_CONGESTED_PACKET_LOSS;
+            pDest->messagesInSendBuffer = SIM_CLIENT_CONGESTED_SEND_QUEUE;
+        }
+    }
+    return true;
+}
+
+bool CSimClientNetServer::SendPacket ( unsigned char ucPacketID, const NetServerPlayerID& playerID, NetBitStreamInterface* bitStream, bool bBroadcast, NetServerPacketPriority packetPriority, NetServerPacketReliability packetReliability, ePacketOrdering packetOrdering )
+{
+    if ( !IsFakeSocket ( playerID ) )
+        return m_pNextNetServer->SendPacket ( ucPacketID, playerID, bitStream, bBroadcast, packetPriority, packetReliability, packetOrdering );
+
+    std::lock_guard < std::mutex > guard ( m_Mutex );
+    if ( SSimClient* pClient = GetSimClient ( playerID ) )
+        ReceivePacket ( *pClient, ucPacketID, bitStream );
+    return true;
+}
+
+void CSimClientNetServer::Kick ( const NetServerPlayerID &PlayerID )
+{
+    if ( !IsFakeSocket ( PlayerID ) )
+        return m_pNextNetServer->Kick ( PlayerID );
+
+    std::lock_guard < std::mutex > guard ( m_Mutex );
+    if ( SSimClient* pClient = GetSimClient ( PlayerID ) )
+        pClient->state = SIM_CLIENT_GONE;
+}
+
+bool CSimClientNetServer::IsValidSocket ( const NetServerPlayerID& playerID )
+{
+    if ( !IsFakeSocket ( playerID ) )
+        return m_pNextNetServer->IsValidSocket ( playerID );
+
+    std::lock_guard < std::mutex > guard ( m_Mutex );
+    return GetSimClient ( playerID ) != NULL;
+}
@@ -0,0 +1,116 @@
+/*****************************************************************************
+*
+*  PROJECT:     Multi Theft Auto v1.0
+*  LICENSE:     See LICENSE in the top level directory
+*
+*  Multi Theft Auto is available from http://www.multitheftauto.com/
+*
+*****************************************************************************/
+
+#define SIM_CLIENT_PORT                     0           // Real connections never use port 0
+#define SIM_CLIENT_MAX                      4096
+#define SIM_CLIENT_CONNECTS_PER_PULSE       20          // Stop a large client count from stalling startup
+#define SIM_CLIENT_KEYSYNC_INTERVAL         1000
+#define SIM_CLIENT_BULLETSYNC_INTERVAL      2000
+#define SIM_CLIENT_STATS_INTERVAL           10000
+#define SIM_CLIENT_CONGESTED_PACKET_LOSS    5.f         // Percent reported by congested clients
+#define SIM_CLIENT_CONGESTED_SEND_QUEUE     300         // Messages reported waiting by congested clients
+
+//
+// Replacement net interface which adds synthetic players to the real one, for load testing
+// Synthetic players connect, join, walk around a loop and fire now and then.
+// Everything sent to them is counted and then thrown away.
+//
+class CSimClientNetServer : public CNetServerPassThrough
+{
+public:
+    ZERO_ON_NEW
+                                            CSimClientNetServer             ( CNetServer* pRealNetServer );
+    virtual                                 ~CSimClientNetServer            ( void );
+
+    // Main thread methods
+    void                                    SetClientCount                  ( uint uiCount );
+    void                                    SetCongestedPercent             ( uint uiPercent );
+    void                                    AddMainPulseTime                ( TIMEUS timeUs );
+    SString                                 GetStatus                       ( void );
+
+    // CNetServer interface
+    virtual void                            DoPulse                         ( void );
+
+    virtual void                            RegisterPacketHandler           ( PPACKETHANDLER pfnPacketHandler );
+
+    virtual bool                            GetNetworkStatistics            ( NetStatistics* pDest, const NetServerPlayerID& PlayerID );
+    virtual bool                            SendPacket                      ( unsigned char ucPacketID, const NetServerPlayerID& playerID, NetBitStreamInterface* bitStream, bool bBroadcast, NetServerPacketPriority packetPriority, NetServerPacketReliability packetReliability, ePacketOrdering packetOrdering );
+    virtual void                            Kick                            ( const NetServerPlayerID &PlayerID );
+    virtual bool                            IsValidSocket                   ( const NetServerPlayerID& playerID );
+
+protected:
+    enum ESimClientState
+    {
+        SIM_CLIENT_CONNECT,             // Needs to send join and join data
+        SIM_CLIENT_CONNECTING,          // Waiting for connect complete
+        SIM_CLIENT_INGAME_NOTICE,       // Needs to send ingame notice
+        SIM_CLIENT_JOINING,             // Waiting for joined game
+        SIM_CLIENT_INITIAL_DATA,        // Needs to send initial data stream request
+        SIM_CLIENT_JOINED,              // Sending sync
+        SIM_CLIENT_QUIT,                // Needs to send quit
+        SIM_CLIENT_GONE,                // Disconnected by the server
+    };
+
+    struct SSimClient
+    {
+        NetServerPlayerID       socket;
+        uint                    uiIndex;
+        ESimClientState         state;
+        ElementID               playerID;
+        bool                    bSpawned;
+        uchar                   ucTimeContext;
+        CVector                 vecPathCenter;
+        float                   fPathRadius;
+        float                   fPathSpeed;
+        long long               llNextPuresyncTime;
+        long long               llNextKeysyncTime;
+        long long               llNextBulletsyncTime;
+        uchar                   ucBulletOrderCounter;
+        uint                    uiOutPackets;
+        long long               llOutBytes;
+        long long               llTotalOutBytes;
+    };
+
+    struct SSimPacket
+    {
+        uchar                   ucPacketID;
+        NetServerPlayerID       socket;
+        NetBitStreamInterface*  pBitStream;
+    };
+
+    virtual bool                IsFakeSocket                ( const NetServerPlayerID& socket ) const   { return socket.GetPort () == SIM_CLIENT_PORT && socket.GetBinaryAddress () != 0; }
+    SSimClient*                 GetSimClient                ( const NetServerPlayerID& socket );
+    void                        ReceivePacket               ( SSimClient& client, uchar ucPacketID, NetBitStreamInterface* pBitStream );
+    void                        PulseClient                 ( SSimClient& client, long long llTime, std::vector < SSimPacket >& outPacketList );
+    NetBitStreamInterface*      AddPacket                   ( SSimClient& client, uchar ucPacketID, std::vector < SSimPacket >& outPacketList );
+    void                        WriteJoinData               ( SSimClient& client, NetBitStreamInterface& BitStream );
+    void                        WritePuresync               ( SSimClient& client, long long llTime, NetBitStreamInterface& BitStream );
+    void                        WriteKeysync                ( SSimClient& client, long long llTime, NetBitStreamInterface& BitStream );
+    void                        WriteBulletsync             ( SSimClient& client, long long llTime, NetBitStreamInterface& BitStream );
+    void                        GetPathPosition             ( SSimClient& client, long long llTime, CVector& vecOutPosition, float& fOutRotation );
+    void                        UpdateStats                 ( long long llTime );
+    bool                        IsCongested                 ( const SSimClient& client );
+
+    PPACKETHANDLER                              m_pfnPacketHandler;
+    std::mutex                                  m_Mutex;
+
+    // Shared variables
+    uint                                        m_uiTargetCount;
+    uint                                        m_uiCongestedPercent;
+    uint                                        m_uiNextIndex;
+    std::map < uint, SSimClient >               m_ClientMap;    // Keyed by binary address
+
+    // Stats
+    long long                                   m_llStatsStartTime;
+    uint                                        m_uiInPackets;
+    uint                                        m_uiMainPulseCount;
+    long long                                   m_llMainPulseTotalUs;
+    TIMEUS                                      m_MainPulseMaxUs;
+    SString                                     m_strStatus;
+};
@@ -10,6 +10,8 @@
 #include "StdInc.h"
 #include "SimHeaders.h"
 
+#define BENCH_QUEUE_MAX_ROUND_TRIPS     10000       // Each trip needs two wake ups, so is much slower than streaming
+
 namespace
 {
     bool                ms_bEnabled = false;
@@ -167,3 +169,150 @@ void CSimControl::UpdateSimPlayer ( CPlayer* pPlayer )
 {
     ms_pSimPlayerManager->UpdateSimPlayer ( pPlayer );
 }
+
+
+///////////////////////////////////////////////////////////////
+//
+// CSimControl::GetNetworkStatistics
+//
+// Non blocking. When the sim system is on, this uses the stats last published
+// by the sync thread and returns false for players not published yet.
+//
+///////////////////////////////////////////////////////////////
+bool CSimControl::GetNetworkStatistics ( NetStatistics* pDest, const NetServerPlayerID& PlayerID )
+{
+    if ( ms_pNetServerBuffer )
+        return ms_pNetServerBuffer->GetPublishedNetworkStatistics ( pDest, PlayerID );
+    return g_pNetServer->GetNetworkStatistics ( pDest, PlayerID );
+}
+
+
+///////////////////////////////////////////////////////////////
+//
+// CSimControl::GetRelayStatus
+//
+// Relay stats since the last call
+//
+///////////////////////////////////////////////////////////////
+SString CSimControl::GetRelayStatus ( void )
+{
+    if ( !ms_pSimPlayerManager || !ms_bEnabled )
+        return "Relay off";
+    return ms_pSimPlayerManager->GetRelayStatus ();
+}
+
+
+///////////////////////////////////////////////////////////////
+//
+// CSimControl::BenchQueue
+//
+// Push numbers through a small queue to another thread, using the same
+// wake up protocol as CNetServerBuffer. Checks that every item arrives
+// in order and counts waits which timed out with items in the queue.
+// Then bounces single items to the other thread and back, to time the
+// round trip latency when each side has to wake the other.
+//
+///////////////////////////////////////////////////////////////
+SString CSimControl::BenchQueue ( uint uiCount )
+{
+    // Small capacity so the overflow list is used as well
+    CSPSCQueue < uint, 256 > queue;
+    CWorkSignal signal;
+    std::atomic < uint > uiNumReceived ( 0 );
+    uint uiNumOutOfOrder = 0;
+    uint uiNumWaits = 0;
+    uint uiNumLostWakes = 0;
+
+    TIMEUS startTime = GetTimeUs ();
+
+    std::thread consumer ( [&] {
+        uint uiExpected = 0;
+        while ( uiNumReceived < uiCount )
+        {
+            uint uiItem;
+            while ( queue.Pop ( uiItem ) )
+            {
+                if ( uiItem != uiExpected )
+                    uiNumOutOfOrder++;
+                uiExpected = uiItem + 1;
+                uiNumReceived++;
+            }
+
+            if ( uiNumReceived < uiCount && queue.IsEmpty () )
+            {
+                uiNumWaits++;
+                if ( !signal.Wait ( 100 ) && !queue.IsEmpty () )
+                    uiNumLostWakes++;
+            }
+        }
+    } );
+
+    for ( uint i = 0 ; i < uiCount ; i++ )
+        if ( queue.Push ( i ) )
+            signal.Notify ();
+
+    // Move anything left in the overflow list
+    while ( uiNumReceived < uiCount )
+    {
+        if ( queue.FlushOverflow () )
+            signal.Notify ();
+        std::this_thread::yield ();
+    }
+
+    consumer.join ();
+
+    TIMEUS timeUs = std::max < TIMEUS > ( 1, GetTimeUs () - startTime );
+
+    // Ping-pong
+    uint uiNumTrips = std::min < uint > ( uiCount, BENCH_QUEUE_MAX_ROUND_TRIPS );
+    CSPSCQueue < uint, 256 > pingQueue;
+    CSPSCQueue < uint, 256 > pongQueue;
+    CWorkSignal pingSignal;
+    CWorkSignal pongSignal;
+    TIMEUS totalTripUs = 0;
+    TIMEUS maxTripUs = 0;
+
+    std::thread echo ( [&] {
+        for ( uint i = 0 ; i < uiNumTrips ; i++ )
+        {
+            uint uiItem;
+            while ( !pingQueue.Pop ( uiItem ) )
+                if ( pingQueue.IsEmpty () )
+                    pingSignal.Wait ( 100 );
+
+            if ( pongQueue.Push ( uiItem ) )
+                pongSignal.Notify ();
+        }
+    } );
+
+    for ( uint i = 0 ; i < uiNumTrips ; i++ )
+    {
+        TIMEUS tripStartTime = GetTimeUs ();
+        if ( pingQueue.Push ( i ) )
+            pingSignal.Notify ();
+
+        uint uiItem;
+        while ( !pongQueue.Pop ( uiItem ) )
+            if ( pongQueue.IsEmpty () )
+                pongSignal.Wait ( 100 );
+
+        if ( uiItem != i )
+            uiNumOutOfOrder++;
+        TIMEUS tripUs = GetTimeUs () - tripStartTime;
+        totalTripUs += tripUs;
+        maxTripUs = std::max ( maxTripUs, tripUs );
+    }
+
+    echo.join ();
+
+    return SString ( "%u items in %.1f ms, %.0f items/sec, %u waits, %u lost wake ups, %u out of order, %u round trips avg %.1f us max %u us"
+                        , uiCount
+                        , timeUs / 1000.0
+                        , uiCount * 1000000.0 / timeUs
+                        , uiNumWaits
+                        , uiNumLostWakes
+                        , uiNumOutOfOrder
+                        , uiNumTrips
+                        , totalTripUs / (double)uiNumTrips
+                        , (uint)maxTripUs );
+}
@@ -22,4 +22,7 @@ public:
     static void AddSimPlayer                ( CPlayer* pPlayer );
     static void RemoveSimPlayer             ( CPlayer* pPlayer );
     static void UpdateSimPlayer             ( CPlayer* pPlayer );
+    static bool GetNetworkStatistics        ( NetStatistics* pDest, const NetServerPlayerID& PlayerID );
+    static SString GetRelayStatus           ( void );
+    static SString BenchQueue               ( uint uiCount );
 };
@@ -147,6 +147,9 @@ bool CSimKeysyncPacket::Read ( NetBitStreamInterface& BitStream )
         }
     }
 
+    // Keep a copy for Write, as the shared state can change before the relay is encoded
+    m_Cache.ControllerState = m_sharedControllerState;
+
     return true;
 }
 
@@ -160,7 +163,7 @@ bool CSimKeysyncPacket::Write ( NetBitStreamInterface& BitStream ) const
     BitStream.Write ( m_PlayerID );
 
     // Write the keysync data
-    WriteSmallKeysync ( m_sharedControllerState, BitStream );
+    WriteSmallKeysync ( m_Cache.ControllerState, BitStream );
 
     // Write the rotations
     SKeysyncRotation rotation;
@@ -172,7 +175,7 @@ bool CSimKeysyncPacket::Write ( NetBitStreamInterface& BitStream ) const
     BitStream.Write ( &m_Cache.flags );
 
     // If he's shooting or aiming
-    if ( m_sharedControllerState.ButtonCircle || ( m_sharedControllerState.RightShoulder1 ) )
+    if ( m_Cache.ControllerState.ButtonCircle || ( m_Cache.ControllerState.RightShoulder1 ) )
     {
         // Write his current weapon slot
         unsigned int uiSlot = m_Cache.ucWeaponSlot;   // check m_Cache.bWeaponCorrect ! 
@@ -207,14 +210,14 @@ bool CSimKeysyncPacket::Write ( NetBitStreamInterface& BitStream ) const
 
         if ( m_bVehicleHasHydraulics )
         {
-            BitStream.Write ( m_sharedControllerState.RightStickX );
-            BitStream.Write ( m_sharedControllerState.RightStickY );
+            BitStream.Write ( m_Cache.ControllerState.RightStickX );
+            BitStream.Write ( m_Cache.ControllerState.RightStickY );
         }
 
         if ( m_bVehicleIsPlaneOrHeli )
         {
-            BitStream.WriteBit ( m_sharedControllerState.LeftShoulder2 != 0);
-            BitStream.WriteBit ( m_sharedControllerState.RightShoulder2 != 0);
+            BitStream.WriteBit ( m_Cache.ControllerState.LeftShoulder2 != 0);
+            BitStream.WriteBit ( m_Cache.ControllerState.RightShoulder2 != 0);
         }
     }
 
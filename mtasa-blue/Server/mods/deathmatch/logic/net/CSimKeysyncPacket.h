@@ -61,6 +61,8 @@ public:
         uchar           ucDriveByDirection;
 
         SVehicleTurretSync turretSync;
+
+        CControllerState    ControllerState;        // Copy of m_sharedControllerState for Write
     } m_Cache;
 
 };
@@ -15,6 +15,19 @@ struct SSimVehicleDamageInfo
     SFixedArray < unsigned char, MAX_LIGHTS > m_ucLightStates;
 };
 
+//
+// Recipients of relayed packets, grouped by bitstream version.
+// Built by the main thread and replaced whole, so the sync thread can keep
+// sending to a copy after it has released the sim lock.
+//
+struct SSimSendGroup
+{
+    ushort                              usBitStreamVersion;
+    std::vector < NetServerPlayerID >   socketList;
+};
+typedef std::vector < SSimSendGroup >           CSimSendList;
+typedef std::shared_ptr < const CSimSendList >  CSimSendListPtr;
+
 //
 // Copy of enough data from CPlayer to enable autonomous relaying of pure sync packets
 //
@@ -26,7 +39,6 @@ public:
                                                     ~CSimPlayer                 ( void )                        { DEBUG_DESTROY_COUNT( "CSimPlayer" ); }
 
     bool                                            IsJoined                    ( void )                        { return m_iStatus == STATUS_JOINED; };
-    const std::multimap < ushort, CSimPlayer* >&    GetPuresyncSendList         ( void );
     unsigned short                                  GetBitStreamVersion         ( void )                        { return m_usBitStreamVersion; };
     NetServerPlayerID&                              GetSocket                   ( void )                        { return m_PlayerSocket; };
 
@@ -35,8 +47,7 @@ public:
     unsigned short                          m_usBitStreamVersion;
     NetServerPlayerID                       m_PlayerSocket;
     std::vector < CSimPlayer* >             m_PuresyncSendListFlat;
-    std::multimap < ushort, CSimPlayer* >   m_PuresyncSendListGrouped;      // Send list grouped by bitstream version
-    bool                                    m_bSendListChanged;
+    CSimSendListPtr                         m_pPuresyncSendList;            // Send list grouped by bitstream version
     bool                                    m_bHasOccupiedVehicle;
     CControllerState                        m_sharedControllerState;        // Updated by CSim*Packet code
 
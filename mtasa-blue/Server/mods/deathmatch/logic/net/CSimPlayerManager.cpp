@@ -92,8 +92,11 @@ void CSimPlayerManager::RemoveSimPlayer ( CPlayer* pPlayer )
     for ( std::set < CSimPlayer* > ::const_iterator iter = m_AllSimPlayerMap.begin () ; iter != m_AllSimPlayerMap.end (); ++iter )
     {
         CSimPlayer* pOtherSim = *iter;
-        ListRemove ( pOtherSim->m_PuresyncSendListFlat, pSim );
-        pOtherSim->m_bSendListChanged = true;
+        if ( ListContains ( pOtherSim->m_PuresyncSendListFlat, pSim ) )
+        {
+            ListRemove ( pOtherSim->m_PuresyncSendListFlat, pSim );
+            RebuildSendList ( pOtherSim );
+        }
     }
 
     SAFE_DELETE( pSim );
@@ -157,7 +160,6 @@ void CSimPlayerManager::UpdateSimPlayer ( CPlayer* pPlayer )
     {
         pPlayer->m_bPureSyncSimSendListDirty = false;
         pSim->m_PuresyncSendListFlat.clear ();
-        pSim->m_bSendListChanged = true;
         for ( CFastHashSet < CPlayer* > ::const_iterator iter = pPlayer->m_PureSyncSimSendList.begin (); iter != pPlayer->m_PureSyncSimSendList.end (); ++iter )
         {
             CSimPlayer* pSendSimPlayer = (*iter)->m_pSimPlayer;
@@ -166,6 +168,7 @@ void CSimPlayerManager::UpdateSimPlayer ( CPlayer* pPlayer )
             else
                 pPlayer->m_bPureSyncSimSendListDirty = true;    // Retry next time
         }
+        RebuildSendList ( pSim );
     }
 
     // Set this flag
@@ -175,6 +178,73 @@ void CSimPlayerManager::UpdateSimPlayer ( CPlayer* pPlayer )
 }
 
 
+///////////////////////////////////////////////////////////////////////////
+//
+// CSimPlayerManager::RebuildSendList
+//
+// Thread:              main
+// CS should be locked: yes
+//
+// Make a new send list grouped by bitstream version. The old one is left
+// alone, as the sync thread could still be sending to it.
+//
+///////////////////////////////////////////////////////////////////////////
+void CSimPlayerManager::RebuildSendList ( CSimPlayer* pSim )
+{
+    dassert ( m_bIsLocked );
+
+    std::map < ushort, std::vector < NetServerPlayerID > > groupMap;
+    for ( std::vector < CSimPlayer* >::const_iterator iter = pSim->m_PuresyncSendListFlat.begin () ; iter != pSim->m_PuresyncSendListFlat.end () ; ++iter )
+    {
+        CSimPlayer* pPlayer = *iter;
+        groupMap[ pPlayer->GetBitStreamVersion () ].push_back ( pPlayer->GetSocket () );
+    }
+
+    std::shared_ptr < CSimSendList > pSendList = std::make_shared < CSimSendList > ();
+    pSendList->resize ( groupMap.size () );
+    uint uiIndex = 0;
+    for ( std::map < ushort, std::vector < NetServerPlayerID > >::iterator iter = groupMap.begin () ; iter != groupMap.end () ; ++iter, ++uiIndex )
+    {
+        SSimSendGroup& group = (*pSendList)[ uiIndex ];
+        group.usBitStreamVersion = iter->first;
+        group.socketList.swap ( iter->second );
+    }
+
+    pSim->m_pPuresyncSendList = pSendList;
+}
+
+
+///////////////////////////////////////////////////////////////////////////
+//
+// CSimPlayerManager::GetRelayStatus
+//
+// Thread:              any, one at a time
+// CS should be locked: no
+//
+// Relay stats since the last call
+//
+///////////////////////////////////////////////////////////////////////////
+SString CSimPlayerManager::GetRelayStatus ( void )
+{
+    float fSeconds = std::max ( 1ULL, m_RelayStatusTimer.Get () ) / 1000.f;
+    m_RelayStatusTimer.Reset ();
+
+    uint uiPackets = m_uiRelayPacketCount.exchange ( 0 );
+    uint uiSends = m_uiRelaySendCount.exchange ( 0 );
+    long long llSyncThreadTimeUs = m_llRelaySyncThreadTimeUs.exchange ( 0 );
+    long long llEncodeTimeUs = m_llRelayEncodeTimeUs.exchange ( 0 );
+    float fPackets = static_cast < float > ( std::max < uint > ( 1, uiPackets ) );
+
+    return SString ( "Relay | In %.0f pkts/s | Out %.0f pkts/s | Sync thread %.1f us/pkt %.0f%% | Encode %.1f us/pkt"
+                        , uiPackets / fSeconds
+                        , uiSends / fSeconds
+                        , llSyncThreadTimeUs / fPackets
+                        , llSyncThreadTimeUs / 10.f / 1000.f / fSeconds
+                        , llEncodeTimeUs / fPackets
+                    );
+}
+
+
 ///////////////////////////////////////////////////////////////////////////
 //
 // CSimPlayerManager::LockSimSystem
@@ -236,6 +306,9 @@ bool CSimPlayerManager::HandlePlayerPureSync ( const NetServerPlayerID& Socket,
     if ( !CNetBufferWatchDog::CanSendPacket ( PACKET_ID_PLAYER_PURESYNC ) )
         return true;
 
+    TIMEUS startTime = GetTimeUs ();
+    SSimRelayJob* pJob = NULL;
+
     LockSimSystem ();     // Prevent player additions and deletions
 
     // Grab the source player
@@ -253,14 +326,18 @@ bool CSimPlayerManager::HandlePlayerPureSync ( const NetServerPlayerID& Socket,
                                                                            pSourceSimPlayer->m_sharedControllerState );
         if ( pPacket->Read ( *BitStream ) )
         {
-            // Relay it to nearbyers
-            Broadcast ( *pPacket, pSourceSimPlayer->GetPuresyncSendList () );
+            // Take the send list while the source player can't change
+            pJob = MakeRelayJob ( pPacket, pSourceSimPlayer->m_pPuresyncSendList );
         }
-
-        delete pPacket;
+        else
+            delete pPacket;
     }
 
     UnlockSimSystem ();
+
+    // Relay it to nearbyers without holding up the main thread
+    Relay ( pJob );
+    m_llRelaySyncThreadTimeUs += GetTimeUs () - startTime;
     return true;
 }
 
@@ -278,6 +355,9 @@ bool CSimPlayerManager::HandleVehiclePureSync ( const NetServerPlayerID& Socket,
     if ( !CNetBufferWatchDog::CanSendPacket ( PACKET_ID_PLAYER_VEHICLE_PURESYNC ) )
         return true;
 
+    TIMEUS startTime = GetTimeUs ();
+    SSimRelayJob* pJob = NULL;
+
     LockSimSystem ();     // Prevent player additions and deletions
 
     // Grab the source player
@@ -300,14 +380,18 @@ bool CSimPlayerManager::HandleVehiclePureSync ( const NetServerPlayerID& Socket,
                                                                              pSourceSimPlayer->m_VehicleDamageInfo );
         if ( pPacket->Read ( *BitStream ) )
         {
-            // Relay it to nearbyers
-            Broadcast ( *pPacket, pSourceSimPlayer->GetPuresyncSendList () );
+            // Take the send list while the source player can't change
+            pJob = MakeRelayJob ( pPacket, pSourceSimPlayer->m_pPuresyncSendList );
         }
-
-        delete pPacket;
+        else
+            delete pPacket;
     }
 
     UnlockSimSystem ();
+
+    // Relay it to nearbyers without holding up the main thread
+    Relay ( pJob );
+    m_llRelaySyncThreadTimeUs += GetTimeUs () - startTime;
     return true;
 }
 
@@ -325,6 +409,9 @@ bool CSimPlayerManager::HandleKeySync ( const NetServerPlayerID& Socket, NetBitS
     if ( !CNetBufferWatchDog::CanSendPacket ( PACKET_ID_PLAYER_KEYSYNC ) )
         return true;
 
+    TIMEUS startTime = GetTimeUs ();
+    SSimRelayJob* pJob = NULL;
+
     LockSimSystem ();     // Prevent player additions and deletions
 
     // Grab the source player
@@ -345,14 +432,18 @@ bool CSimPlayerManager::HandleKeySync ( const NetServerPlayerID& Socket, NetBitS
 
         if ( pPacket->Read ( *BitStream ) )
         {
-            // Relay it to nearbyers
-            Broadcast ( *pPacket, pSourceSimPlayer->GetPuresyncSendList () );
+            // Take the send list while the source player can't change
+            pJob = MakeRelayJob ( pPacket, pSourceSimPlayer->m_pPuresyncSendList );
         }
-
-        delete pPacket;
+        else
+            delete pPacket;
     }
 
     UnlockSimSystem ();
+
+    // Relay it to nearbyers without holding up the main thread
+    Relay ( pJob );
+    m_llRelaySyncThreadTimeUs += GetTimeUs () - startTime;
     return true;
 }
 
@@ -370,6 +461,9 @@ bool CSimPlayerManager::HandleBulletSync ( const NetServerPlayerID& Socket, NetB
     if ( !CNetBufferWatchDog::CanSendPacket ( PACKET_ID_PLAYER_BULLETSYNC ) )
         return true;
 
+    TIMEUS startTime = GetTimeUs ();
+    SSimRelayJob* pJob = NULL;
+
     LockSimSystem ();     // Prevent player additions and deletions
 
     // Grab the source player
@@ -383,14 +477,18 @@ bool CSimPlayerManager::HandleBulletSync ( const NetServerPlayerID& Socket, NetB
 
         if ( pPacket->Read ( *BitStream ) )
         {
-            // Relay it to nearbyers
-            Broadcast ( *pPacket, pSourceSimPlayer->GetPuresyncSendList () );
+            // Take the send list while the source player can't change
+            pJob = MakeRelayJob ( pPacket, pSourceSimPlayer->m_pPuresyncSendList );
         }
-
-        delete pPacket;
+        else
+            delete pPacket;
     }
 
     UnlockSimSystem ();
+
+    // Relay it to nearbyers without holding up the main thread
+    Relay ( pJob );
+    m_llRelaySyncThreadTimeUs += GetTimeUs () - startTime;
     return true;
 }
 
@@ -408,6 +506,9 @@ bool CSimPlayerManager::HandlePedTaskPacket ( const NetServerPlayerID& Socket, N
     if ( !CNetBufferWatchDog::CanSendPacket ( PACKET_ID_PED_TASK ) )
         return true;
 
+    TIMEUS startTime = GetTimeUs ();
+    SSimRelayJob* pJob = NULL;
+
     LockSimSystem ();     // Prevent player additions and deletions
 
     // Grab the source player
@@ -421,14 +522,18 @@ bool CSimPlayerManager::HandlePedTaskPacket ( const NetServerPlayerID& Socket, N
 
         if ( pPacket->Read ( *BitStream ) )
         {
-            // Relay it to nearbyers
-            Broadcast ( *pPacket, pSourceSimPlayer->GetPuresyncSendList () );
+            // Take the send list while the source player can't change
+            pJob = MakeRelayJob ( pPacket, pSourceSimPlayer->m_pPuresyncSendList );
         }
-
-        delete pPacket;
+        else
+            delete pPacket;
     }
 
     UnlockSimSystem ();
+
+    // Relay it to nearbyers without holding up the main thread
+    Relay ( pJob );
+    m_llRelaySyncThreadTimeUs += GetTimeUs () - startTime;
     return true;
 }
 
@@ -452,25 +557,50 @@ CSimPlayer* CSimPlayerManager::Get ( const NetServerPlayerID& PlayerSocket )
 
 ///////////////////////////////////////////////////////////////////////////
 //
-// CSimPlayerManager::Broadcast
+// CSimPlayerManager::GetSocketList
+//
+// Thread:              sync
+// CS should be locked: no
+//
+// Get the sockets of all sim players
+//
+///////////////////////////////////////////////////////////////////////////
+void CSimPlayerManager::GetSocketList ( std::vector < NetServerPlayerID >& outSocketList )
+{
+    LockSimSystem ();     // Prevent player additions and deletions
+
+    outSocketList.clear ();
+    for ( std::map < NetServerPlayerID, CSimPlayer* > ::const_iterator iter = m_SocketSimMap.begin () ; iter != m_SocketSimMap.end () ; ++iter )
+        outSocketList.push_back ( iter->first );
+
+    UnlockSimSystem ();
+}
+
+
+///////////////////////////////////////////////////////////////////////////
+//
+// CSimPlayerManager::MakeRelayJob
 //
 // Thread:              sync
 // CS should be locked: yes
 //
-// Send one packet to a list of players
+// Wrap a packet which has been read, ready for encoding. Takes ownership of pPacket.
+// Returns NULL if there is nothing to send.
 //
 ///////////////////////////////////////////////////////////////////////////
-void CSimPlayerManager::Broadcast ( const CSimPacket& Packet, const std::multimap < ushort, CSimPlayer* >& groupMap )
+SSimRelayJob* CSimPlayerManager::MakeRelayJob ( CSimPacket* pPacket, const CSimSendListPtr& pSendList )
 {
     dassert ( m_bIsLocked );
 
-    if ( !CNetBufferWatchDog::CanSendPacket ( Packet.GetPacketID () ) )
-        return;
-
+    if ( !pSendList || pSendList->empty () || !CNetBufferWatchDog::CanSendPacket ( pPacket->GetPacketID () ) )
+    {
+        delete pPacket;
+        return NULL;
+    }
 
     // Use the flags to determine how to send it
     NetServerPacketReliability Reliability;
-    unsigned long ulFlags = Packet.GetFlags ();
+    unsigned long ulFlags = pPacket->GetFlags ();
     if ( ulFlags & PACKET_RELIABLE )
     {
         if ( ulFlags & PACKET_SEQUENCED )
@@ -503,63 +633,120 @@ void CSimPlayerManager::Broadcast ( const CSimPacket& Packet, const std::multima
         packetPriority = PACKET_PRIORITY_LOW;
     }
 
-    // For each bitstream version, make and send a packet
-    typedef std::multimap < ushort, CSimPlayer* > ::const_iterator mapIter;
-    mapIter m_it, s_it;
-    for ( m_it = groupMap.begin () ; m_it != groupMap.end () ; m_it = s_it )
-    {
-        ushort usBitStreamVersion = (*m_it).first;
+    SSimRelayJob* pJob = new SSimRelayJob ();
+    pJob->pPacket = pPacket;
+    pJob->pSendList = pSendList;
+    pJob->packetID = pPacket->GetPacketID ();
+    pJob->packetOrdering = pPacket->GetPacketOrdering ();
+    pJob->packetPriority = packetPriority;
+    pJob->packetReliability = Reliability;
+    m_uiRelayPacketCount++;
+    return pJob;
+}
 
-        // Allocate a bitstream
-        NetBitStreamInterface* pBitStream = g_pRealNetServer->AllocateNetServerBitStream ( usBitStreamVersion );
 
-        // Write the content
-        if ( Packet.Write ( *pBitStream ) )
-        {
-            // For each player, send the packet
-            const pair < mapIter , mapIter > keyRange = groupMap.equal_range ( usBitStreamVersion );
-            for ( s_it = keyRange.first ; s_it != keyRange.second ; ++s_it )
-            {
-                CSimPlayer* pPlayer = s_it->second;
-                dassert ( usBitStreamVersion == pPlayer->GetBitStreamVersion () );
-                g_pRealNetServer->SendPacket ( Packet.GetPacketID (), pPlayer->GetSocket (), pBitStream, FALSE, packetPriority, Reliability, Packet.GetPacketOrdering() );
-            }
-        }
-        else
+///////////////////////////////////////////////////////////////////////////
+//
+// CSimPlayerManager::Relay
+//
+// Thread:              sync
+// CS should be locked: no
+//
+// Encode and send a job from MakeRelayJob
+//
+///////////////////////////////////////////////////////////////////////////
+void CSimPlayerManager::Relay ( SSimRelayJob* pJob )
+{
+    if ( !pJob )
+        return;
+
+    TIMEUS startTime = GetTimeUs ();
+    EncodeRelay ( pJob );
+    m_llRelayEncodeTimeUs += GetTimeUs () - startTime;
+    SendRelay ( pJob );
+}
+
+
+///////////////////////////////////////////////////////////////////////////
+//
+// CSimPlayerManager::EncodeRelay
+//
+// Thread:              sync
+// CS should be locked: no
+//
+// Write one packet for each bitstream version in the send list.
+// Only uses the job, so the sim lock is not needed.
+//
+///////////////////////////////////////////////////////////////////////////
+void CSimPlayerManager::EncodeRelay ( SSimRelayJob* pJob )
+{
+    const CSimSendList& sendList = *pJob->pSendList;
+    pJob->bitStreamList.reserve ( sendList.size () );
+
+    // For each bitstream version, make a packet
+    for ( CSimSendList::const_iterator iter = sendList.begin () ; iter != sendList.end () ; ++iter )
+    {
+        NetBitStreamInterface* pBitStream = g_pRealNetServer->AllocateNetServerBitStream ( iter->usBitStreamVersion );
+        if ( !pJob->pPacket->Write ( *pBitStream ) )
         {
             // Skip
-            const pair < mapIter , mapIter > keyRange = groupMap.equal_range ( usBitStreamVersion );
-            for ( s_it = keyRange.first ; s_it != keyRange.second ; ++s_it )
-            {}
+            g_pRealNetServer->DeallocateNetServerBitStream ( pBitStream );
+            pBitStream = NULL;
         }
-
-        // Destroy the bitstream
-        g_pRealNetServer->DeallocateNetServerBitStream ( pBitStream );
+        pJob->bitStreamList.push_back ( pBitStream );
     }
+
+    // Packet is not needed after encoding
+    SAFE_DELETE ( pJob->pPacket );
 }
 
 
 ///////////////////////////////////////////////////////////////////////////
 //
-// CSimPlayer::GetPuresyncSendList
+// CSimPlayerManager::SendRelay
+//
+// Thread:              sync
+// CS should be locked: no
 //
-// Returns list of players, grouped by bitstream version
+// Send the packets from EncodeRelay to each player in the send list, then free the job
 //
 ///////////////////////////////////////////////////////////////////////////
-const std::multimap < ushort, CSimPlayer* >& CSimPlayer::GetPuresyncSendList ( void )
+void CSimPlayerManager::SendRelay ( SSimRelayJob* pJob )
 {
-    if ( m_bSendListChanged )
+    const CSimSendList& sendList = *pJob->pSendList;
+    for ( uint i = 0 ; i < pJob->bitStreamList.size () ; i++ )
     {
-        m_bSendListChanged = false;
-        // Group players by bitstream version
-        m_PuresyncSendListGrouped.clear();
-        for ( std::vector < CSimPlayer* >::const_iterator iter = m_PuresyncSendListFlat.begin () ; iter != m_PuresyncSendListFlat.end () ; ++iter )
-        {
-            CSimPlayer* pPlayer = *iter;
-            MapInsert ( m_PuresyncSendListGrouped, pPlayer->GetBitStreamVersion (), pPlayer );
-        }
+        NetBitStreamInterface* pBitStream = pJob->bitStreamList[i];
+        if ( !pBitStream )
+            continue;
+
+        // For each player, send the packet
+        const std::vector < NetServerPlayerID >& socketList = sendList[i].socketList;
+        for ( uint s = 0 ; s < socketList.size () ; s++ )
+            g_pRealNetServer->SendPacket ( pJob->packetID, socketList[s], pBitStream, FALSE, pJob->packetPriority, pJob->packetReliability, pJob->packetOrdering );
+        m_uiRelaySendCount += socketList.size ();
     }
 
-    dassert( m_PuresyncSendListFlat.size() == m_PuresyncSendListGrouped.size() );
-    return m_PuresyncSendListGrouped;
+    FreeRelay ( pJob );
+}
+
+
+///////////////////////////////////////////////////////////////////////////
+//
+// CSimPlayerManager::FreeRelay
+//
+// Thread:              sync
+// CS should be locked: no
+//
+// Destroy the job and anything it still owns
+//
+///////////////////////////////////////////////////////////////////////////
+void CSimPlayerManager::FreeRelay ( SSimRelayJob* pJob )
+{
+    for ( uint i = 0 ; i < pJob->bitStreamList.size () ; i++ )
+        if ( pJob->bitStreamList[i] )
+            g_pRealNetServer->DeallocateNetServerBitStream ( pJob->bitStreamList[i] );
+
+    SAFE_DELETE ( pJob->pPacket );
+    delete pJob;
 }
@@ -7,6 +7,21 @@
 *
 *****************************************************************************/
 
+//
+// One relayed packet. Read on the sync thread while the sim lock is held,
+// then encoded and sent after it is released.
+//
+struct SSimRelayJob
+{
+    CSimPacket*                             pPacket;
+    CSimSendListPtr                         pSendList;
+    std::vector < NetBitStreamInterface* >  bitStreamList;      // One for each send group, NULL if Write failed
+    ePacketID                               packetID;
+    ePacketOrdering                         packetOrdering;
+    NetServerPacketPriority                 packetPriority;
+    NetServerPacketReliability              packetReliability;
+};
+
 
 class CSimPlayerManager
 {
@@ -21,6 +36,7 @@ public:
     // Any thread methods
     void            LockSimSystem           ( void );
     void            UnlockSimSystem         ( void );
+    SString         GetRelayStatus          ( void );
 
     // Sync thread methods
     bool            HandlePlayerPureSync    ( const NetServerPlayerID& Socket, NetBitStreamInterface* BitStream );
@@ -29,13 +45,27 @@ public:
     bool            HandleBulletSync        ( const NetServerPlayerID& Socket, NetBitStreamInterface* BitStream );
     bool            HandlePedTaskPacket     ( const NetServerPlayerID& Socket, NetBitStreamInterface* BitStream );
     CSimPlayer*     Get                     ( const NetServerPlayerID& PlayerSocket );
-    void            Broadcast               ( const CSimPacket& Packet, const std::multimap < ushort, CSimPlayer* >& sendList );
+    void            GetSocketList           ( std::vector < NetServerPlayerID >& outSocketList );
+    SSimRelayJob*   MakeRelayJob            ( CSimPacket* pPacket, const CSimSendListPtr& pSendList );
+    void            Relay                   ( SSimRelayJob* pJob );
+    void            EncodeRelay             ( SSimRelayJob* pJob );
+    void            SendRelay               ( SSimRelayJob* pJob );
+    void            FreeRelay               ( SSimRelayJob* pJob );
 
 protected:
+    // Main thread methods
+    void            RebuildSendList         ( CSimPlayer* pSim );
+
     // Shared variables
     bool                                        m_bIsLocked;
     CCriticalSection                            m_CS;
     std::set < CSimPlayer* >                    m_AllSimPlayerMap;
     std::map < NetServerPlayerID, CSimPlayer* > m_SocketSimMap;
-};
 
+    // Relay stats
+    std::atomic < uint >                        m_uiRelayPacketCount;
+    std::atomic < uint >                        m_uiRelaySendCount;
+    std::atomic < long long >                   m_llRelaySyncThreadTimeUs;  // Reading, encoding and sending
+    std::atomic < long long >                   m_llRelayEncodeTimeUs;
+    CElapsedTime                                m_RelayStatusTimer;
+};
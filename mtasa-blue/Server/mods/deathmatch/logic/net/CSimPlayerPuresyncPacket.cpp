@@ -183,6 +183,9 @@ bool CSimPlayerPuresyncPacket::Read ( NetBitStreamInterface& BitStream )
         m_Cache.usTotalAmmo = 1;
     }
 
+    // Keep a copy for Write, as the shared state can change before the relay is encoded
+    m_Cache.ControllerState = m_sharedControllerState;
+
     // Success
     return true;
 }
@@ -199,7 +202,7 @@ bool CSimPlayerPuresyncPacket::Write ( NetBitStreamInterface& BitStream ) const
     BitStream.Write ( m_Cache.ucTimeContext );
 
     BitStream.WriteCompressed ( m_PlayerLatency );
-    WriteFullKeysync ( m_sharedControllerState, BitStream );
+    WriteFullKeysync ( m_Cache.ControllerState, BitStream );
 
     BitStream.Write ( &m_Cache.flags );
 
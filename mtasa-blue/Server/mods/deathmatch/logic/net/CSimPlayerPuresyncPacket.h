@@ -87,6 +87,8 @@ public:
         float           fAimDirection;      // Only valid if bWeaponCorrect
         CVector         vecSniperSource;  // Only valid if bWeaponCorrect and bIsAimFull
         CVector         vecTargetting;    // Only valid if bWeaponCorrect and bIsAimFull
+
+        CControllerState    ControllerState;        // Copy of m_sharedControllerState for Write
     } m_Cache;
 
 };
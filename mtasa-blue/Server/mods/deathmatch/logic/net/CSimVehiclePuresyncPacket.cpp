@@ -258,6 +258,9 @@ bool CSimVehiclePuresyncPacket::Read ( NetBitStreamInterface& BitStream )
             m_sharedControllerState.RightShoulder2 = BitStream.ReadBit () * 255;
         }
 
+        // Keep a copy for Write, as the shared state can change before the relay is encoded
+        m_Cache.ControllerState = m_sharedControllerState;
+
         // Success
         return true;
     }
@@ -284,7 +287,7 @@ bool CSimVehiclePuresyncPacket::Write ( NetBitStreamInterface& BitStream ) const
         BitStream.WriteCompressed ( m_usPlayerLatency );
 
         // Write the keysync data
-        WriteFullKeysync ( m_sharedControllerState, BitStream );
+        WriteFullKeysync ( m_Cache.ControllerState, BitStream );
 
         // Write the serverside model (#8800)
         if ( BitStream.Version ( ) >= 0x05F )
@@ -409,8 +412,8 @@ bool CSimVehiclePuresyncPacket::Write ( NetBitStreamInterface& BitStream ) const
         // it's an aircraft.
         if ( m_Cache.flags.data.bIsAircraft )
         {
-            BitStream.WriteBit ( m_sharedControllerState.LeftShoulder2 != 0 );
-            BitStream.WriteBit ( m_sharedControllerState.RightShoulder2 != 0 );
+            BitStream.WriteBit ( m_Cache.ControllerState.LeftShoulder2 != 0 );
+            BitStream.WriteBit ( m_Cache.ControllerState.RightShoulder2 != 0 );
         }
 
         // Write parts state
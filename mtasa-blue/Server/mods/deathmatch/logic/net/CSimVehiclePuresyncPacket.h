@@ -62,7 +62,7 @@ private:
     const float     m_fPlayerGotWeaponRange;
     CControllerState& m_sharedControllerState;
     const uint      m_uiDamageInfoSendPhase;
-    const SSimVehicleDamageInfo& m_DamageInfo;
+    const SSimVehicleDamageInfo m_DamageInfo;      // Copy, as the relay can be encoded after the lock is released
 
     // Set in Read()
     struct
@@ -109,6 +109,8 @@ private:
         float           fRailSpeed;
 
         SFixedArray < float, 4 >    fDoorOpenRatio;
+
+        CControllerState    ControllerState;        // Copy of m_sharedControllerState for Write
     } m_Cache;
 };
 
@@ -11,6 +11,7 @@ class CSimPacket;
 class CSimPlayerManager;
 
 #include "SharedUtil.Thread.h"
+#include "CSPSCQueue.h"
 #include "CNetBufferWatchDog.h"
 #include "CNetBuffer.h"
 #include "CSimPlayer.h"
@@ -20,5 +21,8 @@ class CSimPlayerManager;
 #include "CSimKeysyncPacket.h"
 #include "CSimBulletsyncPacket.h"
 #include "CSimPedTaskPacket.h"
+#include "CNetServerPassThrough.h"
+#include "CSimClientNetServer.h"
+#include "CReplayNetServer.h"
 
 extern CNetServer* g_pRealNetServer;
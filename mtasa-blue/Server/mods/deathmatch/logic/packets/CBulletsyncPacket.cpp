@@ -50,6 +50,15 @@ bool CBulletsyncPacket::Read ( NetBitStreamInterface& BitStream )
 }
 
 
+// Damage is optional in Read, so make sure it does not carry over from the previous use
+void CBulletsyncPacket::Recycle ( void )
+{
+    m_fDamage = 0;
+    m_ucHitZone = 0;
+    m_DamagedPlayerID = INVALID_ELEMENT_ID;
+}
+
+
 // Note: Relays a previous Read()
 bool CBulletsyncPacket::Write ( NetBitStreamInterface& BitStream ) const
 {
@@ -21,6 +21,7 @@ public:
 
     bool                                    Read                        ( NetBitStreamInterface& BitStream );
     bool                                    Write                       ( NetBitStreamInterface& BitStream ) const;
+    void                                    Recycle                     ( void );
 
     eWeaponType             m_WeaponType;
     CVector                 m_vecStart;
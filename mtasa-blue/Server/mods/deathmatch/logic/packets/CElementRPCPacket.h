@@ -30,6 +30,9 @@ public:
 
     bool                            Write               ( NetBitStreamInterface& BitStream ) const;
 
+    unsigned char                   GetActionID         ( void ) const  { return m_ucActionID; }
+    CElement*                       GetSourceElement    ( void ) const  { return m_pSourceElement; }
+
 private:
     unsigned char                   m_ucActionID;
     NetBitStreamInterface&          m_BitStream;
@@ -47,6 +47,33 @@ void SilentlyFixIndeterminate( CVector2D& vecValue )
 }
 
 
+//
+// Get the cache for the element's encoded data, or NULL if it should not be cached.
+// Only static objects are cached. They make up most of a big map and everything sent for them is changed through setters.
+//
+static CBitStreamFragment* GetEntityAddFragment ( CElement* pElement )
+{
+    if ( pElement->GetType () != CElement::OBJECT )
+        return NULL;
+
+    CObject* pObject = static_cast < CObject* > ( pElement );
+    if ( pObject->GetAttachedToElement () || pObject->IsMoving () )
+        return NULL;
+
+    // Element references in the custom data can become invalid without the revision changing
+    CCustomData* pCustomData = pElement->GetCustomDataPointer ();
+    map < string, SCustomData > :: const_iterator iter = pCustomData->SyncedIterBegin ();
+    for ( ; iter != pCustomData->SyncedIterEnd (); ++iter )
+    {
+        int iType = iter->second.Variable.GetType ();
+        if ( iType == LUA_TLIGHTUSERDATA || iType == LUA_TUSERDATA || iType == LUA_TTABLE )
+            return NULL;
+    }
+
+    return &pObject->GetEntityAddFragment ();
+}
+
+
 void CEntityAddPacket::Add ( CElement * pElement )
 {
     // Only add it if it has a parent.
@@ -89,8 +116,19 @@ bool CEntityAddPacket::Write ( NetBitStreamInterface& BitStream ) const
         vector < CElement* > ::const_iterator iter = m_Entities.begin ();
         for ( ; iter != m_Entities.end (); ++iter )
         {
-            // Entity id
             CElement* pElement = *iter;
+
+            // Reuse the data from an earlier packet if nothing has changed since
+            CBitStreamFragment* pFragment = GetEntityAddFragment ( pElement );
+            uint uiSyncRevision = pElement->GetSyncRevision ();
+            if ( pFragment && pFragment->IsValid ( uiSyncRevision, BitStream.Version () ) )
+            {
+                pFragment->Write ( BitStream );
+                continue;
+            }
+            uint uiStartBit = BitStream.GetNumberOfBitsUsed ();
+
+            // Entity id
             BitStream.Write ( pElement->GetID () );
 
             // Entity type id
@@ -1067,6 +1105,10 @@ bool CEntityAddPacket::Write ( NetBitStreamInterface& BitStream ) const
                     CLogger::LogPrintf ( "not sending this element - id: %i\n", pElement->GetType () );
                 }
             }
+
+            // Keep a copy for next time
+            if ( pFragment )
+                pFragment->Capture ( uiSyncRevision, BitStream, uiStartBit );
         }
 
         // Success
@@ -21,8 +21,6 @@ bool CLightsyncPacket::Read ( NetBitStreamInterface& BitStream )
 
 bool CLightsyncPacket::Write ( NetBitStreamInterface& BitStream ) const 
 {
-    bool bSyncPosition;
-
     if ( Count() == 0 )
         return false;
 
@@ -30,53 +28,83 @@ bool CLightsyncPacket::Write ( NetBitStreamInterface& BitStream ) const
           iter != m_players.end();
           ++iter )
     {
-        CPlayer* pPlayer = *iter;
-        CPlayer::SLightweightSyncData& data = pPlayer->GetLightweightSyncData ();
-        CVehicle* pVehicle = pPlayer->GetOccupiedVehicle ();
-
-        // Find the difference between now and the time the position last changed for the player
-        long long llTicksDifference = GetTickCount64_ ( ) - pPlayer->GetPositionLastChanged ( );
+        if ( m_uiFragmentContext )
+            WriteFragment ( *iter, m_uiFragmentContext, BitStream );
+        else
+            WritePlayer ( *iter, BitStream );
+    }
 
-        // Right we need to sync the position if there is no vehicle or he's in a vehicle and the difference between setPosition is less than or equal to the slow sync rate
-        // i.e. make sure his position has been updated more than 0.001f in the last 1500ms plus a small margin for error (probably not needed).
-        // This will ensure we only send positions when the position has changed.
-        bSyncPosition = ( !pVehicle || pPlayer->GetOccupiedVehicleSeat () == 0 ) && llTicksDifference <= g_TickRateSettings.iLightSync + 100;
+    return true;
+}
 
-        BitStream.Write ( pPlayer->GetID () );
-        BitStream.Write ( (unsigned char)pPlayer->GetSyncTimeContext () );
 
-        unsigned short usLatency = pPlayer->GetPing ();
-        BitStream.WriteCompressed ( usLatency );
+// Copy the player's record from the fragment made during this lightsync pulse, making it first if needed
+void CLightsyncPacket::WriteFragment ( CPlayer* pPlayer, unsigned int uiFragmentContext, NetBitStreamInterface& BitStream )
+{
+    CPlayer::SLightweightSyncData& data = pPlayer->GetLightweightSyncData ();
 
-        BitStream.WriteBit ( data.health.bSync );
-        if ( data.health.bSync )
+    if ( !data.fragment.IsValid ( uiFragmentContext, BitStream.Version () ) )
+    {
+        NetBitStreamInterface* pFragmentStream = g_pNetServer->AllocateNetServerBitStream ( BitStream.Version () );
+        if ( !pFragmentStream )
         {
-            SPlayerHealthSync health;
-            health.data.fValue = pPlayer->GetHealth ();
-            BitStream.Write ( &health );
-
-            SPlayerArmorSync armor;
-            armor.data.fValue = pPlayer->GetArmor ();
-            BitStream.Write ( &armor );
+            WritePlayer ( pPlayer, BitStream );
+            return;
         }
+        WritePlayer ( pPlayer, *pFragmentStream );
+        data.fragment.Capture ( uiFragmentContext, *pFragmentStream, 0 );
+        g_pNetServer->DeallocateNetServerBitStream ( pFragmentStream );
+    }
+
+    data.fragment.Write ( BitStream );
+}
+
+
+void CLightsyncPacket::WritePlayer ( CPlayer* pPlayer, NetBitStreamInterface& BitStream )
+{
+    CPlayer::SLightweightSyncData& data = pPlayer->GetLightweightSyncData ();
+    CVehicle* pVehicle = pPlayer->GetOccupiedVehicle ();
+
+    // Find the difference between now and the time the position last changed for the player
+    long long llTicksDifference = GetTickCount64_ ( ) - pPlayer->GetPositionLastChanged ( );
+
+    // Right we need to sync the position if there is no vehicle or he's in a vehicle and the difference between setPosition is less than or equal to the slow sync rate
+    // i.e. make sure his position has been updated more than 0.001f in the last 1500ms plus a small margin for error (probably not needed).
+    // This will ensure we only send positions when the position has changed.
+    bool bSyncPosition = ( !pVehicle || pPlayer->GetOccupiedVehicleSeat () == 0 ) && llTicksDifference <= g_TickRateSettings.iLightSync + 100;
+
+    BitStream.Write ( pPlayer->GetID () );
+    BitStream.Write ( (unsigned char)pPlayer->GetSyncTimeContext () );
+
+    unsigned short usLatency = pPlayer->GetPing ();
+    BitStream.WriteCompressed ( usLatency );
+
+    BitStream.WriteBit ( data.health.bSync );
+    if ( data.health.bSync )
+    {
+        SPlayerHealthSync health;
+        health.data.fValue = pPlayer->GetHealth ();
+        BitStream.Write ( &health );
 
-        BitStream.WriteBit ( bSyncPosition );
-        if ( bSyncPosition )
+        SPlayerArmorSync armor;
+        armor.data.fValue = pPlayer->GetArmor ();
+        BitStream.Write ( &armor );
+    }
+
+    BitStream.WriteBit ( bSyncPosition );
+    if ( bSyncPosition )
+    {
+        SLowPrecisionPositionSync pos;
+        pos.data.vecPosition = pPlayer->GetPosition ();
+        BitStream.Write ( &pos );
+
+        bool bSyncVehicleHealth = data.vehicleHealth.bSync && pVehicle;
+        BitStream.WriteBit ( bSyncVehicleHealth );
+        if ( bSyncVehicleHealth )
         {
-            SLowPrecisionPositionSync pos;
-            pos.data.vecPosition = pPlayer->GetPosition ();
-            BitStream.Write ( &pos );
-
-            bool bSyncVehicleHealth = data.vehicleHealth.bSync && pVehicle;
-            BitStream.WriteBit ( bSyncVehicleHealth );
-            if ( bSyncVehicleHealth )
-            {
-                SLowPrecisionVehicleHealthSync health;
-                health.data.fValue = pVehicle->GetHealth ();
-                BitStream.Write ( &health );
-            }
+            SLowPrecisionVehicleHealthSync health;
+            health.data.fValue = pVehicle->GetHealth ();
+            BitStream.Write ( &health );
         }
     }
-
-    return true;
 }
@@ -21,7 +21,7 @@
 class CLightsyncPacket : public CPacket
 {
 public:
-                                CLightsyncPacket            () {}
+                                CLightsyncPacket            ( unsigned int uiFragmentContext = 0 ) : m_uiFragmentContext ( uiFragmentContext ) {}
 
     inline ePacketID                GetPacketID                 ( void ) const                  { return PACKET_ID_LIGHTSYNC; };
     inline unsigned long            GetFlags                    ( void ) const                  { return PACKET_LOW_PRIORITY; };
@@ -34,6 +34,10 @@ public:
     bool                        Write                       ( NetBitStreamInterface& BitStream ) const;
 
 private:
+    static void                 WritePlayer                 ( CPlayer* pPlayer, NetBitStreamInterface& BitStream );
+    static void                 WriteFragment               ( CPlayer* pPlayer, unsigned int uiFragmentContext, NetBitStreamInterface& BitStream );
+
     std::vector < CPlayer* >    m_players;
+    unsigned int                m_uiFragmentContext;    // Non zero to share each player's encoded record between packets
 };
 
@@ -13,6 +13,12 @@
 #include "StdInc.h"
 
 CObjectSyncPacket::~CObjectSyncPacket ( void )
+{
+    Recycle ();
+}
+
+
+void CObjectSyncPacket::Recycle ( void )
 {
     vector < SyncData* > ::const_iterator iter = m_Syncs.begin ();
     for ( ; iter != m_Syncs.end (); ++iter )
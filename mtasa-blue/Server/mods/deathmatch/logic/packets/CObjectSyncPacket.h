@@ -39,6 +39,7 @@ public:
 
     bool                    Read                                    ( NetBitStreamInterface& BitStream );
     bool                    Write                                   ( NetBitStreamInterface& BitStream ) const;
+    void                    Recycle                                 ( void );
 
     inline std::vector < SyncData* > ::const_iterator     IterBegin ( void )                        { return m_Syncs.begin (); };
     inline std::vector < SyncData* > ::const_iterator     IterEnd   ( void )                        { return m_Syncs.end (); };
@@ -48,6 +48,7 @@ public:
 
     virtual bool                        Read                ( NetBitStreamInterface& BitStream )                { return false; };
     virtual bool                        Write               ( NetBitStreamInterface& BitStream ) const          { return false; };
+    virtual void                        Recycle             ( void )                                            {};     // Clear state left by Read before a pooled packet is reused
 
     inline void                         SetSourceElement    ( CElement* pSource )                               { m_pSourceElement = pSource; };
     inline CElement*                    GetSourceElement    ( void ) const                                      { return m_pSourceElement; };
@@ -13,6 +13,12 @@
 #include "StdInc.h"
 
 CPedSyncPacket::~CPedSyncPacket ( void )
+{
+    Recycle ();
+}
+
+
+void CPedSyncPacket::Recycle ( void )
 {
     vector < SyncData* > ::const_iterator iter = m_Syncs.begin ();
     for ( ; iter != m_Syncs.end (); ++iter )
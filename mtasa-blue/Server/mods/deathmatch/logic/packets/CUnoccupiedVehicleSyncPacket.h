@@ -37,6 +37,7 @@ public:
 
     bool                    Read                                    ( NetBitStreamInterface& BitStream );
     bool                    Write                                   ( NetBitStreamInterface& BitStream ) const;
+    void                    Recycle                                 ( void )                        { m_Syncs.clear (); };
 
     inline std::vector < SyncData > ::iterator          IterBegin       ( void )                        { return m_Syncs.begin (); };
     inline std::vector < SyncData > ::iterator          IterEnd         ( void )                        { return m_Syncs.end (); };
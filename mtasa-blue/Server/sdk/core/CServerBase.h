@@ -27,6 +27,7 @@ public:
 
     virtual bool        IsFinished                  ( void ) = 0;
     virtual bool        PendingWorkToDo             ( void ) = 0;
+    virtual void        WaitForPendingWork          ( unsigned int uiTimeoutMs ) = 0;
     virtual bool        GetSleepIntervals           ( int& iSleepBusyMs, int& iSleepIdleMs, int& iLogicFpsLimit ) = 0;
 };
 
@@ -121,28 +121,37 @@ void CLatentReceiver::OnReceive ( NetBitStreamInterface* pBitStream )
     //
     if ( bIsHead )
     {
-        // If head, check no previous transfer
-        if ( activeRx.bReceiveStarted )
+        // If head, check no previous transfer with this id
+        if ( MapContains ( m_ActiveRxMap, usId ) )
             return OnReceiveError ( "bIsHead && activeRx.bReceiveActive" );
-        if ( uiFinalSize > 100 * 1024 * 1024 )
+        if ( uiFinalSize > MAX_RECEIVE_SIZE )
             return OnReceiveError ( "uiFinalSize too large" );
-
-        activeRx.usId = usId;
-        activeRx.bReceiveStarted = true;
-        activeRx.usCategory = usCategory;
-        activeRx.uiRate = uiRate;
-        activeRx.usResourceNetId = usResourceNetId;
-        activeRx.buffer.SetSize ( uiFinalSize );
-        activeRx.uiWritePosition = 0;
+        if ( m_ActiveRxMap.size () >= MAX_RECEIVE_ITEMS )
+            return OnReceiveError ( "Too many transfers" );
+        if ( m_uiActiveRxSize + uiFinalSize > MAX_RECEIVE_SIZE_TOTAL )
+            return OnReceiveError ( "Total size too large" );
+
+        SReceiveItem& newRx = m_ActiveRxMap[ usId ];
+        newRx.usId = usId;
+        newRx.bReceiveStarted = true;
+        newRx.usCategory = usCategory;
+        newRx.uiRate = uiRate;
+        newRx.usResourceNetId = usResourceNetId;
+        newRx.buffer.SetSize ( uiFinalSize );
+        newRx.uiWritePosition = 0;
+        m_uiActiveRxSize += uiFinalSize;
     }
 
-    if ( activeRx.usId != usId )
+    SReceiveItem* pActiveRx = MapFind ( m_ActiveRxMap, usId );
+    if ( !pActiveRx )
         return OnReceiveError ( "usId wrong" );
+    SReceiveItem& activeRx = *pActiveRx;
 
     if ( bIsCancel )
     {
-        // Reset for next receive
-        activeRx = SReceiveItem ();
+        // Forget this receive
+        m_uiActiveRxSize -= activeRx.buffer.GetSize ();
+        MapRemove ( m_ActiveRxMap, usId );
         return;
     }
 
@@ -165,33 +174,39 @@ void CLatentReceiver::OnReceive ( NetBitStreamInterface* pBitStream )
     //
     if ( bIsTail )
     {
-        if ( activeRx.usCategory == CATEGORY_PACKET )
+        // Take the item out first as processing the packet could cause more receives
+        SReceiveItem finishedRx;
+        std::swap ( finishedRx, activeRx );
+        m_uiActiveRxSize -= finishedRx.buffer.GetSize ();
+        MapRemove ( m_ActiveRxMap, usId );
+
+        if ( finishedRx.usCategory == CATEGORY_PACKET )
         {
             // Recreate the packet data
             NetBitStreamInterface* pBitStream = DoAllocateNetBitStream ( m_RemoteId, m_usBitStreamVersion );
             uchar ucPacketId = 0;
             uint uiBitStreamBitsUsed = 0;
 
-            CBufferReadStream stream ( activeRx.buffer );
+            CBufferReadStream stream ( finishedRx.buffer );
             stream.Read ( ucPacketId );
             stream.Read ( uiBitStreamBitsUsed );
             uint uiBitStreamBytesUsed = ( uiBitStreamBitsUsed + 7 ) >> 3;
 
-            if ( uiBitStreamBytesUsed != activeRx.buffer.GetSize () - 5 )
+            if ( uiBitStreamBytesUsed != finishedRx.buffer.GetSize () - 5 )
+            {
+                DoDeallocateNetBitStream ( pBitStream );
                 return OnReceiveError ( "Buffer size mismatch" );
+            }
 
-            pBitStream->WriteBits ( activeRx.buffer.GetData () + 5, uiBitStreamBitsUsed );
+            pBitStream->WriteBits ( finishedRx.buffer.GetData () + 5, uiBitStreamBitsUsed );
             pBitStream->ResetReadPointer ();
 
-            DoStaticProcessPacket ( ucPacketId, m_RemoteId, pBitStream, activeRx.usResourceNetId );
+            DoStaticProcessPacket ( ucPacketId, m_RemoteId, pBitStream, finishedRx.usResourceNetId );
             DoDeallocateNetBitStream ( pBitStream );
         }
         else
         {
             OutputDebugLine ( "[Misc] CLatentReceiver::OnReceive - Unknown category" );
         }
-
-        // Reset for next receive
-        activeRx = SReceiveItem ();
     }
 }
@@ -22,6 +22,7 @@ CLatentSendQueue::CLatentSendQueue ( NetPlayerID remoteId, ushort usBitStreamVer
     : m_RemoteId ( remoteId )
     , m_usBitStreamVersion ( usBitStreamVersion )
 {
+    m_fCongestionScale = 1;
 }
 
 
@@ -41,7 +42,7 @@ CLatentSendQueue::~CLatentSendQueue ( void )
 //
 // CLatentSendQueue::DoPulse
 //
-// Send next part of the active transfer
+// Send next parts of the queued transfers
 //
 ///////////////////////////////////////////////////////////////
 void CLatentSendQueue::DoPulse ( int iTimeMsBetweenCalls )
@@ -52,28 +53,22 @@ void CLatentSendQueue::DoPulse ( int iTimeMsBetweenCalls )
         return;
     }
 
-    // Check if previous tx has completed
-    if ( m_TxQueue.front ().uiReadPosition == m_TxQueue.front ().bufferRef->GetSize () && m_TxQueue.front ().bSendFinishing )
-    {
-        m_TxQueue.pop_front ();
-        PostQueueRemove ();
-        if ( m_TxQueue.empty () )
-        {
-            m_iBytesOwing = 0;
-            return;
-        }
-    }
-
     m_uiCurrentRate = std::max < uint > ( MIN_SEND_RATE, m_uiCurrentRate );
 
+    // Rate after congestion and the global budget have had their say
+    uint uiRate = GetWantedRate ();
+    if ( m_uiRateLimit )
+        uiRate = std::min ( uiRate, m_uiRateLimit );
+    uiRate = std::max < uint > ( MIN_SEND_RATE, uiRate );
+
     // How many bytes to send this pulse
-    int iBytesToSendThisPulse = iTimeMsBetweenCalls * m_uiCurrentRate / 1000;
+    int iBytesToSendThisPulse = iTimeMsBetweenCalls * uiRate / 1000;
 
     // Add bytes owing from last pulse
     iBytesToSendThisPulse += m_iBytesOwing;
 
     // Calc packet size depending on rate
-    uint uiMaxPacketSize = Lerp ( MIN_PACKET_SIZE, UnlerpClamped ( MIN_PACKET_SIZE * 10, m_uiCurrentRate, MAX_PACKET_SIZE * 15 ), MAX_PACKET_SIZE );
+    uint uiMaxPacketSize = Lerp ( MIN_PACKET_SIZE, UnlerpClamped ( MIN_PACKET_SIZE * 10, uiRate, MAX_PACKET_SIZE * 15 ), MAX_PACKET_SIZE );
 
     // Calc how many packets to do this pulse
     uint uiNumPackets = iBytesToSendThisPulse / uiMaxPacketSize;
@@ -81,57 +76,267 @@ void CLatentSendQueue::DoPulse ( int iTimeMsBetweenCalls )
     // Update carry over
     m_iBytesOwing = iBytesToSendThisPulse % uiMaxPacketSize;
 
-    // Process item at front of queue
-    SSendItem& activeTx = m_TxQueue.front ();
-    for ( uint i = 0 ; i < uiNumPackets && !activeTx.bSendFinishing ; i++ )
+    for ( uint i = 0 ; i < uiNumPackets ; i++ )
     {
-        // Send next part of data    
-        NetBitStreamInterface* pBitStream = DoAllocateNetBitStream ( m_RemoteId, m_usBitStreamVersion );
-        pBitStream->WriteBits ( &activeTx.uiId, 15 );
+        CSendItemIter iter = SelectNextItem ( uiMaxPacketSize );
+        if ( iter == m_TxQueue.end () )
+            break;
 
-        // Next bit indicates if it has a special flag
-        if ( activeTx.uiReadPosition == 0 )
+        SendNextPart ( *iter, uiMaxPacketSize );
+
+        // Remove when the tail has gone
+        if ( iter->bSendFinishing )
         {
-            // Head
-            pBitStream->WriteBit ( 1 );
-            pBitStream->Write ( (uchar)FLAG_HEAD );
-            pBitStream->Write ( activeTx.usCategory );
-            pBitStream->Write ( activeTx.bufferRef->GetSize () );
-            pBitStream->Write ( activeTx.uiRate );
-            if ( pBitStream->Version () >= 0x31 )
-                pBitStream->Write ( activeTx.usResourceNetId );
-            activeTx.bSendStarted = true;
+            m_TxQueue.erase ( iter );
+            PostQueueRemove ();
         }
-        else
-        if ( activeTx.bufferRef->GetSize () == activeTx.uiReadPosition )
+    }
+}
+
+
+///////////////////////////////////////////////////////////////
+//
+// CLatentSendQueue::SelectNextItem
+//
+// Deficit round robin across the resources with queued items.
+// Each resource gets a quantum of bytes per turn, weighted by the rate its item asked for.
+// A resource whose next item cannot be started yet misses its turn.
+//
+///////////////////////////////////////////////////////////////
+CLatentSendQueue::CSendItemIter CLatentSendQueue::SelectNextItem ( uint uiPacketSize )
+{
+    // Older remotes can only receive one transfer at a time
+    if ( !CanInterleave () )
+    {
+        for ( CSendItemIter iter = m_TxQueue.begin () ; iter != m_TxQueue.end () ; ++iter )
+        {
+            if ( iter->bSendStarted )
+            {
+                ChargeFlow ( iter->usResourceNetId, uiPacketSize );
+                return iter;
+            }
+        }
+    }
+
+    uint uiNumBlocked = 0;
+    while ( !m_FlowList.empty () )
+    {
+        if ( m_uiFlowCursor >= m_FlowList.size () )
+            m_uiFlowCursor = 0;
+
+        SSendFlow& flow = m_FlowList[ m_uiFlowCursor ];
+        CSendItemIter iter = FindFlowItem ( flow.usResourceNetId );
+        if ( iter == m_TxQueue.end () )
         {
-            // Tail
-            pBitStream->WriteBit ( 1 );
-            pBitStream->Write ( (uchar)FLAG_TAIL );
-            activeTx.bSendFinishing = true;
+            // Nothing left from this resource
+            m_FlowList.erase ( m_FlowList.begin () + m_uiFlowCursor );
+            m_bFlowTurnStarted = false;
+            continue;
         }
-        else
+
+        if ( !iter->bSendStarted && !CanStartItem ( *iter ) )
         {
-            // Body
-            pBitStream->WriteBit ( 0 );
+            // Wait for the remote to finish some of the other transfers
+            if ( ++uiNumBlocked >= m_FlowList.size () )
+                break;
+            m_uiFlowCursor++;
+            m_bFlowTurnStarted = false;
+            continue;
         }
+        uiNumBlocked = 0;
 
-        // Align to next boundary
-        pBitStream->AlignWriteToByteBoundary ();
-        uint uiMaxDataSize = std::max < int > ( 10, uiMaxPacketSize - pBitStream->GetNumberOfBytesUsed () );
+        if ( !m_bFlowTurnStarted )
+        {
+            flow.iDeficit += GetFlowQuantum ( *iter, uiPacketSize );
+            m_bFlowTurnStarted = true;
+        }
 
-        // Calc how much data to send
-        uint uiDataOffset = activeTx.uiReadPosition;
-        uint uiSizeToSend = std::min( uiMaxDataSize, activeTx.bufferRef->GetSize () - activeTx.uiReadPosition );
-        activeTx.uiReadPosition += uiSizeToSend;
+        if ( flow.iDeficit >= (int)uiPacketSize )
+        {
+            flow.iDeficit -= uiPacketSize;
+            return iter;
+        }
 
-        pBitStream->Write ( (ushort)uiSizeToSend );
-        pBitStream->Write ( activeTx.bufferRef->GetData () + uiDataOffset, uiSizeToSend );
+        // Turn over
+        m_uiFlowCursor++;
+        m_bFlowTurnStarted = false;
+    }
 
-        // Send
-        DoSendPacket ( PACKET_ID_LATENT_TRANSFER, m_RemoteId, pBitStream, PACKET_PRIORITY_LOW, PACKET_RELIABILITY_RELIABLE_ORDERED, PACKET_ORDERING_DATA_TRANSFER );
-        DoDeallocateNetBitStream ( pBitStream );
+    return m_TxQueue.end ();
+}
+
+
+///////////////////////////////////////////////////////////////
+//
+// CLatentSendQueue::CanStartItem
+//
+// Check the remote will accept another transfer, using the same limits as CLatentReceiver.
+// An item can always start if nothing else is in progress.
+//
+///////////////////////////////////////////////////////////////
+bool CLatentSendQueue::CanStartItem ( const SSendItem& tx )
+{
+    uint uiNumStarted = 0;
+    uint uiStartedSize = 0;
+    for ( std::list < SSendItem >::iterator iter = m_TxQueue.begin () ; iter != m_TxQueue.end () ; ++iter )
+    {
+        if ( iter->bSendStarted )
+        {
+            uiNumStarted++;
+            uiStartedSize += iter->bufferRef->GetSize ();
+        }
     }
+
+    if ( uiNumStarted == 0 )
+        return true;
+
+    return uiNumStarted < MAX_RECEIVE_ITEMS && uiStartedSize + tx.bufferRef->GetSize () <= MAX_RECEIVE_SIZE_TOTAL;
+}
+
+
+///////////////////////////////////////////////////////////////
+//
+// CLatentSendQueue::FindFlowItem
+//
+// Oldest item from a resource
+//
+///////////////////////////////////////////////////////////////
+CLatentSendQueue::CSendItemIter CLatentSendQueue::FindFlowItem ( ushort usResourceNetId )
+{
+    for ( CSendItemIter iter = m_TxQueue.begin () ; iter != m_TxQueue.end () ; ++iter )
+        if ( iter->usResourceNetId == usResourceNetId )
+            return iter;
+    return m_TxQueue.end ();
+}
+
+
+///////////////////////////////////////////////////////////////
+//
+// CLatentSendQueue::ChargeFlow
+//
+// Take a packet sent outside of its turn from the resource deficit
+//
+///////////////////////////////////////////////////////////////
+void CLatentSendQueue::ChargeFlow ( ushort usResourceNetId, uint uiPacketSize )
+{
+    for ( uint i = 0 ; i < m_FlowList.size () ; i++ )
+    {
+        SSendFlow& flow = m_FlowList[i];
+        if ( flow.usResourceNetId == usResourceNetId )
+        {
+            // Limit the debt so the selection loop stays short
+            flow.iDeficit = std::max < int > ( flow.iDeficit - uiPacketSize, -MAX_FLOW_WEIGHT * MAX_PACKET_SIZE );
+            return;
+        }
+    }
+}
+
+
+///////////////////////////////////////////////////////////////
+//
+// CLatentSendQueue::GetFlowQuantum
+//
+// Bytes a resource can send in one turn
+//
+///////////////////////////////////////////////////////////////
+int CLatentSendQueue::GetFlowQuantum ( const SSendItem& tx, uint uiPacketSize )
+{
+    uint uiWeight = (uint)( tx.uiRate * (double)MAX_FLOW_WEIGHT / std::max < uint > ( 1, m_uiCurrentRate ) );
+    return uiPacketSize * Clamp < uint > ( 1, uiWeight, MAX_FLOW_WEIGHT );
+}
+
+
+///////////////////////////////////////////////////////////////
+//
+// CLatentSendQueue::SendNextPart
+//
+// Send one packet of a transfer
+//
+///////////////////////////////////////////////////////////////
+void CLatentSendQueue::SendNextPart ( SSendItem& activeTx, uint uiMaxPacketSize )
+{
+    NetBitStreamInterface* pBitStream = DoAllocateNetBitStream ( m_RemoteId, m_usBitStreamVersion );
+    pBitStream->WriteBits ( &activeTx.uiId, 15 );
+
+    // Next bit indicates if it has a special flag
+    if ( activeTx.uiReadPosition == 0 && !activeTx.bSendStarted )
+    {
+        // Head
+        pBitStream->WriteBit ( 1 );
+        pBitStream->Write ( (uchar)FLAG_HEAD );
+        pBitStream->Write ( activeTx.usCategory );
+        pBitStream->Write ( activeTx.bufferRef->GetSize () );
+        pBitStream->Write ( activeTx.uiRate );
+        if ( pBitStream->Version () >= 0x31 )
+            pBitStream->Write ( activeTx.usResourceNetId );
+        activeTx.bSendStarted = true;
+    }
+    else
+    if ( activeTx.bufferRef->GetSize () == activeTx.uiReadPosition )
+    {
+        // Tail
+        pBitStream->WriteBit ( 1 );
+        pBitStream->Write ( (uchar)FLAG_TAIL );
+        activeTx.bSendFinishing = true;
+    }
+    else
+    {
+        // Body
+        pBitStream->WriteBit ( 0 );
+    }
+
+    // Align to next boundary
+    pBitStream->AlignWriteToByteBoundary ();
+    uint uiMaxDataSize = std::max < int > ( 10, uiMaxPacketSize - pBitStream->GetNumberOfBytesUsed () );
+
+    // Calc how much data to send
+    uint uiDataOffset = activeTx.uiReadPosition;
+    uint uiSizeToSend = std::min( uiMaxDataSize, activeTx.bufferRef->GetSize () - activeTx.uiReadPosition );
+    activeTx.uiReadPosition += uiSizeToSend;
+
+    // The data is read straight from the buffer shared by all recipients
+    pBitStream->Write ( (ushort)uiSizeToSend );
+    pBitStream->Write ( activeTx.bufferRef->GetData () + uiDataOffset, uiSizeToSend );
+
+    // Send
+    DoSendPacket ( PACKET_ID_LATENT_TRANSFER, m_RemoteId, pBitStream, PACKET_PRIORITY_LOW, PACKET_RELIABILITY_RELIABLE_ORDERED, PACKET_ORDERING_DATA_TRANSFER );
+    DoDeallocateNetBitStream ( pBitStream );
+}
+
+
+///////////////////////////////////////////////////////////////
+//
+// CLatentSendQueue::GetWantedRate
+//
+// Bytes per second this queue would like to send, after backing off for congestion
+//
+///////////////////////////////////////////////////////////////
+uint CLatentSendQueue::GetWantedRate ( void )
+{
+    if ( m_TxQueue.empty () )
+        return 0;
+    return std::max < uint > ( MIN_SEND_RATE, (uint)( m_uiCurrentRate * m_fCongestionScale ) );
+}
+
+
+///////////////////////////////////////////////////////////////
+//
+// CLatentSendQueue::UpdateCongestion
+//
+// Back off quickly when the remote is losing packets, and recover slowly
+//
+///////////////////////////////////////////////////////////////
+void CLatentSendQueue::UpdateCongestion ( void )
+{
+    NetStatistics stats;
+    if ( !DoGetNetworkStatistics ( m_RemoteId, &stats ) )
+        return;
+
+    if ( stats.packetlossLastSecond > CONGESTION_PACKET_LOSS )
+        m_fCongestionScale = std::max ( 0.1f, m_fCongestionScale * 0.5f );
+    else
+    if ( !stats.isLimitedByCongestionControl )
+        m_fCongestionScale = std::min ( 1.f, m_fCongestionScale + 0.1f );
 }
 
 
@@ -154,6 +359,13 @@ SSendHandle CLatentSendQueue::AddSend ( CBufferRef bufferRef, uint uiRate, ushor
     newTx.pLuaMain = pLuaMain;
     newTx.usResourceNetId = usResourceNetId;
 
+    // New resources join the end of the round
+    bool bHasFlow = false;
+    for ( uint i = 0 ; i < m_FlowList.size () && !bHasFlow ; i++ )
+        bHasFlow = m_FlowList[i].usResourceNetId == usResourceNetId;
+    if ( !bHasFlow )
+        m_FlowList.push_back ( SSendFlow ( usResourceNetId ) );
+
     // Current rate is highest queued item
     m_uiCurrentRate = std::max ( m_uiCurrentRate, newTx.uiRate );
 
@@ -208,6 +420,7 @@ void CLatentSendQueue::CancelAllSends ( void )
     for ( std::list < SSendItem >::iterator iter = listCopy.begin () ; iter != listCopy.end () ; ++iter )
         CancelSend ( iter->uiId );
     m_TxQueue.clear ();
+    m_FlowList.clear ();
 }
 
 
@@ -60,12 +60,64 @@ void CLatentTransferManager::DoPulse ( void )
 
     m_iTimeMsBetweenCalls = Clamp ( 1, m_iTimeMsBetweenCalls, 100 );
 
+    UpdateRateLimits ();
+
     // Update each send queue
     for ( uint i = 0 ; i < m_SendQueueList.size () ; i++ )
         m_SendQueueList[i]->DoPulse ( m_iTimeMsBetweenCalls );
 }
 
 
+///////////////////////////////////////////////////////////////
+//
+// CLatentTransferManager::UpdateRateLimits
+//
+// Check the remotes for congestion now and then, and share the global
+// budget so that remotes wanting less than an equal share get all they want.
+//
+///////////////////////////////////////////////////////////////
+void CLatentTransferManager::UpdateRateLimits ( void )
+{
+    // Collect queues with something to send
+    std::vector < std::pair < uint, CLatentSendQueue* > > activeList;
+    for ( uint i = 0 ; i < m_SendQueueList.size () ; i++ )
+    {
+        CLatentSendQueue* pSendQueue = m_SendQueueList[i];
+        uint uiWantedRate = pSendQueue->GetWantedRate ();
+        if ( uiWantedRate )
+            activeList.push_back ( std::pair < uint, CLatentSendQueue* > ( uiWantedRate, pSendQueue ) );
+    }
+
+    if ( activeList.empty () )
+        return;
+
+    if ( m_CongestionSampleTimer.Get () >= CONGESTION_SAMPLE_INTERVAL_MS )
+    {
+        m_CongestionSampleTimer.Reset ();
+        for ( uint i = 0 ; i < activeList.size () ; i++ )
+            activeList[i].second->UpdateCongestion ();
+    }
+
+    uint uiBudget = DoGetSendRateLimit ();
+    if ( !uiBudget )
+    {
+        for ( uint i = 0 ; i < activeList.size () ; i++ )
+            activeList[i].second->SetRateLimit ( 0 );
+        return;
+    }
+
+    // Max-min fair share, smallest wants first
+    std::sort ( activeList.begin (), activeList.end () );
+    for ( uint i = 0 ; i < activeList.size () ; i++ )
+    {
+        uint uiFairShare = uiBudget / ( activeList.size () - i );
+        uint uiShare = std::min ( activeList[i].first, uiFairShare );
+        activeList[i].second->SetRateLimit ( std::max < uint > ( MIN_SEND_RATE, uiShare ) );
+        uiBudget -= uiShare;
+    }
+}
+
+
 ///////////////////////////////////////////////////////////////
 //
 // CLatentTransferManager::RemoveRemote
@@ -369,6 +421,16 @@ bool DoStaticProcessPacket ( unsigned char ucPacketID, NetPlayerID remoteId, Net
     return CClientGame::StaticProcessPacket ( ucPacketID, *pBitStream );
 }
 
+bool DoGetNetworkStatistics ( NetPlayerID remoteId, NetStatistics* pDest )
+{
+    return g_pNet->GetNetworkStatistics ( pDest );
+}
+
+uint DoGetSendRateLimit ( void )
+{
+    return 0;
+}
+
 void DoDisconnectRemote ( NetPlayerID remoteId, const SString& strReason )
 {
     g_pCore->ShowMessageBox ( _("Error")+_E("CD61"), strReason, MB_BUTTON_OK | MB_ICON_ERROR ); // DoDisconnectRemote
@@ -420,4 +482,15 @@ void DoDisconnectRemote ( NetPlayerID remoteId, const SString& strReason )
         DisconnectPlayer ( g_pGame, *pPlayer, strReason );
 }
 
+bool DoGetNetworkStatistics ( NetPlayerID remoteId, NetStatistics* pDest )
+{
+    // Same stats as the sync rate control, published by the sync thread
+    return CSimControl::GetNetworkStatistics ( pDest, remoteId );
+}
+
+uint DoGetSendRateLimit ( void )
+{
+    return g_pGame->GetConfig ()->GetLatentSendBandwidthLimit ();
+}
+
 #endif
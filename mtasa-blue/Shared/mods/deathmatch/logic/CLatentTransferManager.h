@@ -30,6 +30,13 @@ namespace LatentTransfer
     const static int MIN_SEND_RATE      = 500;      // Bytes per second
     const static int MIN_PACKET_SIZE    = 500;
     const static int MAX_PACKET_SIZE    = 1100;     // Set to 1100 as MTU is hard coded at 1200 (as of 2012-01-28)
+
+    const static int MAX_FLOW_WEIGHT                = 4;        // Packets per turn for the resource asking the highest rate
+    const static int CONGESTION_SAMPLE_INTERVAL_MS  = 500;      // How often every remote has its packet loss checked
+    const static int CONGESTION_PACKET_LOSS         = 2;        // Percent
+    const static int MAX_RECEIVE_ITEMS              = 32;       // Transfers one remote can have in progress at once
+    const static int MAX_RECEIVE_SIZE               = 100 * 1024 * 1024;
+    const static int MAX_RECEIVE_SIZE_TOTAL         = 200 * 1024 * 1024;
 };
 
 
@@ -66,6 +73,21 @@ struct SSendItem
 };
 
 
+//
+// Deficit round robin state for the sends from one resource
+//
+struct SSendFlow
+{
+    SSendFlow ( ushort usResourceNetId )
+        : usResourceNetId ( usResourceNetId )
+        , iDeficit ( 0 )
+    {}
+
+    ushort      usResourceNetId;
+    int         iDeficit;       // Bytes this resource can send before the next one gets a turn
+};
+
+
 //
 // One complete item to receive
 //
@@ -107,7 +129,9 @@ struct SSendStatus
 //
 // CLatentSendQueue
 //
-// FIFO queue of SSendItems to transfer to a remote connection
+// SSendItems to transfer to a remote connection.
+// Items from each resource are sent in order, and the resources share the
+// bandwidth using deficit round robin, so one big transfer cannot hold up the others.
 //
 ///////////////////////////////////////////////////////////////
 class CLatentSendQueue
@@ -123,8 +147,20 @@ public:
     void                CancelAllSends              ( void );
     bool                GetSendStatus               ( SSendHandle handle, SSendStatus* pOutSendStatus );
     void                GetSendHandles              ( std::vector < SSendHandle >& outResultList );
+    uint                GetWantedRate               ( void );
+    void                SetRateLimit                ( uint uiRateLimit )            { m_uiRateLimit = uiRateLimit; }
+    void                UpdateCongestion            ( void );
 
 protected:
+    typedef std::list < SSendItem >::iterator   CSendItemIter;
+
+    bool                CanInterleave               ( void ) const                  { return m_usBitStreamVersion >= 0x06D; }
+    CSendItemIter       SelectNextItem              ( uint uiPacketSize );
+    bool                CanStartItem                ( const SSendItem& tx );
+    CSendItemIter       FindFlowItem                ( ushort usResourceNetId );
+    void                ChargeFlow                  ( ushort usResourceNetId, uint uiPacketSize );
+    int                 GetFlowQuantum              ( const SSendItem& tx, uint uiPacketSize );
+    void                SendNextPart                ( SSendItem& activeTx, uint uiMaxPacketSize );
     void                SendCancelNotification      ( SSendItem& activeTx );
     void                PostQueueRemove             ( void );
     void                UpdateEstimatedDurations    ( void );
@@ -132,7 +168,12 @@ protected:
     const NetPlayerID           m_RemoteId;
     const ushort                m_usBitStreamVersion;
     std::list < SSendItem >     m_TxQueue;
+    std::vector < SSendFlow >   m_FlowList;
+    uint                        m_uiFlowCursor;
+    bool                        m_bFlowTurnStarted;
     uint                        m_uiCurrentRate;
+    uint                        m_uiRateLimit;          // Share of the global budget (0 = no limit)
+    float                       m_fCongestionScale;
     uint                        m_uiNextSendId;
     int                         m_iBytesOwing;
 };
@@ -143,7 +184,8 @@ protected:
 //
 // CLatentReceiver
 //
-// Keeps track of the current SReceiveItem being transfered from a remote connection
+// Keeps track of the SReceiveItems being transfered from a remote connection.
+// Newer remotes can interleave the parts of several transfers.
 //
 ///////////////////////////////////////////////////////////////
 class CLatentReceiver
@@ -157,9 +199,10 @@ public:
 protected:
     void                OnReceiveError              ( const SString& strMessage );
 
-    const NetPlayerID   m_RemoteId;
-    const ushort        m_usBitStreamVersion;
-    SReceiveItem        activeRx;
+    const NetPlayerID                   m_RemoteId;
+    const ushort                        m_usBitStreamVersion;
+    std::map < ushort, SReceiveItem >   m_ActiveRxMap;
+    uint                                m_uiActiveRxSize;
 };
 
 
@@ -199,7 +242,7 @@ protected:
     CLatentSendQueue*   FindSendQueueForRemote      ( NetPlayerID remoteId );
     CLatentReceiver*    GetReceiverForRemote        ( NetPlayerID remoteId, ushort usBitStreamVersion );
     CLatentReceiver*    FindReceiverForRemote       ( NetPlayerID remoteId );
-
+    void                UpdateRateLimits            ( void );
 
     CTickCount          m_LastTimeMs;
     int                 m_iTimeMsBetweenCalls;
@@ -209,6 +252,7 @@ protected:
     std::vector < CLatentSendQueue* >               m_SendQueueList;
     std::map < NetPlayerID, CLatentSendQueue* >     m_SendQueueMap;
     CBufferRef*                                     m_pBatchBufferRef;
+    CElapsedTime                                    m_CongestionSampleTimer;
 
     // Receive variables
     std::map < NetPlayerID, CLatentReceiver* >      m_ReceiverMap;
@@ -223,3 +267,5 @@ void                    DoDeallocateNetBitStream    ( NetBitStreamInterface* pBi
 bool                    DoSendPacket                ( unsigned char ucPacketID, NetPlayerID remoteId, NetBitStreamInterface* bitStream, NetPacketPriority packetPriority, NetPacketReliability packetReliability, ePacketOrdering packetOrdering = PACKET_ORDERING_DEFAULT );
 bool                    DoStaticProcessPacket       ( unsigned char ucPacketID, NetPlayerID remoteId, NetBitStreamInterface* pBitStream, ushort usResourceNetId );
 void                    DoDisconnectRemote          ( NetPlayerID remoteId, const SString& strReason );
+bool                    DoGetNetworkStatistics      ( NetPlayerID remoteId, NetStatistics* pDest );     // Non blocking
+uint                    DoGetSendRateLimit          ( void );
@@ -0,0 +1,83 @@
+/*****************************************************************************
+*
+*  PROJECT:     Multi Theft Auto v1.0
+*  LICENSE:     See LICENSE in the top level directory
+*  FILE:        Shared/mods/deathmatch/logic/CRegexCache.cpp
+*  PURPOSE:     Cache of compiled regular expressions used by pregFind etc.
+*
+*  Multi Theft Auto is available from http://www.multitheftauto.com/
+*
+*****************************************************************************/
+
+#include "StdInc.h"
+
+std::list < CRegexCache::SEntry >                                   CRegexCache::ms_EntryList;
+CHashMap < SString, std::list < CRegexCache::SEntry >::iterator >   CRegexCache::ms_EntryMap;
+long long                                                           CRegexCache::ms_llHits = 0;
+long long                                                           CRegexCache::ms_llMisses = 0;
+
+
+///////////////////////////////////////////////////////////////
+//
+// CRegexCache::Get
+//
+// Returns a compiled pattern, which is only valid until the next call
+// Patterns which fail to compile are cached too, so they do not fail again every time
+//
+///////////////////////////////////////////////////////////////
+const pcrecpp::RE& CRegexCache::Get ( const SString& strPattern, const pcrecpp::RE_Options& options )
+{
+    SString strKey ( "%x:%x:%x:", options.all_options (), options.match_limit (), options.match_limit_recursion () );
+    strKey += strPattern;
+
+    std::list < SEntry >::iterator* pIter = MapFind ( ms_EntryMap, strKey );
+    if ( pIter )
+    {
+        // Move to the front of the list
+        ms_llHits++;
+        if ( *pIter != ms_EntryList.begin () )
+            ms_EntryList.splice ( ms_EntryList.begin (), ms_EntryList, *pIter );
+        return ms_EntryList.front ().regex;
+    }
+
+    // Remove least recently used
+    ms_llMisses++;
+    while ( ms_EntryList.size () >= REGEX_CACHE_MAX_ENTRIES )
+    {
+        MapRemove ( ms_EntryMap, ms_EntryList.back ().strKey );
+        ms_EntryList.pop_back ();
+    }
+
+    ms_EntryList.emplace_front ( strKey, strPattern, options );
+    MapSet ( ms_EntryMap, strKey, ms_EntryList.begin () );
+    return ms_EntryList.front ().regex;
+}
+
+
+///////////////////////////////////////////////////////////////
+//
+// CRegexCache::GetStats
+//
+//
+//
+///////////////////////////////////////////////////////////////
+void CRegexCache::GetStats ( SRegexCacheStats& outStats )
+{
+    outStats.uiNumEntries = ms_EntryList.size ();
+    outStats.llHits = ms_llHits;
+    outStats.llMisses = ms_llMisses;
+}
+
+
+///////////////////////////////////////////////////////////////
+//
+// CRegexCache::Clear
+//
+//
+//
+///////////////////////////////////////////////////////////////
+void CRegexCache::Clear ( void )
+{
+    ms_EntryMap.clear ();
+    ms_EntryList.clear ();
+}
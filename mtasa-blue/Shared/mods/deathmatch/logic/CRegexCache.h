@@ -0,0 +1,45 @@
+/*****************************************************************************
+*
+*  PROJECT:     Multi Theft Auto v1.0
+*  LICENSE:     See LICENSE in the top level directory
+*  FILE:        Shared/mods/deathmatch/logic/CRegexCache.h
+*  PURPOSE:     Cache of compiled regular expressions used by pregFind etc.
+*
+*  Multi Theft Auto is available from http://www.multitheftauto.com/
+*
+*****************************************************************************/
+#pragma once
+
+#define REGEX_CACHE_MAX_ENTRIES     256
+
+struct SRegexCacheStats
+{
+    uint        uiNumEntries;
+    long long   llHits;
+    long long   llMisses;
+};
+
+//
+// Least recently used cache of compiled patterns, keyed by pattern and options
+// Shared by all Lua VMs
+//
+class CRegexCache
+{
+public:
+    static const pcrecpp::RE&   Get                 ( const SString& strPattern, const pcrecpp::RE_Options& options );
+    static void                 GetStats            ( SRegexCacheStats& outStats );
+    static void                 Clear               ( void );
+
+protected:
+    struct SEntry
+    {
+        SString         strKey;
+        pcrecpp::RE     regex;
+        SEntry ( const SString& strKey, const SString& strPattern, const pcrecpp::RE_Options& options ) : strKey ( strKey ), regex ( strPattern, options ) {}
+    };
+
+    static std::list < SEntry >                                     ms_EntryList;    // Most recently used first
+    static CHashMap < SString, std::list < SEntry >::iterator >     ms_EntryMap;
+    static long long                                                ms_llHits;
+    static long long                                                ms_llMisses;
+};
@@ -155,4 +155,6 @@ IMPLEMENT_ENUM_BEGIN( ePacketID )
     ADD_ENUM1( PACKET_ID_PED_TASK )
     ADD_ENUM1( PACKET_ID_PLAYER_NO_SOCKET )
     ADD_ENUM1( PACKET_ID_PLAYER_NETWORK_STATUS )
+    ADD_ENUM1( PACKET_ID_COMPRESSED )
+    ADD_ENUM1( PACKET_ID_LUA_ELEMENT_RPC_BATCH )
 IMPLEMENT_ENUM_END( "ePacketID" )
@@ -226,7 +226,7 @@ int CLuaCryptDefs::PasswordHash(lua_State* luaVM)
                     CLuaMain* pLuaMain = m_pLuaManager->GetVirtualMachine(luaVM);
                     if (pLuaMain)
                     {
-                        CLuaShared::GetAsyncTaskScheduler()->PushTask<SString>([password, salt = options["salt"], cost] {
+                        bool bQueued = CLuaShared::GetAsyncTaskScheduler()->PushTask<SString>([password, salt = options["salt"], cost] {
                             // Execute time-consuming task
                             return SharedUtil::BcryptHash(password, salt, cost);
 
@@ -242,10 +242,14 @@ int CLuaCryptDefs::PasswordHash(lua_State* luaVM)
                                 arguments.PushString(hash);
 
                             arguments.Call(pLuaMain, luaFunctionRef);
-                        });
-
-                        lua_pushboolean(luaVM, true);
-                        return 1;
+                        }, CAsyncTaskScheduler::EPriority::Interactive, pLuaMain->GetAsyncTaskToken());
+
+                        if (bQueued)
+                        {
+                            lua_pushboolean(luaVM, true);
+                            return 1;
+                        }
+                        m_pScriptDebugging->LogWarning(luaVM, "Too many async tasks are waiting to run");
                     }
                 }
             }
@@ -291,7 +295,7 @@ int CLuaCryptDefs::PasswordVerify(lua_State* luaVM)
                 CLuaMain* pLuaMain = m_pLuaManager->GetVirtualMachine(luaVM);
                 if (pLuaMain)
                 {
-                    CLuaShared::GetAsyncTaskScheduler()->PushTask<bool>([password, hash]{
+                    bool bQueued = CLuaShared::GetAsyncTaskScheduler()->PushTask<bool>([password, hash]{
                         // Execute time-consuming task
                         return SharedUtil::BcryptVerify(password, hash);
 
@@ -300,10 +304,16 @@ int CLuaCryptDefs::PasswordVerify(lua_State* luaVM)
                         arguments.PushBoolean(correct);
 
                         arguments.Call(pLuaMain, luaFunctionRef);
-                    });
+                    }, CAsyncTaskScheduler::EPriority::Interactive, pLuaMain->GetAsyncTaskToken());
 
-                    lua_pushboolean(luaVM, true);
+                    if (bQueued)
+                    {
+                        lua_pushboolean(luaVM, true);
+                        return 1;
+                    }
+                    m_pScriptDebugging->LogWarning(luaVM, "Too many async tasks are waiting to run");
                 }
+                lua_pushboolean(luaVM, false);
             }
             return 1;
         }
@@ -479,7 +479,7 @@ int CLuaUtilDefs::PregFind ( lua_State* luaVM )
 
     if ( !argStream.HasErrors () )
     {
-        pcrecpp::RE pPattern ( strPattern, pOptions );
+        const pcrecpp::RE& pPattern = CRegexCache::Get ( strPattern, pOptions );
 
         if ( pPattern.PartialMatch ( strBase ) )
         {
@@ -508,7 +508,7 @@ int CLuaUtilDefs::PregReplace ( lua_State* luaVM )
 
     if ( !argStream.HasErrors () )
     {
-        pcrecpp::RE pPattern ( strPattern, pOptions );
+        const pcrecpp::RE& pPattern = CRegexCache::Get ( strPattern, pOptions );
 
         string strNew = strBase;
         if ( pPattern.GlobalReplace ( strReplace, &strNew ) )
@@ -541,7 +541,7 @@ int CLuaUtilDefs::PregMatch ( lua_State* luaVM )
     {
         lua_newtable ( luaVM );
 
-        pcrecpp::RE pPattern ( strPattern, pOptions );
+        const pcrecpp::RE& pPattern = CRegexCache::Get ( strPattern, pOptions );
 
         pcrecpp::StringPiece strInput ( strBase );
 
@@ -39,9 +39,24 @@ public:
     // static generators
     static CChecksum GenerateChecksumFromFile ( const SString& strFilename )
     {
+        // Read the file once and feed both hashers from the same buffer
         CChecksum result;
-        result.ulCRC = CRCGenerator::GetCRCFromFile ( strFilename );
-        CMD5Hasher ().Calculate ( strFilename, result.md5 );
+        FILE* pFile = File::Fopen ( strFilename, "rb" );
+        if ( !pFile )
+            return result;
+
+        CMD5Hasher hasher;
+        hasher.Init ();
+        char buffer [ 65536 ];
+        while ( size_t sizeRead = fread ( buffer, 1, sizeof ( buffer ), pFile ) )
+        {
+            result.ulCRC = CRCGenerator::GetCRCFromBuffer ( buffer, sizeRead, result.ulCRC );
+            hasher.Update ( (unsigned char*)buffer, (unsigned int)sizeRead );
+        }
+        hasher.Finalize ();
+        fclose ( pFile );
+
+        memcpy ( result.md5.data, hasher.GetResult (), sizeof ( result.md5.data ) );
         return result;
     }
 
@@ -18,11 +18,15 @@ public:
         uint    uiDupCount;
     };
 
-    CDuplicateLineFilter( uint uiMaxNumOfLinesInMatch = 4, uint uiMaxDelaySeconds = 5 )
+    // uiMaxMatchSeconds - If not zero, a long running match outputs its duplicate count at this interval instead of waiting for the match to end
+    CDuplicateLineFilter( uint uiMaxNumOfLinesInMatch = 4, uint uiMaxDelaySeconds = 5, uint uiMaxMatchSeconds = 0 )
     {
         m_uiMaxNumOfLinesInMatch = uiMaxNumOfLinesInMatch;
         m_uiMaxDelaySeconds = uiMaxDelaySeconds;
+        m_uiMaxMatchSeconds = uiMaxMatchSeconds;
         m_bIsMatching = false;
+        m_tLastOutputTime = 0;
+        m_tMatchOutputTime = 0;
     }
 
     //////////////////////////////////////////////////////////
@@ -45,6 +49,7 @@ public:
                     m_uiMatchSize = i + 1;
                     m_uiMatchCurLine = i;
                     m_uiDupCount = 0;
+                    m_tMatchOutputTime = time( NULL );
                     if ( m_uiMatchCurLine == 0)
                         m_uiDupCount++; // Completed matching set (will only occur here for single line match)
                     return;
@@ -61,7 +66,11 @@ public:
                 // Still matching
                 m_uiMatchCurLine = uiNextLine;
                 if ( m_uiMatchCurLine == 0)
+                {
                     m_uiDupCount++;     // Completed matching set
+                    if ( m_uiMaxMatchSeconds && time( NULL ) - m_tMatchOutputTime >= m_uiMaxMatchSeconds )
+                        OutputMatchedSet();
+                }
                 return;
             }
             else
@@ -115,6 +124,24 @@ public:
     }
 
 
+    //////////////////////////////////////////////////////////
+    //
+    // OutputMatchedSet
+    //
+    // Output the duplicate count so far and continue matching
+    //
+    //////////////////////////////////////////////////////////
+    void OutputMatchedSet( void )
+    {
+        for( uint i = 0 ; i < m_uiMatchSize; i++ )
+        {
+            AddLineToOutputBuffer( m_History.at( m_uiMatchSize - 1 - i ), m_uiDupCount );
+        }
+        m_uiDupCount = 0;
+        m_tMatchOutputTime = time( NULL );
+    }
+
+
     //////////////////////////////////////////////////////////
     //
     // AddLineToOutputBuffer
@@ -138,7 +165,13 @@ public:
         if ( m_PendingOutput.empty() )
         {
             if ( time( NULL ) - m_tLastOutputTime > m_uiMaxDelaySeconds )
-                Flush();
+            {
+                // Keep a long running match going if only its count needs outputting
+                if ( m_uiMaxMatchSeconds && m_bIsMatching && m_uiMatchCurLine == 0 && m_uiDupCount > 0 )
+                    OutputMatchedSet();
+                else
+                    Flush();
+            }
             if ( m_PendingOutput.empty() )
                 return false;
         }
@@ -162,4 +195,6 @@ protected:
     time_t                      m_tLastOutputTime;
     uint                        m_uiMaxNumOfLinesInMatch;   // Max number lines in a matching set
     uint                        m_uiMaxDelaySeconds;        // Max seconds to delay outputting duplicated lines
+    uint                        m_uiMaxMatchSeconds;        // Max seconds between outputs of a continuing match
+    time_t                      m_tMatchOutputTime;
 };
@@ -1,5 +1,7 @@
 #pragma once
-#include <queue>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
 #include <functional>
 #include <memory>
 #include <thread>
@@ -7,6 +9,37 @@
 
 namespace SharedUtil
 {
+    ///////////////////////////////////////////////////////////////
+    //
+    // CAsyncTaskToken class
+    //
+    // Shared flag which lets the owner of some tasks cancel them,
+    // e.g. when a resource stops. Copies refer to the same flag.
+    // A default constructed token can never be cancelled.
+    //
+    ///////////////////////////////////////////////////////////////
+    class CAsyncTaskToken
+    {
+    public:
+        static CAsyncTaskToken Create()
+        {
+            CAsyncTaskToken token;
+            token.m_pCancelled = std::make_shared<std::atomic<bool>>(false);
+            return token;
+        }
+
+        void Cancel()
+        {
+            if (m_pCancelled)
+                *m_pCancelled = true;
+        }
+
+        bool IsCancelled() const { return m_pCancelled && *m_pCancelled; }
+
+    private:
+        std::shared_ptr<std::atomic<bool>> m_pCancelled;
+    };
+
     ///////////////////////////////////////////////////////////////
     //
     // CAsyncTaskScheduler class
@@ -14,13 +47,20 @@ namespace SharedUtil
     // Asynchronously executes tasks in secondary worker threads
     // and returns the result back to the main thread
     //
+    // Each worker has its own queues and takes work from the others
+    // when it runs out. Interactive tasks are always started before bulk tasks.
+    //
     ///////////////////////////////////////////////////////////////
     class CAsyncTaskScheduler
     {
         struct SBaseTask
         {
+            virtual ~SBaseTask() {}
             virtual void Execute() = 0;
             virtual void ProcessResult() = 0;
+
+            CAsyncTaskToken m_Token;
+            bool m_bExecuted = false;
         };
 
         template<typename ResultType>
@@ -48,14 +88,24 @@ namespace SharedUtil
         };
 
     public:
+        enum class EPriority
+        {
+            Interactive,        // Someone is waiting for the result, e.g. a script callback
+            Bulk,               // Background work which can wait
+            Max
+        };
+
         //
         // Creates a new async task scheduler
         // with a fixed number of worker threads
         //
-        CAsyncTaskScheduler(std::size_t numWorkers);
+        // maxQueuedTasks: PushTask fails while this many tasks are waiting to start (0 = no limit)
+        //
+        CAsyncTaskScheduler(std::size_t numWorkers, std::size_t maxQueuedTasks = 0);
 
         //
-        // Ends all worker threads (waits for the last task to finish)
+        // Ends all worker threads (waits for the running tasks to finish)
+        // Tasks which have not started are discarded
         //
         ~CAsyncTaskScheduler();
 
@@ -65,14 +115,16 @@ namespace SharedUtil
         //
         // taskFunc: Time-consuming function that is executed on the secondary thread (be aware of thread safety!)
         // readyFunc: Function that is called once the result is ready (called on the main thread)
+        // token: If cancelled, taskFunc is skipped if it has not started and readyFunc is never called
+        // Returns false if the queue is full, in which case neither function is called
         //
         template<typename ResultType>
-        void PushTask(const std::function<ResultType()>& taskFunc, const std::function<void(const ResultType&)>& readyFunc)
+        bool PushTask(const std::function<ResultType()>& taskFunc, const std::function<void(const ResultType&)>& readyFunc,
+                      EPriority priority = EPriority::Interactive, const CAsyncTaskToken& token = CAsyncTaskToken())
         {
             std::unique_ptr<SBaseTask> pTask{ new STask<ResultType>{ taskFunc, readyFunc } };
-
-            std::lock_guard<std::mutex>{ m_TasksMutex };
-            m_Tasks.push(std::move(pTask));
+            pTask->m_Token = token;
+            return AddTask(std::move(pTask), priority);
         }
 
         //
@@ -82,17 +134,43 @@ namespace SharedUtil
         //
         void CollectResults();
 
+        //
+        // Sets a signal which is notified whenever a task result
+        // is ready to be collected (optional)
+        //
+        void SetResultSignal(CWorkSignal* pSignal) { m_pResultSignal = pSignal; }
+
+        //
+        // Number of tasks which have not been started yet
+        //
+        std::size_t GetQueuedTaskCount() const { return m_QueuedTaskCount; }
+
     protected:
-        void DoWork();
+        struct SWorkerQueue
+        {
+            std::mutex m_Mutex;
+            std::deque<std::unique_ptr<SBaseTask>> m_Tasks[(int)EPriority::Max];
+        };
+
+        bool AddTask(std::unique_ptr<SBaseTask> pTask, EPriority priority);
+        std::unique_ptr<SBaseTask> TakeTask(std::size_t workerIndex);
+        void DoWork(std::size_t workerIndex);
 
     private:
         std::vector<std::thread> m_Workers;
-        bool m_Running = true;
+        std::vector<std::unique_ptr<SWorkerQueue>> m_WorkerQueues;
+        std::atomic<bool> m_Running{ true };
+        std::atomic<std::size_t> m_NextQueue{ 0 };
+        std::size_t m_MaxQueuedTasks;
 
-        std::queue<std::unique_ptr<SBaseTask>> m_Tasks;
-        std::mutex m_TasksMutex;
+        // Guards changes to m_QueuedTaskCount so waits on the condition are not missed
+        std::mutex m_QueuedMutex;
+        std::condition_variable m_TaskAddedCondition;
+        std::atomic<std::size_t> m_QueuedTaskCount{ 0 };
 
         std::vector<std::unique_ptr<SBaseTask>> m_TaskResults;
         std::mutex m_TaskResultsMutex;
+
+        CWorkSignal* m_pResultSignal = nullptr;
     };
 }
@@ -2,17 +2,30 @@
 
 namespace SharedUtil
 {
-    CAsyncTaskScheduler::CAsyncTaskScheduler(std::size_t numWorkers)
+    CAsyncTaskScheduler::CAsyncTaskScheduler(std::size_t numWorkers, std::size_t maxQueuedTasks)
+        : m_MaxQueuedTasks(maxQueuedTasks)
     {
+        numWorkers = std::max<std::size_t>(numWorkers, 1);
+
+        // Create all queues before any worker can try to take from them
+        for (std::size_t i = 0; i < numWorkers; ++i)
+        {
+            m_WorkerQueues.emplace_back(new SWorkerQueue);
+        }
+
         for (std::size_t i = 0; i < numWorkers; ++i)
         {
-            m_Workers.emplace_back(&CAsyncTaskScheduler::DoWork, this);
+            m_Workers.emplace_back(&CAsyncTaskScheduler::DoWork, this, i);
         }
     }
 
     CAsyncTaskScheduler::~CAsyncTaskScheduler()
     {
-        m_Running = false;
+        {
+            std::lock_guard<std::mutex> lock{ m_QueuedMutex };
+            m_Running = false;
+        }
+        m_TaskAddedCondition.notify_all();
 
         // Wait for all threads to end
         for (auto& thread : m_Workers)
@@ -22,46 +35,119 @@ namespace SharedUtil
         }
     }
 
+    bool CAsyncTaskScheduler::AddTask(std::unique_ptr<SBaseTask> pTask, EPriority priority)
+    {
+        {
+            std::lock_guard<std::mutex> lock{ m_QueuedMutex };
+
+            // Backpressure: the caller is often the main thread, so refuse rather than wait for the workers
+            if (m_MaxQueuedTasks && m_QueuedTaskCount >= m_MaxQueuedTasks)
+                return false;
+
+            // Count before pushing, as a worker which is already awake may take the task straight away
+            ++m_QueuedTaskCount;
+        }
+
+        // Spread new tasks over the workers. Idle workers will steal if this one is busy.
+        SWorkerQueue& queue = *m_WorkerQueues[m_NextQueue++ % m_WorkerQueues.size()];
+        {
+            std::lock_guard<std::mutex> lock{ queue.m_Mutex };
+            queue.m_Tasks[(int)priority].push_back(std::move(pTask));
+        }
+        m_TaskAddedCondition.notify_one();
+        return true;
+    }
+
+    std::unique_ptr<CAsyncTaskScheduler::SBaseTask> CAsyncTaskScheduler::TakeTask(std::size_t workerIndex)
+    {
+        const std::size_t numQueues = m_WorkerQueues.size();
+
+        for (int priority = 0; priority < (int)EPriority::Max; ++priority)
+        {
+            // Oldest task from our own queue
+            {
+                SWorkerQueue& queue = *m_WorkerQueues[workerIndex];
+                std::lock_guard<std::mutex> lock{ queue.m_Mutex };
+                auto& tasks = queue.m_Tasks[priority];
+                if (!tasks.empty())
+                {
+                    std::unique_ptr<SBaseTask> pTask = std::move(tasks.front());
+                    tasks.pop_front();
+                    return pTask;
+                }
+            }
+
+            // Steal newest task from someone else
+            for (std::size_t i = 1; i < numQueues; ++i)
+            {
+                SWorkerQueue& queue = *m_WorkerQueues[(workerIndex + i) % numQueues];
+                std::lock_guard<std::mutex> lock{ queue.m_Mutex };
+                auto& tasks = queue.m_Tasks[priority];
+                if (!tasks.empty())
+                {
+                    std::unique_ptr<SBaseTask> pTask = std::move(tasks.back());
+                    tasks.pop_back();
+                    return pTask;
+                }
+            }
+        }
+        return nullptr;
+    }
+
     void CAsyncTaskScheduler::CollectResults()
     {
-        std::lock_guard<std::mutex>{ m_TaskResultsMutex };
+        // Take the results so ready-functions can push new tasks without holding the lock
+        std::vector<std::unique_ptr<SBaseTask>> results;
+        {
+            std::lock_guard<std::mutex> lock{ m_TaskResultsMutex };
+            std::swap(results, m_TaskResults);
+        }
 
-        for (auto& pTask : m_TaskResults)
+        for (auto& pTask : results)
         {
-            pTask->ProcessResult();
+            if (pTask->m_bExecuted && !pTask->m_Token.IsCancelled())
+                pTask->ProcessResult();
         }
-        m_TaskResults.clear();
     }
 
-    void CAsyncTaskScheduler::DoWork()
+    void CAsyncTaskScheduler::DoWork(std::size_t workerIndex)
     {
-        while (m_Running)
+        while (true)
         {
-            m_TasksMutex.lock();
+            // Sleep until there is something to do
+            {
+                std::unique_lock<std::mutex> lock{ m_QueuedMutex };
+                m_TaskAddedCondition.wait(lock, [this] { return m_QueuedTaskCount > 0 || !m_Running; });
+                if (!m_Running)
+                    break;
+            }
 
-            // Sleep a bit if there are no tasks
-            if (m_Tasks.empty())
+            // Another worker may have got there first, or the task is not pushed yet
+            std::unique_ptr<SBaseTask> pTask = TakeTask(workerIndex);
+            if (!pTask)
             {
-                m_TasksMutex.unlock();
-                std::this_thread::sleep_for(std::chrono::milliseconds(4));
+                std::this_thread::yield();
                 continue;
             }
-                
-            // Get task and remove from front
-            std::unique_ptr<SBaseTask> pTask = std::move(m_Tasks.front());
-            m_Tasks.pop();
 
-            m_TasksMutex.unlock();
+            --m_QueuedTaskCount;
 
-            // Execute time-consuming task
-            pTask->Execute();
+            // Execute time-consuming task unless the owner has gone
+            if (!pTask->m_Token.IsCancelled())
+            {
+                pTask->Execute();
+                pTask->m_bExecuted = true;
+            }
 
-            // Put into result queue
+            // Put into result queue (cancelled tasks are destroyed on the main thread as well)
             {
-                std::lock_guard<std::mutex>{ m_TaskResultsMutex };
+                std::lock_guard<std::mutex> lock{ m_TaskResultsMutex };
 
                 m_TaskResults.push_back(std::move(pTask));
             }
+
+            if (m_pResultSignal)
+                m_pResultSignal->Notify();
         }
     }
 }
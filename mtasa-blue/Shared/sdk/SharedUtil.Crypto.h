@@ -9,6 +9,9 @@
 *****************************************************************************/
 #pragma once
 #include <cryptopp/base64.h>
+#include <cryptopp/hex.h>
+#include <cryptopp/hmac.h>
+#include <cryptopp/sha.h>
 
 namespace SharedUtil
 {
@@ -27,4 +30,13 @@ namespace SharedUtil
 
         return result;
     }
+
+    inline SString HmacSha256HexString(const SString& key, const SString& data)
+    {
+        SString result;
+        CryptoPP::HMAC<CryptoPP::SHA256> hmac((const unsigned char*)key.data(), key.size());
+        CryptoPP::StringSource ss(data, true, new CryptoPP::HashFilter(hmac, new CryptoPP::HexEncoder(new CryptoPP::StringSink(result)))); // Memory is freed automatically
+
+        return result;
+    }
 }
@@ -41,6 +41,11 @@ namespace SharedUtil
     //
     uint64          FileSize                        ( const SString& strFilename );
 
+    //
+    // Get a file size and last write time without opening it. Returns false if the file does not exist
+    //
+    bool            FileGetSizeAndModifiedTime      ( const SString& strFilename, uint64& uiOutSize, uint64& uiOutModifiedTime );
+
     //
     // Ensure all directories exist to the file
     //
@@ -63,6 +68,7 @@ namespace SharedUtil
     bool            MkDir                           ( const SString& strInPath, bool bTree = true );
     bool            FileCopy                        ( const SString& strSrc, const SString& strDest, bool bForce = true );
     std::vector < SString > FindFiles               ( const SString& strMatch, bool bFiles, bool bDirectories, bool bSortByDate = false );
+    long long       PruneFilesBySize                ( const SString& strPath, const SString& strMatch, long long llMaxSize );
     SString         MakeUniquePath                  ( const SString& strPathFilename );
     SString         ConformPathForSorting           ( const SString& strPathFilename );
     bool            IsAbsolutePath                  ( const SString& strPath );
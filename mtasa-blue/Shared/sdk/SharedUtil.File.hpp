@@ -201,6 +201,33 @@ uint64 SharedUtil::FileSize ( const SString& strFilename  )
 }
 
 
+//
+// Get a file size and last write time without opening it
+// Modified time is only useful for comparing against a previous value
+//
+bool SharedUtil::FileGetSizeAndModifiedTime ( const SString& strFilename, uint64& uiOutSize, uint64& uiOutModifiedTime )
+{
+#ifdef WIN32
+    WIN32_FILE_ATTRIBUTE_DATA fileData;
+    if ( !GetFileAttributesExW ( FromUTF8( strFilename ), GetFileExInfoStandard, &fileData ) )
+        return false;
+    if ( fileData.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY )
+        return false;
+    uiOutSize = ( (uint64)fileData.nFileSizeHigh << 32 ) | fileData.nFileSizeLow;
+    uiOutModifiedTime = (uint64&)fileData.ftLastWriteTime;
+#else
+    struct stat Info;
+    if ( stat ( strFilename, &Info ) == -1 )
+        return false;
+    if ( S_ISDIR ( Info.st_mode ) )
+        return false;
+    uiOutSize = Info.st_size;
+    uiOutModifiedTime = (uint64)Info.st_mtim.tv_sec * 1000000000ULL + Info.st_mtim.tv_nsec;
+#endif
+    return true;
+}
+
+
 //
 // Ensure all directories exist to the file
 //
@@ -716,6 +743,43 @@ std::vector < SString > SharedUtil::FindFiles ( const SString& strMatch, bool bF
 #endif
 
 
+//
+// Measure the files matching strMatch in each directory inside strPath.
+// If they add up to more than llMaxSize, delete the least recently written until
+// well under it, so this does not have to run again soon.
+// Returns the total size of the files left.
+//
+long long SharedUtil::PruneFilesBySize ( const SString& strPath, const SString& strMatch, long long llMaxSize )
+{
+    std::multimap < uint64, std::pair < SString, uint64 > > fileListByTime;
+    long long llTotalSize = 0;
+    for ( const SString& strDir : FindFiles ( PathJoin ( strPath, "*" ), false, true ) )
+    {
+        for ( const SString& strFilename : FindFiles ( PathJoin ( strPath, strDir, strMatch ), true, false ) )
+        {
+            SString strPathFilename = PathJoin ( strPath, strDir, strFilename );
+            uint64 uiSize, uiModifiedTime;
+            if ( FileGetSizeAndModifiedTime ( strPathFilename, uiSize, uiModifiedTime ) )
+            {
+                fileListByTime.insert ( std::make_pair ( uiModifiedTime, std::make_pair ( strPathFilename, uiSize ) ) );
+                llTotalSize += uiSize;
+            }
+        }
+    }
+
+    if ( llTotalSize > llMaxSize )
+    {
+        for ( auto iter = fileListByTime.begin () ; iter != fileListByTime.end () && llTotalSize > llMaxSize * 3 / 4 ; ++iter )
+        {
+            if ( FileDelete ( iter->second.first ) )
+                llTotalSize -= iter->second.second;
+        }
+    }
+
+    return llTotalSize;
+}
+
+
 void SharedUtil::ExtractFilename ( const SString& strInPathFilename, SString* strPath, SString* strFilename )
 {
     const SString strPathFilename = PathConform ( strInPathFilename );
@@ -1694,6 +1694,84 @@ namespace SharedUtil
         SFixedArrayInit < vartype, NUMELMS( _##varname ) > varname ( _##varname, NUMELMS( _##varname ) )
 
 
+    //
+    // Queue stored in one growable array
+    //
+    // Replacement for std::list when used as a FIFO, without the allocation per item
+    // Capacity is kept at a power of 2 so positions can wrap with a mask
+    //
+    template < class T >
+    class CRingBuffer
+    {
+    public:
+        CRingBuffer ( void ) : m_uiHead ( 0 ), m_uiSize ( 0 ) {}
+
+        uint size ( void ) const                { return m_uiSize; }
+        bool empty ( void ) const               { return m_uiSize == 0; }
+        void clear ( void )                     { m_uiHead = 0; m_uiSize = 0; }
+
+        T& front ( void )
+        {
+            assert ( m_uiSize > 0 );
+            return m_Data [ m_uiHead ];
+        }
+
+        // Index from the front
+        T& operator[] ( uint uiIndex )
+        {
+            assert ( uiIndex < m_uiSize );
+            return m_Data [ ( m_uiHead + uiIndex ) & ( m_Data.size () - 1 ) ];
+        }
+
+        void push_back ( const T& item )
+        {
+            if ( m_uiSize == m_Data.size () )
+                Grow ();
+            m_Data [ ( m_uiHead + m_uiSize ) & ( m_Data.size () - 1 ) ] = item;
+            m_uiSize++;
+        }
+
+        void pop_front ( void )
+        {
+            assert ( m_uiSize > 0 );
+            m_uiHead = ( m_uiHead + 1 ) & ( m_Data.size () - 1 );
+            m_uiSize--;
+        }
+
+        // Remove items for which pred returns true, keeping the order of the others
+        template < class PRED >
+        void remove_if ( PRED pred )
+        {
+            uint uiNewSize = 0;
+            for ( uint i = 0 ; i < m_uiSize ; i++ )
+            {
+                T& item = (*this) [ i ];
+                if ( !pred ( item ) )
+                {
+                    if ( uiNewSize != i )
+                        (*this) [ uiNewSize ] = item;
+                    uiNewSize++;
+                }
+            }
+            m_uiSize = uiNewSize;
+        }
+
+    protected:
+        void Grow ( void )
+        {
+            std::vector < T > newData ( std::max < size_t > ( 16, m_Data.size () * 2 ) );
+            for ( uint i = 0 ; i < m_uiSize ; i++ )
+                newData [ i ] = (*this) [ i ];
+            m_Data.swap ( newData );
+            m_uiHead = 0;
+        }
+
+        std::vector < T >   m_Data;
+        uint                m_uiHead;
+        uint                m_uiSize;
+    };
+
+
     //
     //  Ranges of numbers. i.e. 100-4000, 5000-6999, 7000-7010
     //
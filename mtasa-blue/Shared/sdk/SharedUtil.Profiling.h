@@ -45,6 +45,10 @@ namespace SharedUtil
         bool    ClearBuffer     ( bool bCanResize );
         void    Sample          ( class SStatCollection& m_StatCollection );
 
+        // Events added since the buffer was last cleared
+        int             GetBufferPos    ( void ) const      { return m_BufferPos; }
+        const SItem*    GetBufferItems  ( void ) const      { return m_ItemBuffer; }
+
         void Add ( const char* szSection, const char* szName, eStatEventType type )
         {
             if ( m_BufferPos < m_BufferPosMaxUsing )
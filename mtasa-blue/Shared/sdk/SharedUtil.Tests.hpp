@@ -21,6 +21,7 @@ void 	SharedUtil_WildcardMatch_Tests  ( void );
 void    SharedUtil_Collection_Tests     ( void );
 void    SharedUtil_String_Tests         ( void );
 void    SharedUtil_Hash_Tests           ( void );
+void    SharedUtil_AsyncTaskScheduler_Tests ( void );
 
 ///////////////////////////////////////////////////////////////
 //
@@ -38,6 +39,7 @@ void SharedUtil_Tests ( void )
     SharedUtil_Collection_Tests ();
     SharedUtil_String_Tests ();
     SharedUtil_Hash_Tests ();
+    SharedUtil_AsyncTaskScheduler_Tests ();
 }
 
 
@@ -899,3 +901,136 @@ void SharedUtil_Hash_Tests ( void )
 
     FileDelete( szTempFilename );
 }
+
+///////////////////////////////////////////////////////////////
+//
+// SharedUtil_AsyncTaskScheduler_Tests
+//
+// Test behaviour of CAsyncTaskScheduler
+// The stress part is most useful when built with a thread sanitizer
+//
+///////////////////////////////////////////////////////////////
+void SharedUtil_AsyncTaskScheduler_Tests ( void )
+{
+    // Full queue refuses new tasks
+    {
+        CAsyncTaskScheduler scheduler ( 1, 2 );
+        std::atomic < bool > bRelease ( false );
+        std::atomic < bool > bStarted ( false );
+        int iNumReady = 0;
+
+        // Keep the worker busy so nothing else is taken
+        bool bPushed = scheduler.PushTask < int > ( [&] { bStarted = true; while ( !bRelease ) std::this_thread::yield (); return 0; }, [&] ( const int& ) { iNumReady++; } );
+        assert ( bPushed );
+        while ( !bStarted )
+            std::this_thread::yield ();
+
+        for ( int i = 0 ; i < 2 ; i++ )
+        {
+            bPushed = scheduler.PushTask < int > ( [] { return 0; }, [&] ( const int& ) { iNumReady++; } );
+            assert ( bPushed );
+        }
+        bPushed = scheduler.PushTask < int > ( [] { return 0; }, [&] ( const int& ) { iNumReady++; } );
+        assert ( !bPushed );
+        assert ( scheduler.GetQueuedTaskCount () == 2 );
+
+        bRelease = true;
+        while ( iNumReady < 3 )
+        {
+            std::this_thread::yield ();
+            scheduler.CollectResults ();
+        }
+        assert ( iNumReady == 3 );
+    }
+
+    // Interactive tasks start before bulk tasks
+    {
+        std::vector < int > orderList;
+        {
+            CAsyncTaskScheduler scheduler ( 1 );
+            std::atomic < bool > bRelease ( false );
+            std::atomic < bool > bStarted ( false );
+
+            scheduler.PushTask < int > ( [&] { bStarted = true; while ( !bRelease ) std::this_thread::yield (); return 0; }, [] ( const int& ) {} );
+            while ( !bStarted )
+                std::this_thread::yield ();
+
+            scheduler.PushTask < int > ( [&] { orderList.push_back ( 1 ); return 0; }, [] ( const int& ) {}, CAsyncTaskScheduler::EPriority::Bulk );
+            scheduler.PushTask < int > ( [&] { orderList.push_back ( 2 ); return 0; }, [] ( const int& ) {}, CAsyncTaskScheduler::EPriority::Interactive );
+            bRelease = true;
+            while ( scheduler.GetQueuedTaskCount () )
+                std::this_thread::yield ();
+        }
+        // Scheduler has waited for the worker, so the list is safe to read
+        assert ( orderList.size () == 2 && orderList[0] == 2 && orderList[1] == 1 );
+    }
+
+    // Many tasks on several workers, with cancelling and ready functions which push more tasks
+    {
+        const int iNumTasks = 20000;
+        std::vector < int > runCountList ( iNumTasks * 2 );     // Each task only writes its own slot
+        std::vector < int > readyCountList ( iNumTasks * 2 );
+        {
+            CAsyncTaskScheduler scheduler ( 4, iNumTasks * 2 );
+            CAsyncTaskToken cancelToken = CAsyncTaskToken::Create ();
+            int iNumExpected = 0;
+            int iNumReady = 0;
+
+            for ( int i = 0 ; i < iNumTasks ; i++ )
+            {
+                bool bCancel = ( i % 7 ) == 0;
+                bool bPushMore = ( i % 5 ) == 0;
+                CAsyncTaskScheduler::EPriority priority = ( i % 3 ) ? CAsyncTaskScheduler::EPriority::Interactive : CAsyncTaskScheduler::EPriority::Bulk;
+                bool bPushed = scheduler.PushTask < int > (
+                    [i, &runCountList] { runCountList[i]++; return i * 2; },
+                    [i, bPushMore, iNumTasks, &scheduler, &runCountList, &readyCountList, &iNumReady] ( const int& iResult )
+                    {
+                        assert ( iResult == i * 2 );
+                        assert ( runCountList[i] == 1 );
+                        readyCountList[i]++;
+                        iNumReady++;
+                        if ( bPushMore )
+                        {
+                            int j = i + iNumTasks;
+                            bool bPushed = scheduler.PushTask < int > ( [j, &runCountList] { runCountList[j]++; return j; },
+                                                                        [j, &readyCountList, &iNumReady] ( const int& iResult ) { assert ( iResult == j ); readyCountList[j]++; iNumReady++; } );
+                            assert ( bPushed );
+                        }
+                    },
+                    priority, bCancel ? cancelToken : CAsyncTaskToken ()
+                );
+                assert ( bPushed );
+
+                if ( !bCancel )
+                    iNumExpected += bPushMore ? 2 : 1;
+            }
+            cancelToken.Cancel ();
+
+            while ( iNumReady < iNumExpected )
+            {
+                std::this_thread::yield ();
+                scheduler.CollectResults ();
+            }
+            assert ( iNumReady == iNumExpected );
+        }
+
+        // Workers have stopped, so all counts are final
+        for ( int i = 0 ; i < iNumTasks ; i++ )
+        {
+            bool bCancel = ( i % 7 ) == 0;
+            bool bPushMore = ( i % 5 ) == 0;
+            assert ( bCancel ? runCountList[i] <= 1 : runCountList[i] == 1 );
+            assert ( readyCountList[i] == ( bCancel ? 0 : 1 ) );
+            assert ( runCountList[i + iNumTasks] == readyCountList[i + iNumTasks] );
+            assert ( readyCountList[i + iNumTasks] == ( !bCancel && bPushMore ? 1 : 0 ) );
+        }
+    }
+
+    // Destroying with tasks still queued
+    {
+        CAsyncTaskScheduler* pScheduler = new CAsyncTaskScheduler ( 2 );
+        for ( int i = 0 ; i < 1000 ; i++ )
+            pScheduler->PushTask < int > ( [i] { return i; }, [] ( const int& ) { assert ( 0 ); } );
+        delete pScheduler;
+    }
+}
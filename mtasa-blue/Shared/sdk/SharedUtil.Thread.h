@@ -133,6 +133,12 @@ namespace SharedUtil
         {
             pthread_cond_signal ( &cond );
         }
+
+        // Wake all waiting threads
+        void Broadcast ( void )
+        {
+            pthread_cond_broadcast ( &cond );
+        }
     };
 
 }
@@ -0,0 +1,63 @@
+/*****************************************************************************
+*
+*  PROJECT:     Multi Theft Auto v1.0
+*  LICENSE:     See LICENSE in the top level directory
+*  FILE:        SharedUtil.WorkSignal.h
+*
+*  Multi Theft Auto is available from http://www.multitheftauto.com/
+*
+*****************************************************************************/
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+
+namespace SharedUtil
+{
+    ///////////////////////////////////////////////////////////////
+    //
+    // CWorkSignal class
+    //
+    // Lets any number of producer threads wake a single consumer
+    // thread which is blocked waiting for something to do
+    //
+    ///////////////////////////////////////////////////////////////
+    class CWorkSignal
+    {
+    public:
+        //
+        // Flag that there is work pending and wake the waiting thread
+        // Can be called from any thread
+        //
+        void Notify()
+        {
+            // Skip the lock if the consumer has not yet picked up a previous notify
+            if (m_bPending.load())
+                return;
+
+            {
+                std::lock_guard<std::mutex> lock{ m_Mutex };
+                m_bPending = true;
+            }
+            m_Condition.notify_one();
+        }
+
+        //
+        // Block until Notify() is called or the timeout expires
+        // Returns true if work was signalled
+        //
+        bool Wait(uint uiTimeoutMs)
+        {
+            std::unique_lock<std::mutex> lock{ m_Mutex };
+            bool bSignalled = m_Condition.wait_for(lock, std::chrono::milliseconds(uiTimeoutMs), [this] { return m_bPending.load(); });
+            m_bPending = false;
+            return bSignalled;
+        }
+
+    private:
+        std::atomic<bool> m_bPending{ false };
+        std::mutex m_Mutex;
+        std::condition_variable m_Condition;
+    };
+}
@@ -154,4 +154,7 @@ enum ePacketID
     PACKET_ID_PLAYER_NO_SOCKET,
     PACKET_ID_PLAYER_NETWORK_STATUS,
     PACKET_ID_PLAYER_ACINFO,
+
+    PACKET_ID_COMPRESSED,
+    PACKET_ID_LUA_ELEMENT_RPC_BATCH,
 };